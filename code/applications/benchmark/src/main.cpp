@@ -0,0 +1,482 @@
+#include "stdlib/Util.h"
+#include "baremetal/ARMInstructions.h"
+#include "baremetal/ARMRegisters.h"
+#include "baremetal/AsyncMemory.h"
+#include "baremetal/Clock.h"
+#include "baremetal/DeferredWork.h"
+#include "baremetal/Histogram.h"
+#include "baremetal/InterruptHandler.h"
+#include "baremetal/Logger.h"
+#include "baremetal/MemoryAccess.h"
+#include "baremetal/MemoryManager.h"
+#include "baremetal/New.h"
+#include "baremetal/PeriodicTaskService.h"
+#include "baremetal/System.h"
+#include "baremetal/Timer.h"
+
+LOG_MODULE("main");
+
+using namespace baremetal;
+
+/// @brief Smallest buffer size benchmarked
+static const size_t MinSize = 4 * 1024;
+/// @brief Largest buffer size benchmarked
+static const size_t MaxSize = 8 * 1024 * 1024;
+
+/// <summary>
+/// Return the CPU cycle counter
+/// </summary>
+/// <returns>Current CPU cycle count</returns>
+static uint64 GetCycles()
+{
+    uint64 cycles;
+    GetCycleCounter(cycles);
+    return cycles;
+}
+
+/// <summary>
+/// Return the system counter
+/// </summary>
+/// <returns>Current system counter value</returns>
+/// <summary>
+/// Compare copying and filling by the CPU with offloading to DMA. For the CPU, all cycles are spent on the operation. For DMA, only the
+/// cycles needed to submit the operation are spent, the CPU is free until the operation has completed. The elapsed time shows when
+/// the data has actually been moved.
+/// </summary>
+/// <param name="destination">Destination buffer of MaxSize bytes</param>
+/// <param name="source">Source buffer of MaxSize bytes</param>
+static void BenchmarkMemoryOffload(uint8* destination, const uint8* source)
+{
+    AsyncMemory memory;
+    memory.SetThreshold(0);
+
+    LOG_INFO("Operation     Size    CPU cycles   CPU us    DMA submit cycles   DMA us");
+    for (size_t size = MinSize; size <= MaxSize; size *= 2)
+    {
+        uint64 startCycles = GetCycles();
+        TimePoint start = Clock::Now();
+        memcpy(destination, source, size);
+        uint64 cpuCycles = GetCycles() - startCycles;
+        Duration cpuTime = Clock::Elapsed(start);
+
+        start = Clock::Now();
+        startCycles = GetCycles();
+        AsyncMemoryHandle handle = memory.AsyncCopy(destination, source, size);
+        uint64 dmaCycles = GetCycles() - startCycles;
+        bool success = handle.Wait();
+        Duration dmaTime = Clock::Elapsed(start);
+        if (!success || (memcmp(destination, source, size) != 0))
+            LOG_ERROR("DMA copy of %u bytes failed", size);
+        LOG_INFO("Copy     %8u %12llu %8lld %20llu %8lld", size, cpuCycles, cpuTime.MicroSeconds(), dmaCycles, dmaTime.MicroSeconds());
+
+        startCycles = GetCycles();
+        start = Clock::Now();
+        memset(destination, 0x55, size);
+        cpuCycles = GetCycles() - startCycles;
+        cpuTime = Clock::Elapsed(start);
+
+        start = Clock::Now();
+        startCycles = GetCycles();
+        handle = memory.AsyncFill(destination, 0xAA, size);
+        dmaCycles = GetCycles() - startCycles;
+        success = handle.Wait();
+        dmaTime = Clock::Elapsed(start);
+        if (!success || (destination[0] != 0xAA) || (destination[size - 1] != 0xAA))
+            LOG_ERROR("DMA fill of %u bytes failed", size);
+        LOG_INFO("Fill     %8u %12llu %8lld %20llu %8lld", size, cpuCycles, cpuTime.MicroSeconds(), dmaCycles, dmaTime.MicroSeconds());
+    }
+}
+
+/// @brief Number of times the measurement kernel timer has elapsed
+static volatile unsigned kernelTimerCount{};
+/// @brief Set to stop the measurement kernel timer from restarting
+static volatile bool stopKernelTimer{};
+
+/// <summary>
+/// Kernel timer handler, restarting itself every 100 ms until stopped
+/// </summary>
+static void MeasurementTimerHandler(KernelTimerHandle /*handle*/, void* /*param*/, void* /*context*/)
+{
+    kernelTimerCount++;
+    if (!stopKernelTimer)
+        GetTimer().StartKernelTimerMicroSeconds(100 * USEC_PER_MSEC, MeasurementTimerHandler);
+}
+
+/// <summary>
+/// Periodic timer handler, doing nothing
+/// </summary>
+static void PeriodicHandler()
+{
+}
+
+/// <summary>
+/// Count the number of timer interrupts during one second of busy waiting (which does not use the timer interrupt)
+/// </summary>
+/// <returns>Number of timer interrupts</returns>
+static uint64 CountTimerInterrupts()
+{
+    auto& timer = GetTimer();
+    uint64 startCount = timer.GetInterruptCount();
+    Timer::WaitMilliSeconds(1000);
+    return timer.GetInterruptCount() - startCount;
+}
+
+/// <summary>
+/// Show how often the core is woken up by the timer interrupt, when idle, with a kernel timer elapsing every 100 ms, and with a periodic handler installed.
+/// With the periodic tick, this is always TICKS_PER_SECOND per second. In tickless mode (BAREMETAL_TICKLESS_TIMER=ON) the interrupt only fires for timers that elapse.
+/// </summary>
+static void BenchmarkTimerInterrupts()
+{
+    auto& timer = GetTimer();
+    LOG_INFO("Timer interrupts per second (%s)", BAREMETAL_TICKLESS ? "tickless" : "periodic tick");
+    LOG_INFO("Idle                      %8llu", CountTimerInterrupts());
+
+    timer.StartKernelTimerMicroSeconds(100 * USEC_PER_MSEC, MeasurementTimerHandler);
+    uint64 interrupts = CountTimerInterrupts();
+    unsigned elapsed = kernelTimerCount;
+    stopKernelTimer = true;
+    Timer::WaitMilliSeconds(100);
+    LOG_INFO("Kernel timer every 100 ms %8llu (%u elapsed)", interrupts, elapsed);
+
+    timer.RegisterPeriodicHandler(PeriodicHandler);
+    LOG_INFO("Periodic handler          %8llu", CountTimerInterrupts());
+    timer.UnregisterPeriodicHandler(PeriodicHandler);
+}
+
+/// <summary>
+/// Measure how accurately Timer::WaitMicroSeconds() ends at the requested time, and how many CPU cycles it uses.
+/// The PMU cycle counter does not count while the core is sleeping in WFE, so the active cycles show how much of the wait was spent spinning.
+/// </summary>
+static void BenchmarkWaitAccuracy()
+{
+    static const uint64 delays[]{1, 5, 20, 100, 1000, 20000};
+    const unsigned Repeat = 20;
+
+    LOG_INFO("Wait accuracy (event period %lld ns)", Clock::GetEventPeriod().NanoSeconds());
+    LOG_INFO("Requested us  Min late ns  Avg late ns  Max late ns  Avg active cycles");
+    for (auto delay : delays)
+    {
+        int64 minLate{};
+        int64 maxLate{};
+        int64 totalLate{};
+        uint64 totalCycles{};
+        for (unsigned i = 0; i < Repeat; ++i)
+        {
+            uint64 startCycles = GetCycles();
+            TimePoint start = Clock::Now();
+            Timer::WaitMicroSeconds(delay);
+            int64 late = (Clock::Elapsed(start) - Duration::FromMicroSeconds(static_cast<int64>(delay))).NanoSeconds();
+            totalCycles += GetCycles() - startCycles;
+            if ((i == 0) || (late < minLate))
+                minLate = late;
+            if ((i == 0) || (late > maxLate))
+                maxLate = late;
+            totalLate += late;
+        }
+        LOG_INFO("%12llu %12lld %12lld %12lld %18llu", delay, minLate, totalLate / Repeat, maxLate, totalCycles / Repeat);
+    }
+}
+
+#if BAREMETAL_RPI_TARGET != 3
+/// @brief Unused IRQ lines, triggered by software to create a burst of interrupts
+static const IRQ_ID BurstIRQs[]{IRQ_ID::IRQ_HOSTPORT, IRQ_ID::IRQ_VIDEOSCALER, IRQ_ID::IRQ_DSI0, IRQ_ID::IRQ_CAM0, IRQ_ID::IRQ_CAM1, IRQ_ID::IRQ_CPR};
+/// @brief Number of burst IRQs handled
+static volatile unsigned burstIRQCount{};
+
+/// <summary>
+/// IRQ handler for the burst IRQs
+/// </summary>
+static void BurstIRQHandler(void* /*param*/)
+{
+    burstIRQCount++;
+}
+#endif
+
+/// <summary>
+/// Measure the cost of handling a burst of interrupts which are pending at the same time. All pending IRQs are handled in a single exception,
+/// so the number of exception entries per burst should be 1, and the cost per IRQ should drop as the burst grows.
+/// The burst is created by setting IRQs pending in the GIC distributor while IRQs are masked, which is only possible on Raspberry Pi 4.
+/// </summary>
+static void BenchmarkInterruptBurst()
+{
+#if BAREMETAL_RPI_TARGET == 3
+    LOG_INFO("Interrupt burst benchmark needs software triggered interrupts (GIC), skipped");
+#else
+    const unsigned Repeat = 1000;
+    auto& interruptSystem = GetInterruptSystem();
+    auto& memoryAccess = GetMemoryAccess();
+    for (auto irqID : BurstIRQs)
+        interruptSystem.RegisterIRQHandler(irqID, BurstIRQHandler, nullptr);
+
+    LOG_INFO("Interrupt burst  Entries/burst  Avg cycles/burst  Avg cycles/IRQ");
+    for (unsigned burstSize = 1; burstSize <= sizeof(BurstIRQs) / sizeof(BurstIRQs[0]); ++burstSize)
+    {
+        uint64 totalCycles{};
+        uint64 entries = interruptSystem.GetInterruptEntryCount();
+        for (unsigned i = 0; i < Repeat; ++i)
+        {
+            burstIRQCount = 0;
+            uint64 daif;
+            GetDAIF(daif);
+            DisableIRQs();
+            for (unsigned n = 0; n < burstSize; ++n)
+            {
+                unsigned irq = static_cast<unsigned>(BurstIRQs[n]);
+                memoryAccess.Write32(RPI_GICD_ISPENDR0 + 4 * (irq / 32), static_cast<uint32>(BIT1(irq % 32)));
+            }
+            DataSyncBarrier();
+            uint64 startCycles = GetCycles();
+            SetDAIF(daif);
+            while (burstIRQCount < burstSize)
+                NOP();
+            totalCycles += GetCycles() - startCycles;
+        }
+        // Timer interrupts during the measurement are included in the entry count
+        entries = interruptSystem.GetInterruptEntryCount() - entries;
+        LOG_INFO("%15u %14llu.%02llu %17llu %15llu", burstSize, entries / Repeat, (entries * 100 / Repeat) % 100, totalCycles / Repeat,
+                 totalCycles / Repeat / burstSize);
+    }
+
+    for (auto irqID : BurstIRQs)
+        interruptSystem.UnregisterIRQHandler(irqID);
+#endif
+}
+
+#if BAREMETAL_RPI_TARGET != 3
+/// @brief Number of timer interrupts handled while the slow IRQ handler was running
+static volatile uint64 slowHandlerTimerInterrupts{};
+/// @brief Set when the slow IRQ handler is done
+static volatile bool slowHandlerDone{};
+
+/// <summary>
+/// IRQ handler taking 25 ms
+/// </summary>
+static void SlowIRQHandler(void* /*param*/)
+{
+    uint64 startCount = GetTimer().GetInterruptCount();
+    Clock::Wait(Duration::FromMilliSeconds(25));
+    slowHandlerTimerInterrupts = GetTimer().GetInterruptCount() - startCount;
+    slowHandlerDone = true;
+}
+
+/// <summary>
+/// Kernel timer handler, doing nothing
+/// </summary>
+static void IdleTimerHandler(KernelTimerHandle /*handle*/, void* /*param*/, void* /*context*/)
+{
+}
+#endif
+
+/// <summary>
+/// Show that a slow preemptible IRQ handler holds off the timer interrupt if it has the same priority, and is preempted by it if it has a lower priority.
+/// Only the GIC (Raspberry Pi 4) supports priorities
+/// </summary>
+static void BenchmarkNestedInterrupts()
+{
+#if BAREMETAL_RPI_TARGET == 3
+    LOG_INFO("Nested interrupt benchmark needs interrupt priorities (GIC), skipped");
+#else
+    auto& interruptSystem = GetInterruptSystem();
+    const IRQ_ID SlowIRQ = IRQ_ID::IRQ_HOSTPORT;
+    static const uint8 priorities[]{IRQ_PRIORITY_DEFAULT, IRQ_PRIORITY_LOWEST};
+
+    LOG_INFO("Slow handler priority  Timer interrupts during 25 ms handler");
+    for (auto priority : priorities)
+    {
+        interruptSystem.RegisterIRQHandler(SlowIRQ, SlowIRQHandler, nullptr, priority, true);
+        slowHandlerDone = false;
+        // Make sure the timer interrupt fires while the slow handler runs, also in tickless mode
+        GetTimer().StartKernelTimerMicroSeconds(5000, IdleTimerHandler);
+        unsigned irq = static_cast<unsigned>(SlowIRQ);
+        GetMemoryAccess().Write32(RPI_GICD_ISPENDR0 + 4 * (irq / 32), static_cast<uint32>(BIT1(irq % 32)));
+        while (!slowHandlerDone)
+            NOP();
+        LOG_INFO("%20s   %8llu", (priority == IRQ_PRIORITY_DEFAULT) ? "same as timer" : "lower than timer", slowHandlerTimerInterrupts);
+        interruptSystem.UnregisterIRQHandler(SlowIRQ);
+        Timer::WaitMilliSeconds(20);
+    }
+#endif
+}
+
+/// @brief PMU cycle counter value at the start of the last call to EntryMeasurementHandler()
+static volatile uint64 entryHandlerCycles{};
+/// @brief Number of calls to EntryMeasurementHandler()
+static volatile unsigned entryHandlerCount{};
+
+/// <summary>
+/// IRQ or FIQ handler for the interrupt entry measurement
+/// </summary>
+static void EntryMeasurementHandler(void* /*param*/)
+{
+    entryHandlerCycles = GetCycles();
+#if BAREMETAL_RPI_TARGET == 3
+    GetMemoryAccess().Write32(ARM_LOCAL_MAILBOX0_CLR0, ~0U); // Clearing the mailbox clears the interrupt
+#endif
+    entryHandlerCount++;
+}
+
+/// <summary>
+/// Trigger the interrupt for the interrupt entry measurement: core 0 mailbox 0 on Raspberry Pi 3, the unused USB host port IRQ on the GIC
+/// </summary>
+static void TriggerEntryMeasurement()
+{
+#if BAREMETAL_RPI_TARGET == 3
+    GetMemoryAccess().Write32(ARM_LOCAL_MAILBOX0_SET0, 1);
+#else
+    unsigned irq = static_cast<unsigned>(IRQ_ID::IRQ_HOSTPORT);
+    GetMemoryAccess().Write32(RPI_GICD_ISPENDR0 + 4 * (irq / 32), static_cast<uint32>(BIT1(irq % 32)));
+#endif
+}
+
+/// <summary>
+/// Trigger the entry measurement interrupt repeatedly, and show the PMU cycles from the trigger to the start of the handler, and to the return
+/// to the interrupted code
+/// </summary>
+/// <param name="path">Name of the interrupt path measured</param>
+static void MeasureInterruptEntry(const char* path)
+{
+    const unsigned Repeat = 1000;
+    Histogram entry;
+    Histogram roundTrip;
+    for (unsigned i = 0; i < Repeat; ++i)
+    {
+        unsigned count = entryHandlerCount;
+        uint64 startCycles = GetCycles();
+        TriggerEntryMeasurement();
+        while (entryHandlerCount == count)
+            NOP();
+        uint64 endCycles = GetCycles();
+        entry.Add(entryHandlerCycles - startCycles);
+        roundTrip.Add(endCycles - startCycles);
+    }
+    LOG_INFO("%-4s  %llu/%llu/%llu/%llu  %llu/%llu/%llu/%llu", path, entry.GetMin(), entry.GetPercentile(50), entry.GetPercentile(99), entry.GetMax(),
+             roundTrip.GetMin(), roundTrip.GetPercentile(50), roundTrip.GetPercentile(99), roundTrip.GetMax());
+}
+
+/// <summary>
+/// Compare the entry overhead of the generic IRQ path and the FIQ fast path, in PMU cycles.
+/// On Raspberry Pi 3 the core mailbox interrupt is used, which is only supported as FIQ, so only the FIQ path is measured.
+/// On the GIC, the FIQ path is only a real FIQ if the kernel has secure access to the GIC, otherwise the source is signalled as the highest priority
+/// IRQ (see EnableFIQ())
+/// </summary>
+static void BenchmarkInterruptEntry()
+{
+    auto& interruptSystem = GetInterruptSystem();
+    LOG_INFO("Path  Trigger to handler min/p50/p99/max  Trigger to return min/p50/p99/max (cycles)");
+#if BAREMETAL_RPI_TARGET == 3
+    const FIQ_ID fiqID = FIQ_ID::FIQ_LOCAL_MAILBOX0;
+    GetMemoryAccess().Write32(ARM_LOCAL_MAILBOX0_CLR0, ~0U);
+#else
+    const FIQ_ID fiqID = FIQ_ID::FIQ_HOSTPORT;
+    interruptSystem.RegisterIRQHandler(IRQ_ID::IRQ_HOSTPORT, EntryMeasurementHandler, nullptr);
+    MeasureInterruptEntry("IRQ");
+    interruptSystem.UnregisterIRQHandler(IRQ_ID::IRQ_HOSTPORT);
+#endif
+    interruptSystem.RegisterFIQHandler(fiqID, EntryMeasurementHandler, nullptr);
+    MeasureInterruptEntry("FIQ");
+    interruptSystem.UnregisterFIQHandler(fiqID);
+}
+
+/// <summary>
+/// Periodic task doing a small amount of work
+/// </summary>
+static void SamplingTask(void* /*context*/)
+{
+    Timer::WaitCycles(1000);
+}
+
+/// <summary>
+/// Run sampling tasks at 1 kHz, 100 Hz and 1 Hz for a few seconds, and show their execution time and release jitter.
+/// Without BAREMETAL_TICKLESS_TIMER=ON, releases are rounded to timer ticks, so the 1 kHz task shows overruns and large jitter.
+/// </summary>
+static void BenchmarkPeriodicTasks()
+{
+    auto& service = GetPeriodicTaskService();
+    PeriodicTask* tasks[]{
+        service.AddTask("1 kHz", 1000, 0, SamplingTask),
+        service.AddTask("100 Hz", 10000, 500, SamplingTask),
+        service.AddTask("1 Hz", USEC_PER_SEC, 0, SamplingTask),
+    };
+    Timer::WaitMilliSeconds(3000);
+    LOG_INFO("Periodic tasks (%s)", BAREMETAL_TICKLESS ? "tickless" : "periodic tick");
+    service.DumpStatistics();
+    for (auto task : tasks)
+    {
+        if (task != nullptr)
+            service.RemoveTask(task);
+    }
+}
+
+/// <summary>
+/// Deferred work, doing the same amount of work as SamplingTask()
+/// </summary>
+static void SamplingWork(void* /*param*/, uintptr /*value*/)
+{
+    Timer::WaitCycles(1000);
+}
+
+/// <summary>
+/// Periodic task which only queues its work, so the time spent in interrupt context is a single Enqueue()
+/// </summary>
+static void DeferringTask(void* /*context*/)
+{
+    GetDeferredWorkQueue().Enqueue(SamplingWork, nullptr);
+}
+
+/// <summary>
+/// Run a 100 Hz task which defers its work, and show the execution time of the task in interrupt context, and the queue depth and latency of the deferred work.
+/// Compare the execution time with that of the 100 Hz task in BenchmarkPeriodicTasks(), which does the work in interrupt context
+/// </summary>
+static void BenchmarkDeferredWork()
+{
+    auto& service = GetPeriodicTaskService();
+    auto& deferredWork = GetDeferredWorkQueue();
+    deferredWork.ResetStatistics();
+    PeriodicTask* task = service.AddTask("100 Hz deferring", 10000, 500, DeferringTask);
+    Timer::WaitMilliSeconds(3000);
+    LOG_INFO("Deferred work (run at IRQ exit: %s)", DEFERRED_WORK_RUN_AT_IRQ_EXIT ? "yes" : "no");
+    service.DumpStatistics();
+    if (task != nullptr)
+        service.RemoveTask(task);
+    // Without the pass at IRQ exit, the work is only run here
+    deferredWork.Run();
+    deferredWork.DumpStatistics();
+}
+
+int main()
+{
+    uint64 pmcr;
+    GetPMCR(pmcr);
+    SetPMCR(pmcr | PMCR_EL0_E | PMCR_EL0_C);
+    SetPMCNTENSET(PMCNTENSET_EL0_C);
+
+    // DMA can only access memory below 1 Gb
+    uint8* source = new (HeapType::DMA30) uint8[MaxSize];
+    uint8* destination = new (HeapType::DMA30) uint8[MaxSize];
+    if ((source == nullptr) || (destination == nullptr))
+    {
+        LOG_ERROR("Cannot allocate buffers");
+        return static_cast<int>(ReturnCode::ExitHalt);
+    }
+    for (size_t i = 0; i < MaxSize; ++i)
+        source[i] = static_cast<uint8>(i);
+
+    BenchmarkTimerInterrupts();
+    BenchmarkWaitAccuracy();
+    BenchmarkInterruptBurst();
+    BenchmarkNestedInterrupts();
+    BenchmarkInterruptEntry();
+    BenchmarkPeriodicTasks();
+    BenchmarkDeferredWork();
+#if BAREMETAL_IRQ_STATS
+    GetInterruptSystem().DumpIRQStatistics();
+#endif
+    BenchmarkMemoryOffload(destination, source);
+
+    delete[] destination;
+    delete[] source;
+
+    LOG_INFO("Halting");
+
+    return static_cast<int>(ReturnCode::ExitHalt);
+}
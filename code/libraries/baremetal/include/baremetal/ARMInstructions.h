@@ -53,18 +53,26 @@
 #define DataSyncBarrier()                              asm volatile("dsb sy" ::: "memory")
 /// @brief Data memory barrier
 #define DataMemBarrier()                               asm volatile("dmb sy" ::: "memory")
+/// @brief Instruction sync barrier, e.g. to keep a counter read from being executed ahead of preceding instructions
+#define InstructionSyncBarrier()                       asm volatile("isb" ::: "memory")
 
 /// @brief Wait for interrupt
 #define WaitForInterrupt()                             asm volatile("wfi")
+/// @brief Wait for event (or interrupt)
+#define WaitForEvent()                                 asm volatile("wfe")
 
 /// @brief Enable IRQs. Clear bit 1 of DAIF register. See @ref ARM_REGISTERS_REGISTER_OVERVIEW_DAIF_REGISTER
-#define EnableIRQs()                                   asm volatile("msr DAIFClr, #2")
+#define EnableIRQs()                                   asm volatile("msr DAIFClr, #2" ::: "memory")
 /// @brief Disable IRQs. Set bit 1 of DAIF register. See @ref ARM_REGISTERS_REGISTER_OVERVIEW_DAIF_REGISTER
-#define DisableIRQs()                                  asm volatile("msr DAIFSet, #2")
+#define DisableIRQs()                                  asm volatile("msr DAIFSet, #2" ::: "memory")
 /// @brief Enable FIQs. Clear bit 0 of DAIF register. See @ref ARM_REGISTERS_REGISTER_OVERVIEW_DAIF_REGISTER
 #define EnableFIQs()                                   asm volatile("msr DAIFClr, #1")
 /// @brief Disable FIQs. Set bit 0 of DAIF register. See @ref ARM_REGISTERS_REGISTER_OVERVIEW_DAIF_REGISTER
 #define DisableFIQs()                                  asm volatile("msr DAIFSet, #1")
+/// @brief Get DAIF register, holding the interrupt mask bits. See @ref ARM_REGISTERS_REGISTER_OVERVIEW_DAIF_REGISTER
+#define GetDAIF(value)                                 asm volatile("mrs %0, DAIF" : "=r"(value))
+/// @brief Set DAIF register, e.g. to restore interrupt mask bits saved with GetDAIF(). See @ref ARM_REGISTERS_REGISTER_OVERVIEW_DAIF_REGISTER
+#define SetDAIF(value)                                 asm volatile("msr DAIF, %0" ::"r"(value) : "memory")
 
 /// @brief Get counter timer frequency. See @ref ARM_REGISTERS_REGISTER_OVERVIEW_CNTFRQ_EL0_REGISTER
 #define GetTimerFrequency(freq)                        asm volatile("mrs %0, CNTFRQ_EL0" : "=r"(freq))
@@ -88,6 +96,32 @@
 /// @brief Set Physical counter-timer comparison value. See \ref ARM_REGISTERS_REGISTER_OVERVIEW_CNTP_CVAL_EL0_REGISTER
 #define SetTimerCompareValue(value)                    asm volatile("msr CNTP_CVAL_EL0, %0" ::"r"(value))
 
+/// @brief Get Counter-timer Kernel Control register
+#define GetTimerKernelControl(value)                   asm volatile("mrs %0, CNTKCTL_EL1" : "=r"(value))
+/// @brief Set Counter-timer Kernel Control register
+#define SetTimerKernelControl(value)                   asm volatile("msr CNTKCTL_EL1, %0" ::"r"(value))
+/// @brief EVNTEN bit, enables the event stream generated from the virtual counter
+#define CNTKCTL_EL1_EVNTEN                             BIT1(2)
+/// @brief EVNTI field, selects the counter bit which triggers an event when it changes from 0 to 1, giving an event every 2^(EVNTI+1) counter ticks
+#define CNTKCTL_EL1_EVNTI(bit)                         (static_cast<uint64>(bit) << 4)
+/// @brief Mask for EVNTI field
+#define CNTKCTL_EL1_EVNTI_MASK                         (0xFULL << 4)
+
+/// @brief Get Performance Monitors Control register
+#define GetPMCR(value)                                 asm volatile("mrs %0, PMCR_EL0" : "=r"(value))
+/// @brief Set Performance Monitors Control register
+#define SetPMCR(value)                                 asm volatile("msr PMCR_EL0, %0" ::"r"(value))
+/// @brief PMCR_EL0 E bit, enables all counters
+#define PMCR_EL0_E                                     BIT1(0)
+/// @brief PMCR_EL0 C bit, resets the cycle counter
+#define PMCR_EL0_C                                     BIT1(2)
+/// @brief Set Performance Monitors Count Enable Set register
+#define SetPMCNTENSET(value)                           asm volatile("msr PMCNTENSET_EL0, %0" ::"r"(value))
+/// @brief PMCNTENSET_EL0 C bit, enables the cycle counter
+#define PMCNTENSET_EL0_C                               BIT1(31)
+/// @brief Get Performance Monitors Cycle Count register, counting CPU cycles once enabled through PMCR_EL0 and PMCNTENSET_EL0
+#define GetCycleCounter(value)                         asm volatile("mrs %0, PMCCNTR_EL0" : "=r"(value))
+
 /// @brief Get current exception level
 #define GetCurrentEL(value)                            asm volatile("mrs %0, CurrentEL" : "=r"(value))
 /// @brief EL value shift
@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : AsyncMemory.h
+//
+// Namespace   : baremetal
+//
+// Class       : AsyncMemory
+//
+// Description : Asynchronous memory copy and fill, offloaded to DMA
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "baremetal/DMAChannel.h"
+#include "stdlib/Macros.h"
+#include "stdlib/Types.h"
+
+/// @file
+/// Asynchronous memory copy and fill, offloaded to DMA
+
+/// @brief Minimum size in bytes for which a copy or fill is performed by DMA. Smaller operations are done by the CPU,
+/// as setting up the DMA transfer costs more than it saves. Can be changed at run time with AsyncMemory::SetThreshold()
+#ifndef ASYNC_MEMORY_DMA_THRESHOLD
+#define ASYNC_MEMORY_DMA_THRESHOLD 4096
+#endif
+
+namespace baremetal {
+
+class AsyncMemory;
+
+/// <summary>
+/// Completion handle for an asynchronous memory operation. A default constructed handle refers to an operation that has completed
+/// </summary>
+class AsyncMemoryHandle
+{
+    /// <summary>
+    /// Only AsyncMemory creates handles for operations
+    /// </summary>
+    friend class AsyncMemory;
+
+private:
+    /// @brief Instance the operation was submitted to, nullptr for a completed operation
+    AsyncMemory* m_owner;
+    /// @brief Sequence number of the operation
+    uint32 m_sequence;
+
+    AsyncMemoryHandle(AsyncMemory* owner, uint32 sequence);
+
+public:
+    AsyncMemoryHandle();
+
+    bool IsDone() const;
+    bool Wait() const;
+};
+
+/// <summary>
+/// Asynchronous memory copy and fill. Operations of at least the threshold size are performed by a DMA channel, so the CPU is free while
+/// the data is moved; smaller operations, or operations the DMA channel cannot handle, are performed by the CPU before returning.
+///
+/// One DMA operation is in flight at a time: submitting a new operation first waits for the previous one, so operations complete in order.
+/// The result of the last 64 operations is kept for their handles; waiting on an older operation reports failure if any operation that old failed.
+/// Buffers must not overlap, and must stay valid until the operation has completed.
+/// </summary>
+class AsyncMemory
+{
+    /// <summary>
+    /// Handles query the state of their operation
+    /// </summary>
+    friend class AsyncMemoryHandle;
+
+private:
+    /// @brief DMA channel used for the operations
+    DMAChannel m_channel;
+    /// @brief Minimum size for DMA operations in bytes
+    size_t m_threshold;
+    /// @brief Sequence number of the last operation submitted
+    uint32 m_submittedSequence;
+    /// @brief Sequence number up to which all operations have completed
+    uint32 m_completedSequence;
+    /// @brief Results of the most recent operations, bit n is set if operation m_completedSequence - n failed
+    uint64 m_failureHistory;
+    /// @brief Flags an operation failed which is no longer in m_failureHistory
+    bool m_olderFailure;
+    /// @brief Pattern for fill operations, read repeatedly by the DMA engine
+    uint8 m_fillPattern[16] ALIGN(16);
+
+public:
+    AsyncMemory(DMAChannelType type = DMAChannelType::Normal, DMAController& controller = GetDMAController());
+
+    void SetThreshold(size_t threshold);
+    size_t GetThreshold() const;
+
+    AsyncMemoryHandle AsyncCopy(void* destination, const void* source, size_t length);
+    AsyncMemoryHandle AsyncFill(void* destination, uint8 value, size_t length);
+    AsyncMemoryHandle AsyncCopy2D(void* destination, size_t destinationPitch, const void* source, size_t sourcePitch, size_t width,
+                                  size_t height);
+    void WaitAll();
+
+private:
+    bool IsDone(uint32 sequence);
+    bool Wait(uint32 sequence);
+    AsyncMemoryHandle Completed();
+    AsyncMemoryHandle StartDMA();
+    void FinishDMA();
+    void RecordResult(bool success);
+};
+
+} // namespace baremetal
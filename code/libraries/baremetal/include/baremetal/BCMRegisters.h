@@ -167,7 +167,11 @@
 #define RPI_GICD_CTLR_ENABLE_GROUP1             BIT1(1)
 #define RPI_GICD_IGROUPR0                       reinterpret_cast<regaddr>(RPI_GICD_BASE + 0x0080) // Secure access for group 0
 #define RPI_GICD_ISENABLER0                     reinterpret_cast<regaddr>(RPI_GICD_BASE + 0x0100)
+#ifdef __cplusplus
 #define RPI_GICD_ICENABLER0                     reinterpret_cast<regaddr>(RPI_GICD_BASE + 0x0180)
+#else
+#define RPI_GICD_ICENABLER0                     (RPI_GICD_BASE + 0x0180) // Used in FIQStub
+#endif
 #define RPI_GICD_ISPENDR0                       reinterpret_cast<regaddr>(RPI_GICD_BASE + 0x0200)
 #define RPI_GICD_ICPENDR0                       reinterpret_cast<regaddr>(RPI_GICD_BASE + 0x0280)
 #define RPI_GICD_ISACTIVER0                     reinterpret_cast<regaddr>(RPI_GICD_BASE + 0x0300)
@@ -195,11 +199,21 @@
 #define RPI_GICC_CTLR_FIQ_ENABLE                BIT1(3)
 #define RPI_GICC_PMR                            reinterpret_cast<regaddr>(RPI_GICC_BASE + 0x0004)
 #define RPI_GICC_PMR_PRIORITY                   BITS(4, 7)
+#define RPI_GICC_BPR                            reinterpret_cast<regaddr>(RPI_GICC_BASE + 0x0008)
+#define RPI_GICC_BPR_ALL_GROUP_PRIORITY         3 // Priority bits 7..4 (all implemented bits) are group priority, so every higher priority level preempts
+#ifdef __cplusplus
 #define RPI_GICC_IAR                            reinterpret_cast<regaddr>(RPI_GICC_BASE + 0x000C)
+#else
+#define RPI_GICC_IAR                            (RPI_GICC_BASE + 0x000C) // Used in FIQStub
+#endif
 #define RPI_GICC_IAR_INTERRUPT_ID_MASK          BITS(0, 9)
 #define RPI_GICC_IAR_CPUID_SHIFT                10
 #define RPI_GICC_IAR_CPUID_MASK                 BITS(RPI_GICC_IAR_CPUID_SHIFT, RPI_GICC_IAR_CPUID_SHIFT + 1)
+#ifdef __cplusplus
 #define RPI_GICC_EOIR                           reinterpret_cast<regaddr>(RPI_GICC_BASE + 0x0010)
+#else
+#define RPI_GICC_EOIR                           (RPI_GICC_BASE + 0x0010) // Used in FIQStub
+#endif
 #define RPI_GICC_EOIR_EOIINTID_MASK             BITS(0, 9)
 #define RPI_GICC_EOIR_CPUID_SHIFT               10
 #define RPI_GICC_EOIR_CPUID_MASK                BITS(RPI_GICC_EOIR_CPUID_SHIFT, RPI_GICC_EOIR_CPUID_SHIFT + 1)
@@ -283,6 +297,120 @@
 /// @brief Convert seconds to watchdog timer value (each step is 1/65536 seconds)
 #define RPI_PWRMGT_TIMER_SECONDS(x)     ((x) << 16)
 
+//---------------------------------------------
+// Raspberry Pi DMA controller
+//---------------------------------------------
+
+/// @brief Raspberry Pi DMA controller channel 0-14 registers base address. Channel 15 is located elsewhere, and is not used. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_BASE                    RPI_BCM_IO_BASE + 0x00007000
+/// @brief Raspberry Pi DMA controller register block base address for a channel (0-14). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_CHANNEL_BASE(channel)   (RPI_DMA_BASE + (channel) * 0x00000100)
+/// @brief Raspberry Pi DMA channel Control and Status register (R/W). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_CS(channel)             reinterpret_cast<regaddr>(RPI_DMA_CHANNEL_BASE(channel) + 0x00000000)
+/// @brief Raspberry Pi DMA channel Control Block Address register (R/W). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_CONBLK_AD(channel)      reinterpret_cast<regaddr>(RPI_DMA_CHANNEL_BASE(channel) + 0x00000004)
+/// @brief Raspberry Pi DMA channel Transfer Information register of current control block (R). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TI(channel)             reinterpret_cast<regaddr>(RPI_DMA_CHANNEL_BASE(channel) + 0x00000008)
+/// @brief Raspberry Pi DMA channel Source Address register of current control block (R). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_SOURCE_AD(channel)      reinterpret_cast<regaddr>(RPI_DMA_CHANNEL_BASE(channel) + 0x0000000C)
+/// @brief Raspberry Pi DMA channel Destination Address register of current control block (R). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_DEST_AD(channel)        reinterpret_cast<regaddr>(RPI_DMA_CHANNEL_BASE(channel) + 0x00000010)
+/// @brief Raspberry Pi DMA channel Transfer Length register of current control block (R). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TXFR_LEN(channel)       reinterpret_cast<regaddr>(RPI_DMA_CHANNEL_BASE(channel) + 0x00000014)
+/// @brief Raspberry Pi DMA channel 2D Stride register of current control block (R). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_STRIDE(channel)         reinterpret_cast<regaddr>(RPI_DMA_CHANNEL_BASE(channel) + 0x00000018)
+/// @brief Raspberry Pi DMA channel Next Control Block Address register (R/W, write only when paused). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_NEXTCONBK(channel)      reinterpret_cast<regaddr>(RPI_DMA_CHANNEL_BASE(channel) + 0x0000001C)
+/// @brief Raspberry Pi DMA channel Debug register (R/W). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_DEBUG(channel)          reinterpret_cast<regaddr>(RPI_DMA_CHANNEL_BASE(channel) + 0x00000020)
+/// @brief Raspberry Pi DMA controller Interrupt Status register, one bit per channel (R). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_INT_STATUS              reinterpret_cast<regaddr>(RPI_DMA_BASE + 0x00000FE0)
+/// @brief Raspberry Pi DMA controller Global Enable register, one bit per channel (R/W). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_ENABLE                  reinterpret_cast<regaddr>(RPI_DMA_BASE + 0x00000FF0)
+/// @brief End of DMA channel 0-14 register region
+#define RPI_DMA_END                     RPI_DMA_BASE + 0x00001000
+
+/// @brief Raspberry Pi DMA channel Control and Status register reset channel. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_CS_RESET                BIT1(31)
+/// @brief Raspberry Pi DMA channel Control and Status register abort current control block. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_CS_ABORT                BIT1(30)
+/// @brief Raspberry Pi DMA channel Control and Status register disable debug pause. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_CS_DISDEBUG             BIT1(29)
+/// @brief Raspberry Pi DMA channel Control and Status register wait for outstanding writes before completing. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_CS_WAIT_FOR_OUTSTANDING_WRITES BIT1(28)
+/// @brief Raspberry Pi DMA channel Control and Status register panic priority (0-15). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_CS_PANIC_PRIORITY(x)    (((x) & 0x0F) << 20)
+/// @brief Raspberry Pi DMA channel Control and Status register AXI priority (0-15). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_CS_PRIORITY(x)          (((x) & 0x0F) << 16)
+/// @brief Raspberry Pi DMA channel Control and Status register error flag (R). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_CS_ERROR                BIT1(8)
+/// @brief Raspberry Pi DMA channel Control and Status register channel is paused (R). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_CS_PAUSED               BIT1(4)
+/// @brief Raspberry Pi DMA channel Control and Status register DREQ requesting data (R). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_CS_DREQ                 BIT1(3)
+/// @brief Raspberry Pi DMA channel Control and Status register interrupt status, write 1 to clear. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_CS_INT                  BIT1(2)
+/// @brief Raspberry Pi DMA channel Control and Status register transfer complete, write 1 to clear. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_CS_END                  BIT1(1)
+/// @brief Raspberry Pi DMA channel Control and Status register activate channel. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_CS_ACTIVE               BIT1(0)
+
+/// @brief Raspberry Pi DMA Transfer Information do not do wide writes as 2 beat burst. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TI_NO_WIDE_BURSTS       BIT1(26)
+/// @brief Raspberry Pi DMA Transfer Information add wait cycles after each read / write (0-31). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TI_WAITS(x)             (((x) & 0x1F) << 21)
+/// @brief Raspberry Pi DMA Transfer Information peripheral number (DREQ) for pacing (0-31). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TI_PERMAP(x)            (((x) & 0x1F) << 16)
+/// @brief Raspberry Pi DMA Transfer Information burst transfer length in words (0-15, 0 is single transfer). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TI_BURST_LENGTH(x)      (((x) & 0x0F) << 12)
+/// @brief Raspberry Pi DMA Transfer Information do not read source, write zeroes. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TI_SRC_IGNORE           BIT1(11)
+/// @brief Raspberry Pi DMA Transfer Information pace source reads with DREQ. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TI_SRC_DREQ             BIT1(10)
+/// @brief Raspberry Pi DMA Transfer Information use 128 bit source reads. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TI_SRC_WIDTH            BIT1(9)
+/// @brief Raspberry Pi DMA Transfer Information increment source address. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TI_SRC_INC              BIT1(8)
+/// @brief Raspberry Pi DMA Transfer Information do not write to destination. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TI_DEST_IGNORE          BIT1(7)
+/// @brief Raspberry Pi DMA Transfer Information pace destination writes with DREQ. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TI_DEST_DREQ            BIT1(6)
+/// @brief Raspberry Pi DMA Transfer Information use 128 bit destination writes. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TI_DEST_WIDTH           BIT1(5)
+/// @brief Raspberry Pi DMA Transfer Information increment destination address. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TI_DEST_INC             BIT1(4)
+/// @brief Raspberry Pi DMA Transfer Information wait for write response. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TI_WAIT_RESP            BIT1(3)
+/// @brief Raspberry Pi DMA Transfer Information 2D mode (not available on DMA Lite channels). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TI_TDMODE               BIT1(1)
+/// @brief Raspberry Pi DMA Transfer Information interrupt enable at end of this control block. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TI_INTEN                BIT1(0)
+
+/// @brief Raspberry Pi DMA Transfer Length 2D mode value, ylength + 1 rows of xlength bytes. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TXFR_LEN_2D(xlength, ylength) ((((ylength) & 0x3FFF) << 16) | ((xlength) & 0xFFFF))
+/// @brief Raspberry Pi DMA Transfer Length maximum for normal channels in bytes. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TXFR_LEN_MAX            0x3FFFFFFF
+/// @brief Raspberry Pi DMA Transfer Length maximum for DMA Lite channels in bytes. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_TXFR_LEN_MAX_LITE       0x0000FFFF
+/// @brief Raspberry Pi DMA 2D Stride value, signed byte increments added after each row. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_STRIDE_2D(srcStride, destStride) (((static_cast<uint32>(destStride) & 0xFFFF) << 16) | (static_cast<uint32>(srcStride) & 0xFFFF))
+
+/// @brief Raspberry Pi DMA channel Debug register DMA Lite channel flag (R). See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_DEBUG_LITE              BIT1(28)
+/// @brief Raspberry Pi DMA channel Debug register slave read response error, write 1 to clear. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_DEBUG_READ_ERROR        BIT1(2)
+/// @brief Raspberry Pi DMA channel Debug register FIFO error, write 1 to clear. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_DEBUG_FIFO_ERROR        BIT1(1)
+/// @brief Raspberry Pi DMA channel Debug register read last not set error, write 1 to clear. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_DEBUG_READ_LAST_NOT_SET_ERROR BIT1(0)
+/// @brief Raspberry Pi DMA channel Debug register all error bits. See @ref RASPBERRY_PI_DMA
+#define RPI_DMA_DEBUG_ERRORS            (RPI_DMA_DEBUG_READ_ERROR | RPI_DMA_DEBUG_FIFO_ERROR | RPI_DMA_DEBUG_READ_LAST_NOT_SET_ERROR)
+
+/// @brief Bus address of peripherals as seen by the DMA controller
+#define GPU_IO_BASE                     0x7E000000
+/// @brief Convert ARM peripheral address to bus address for the DMA controller
+#define ARM_IO_TO_GPU(addr)             (((addr) - RPI_BCM_IO_BASE) + GPU_IO_BASE)
+
 //---------------------------------------------
 // Raspberry Pi GPIO
 //---------------------------------------------
@@ -465,10 +593,68 @@
 #define RPI_UART0_DMACR       reinterpret_cast<regaddr>(RPI_UART0_BASE + 0x00000048)
 
 /// @brief Raspberry Pi UART0 flag register values
-/// @brief Raspberry Pi UART0 flag register Receive data ready bit. See @ref RASPBERRY_PI_PL011_UART
+/// @brief Raspberry Pi UART0 flag register bit 4. Despite the name, this is the Receive FIFO empty bit (RXFE), prefer RPI_UART0_FR_RXFE. See @ref RASPBERRY_PI_PL011_UART
 #define RPI_UART0_FR_RX_READY BIT1(4)
-/// @brief Raspberry Pi UART0 flag register Transmit data empty bit. See @ref RASPBERRY_PI_PL011_UART
+/// @brief Raspberry Pi UART0 flag register bit 5. Despite the name, this is the Transmit FIFO full bit (TXFF), prefer RPI_UART0_FR_TXFF. See @ref RASPBERRY_PI_PL011_UART
 #define RPI_UART0_FR_TX_EMPTY BIT1(5)
+/// @brief Raspberry Pi UART0 flag register UART busy transmitting bit (BUSY). See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_FR_BUSY     BIT1(3)
+/// @brief Raspberry Pi UART0 flag register Receive FIFO empty bit (RXFE). See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_FR_RXFE     BIT1(4)
+/// @brief Raspberry Pi UART0 flag register Transmit FIFO full bit (TXFF). See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_FR_TXFF     BIT1(5)
+/// @brief Raspberry Pi UART0 flag register Receive FIFO full bit (RXFF). See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_FR_RXFF     BIT1(6)
+/// @brief Raspberry Pi UART0 flag register Transmit FIFO empty bit (TXFE). See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_FR_TXFE     BIT1(7)
+
+/// @brief Raspberry Pi UART0 data register values
+/// @brief Raspberry Pi UART0 data register Framing error bit (FE). See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_DR_FE       BIT1(8)
+/// @brief Raspberry Pi UART0 data register Parity error bit (PE). See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_DR_PE       BIT1(9)
+/// @brief Raspberry Pi UART0 data register Break error bit (BE). See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_DR_BE       BIT1(10)
+/// @brief Raspberry Pi UART0 data register Overrun error bit (OE). See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_DR_OE       BIT1(11)
+
+/// @brief Raspberry Pi UART0 interrupt bits, used in IMSC, RIS, MIS and ICR registers
+/// @brief Raspberry Pi UART0 Receive interrupt bit (RXIM / RXRIS / RXMIS / RXIC). See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_INT_RX      BIT1(4)
+/// @brief Raspberry Pi UART0 Transmit interrupt bit (TXIM / TXRIS / TXMIS / TXIC). See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_INT_TX      BIT1(5)
+/// @brief Raspberry Pi UART0 Receive timeout interrupt bit (RTIM / RTRIS / RTMIS / RTIC). See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_INT_RT      BIT1(6)
+/// @brief Raspberry Pi UART0 Framing error interrupt bit (FEIM / FERIS / FEMIS / FEIC). See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_INT_FE      BIT1(7)
+/// @brief Raspberry Pi UART0 Parity error interrupt bit (PEIM / PERIS / PEMIS / PEIC). See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_INT_PE      BIT1(8)
+/// @brief Raspberry Pi UART0 Break error interrupt bit (BEIM / BERIS / BEMIS / BEIC). See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_INT_BE      BIT1(9)
+/// @brief Raspberry Pi UART0 Overrun error interrupt bit (OEIM / OERIS / OEMIS / OEIC). See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_INT_OE      BIT1(10)
+/// @brief Raspberry Pi UART0 all interrupt bits. See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_INT_ALL     0x7FF
+
+/// @brief Raspberry Pi UART0 interrupt FIFO level select register values
+/// @brief Raspberry Pi UART0 FIFO level 1/8 full. See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_IFLS_1_8    0
+/// @brief Raspberry Pi UART0 FIFO level 1/4 full. See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_IFLS_1_4    1
+/// @brief Raspberry Pi UART0 FIFO level 1/2 full. See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_IFLS_1_2    2
+/// @brief Raspberry Pi UART0 FIFO level 3/4 full. See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_IFLS_3_4    3
+/// @brief Raspberry Pi UART0 FIFO level 7/8 full. See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_IFLS_7_8    4
+/// @brief Raspberry Pi UART0 transmit interrupt FIFO level select (TXIFLSEL). See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_IFLS_TX(level) ((level) & 0x7)
+/// @brief Raspberry Pi UART0 receive interrupt FIFO level select (RXIFLSEL). See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_IFLS_RX(level) (((level) & 0x7) << 3)
+/// @brief Raspberry Pi UART0 transmit and receive FIFO size in bytes. See @ref RASPBERRY_PI_PL011_UART
+#define RPI_UART0_FIFO_SIZE   32
+/// @brief End of UART0 register region
+#define RPI_UART0_END         RPI_UART0_BASE + 0x00000100
 
 //---------------------------------------------
 // Raspberry Pi SPI Master
@@ -770,6 +956,8 @@
 #define RPI_AUX_MU_IER_TX_IRQ_ENABLE           BIT1(1)
 /// @brief Raspberry Pi Mini UART (UART1) Interrupt Enable register enable receive interrupts. See @ref RASPBERRY_PI_UART1
 #define RPI_AUX_MU_IER_RX_IRQ_ENABLE           BIT1(0)
+/// @brief Raspberry Pi Mini UART (UART1) Interrupt Enable register bits 3:2. Documented as don't care, but must be set for interrupts to be raised (datasheet errata). See @ref RASPBERRY_PI_UART1
+#define RPI_AUX_MU_IER_IRQ_REQUIRED            (BIT1(2) | BIT1(3))
 
 /// @brief Raspberry Pi Mini UART (UART1) Interrupt Identify register values
 /// @brief Raspberry Pi Mini UART (UART1) Interrupt Identify register transmit FIFO enabled (R). See @ref RASPBERRY_PI_UART1
@@ -798,7 +986,7 @@
 /// @brief Raspberry Pi Mini UART (UART1) Line Status register values
 /// @brief Raspberry Pi Mini UART (UART1) Line Status register transmit idle. See @ref RASPBERRY_PI_UART1
 #define RPI_AUX_MU_LSR_TX_IDLE                 BIT1(6)
-/// @brief Raspberry Pi Mini UART (UART1) Line Status register transmit empty. See @ref RASPBERRY_PI_UART1
+/// @brief Raspberry Pi Mini UART (UART1) Line Status register transmit empty, set if the transmit FIFO can accept at least one byte. See @ref RASPBERRY_PI_UART1
 #define RPI_AUX_MU_LSR_TX_EMPTY                BIT1(5)
 /// @brief Raspberry Pi Mini UART (UART1) Line Status register receive overrun. See @ref RASPBERRY_PI_UART1
 #define RPI_AUX_MU_LSR_RX_OVERRUN              BIT1(1)
@@ -815,7 +1003,19 @@
 /// @brief Raspberry Pi Mini UART (UART1) Extra Control register enable receive. See @ref RASPBERRY_PI_UART1
 #define RPI_AUX_MU_CNTL_ENABLE_RX              BIT1(0)
 
-/// @todo extend with register values for RPI_AUX_MU_STAT, RPI_AUX_MU_BAUD
+/// @brief Raspberry Pi Mini UART (UART1) Extra Status register values
+/// @brief Raspberry Pi Mini UART (UART1) Extra Status register transmit FIFO fill level (0..8). See @ref RASPBERRY_PI_UART1
+#define RPI_AUX_MU_STAT_TX_FIFO_LEVEL(value)   (((value) >> 24) & 0x0F)
+/// @brief Raspberry Pi Mini UART (UART1) Extra Status register receive FIFO fill level (0..8). See @ref RASPBERRY_PI_UART1
+#define RPI_AUX_MU_STAT_RX_FIFO_LEVEL(value)   (((value) >> 16) & 0x0F)
+/// @brief Raspberry Pi Mini UART (UART1) Extra Status register transmitter done (transmitter idle and transmit FIFO empty). See @ref RASPBERRY_PI_UART1
+#define RPI_AUX_MU_STAT_TX_DONE                BIT1(9)
+/// @brief Raspberry Pi Mini UART (UART1) Extra Status register transmit FIFO full. See @ref RASPBERRY_PI_UART1
+#define RPI_AUX_MU_STAT_TX_FIFO_FULL           BIT1(5)
+/// @brief Raspberry Pi Mini UART (UART1) transmit and receive FIFO size in bytes. See @ref RASPBERRY_PI_UART1
+#define RPI_AUX_MU_FIFO_SIZE                   8
+
+/// @todo extend with register values for RPI_AUX_MU_BAUD
 
 //---------------------------------------------
 // Raspberry Pi auxiliary mini SPI (SPI1/2)
@@ -0,0 +1,327 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : Clock.h
+//
+// Namespace   : baremetal
+//
+// Class       : Clock
+//
+// Description : Monotonic high resolution clock
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "baremetal/ARMInstructions.h"
+#include "stdlib/Types.h"
+
+/// @file
+/// Monotonic high resolution clock, based on the ARM generic timer counter
+
+namespace baremetal {
+
+/// @brief Number of nanoseconds in a microsecond
+#define NSEC_PER_USEC 1000ULL
+/// @brief Number of nanoseconds in a millisecond
+#define NSEC_PER_MSEC 1000000ULL
+/// @brief Number of nanoseconds in a second
+#define NSEC_PER_SEC  1000000000ULL
+
+/// @brief Target period of the timer event stream which wakes up Clock::WaitUntil(), in microseconds. The actual period is the largest power of two
+/// number of counter cycles not exceeding this
+#ifndef CLOCK_EVENT_STREAM_PERIOD_USEC
+#define CLOCK_EVENT_STREAM_PERIOD_USEC 10
+#endif
+
+/// <summary>
+/// Signed time interval, in nanoseconds
+/// </summary>
+class Duration
+{
+private:
+    /// @brief Interval in nanoseconds
+    int64 m_nanoSeconds;
+
+public:
+    /// <summary>
+    /// Construct a duration
+    /// </summary>
+    /// <param name="nanoSeconds">Interval in nanoseconds</param>
+    constexpr explicit Duration(int64 nanoSeconds = 0)
+        : m_nanoSeconds{nanoSeconds}
+    {
+    }
+    /// <summary>
+    /// Construct a duration from microseconds
+    /// </summary>
+    /// <param name="microSeconds">Interval in microseconds</param>
+    /// <returns>Duration</returns>
+    static constexpr Duration FromMicroSeconds(int64 microSeconds)
+    {
+        return Duration(microSeconds * static_cast<int64>(NSEC_PER_USEC));
+    }
+    /// <summary>
+    /// Construct a duration from milliseconds
+    /// </summary>
+    /// <param name="milliSeconds">Interval in milliseconds</param>
+    /// <returns>Duration</returns>
+    static constexpr Duration FromMilliSeconds(int64 milliSeconds)
+    {
+        return Duration(milliSeconds * static_cast<int64>(NSEC_PER_MSEC));
+    }
+    /// <summary>
+    /// Return the interval in nanoseconds
+    /// </summary>
+    /// <returns>Interval in nanoseconds</returns>
+    constexpr int64 NanoSeconds() const
+    {
+        return m_nanoSeconds;
+    }
+    /// <summary>
+    /// Return the interval in microseconds, rounded towards zero
+    /// </summary>
+    /// <returns>Interval in microseconds</returns>
+    constexpr int64 MicroSeconds() const
+    {
+        return m_nanoSeconds / static_cast<int64>(NSEC_PER_USEC);
+    }
+    /// <summary>
+    /// Return the interval in milliseconds, rounded towards zero
+    /// </summary>
+    /// <returns>Interval in milliseconds</returns>
+    constexpr int64 MilliSeconds() const
+    {
+        return m_nanoSeconds / static_cast<int64>(NSEC_PER_MSEC);
+    }
+    /// <summary>
+    /// Add two durations
+    /// </summary>
+    /// <param name="other">Duration to add</param>
+    /// <returns>Sum of the durations</returns>
+    constexpr Duration operator+(const Duration& other) const
+    {
+        return Duration(m_nanoSeconds + other.m_nanoSeconds);
+    }
+    /// <summary>
+    /// Subtract two durations
+    /// </summary>
+    /// <param name="other">Duration to subtract</param>
+    /// <returns>Difference of the durations</returns>
+    constexpr Duration operator-(const Duration& other) const
+    {
+        return Duration(m_nanoSeconds - other.m_nanoSeconds);
+    }
+    /// <summary>
+    /// Compare two durations
+    /// </summary>
+    /// <param name="other">Duration to compare to</param>
+    /// <returns>True if this duration is shorter than other</returns>
+    constexpr bool operator<(const Duration& other) const
+    {
+        return m_nanoSeconds < other.m_nanoSeconds;
+    }
+    /// <summary>
+    /// Compare two durations
+    /// </summary>
+    /// <param name="other">Duration to compare to</param>
+    /// <returns>True if this duration is longer than other</returns>
+    constexpr bool operator>(const Duration& other) const
+    {
+        return m_nanoSeconds > other.m_nanoSeconds;
+    }
+    /// <summary>
+    /// Compare two durations
+    /// </summary>
+    /// <param name="other">Duration to compare to</param>
+    /// <returns>True if the durations are equal</returns>
+    constexpr bool operator==(const Duration& other) const
+    {
+        return m_nanoSeconds == other.m_nanoSeconds;
+    }
+};
+
+/// <summary>
+/// Point in time, as a raw counter value. The counter is shared by all cores, so time points taken on different cores can be compared
+/// </summary>
+class TimePoint
+{
+private:
+    /// @brief Counter value (CNTPCT_EL0)
+    uint64 m_cycles;
+
+public:
+    /// <summary>
+    /// Construct a time point
+    /// </summary>
+    /// <param name="cycles">Counter value</param>
+    constexpr explicit TimePoint(uint64 cycles = 0)
+        : m_cycles{cycles}
+    {
+    }
+    /// <summary>
+    /// Return the counter value
+    /// </summary>
+    /// <returns>Counter value</returns>
+    constexpr uint64 Cycles() const
+    {
+        return m_cycles;
+    }
+    uint64 NanoSeconds() const;
+    Duration operator-(const TimePoint& other) const;
+};
+
+/// <summary>
+/// Monotonic clock, based on the physical counter of the ARM generic timer (CNTPCT_EL0), which runs at a fixed frequency (CNTFRQ_EL0) on all cores.
+///
+/// Conversion from counter cycles to nanoseconds and back uses a multiplication and a shift with factors computed once from the counter frequency,
+/// so no division is needed. The factors are computed on first use, or by Initialize(). Each factor is a single 64 bit word, and as it only depends
+/// on the counter frequency, any core or interrupt handler computing it concurrently stores the same value. All functions are therefore safe to call
+/// from interrupt context and from any core.
+///
+/// Counter to nanosecond conversion is exact within 1 ns for intervals up to 2^32 cycles (over a minute), and within 1 ppb beyond that.
+///
+/// Wait() and WaitUntil() put the core to sleep with WFE instead of spinning. The timer event stream (CNTKCTL_EL1), enabled on each core on its first wait,
+/// wakes the core every event period (CLOCK_EVENT_STREAM_PERIOD_USEC or less), as do interrupts. The last event period before the deadline is spun,
+/// so waits end at most a few counter cycles after the deadline, plus the time spent in interrupt handlers. Waits shorter than one event period only spin.
+/// </summary>
+class Clock
+{
+private:
+    /// @brief Nanoseconds per counter cycle, as 32.32 fixed point value (rounded up), 0 if not yet initialized
+    static uint64 s_nanoSecondsPerCycle;
+    /// @brief Counter cycles per nanosecond, as 0.64 fixed point value (rounded up, the counter frequency is below 1 GHz), 0 if not yet initialized
+    static uint64 s_cyclesPerNanoSecond;
+    /// @brief Period of the timer event stream in counter cycles, 0 if not yet enabled
+    static uint64 s_eventPeriodCycles;
+
+public:
+    static void Initialize();
+
+    /// <summary>
+    /// Read the counter. An instruction barrier makes sure the counter is not read ahead of the code being measured
+    /// </summary>
+    /// <returns>Current counter value</returns>
+    static uint64 Cycles()
+    {
+        uint64 cycles;
+        InstructionSyncBarrier();
+        GetTimerCounter(cycles);
+        return cycles;
+    }
+    /// <summary>
+    /// Return the current time
+    /// </summary>
+    /// <returns>Current time point</returns>
+    static TimePoint Now()
+    {
+        return TimePoint(Cycles());
+    }
+    /// <summary>
+    /// Return the current time in nanoseconds since the counter was started (normally at power on)
+    /// </summary>
+    /// <returns>Current time in nanoseconds</returns>
+    static uint64 NowNanoSeconds()
+    {
+        return CyclesToNanoSeconds(Cycles());
+    }
+    /// <summary>
+    /// Return the time elapsed since a time point
+    /// </summary>
+    /// <param name="since">Start time point</param>
+    /// <returns>Elapsed time</returns>
+    static Duration Elapsed(const TimePoint& since)
+    {
+        return Now() - since;
+    }
+    /// <summary>
+    /// Return the number of counter cycles elapsed since a time point
+    /// </summary>
+    /// <param name="since">Start time point</param>
+    /// <returns>Elapsed counter cycles</returns>
+    static uint64 ElapsedCycles(const TimePoint& since)
+    {
+        return Cycles() - since.Cycles();
+    }
+
+    static uint64 GetFrequency();
+
+    static void Wait(const Duration& duration);
+    static void WaitUntil(const TimePoint& deadline);
+    static Duration GetEventPeriod();
+
+    /// <summary>
+    /// Convert counter cycles to nanoseconds
+    /// </summary>
+    /// <param name="cycles">Number of counter cycles</param>
+    /// <returns>Number of nanoseconds</returns>
+    static uint64 CyclesToNanoSeconds(uint64 cycles)
+    {
+        if (s_nanoSecondsPerCycle == 0)
+            Initialize();
+        return static_cast<uint64>((static_cast<unsigned __int128>(cycles) * s_nanoSecondsPerCycle) >> 32);
+    }
+    /// <summary>
+    /// Convert nanoseconds to counter cycles
+    /// </summary>
+    /// <param name="nanoSeconds">Number of nanoseconds</param>
+    /// <returns>Number of counter cycles</returns>
+    static uint64 NanoSecondsToCycles(uint64 nanoSeconds)
+    {
+        if (s_cyclesPerNanoSecond == 0)
+            Initialize();
+        return static_cast<uint64>((static_cast<unsigned __int128>(nanoSeconds) * s_cyclesPerNanoSecond) >> 64);
+    }
+
+private:
+    static void EnableEventStream();
+};
+
+/// <summary>
+/// Return the point in time in nanoseconds since the counter was started
+/// </summary>
+/// <returns>Time in nanoseconds</returns>
+inline uint64 TimePoint::NanoSeconds() const
+{
+    return Clock::CyclesToNanoSeconds(m_cycles);
+}
+
+/// <summary>
+/// Return the interval between two time points
+/// </summary>
+/// <param name="other">Earlier time point</param>
+/// <returns>Interval, negative if other is later than this time point</returns>
+inline Duration TimePoint::operator-(const TimePoint& other) const
+{
+    if (m_cycles >= other.m_cycles)
+        return Duration(static_cast<int64>(Clock::CyclesToNanoSeconds(m_cycles - other.m_cycles)));
+    return Duration(-static_cast<int64>(Clock::CyclesToNanoSeconds(other.m_cycles - m_cycles)));
+}
+
+} // namespace baremetal
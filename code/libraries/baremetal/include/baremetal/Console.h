@@ -40,12 +40,35 @@
 #pragma once
 
 #include "baremetal/Device.h"
+#include "stdlib/Macros.h"
 #include "stdlib/Types.h"
 
 /// @file
 /// Console
 ///
 /// Used to write logging information. Supports use of ANSI color coding
+///
+/// All output is passed through a lock-free multi-producer, single-consumer queue.
+/// Each write is placed in the queue as one record, so colored strings are never mixed with other output.
+/// The writer that finds no other writer draining the queue becomes the consumer, and writes all complete records to the device.
+/// Writers that find another writer draining, e.g. an interrupt handler interrupting the main loop, only queue their record and return.
+
+/// @brief Size of the console output queue in bytes, must be a power of 2. A single write (including color codes) larger than half this size is written directly to the device
+#ifndef CONSOLE_QUEUE_SIZE
+#define CONSOLE_QUEUE_SIZE 4096
+#endif
+/// @brief Maximum number of queued records written to the device in one gather write
+#ifndef CONSOLE_GATHER_RECORDS
+#define CONSOLE_GATHER_RECORDS 16
+#endif
+/// @brief Time in milliseconds a writer waits for space in a full console output queue while the consumer makes no progress, before the write is dropped
+#ifndef CONSOLE_QUEUE_STALL_TIMEOUT
+#define CONSOLE_QUEUE_STALL_TIMEOUT 100
+#endif
+/// @brief Time in milliseconds the console retries writing to a device which accepts no data, before the remaining data is dropped
+#ifndef CONSOLE_DEVICE_STALL_TIMEOUT
+#define CONSOLE_DEVICE_STALL_TIMEOUT 100
+#endif
 
 namespace baremetal {
 
@@ -104,23 +127,49 @@ private:
     Device* m_defaultDevice;
     /// @brief Device to write to
     Device* m_device;
+    /// @brief Output queue, holding records of ConsoleQueueRecordHeader followed by the data
+    uint8 m_queue[CONSOLE_QUEUE_SIZE] ALIGN(8);
+    /// @brief Number of bytes ever reserved in the queue by writers. The next record is placed at offset m_queueWriteCount % CONSOLE_QUEUE_SIZE
+    volatile uint32 m_queueWriteCount;
+    /// @brief Number of bytes ever removed from the queue by the consumer
+    volatile uint32 m_queueReadCount;
+    /// @brief Set while a writer is draining the queue to the device. Only one writer is consumer at any time
+    volatile bool m_isDraining;
+    /// @brief Number of writes dropped because the queue was full, or (partly) dropped because the device stopped accepting data
+    volatile uint32 m_droppedWriteCount;
     /// @brief Singleton instance
     static Console* s_instance;
 
 public:
     explicit Console(Device* device);
     void AssignDevice(Device* device);
+    Device* GetDevice() const;
     void SetTerminalColor(ConsoleColor foregroundColor = ConsoleColor::Default, ConsoleColor backgroundColor = ConsoleColor::Default);
     void ResetTerminalColor();
 
     void Write(const char* str, ConsoleColor foregroundColor, ConsoleColor backgroundColor = ConsoleColor::Default);
+    bool TryWrite(const char* str, ConsoleColor foregroundColor, ConsoleColor backgroundColor = ConsoleColor::Default);
     void Write(const char* str);
+    void Write(const char* data, size_t count);
     void Flush();
 
     char ReadChar();
     void WriteChar(char c);
 
+    uint32 GetDroppedWriteCount() const;
+
 private:
+    bool Enqueue(const char* prefix, const char* data, size_t count, const char* suffix, bool wait);
+    bool Reserve(size_t size, uint32& offset, bool wait);
+    bool AcquireConsumer(bool wait);
+    bool TryAcquireConsumer();
+    void ReleaseConsumer();
+    void CountDroppedWrite();
+    void WriteRecords();
+    void WriteToDevice(IOVector* vectors, size_t vectorCount);
+    bool HaveReadyRecord() const;
+    bool TryDrain();
+    void Drain();
 };
 
 Console& GetConsole();
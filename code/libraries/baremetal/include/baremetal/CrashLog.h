@@ -0,0 +1,124 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : CrashLog.h
+//
+// Namespace   : baremetal
+//
+// Class       : CrashLog
+//
+// Description : Log copy in RAM which survives a reboot
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "stdlib/Types.h"
+
+/// @file
+/// Crash log
+///
+/// Keeps a copy of all log output in a ring buffer in a reserved RAM region (MEM_CRASH_LOG_START), which is not cleared on startup.
+/// After a reboot (e.g. after a panic, or by the watchdog), the log of the previous boot can be detected and written to the console.
+/// Writing to the crash log only disables IRQs while reserving space, so it can be done from any context.
+
+namespace baremetal {
+
+/// @brief Magic number identifying a valid crash log ("CLOG")
+#define CRASH_LOG_MAGIC 0x474F4C43
+
+/// <summary>
+/// Crash log header, placed at the start of the crash log region
+/// </summary>
+struct CrashLogHeader
+{
+    /// @brief Magic number, CRASH_LOG_MAGIC if the crash log is valid
+    uint32 magic;
+    /// @brief Size of the data area following the header in bytes
+    uint32 size;
+    /// @brief Boot sequence number, incremented every boot
+    uint32 bootSequence;
+    /// @brief Check value, inverse of magic ^ size ^ bootSequence
+    uint32 check;
+    /// @brief Number of bytes ever written to the data area. The next byte is written at writeCount % size
+    volatile uint64 writeCount;
+};
+
+/// <summary>
+/// Crash log
+///
+/// Note that this is a singleton, in that it is not possible to create a default instance (GetCrashLog() needs to be used for this)
+/// </summary>
+class CrashLog
+{
+    /// <summary>
+    /// Retrieves the singleton CrashLog instance. It is created in the first call to this function. This is a friend function of class CrashLog
+    /// </summary>
+    /// <returns>A reference to the singleton CrashLog</returns>
+    friend CrashLog& GetCrashLog();
+
+private:
+    /// @brief Crash log header, at the start of the crash log region
+    CrashLogHeader* m_header;
+    /// @brief Data area, following the header
+    uint8* m_data;
+    /// @brief Size of the data area in bytes
+    size_t m_dataSize;
+    /// @brief True if the previous boot left a valid crash log
+    bool m_hasPreviousLog;
+    /// @brief Boot sequence number of the previous boot
+    uint32 m_previousBootSequence;
+    /// @brief Number of bytes written to the data area during the previous boot
+    uint64 m_previousWriteCount;
+    /// @brief True if writes are stored in the crash log
+    bool m_isStarted;
+
+    CrashLog();
+
+public:
+    CrashLog(void* buffer, size_t size);
+
+    bool Initialize();
+    void Start();
+
+    bool HasPreviousLog() const;
+    uint32 GetPreviousBootSequence() const;
+    uint32 GetBootSequence() const;
+    size_t ReadPreviousLog(char* buffer, size_t bufferSize) const;
+    void DumpPreviousLog() const;
+
+    void Write(const char* data, size_t count);
+
+private:
+    void GetPreviousLogRange(uint64& start, size_t& length) const;
+};
+
+CrashLog& GetCrashLog();
+
+} // namespace baremetal
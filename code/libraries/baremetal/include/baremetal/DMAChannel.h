@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : DMAChannel.h
+//
+// Namespace   : baremetal
+//
+// Class       : DMAChannel
+//
+// Description : DMA channel with chained control blocks
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "baremetal/DMAController.h"
+#include "stdlib/Types.h"
+
+/// @file
+/// DMA channel with chained control blocks
+
+namespace baremetal {
+
+class DMAChannel;
+
+/// <summary>
+/// Callback when a DMA transfer has completed. Called from the interrupt handler
+/// </summary>
+/// <param name="channel">DMA channel which completed</param>
+/// <param name="success">True if the transfer completed without errors</param>
+/// <param name="param">Parameter passed to DMAChannel::SetCompletionHandler()</param>
+using DMACompletionHandler = void(DMAChannel& channel, bool success, void* param);
+
+/// <summary>
+/// DMA channel. A channel is allocated from the DMA controller on construction, and returned on destruction.
+///
+/// A transfer is built as a list of control blocks, which are chained and executed one after the other after Start().
+/// Each Add...() call adds one or more control blocks, transfers longer than a control block can handle are split automatically.
+/// Completion can be polled with IsBusy() or Wait(), or signalled through a completion handler, which is called from the DMA interrupt.
+///
+/// Memory buffers must be located below 1 Gb, as the DMA controller cannot address memory above that (see HeapType::DMA30).
+/// </summary>
+class DMAChannel
+{
+private:
+    /// @brief DMA controller the channel was allocated from
+    DMAController& m_controller;
+    /// @brief Memory access interface reference for accessing registers.
+    IMemoryAccess& m_memoryAccess;
+    /// @brief Channel number, DMA_CHANNEL_NONE if no channel could be allocated
+    uint32 m_channel;
+    /// @brief Maximum transfer length of a single control block in bytes
+    uint32 m_maxTransferLength;
+    /// @brief Control blocks of this channel, in coherent memory
+    DMAControlBlock* m_controlBlocks;
+    /// @brief Number of control blocks in use
+    size_t m_numControlBlocks;
+    /// @brief Completion handler, called from the interrupt handler
+    DMACompletionHandler* m_completionHandler;
+    /// @brief Parameter for completion handler
+    void* m_completionParam;
+    /// @brief Flags if a transfer was started and its completion was not yet handled
+    volatile bool m_isRunning;
+    /// @brief Flags if the last transfer ended with an error
+    volatile bool m_hasError;
+
+public:
+    DMAChannel(DMAChannelType type = DMAChannelType::Normal, DMAController& controller = GetDMAController());
+    ~DMAChannel();
+
+    bool IsAllocated() const;
+    uint32 GetChannel() const;
+    bool IsLite() const;
+
+    void ClearControlBlocks();
+    size_t GetNumControlBlocks() const;
+    bool AddTransfer(uint32 transferInformation, uint32 sourceAddress, uint32 destinationAddress, uint32 transferLength, uint32 stride = 0);
+    bool AddMemoryCopy(void* destination, const void* source, size_t length);
+    bool AddMemoryCopy2D(void* destination, size_t destinationPitch, const void* source, size_t sourcePitch, size_t width, size_t height);
+    bool AddMemoryFill(void* destination, const void* pattern, size_t length);
+    bool AddPeripheralWrite(regaddr peripheral, const void* source, size_t length, DMADREQ dreq);
+    bool AddPeripheralRead(void* destination, regaddr peripheral, size_t length, DMADREQ dreq);
+    void SetCompletionHandler(DMACompletionHandler* handler, void* param);
+
+    bool Start();
+    bool IsBusy();
+    bool Wait(uint32 timeoutMilliSeconds = 0);
+    void Abort();
+    bool HasError() const;
+    void InterruptHandler();
+
+    static uint32 GetBusAddress(const void* address);
+    static uint32 GetPeripheralBusAddress(regaddr address);
+
+private:
+    bool AddSplitTransfer(uint32 transferInformation, uint32 sourceAddress, uint32 destinationAddress, size_t length);
+    void RemoveControlBlocks(size_t numControlBlocks);
+    void Finish();
+};
+
+} // namespace baremetal
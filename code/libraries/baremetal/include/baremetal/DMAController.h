@@ -0,0 +1,172 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : DMAController.h
+//
+// Namespace   : baremetal
+//
+// Class       : DMAController
+//
+// Description : DMA controller channel allocation and interrupt dispatch
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "baremetal/IMemoryAccess.h"
+#include "baremetal/MemoryAccess.h"
+#include "stdlib/Macros.h"
+#include "stdlib/Types.h"
+
+/// @file
+/// DMA controller channel allocation and interrupt dispatch
+
+/// @brief Number of control blocks available to each DMA channel. All control blocks together must fit in a coherent memory page
+#ifndef DMA_CONTROL_BLOCKS_PER_CHANNEL
+#define DMA_CONTROL_BLOCKS_PER_CHANNEL 64
+#endif
+
+/// @brief Number of DMA channels handled (channel 0-14, channel 15 is not used)
+#define DMA_CHANNELS 15
+/// @brief Returned by DMAController::AllocateChannel() if no channel is available
+#define DMA_CHANNEL_NONE 0xFFFFFFFF
+
+namespace baremetal {
+
+class DMAChannel;
+
+/// <summary>
+/// DMA control block, as read by the DMA controller. Must be 32 byte aligned, and located in memory that is coherent for the DMA controller.
+/// All addresses are bus addresses
+/// </summary>
+struct DMAControlBlock
+{
+    /// @brief Transfer information (RPI_DMA_TI_* bits)
+    uint32 transferInformation;
+    /// @brief Source bus address
+    uint32 sourceAddress;
+    /// @brief Destination bus address
+    uint32 destinationAddress;
+    /// @brief Transfer length in bytes, or RPI_DMA_TXFR_LEN_2D value in 2D mode
+    uint32 transferLength;
+    /// @brief 2D mode stride (RPI_DMA_STRIDE_2D value)
+    uint32 stride;
+    /// @brief Bus address of the next control block, 0 for the last control block
+    uint32 nextControlBlockAddress;
+    /// @brief Reserved, set to 0
+    uint32 reserved[2];
+} PACKED;
+
+/// <summary>
+/// Kind of DMA channel requested
+/// </summary>
+enum class DMAChannelType
+{
+    /// @brief Full DMA channel, supports 2D mode and transfers up to 1 Gb per control block
+    Normal,
+    /// @brief DMA Lite channel, half the bandwidth, no 2D mode, transfers up to 64 Kb per control block
+    Lite,
+    /// @brief Any channel, a DMA Lite channel is used if no full channel is available
+    Any,
+};
+
+/// <summary>
+/// Peripheral DMA request (DREQ) lines, used to pace transfers to or from a peripheral
+/// </summary>
+enum class DMADREQ : uint32
+{
+    /// @brief No pacing, always request data
+    None = 0,
+    /// @brief PCM transmit
+    PCMTX = 2,
+    /// @brief PCM receive
+    PCMRX = 3,
+    /// @brief PWM
+    PWM = 5,
+    /// @brief SPI0 transmit
+    SPITX = 6,
+    /// @brief SPI0 receive
+    SPIRX = 7,
+    /// @brief UART0 transmit
+    UARTTX = 12,
+    /// @brief UART0 receive
+    UARTRX = 14,
+};
+
+/// <summary>
+/// DMA controller. Hands out DMA channels, holds the control blocks for each channel in coherent memory,
+/// and dispatches DMA interrupts to the channels.
+///
+/// This is a pseudo singleton, in that it is not possible to create a default instance (GetDMAController() needs to be used for this),
+/// but it is possible to create an instance with a custom IMemoryAccess instance for testing.
+///
+/// The channels that can be used are requested from the firmware on first allocation, the other channels are in use by the GPU.
+/// </summary>
+class DMAController
+{
+    /// <summary>
+    /// Construct the singleton DMAController instance if needed, and return a reference to the instance. This is a friend function of class DMAController
+    /// </summary>
+    /// <returns>Reference to the singleton DMAController instance</returns>
+    friend DMAController& GetDMAController();
+    friend class DMAChannel;
+
+private:
+    /// @brief Flags if the usable channels were requested from the firmware
+    bool m_isInitialized;
+    /// @brief Memory access interface reference for accessing registers.
+    IMemoryAccess& m_memoryAccess;
+    /// @brief Bit mask of channels which can be used by the ARM
+    uint32 m_channelMask;
+    /// @brief Bit mask of channels currently allocated
+    uint32 m_allocatedMask;
+    /// @brief Channels which have their completion interrupt connected, indexed by channel number
+    DMAChannel* m_interruptChannels[DMA_CHANNELS];
+
+    DMAController();
+
+public:
+    DMAController(IMemoryAccess& memoryAccess);
+
+    void Initialize();
+    uint32 AllocateChannel(DMAChannelType type);
+    void FreeChannel(uint32 channel);
+    bool IsLiteChannel(uint32 channel) const;
+    DMAControlBlock* GetControlBlocks(uint32 channel) const;
+    void InterruptHandler();
+
+private:
+    void ConnectInterrupt(uint32 channel, DMAChannel* dmaChannel);
+    void DisconnectInterrupt(uint32 channel);
+    static void IRQHandler(void* param);
+};
+
+DMAController& GetDMAController();
+
+} // namespace baremetal
@@ -0,0 +1,154 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : DeferredWork.h
+//
+// Namespace   : baremetal
+//
+// Class       : DeferredWorkQueue
+//
+// Description : Deferred work queue, to move work out of interrupt handlers
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "baremetal/Histogram.h"
+#include "stdlib/Types.h"
+
+/// @file
+/// Deferred work (bottom half) queue, to move work out of interrupt handlers
+
+/// @brief Number of work items the deferred work queue can hold. Must be a power of 2
+#ifndef DEFERRED_WORK_QUEUE_SIZE
+#define DEFERRED_WORK_QUEUE_SIZE 64
+#endif
+
+/// @brief If 1, pending deferred work is run at the end of the outermost IRQ exception, with IRQs enabled
+#ifndef DEFERRED_WORK_RUN_AT_IRQ_EXIT
+#define DEFERRED_WORK_RUN_AT_IRQ_EXIT 1
+#endif
+
+namespace baremetal {
+
+/// @brief Deferred work handler
+using DeferredWorkHandler = void(void* param, uintptr value);
+
+/// <summary>
+/// Deferred work queue statistics
+/// </summary>
+struct DeferredWorkStatistics
+{
+    /// @brief Number of work items queued
+    uint64 queued;
+    /// @brief Number of work items run
+    uint64 executed;
+    /// @brief Number of work items dropped because the queue was full
+    uint64 dropped;
+    /// @brief Number of queued items (including the one being run) at the time each item is taken from the queue
+    Histogram depth;
+    /// @brief Time between queueing and the start of the work handler, in nanoseconds
+    Histogram latency;
+};
+
+/// <summary>
+/// Queue of work deferred from interrupt handlers.
+///
+/// An interrupt handler calls Enqueue() to queue a handler with a parameter and a value, and returns. Enqueue() does not allocate and only disables
+/// IRQs while claiming a slot, the queue is a bounded ring of slots with a sequence number each, so it can be used from handlers at any priority, also
+/// when they preempt each other. If the queue is full, the work item is dropped and Enqueue() returns false.
+///
+/// Queued work is run by Run(), one item at a time, in the order it was queued. With DEFERRED_WORK_RUN_AT_IRQ_EXIT set, the interrupt system calls
+/// Run() at the end of the outermost IRQ exception, after all pending IRQs have been acknowledged, with IRQs enabled. An application main loop can
+/// also call Run() (e.g. before going to sleep with WFI). Only one Run() pass is active at a time: a Run() call while another pass is active (e.g.
+/// an IRQ exit while the main loop is running work) returns immediately, and the active pass runs the new items.
+///
+/// Note that this class is created as a singleton, using the GetDeferredWorkQueue() function.
+/// </summary>
+class DeferredWorkQueue
+{
+    /// <summary>
+    /// Retrieves the singleton DeferredWorkQueue instance. It is created in the first call to this function. This is a friend function of class DeferredWorkQueue
+    /// </summary>
+    /// <returns>A reference to the singleton DeferredWorkQueue</returns>
+    friend DeferredWorkQueue& GetDeferredWorkQueue();
+
+private:
+    /// <summary>
+    /// Work item slot
+    /// </summary>
+    struct WorkItem
+    {
+        /// @brief Slot sequence number. Equal to the queue position if the slot is free, position + 1 if it holds a work item
+        uint32 sequence;
+        /// @brief Work handler
+        DeferredWorkHandler* handler;
+        /// @brief Work handler parameter
+        void* param;
+        /// @brief Work handler value
+        uintptr value;
+        /// @brief Clock cycle counter at the time the item was queued
+        uint64 queuedCycles;
+    };
+
+    /// @brief Work item slots
+    WorkItem m_items[DEFERRED_WORK_QUEUE_SIZE];
+    /// @brief Number of slots claimed by Enqueue()
+    uint32 m_enqueueCount;
+    /// @brief Number of items taken from the queue by Run()
+    uint32 m_dequeueCount;
+    /// @brief True while a Run() pass is active
+    bool m_isRunning;
+    /// @brief Number of work items dropped because the queue was full
+    uint32 m_droppedCount;
+    /// @brief Statistics, other than the queued and dropped counts. Only updated by Run()
+    DeferredWorkStatistics m_statistics;
+    /// @brief Value of m_enqueueCount at the last ResetStatistics()
+    uint32 m_enqueueCountAtReset;
+    /// @brief Value of m_droppedCount at the last ResetStatistics()
+    uint32 m_droppedCountAtReset;
+
+public:
+    DeferredWorkQueue();
+
+    bool Enqueue(DeferredWorkHandler* handler, void* param, uintptr value = 0);
+    unsigned Run();
+    bool IsEmpty() const;
+
+    void GetStatistics(DeferredWorkStatistics& statistics) const;
+    void ResetStatistics();
+    void DumpStatistics() const;
+
+private:
+    WorkItem* GetReadyItem();
+};
+
+DeferredWorkQueue& GetDeferredWorkQueue();
+
+} // namespace baremetal
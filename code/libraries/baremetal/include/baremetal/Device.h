@@ -46,6 +46,17 @@
 
 namespace baremetal {
 
+/// <summary>
+/// Element of a gather list, used to write multiple buffers in a single call to Device::WriteV()
+/// </summary>
+struct IOVector
+{
+    /// @brief Buffer to write
+    const void* buffer;
+    /// @brief Number of bytes in buffer
+    size_t count;
+};
+
 /// <summary>
 /// Generic device interface
 /// </summary>
@@ -61,6 +72,7 @@ public:
     virtual bool IsBlockDevice() = 0;
     virtual ssize_t Read(void* buffer, size_t count);
     virtual ssize_t Write(const void* buffer, size_t count);
+    virtual ssize_t WriteV(const IOVector* vectors, size_t vectorCount);
     virtual void Flush();
 
     virtual ssize_t Seek(size_t offset);
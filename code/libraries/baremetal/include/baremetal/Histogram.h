@@ -0,0 +1,124 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : Histogram.h
+//
+// Namespace   : baremetal
+//
+// Class       : Histogram
+//
+// Description : Log-linear histogram for timing statistics
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "stdlib/Types.h"
+
+/// @file
+/// Log-linear histogram for timing statistics
+
+/// @brief Number of bits below the most significant bit used to select a sub bucket. Each power of two range is split in 2^HISTOGRAM_SUB_BUCKET_BITS buckets,
+/// so the relative error of a percentile is at most 1 / 2^HISTOGRAM_SUB_BUCKET_BITS
+#define HISTOGRAM_SUB_BUCKET_BITS 2
+/// @brief Number of sub buckets per power of two
+#define HISTOGRAM_SUB_BUCKETS     (1 << HISTOGRAM_SUB_BUCKET_BITS)
+/// @brief Highest power of two (exclusive) with its own buckets, larger values are counted in the last bucket. 2^40 ns is over 18 minutes
+#define HISTOGRAM_MAX_BITS        40
+/// @brief Total number of buckets
+#define HISTOGRAM_BUCKETS         ((HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+namespace baremetal {
+
+/// <summary>
+/// Histogram of 64 bit values (e.g. durations in nanoseconds or cycles), with buckets of exponentially increasing width.
+///
+/// Values below HISTOGRAM_SUB_BUCKETS are counted exactly, larger values in one of HISTOGRAM_SUB_BUCKETS buckets per power of two.
+/// Adding a value takes constant time and no memory allocation, so it can be done from interrupt context. The histogram does not lock:
+/// reading statistics while values are added (e.g. from an interrupt handler) can give a slightly inconsistent snapshot.
+/// </summary>
+class Histogram
+{
+private:
+    /// @brief Number of values added
+    uint64 m_count;
+    /// @brief Sum of values added
+    uint64 m_sum;
+    /// @brief Smallest value added
+    uint64 m_min;
+    /// @brief Largest value added
+    uint64 m_max;
+    /// @brief Number of values per bucket
+    uint32 m_buckets[HISTOGRAM_BUCKETS];
+
+public:
+    Histogram();
+
+    void Reset();
+    void Add(uint64 value);
+
+    /// <summary>
+    /// Return the number of values added
+    /// </summary>
+    /// <returns>Number of values added</returns>
+    uint64 GetCount() const
+    {
+        return m_count;
+    }
+    /// <summary>
+    /// Return the smallest value added
+    /// </summary>
+    /// <returns>Smallest value, 0 if no values were added</returns>
+    uint64 GetMin() const
+    {
+        return (m_count == 0) ? 0 : m_min;
+    }
+    /// <summary>
+    /// Return the largest value added
+    /// </summary>
+    /// <returns>Largest value, 0 if no values were added</returns>
+    uint64 GetMax() const
+    {
+        return m_max;
+    }
+    /// <summary>
+    /// Return the average of the values added
+    /// </summary>
+    /// <returns>Average value, 0 if no values were added</returns>
+    uint64 GetMean() const
+    {
+        return (m_count == 0) ? 0 : m_sum / m_count;
+    }
+    uint64 GetPercentile(unsigned percent) const;
+
+    static unsigned GetBucketIndex(uint64 value);
+    static uint64 GetBucketUpperBound(unsigned index);
+};
+
+} // namespace baremetal
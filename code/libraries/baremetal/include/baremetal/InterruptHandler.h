@@ -40,6 +40,9 @@
 #pragma once
 
 #include "baremetal/Interrupts.h"
+#if BAREMETAL_IRQ_STATS
+#include "baremetal/Histogram.h"
+#endif
 #include "stdlib/Macros.h"
 #include "stdlib/Types.h"
 
@@ -51,6 +54,10 @@ extern "C" {
 #endif
 
 void InterruptHandler();
+#if BAREMETAL_RPI_TARGET == 3
+#else
+void UnhandledFIQ(uint32 iarValue);
+#endif
 
 #ifdef __cplusplus
 }
@@ -60,6 +67,10 @@ namespace baremetal {
 
 /// <summary>
 /// FIQ handler function
+///
+/// Called directly by FIQStub (see ExceptionStub.S), with IRQ and FIQ masked, so it interrupts IRQ handlers and code which only disables IRQs.
+/// It must not enable interrupts, must not block, and must only share data with other code through lock-free means
+/// (e.g. DeferredWorkQueue::Enqueue()). On Raspberry Pi 3 it must clear the interrupt source, on the GIC the stub acknowledges the interrupt.
 /// </summary>
 using FIQHandler = void(void* param);
 
@@ -83,6 +94,37 @@ struct FIQData
     uint32 fiqID;
 } PACKED;
 
+#if BAREMETAL_IRQ_STATS
+/// @brief Maximum number of IRQs for which statistics are kept. Statistics are assigned to IRQs in the order in which they first occur
+#ifndef IRQ_STATISTICS_MAX
+#define IRQ_STATISTICS_MAX 16
+#endif
+
+/// <summary>
+/// Interrupt timing statistics for an IRQ. Times are in counter cycles (see Clock)
+/// </summary>
+struct IRQStatistics
+{
+    /// @brief ID of IRQ
+    IRQ_ID irqID;
+    /// @brief Number of times the IRQ handler was called
+    uint64 count;
+    /// @brief Time from exception entry (IRQStub) to the start of the IRQ handler. For an IRQ handled after other IRQs in the same exception,
+    /// the time from the end of the previous IRQ, so excluding the time spent waiting for earlier handlers
+    Histogram dispatchLatency;
+    /// @brief Duration of the IRQ handler
+    Histogram duration;
+};
+#endif
+
+/// @brief Highest IRQ priority (lowest value) that can be set. The GIC implements priority bits 7..4, so there are 16 levels in steps of 0x10.
+/// Priorities below 0x50 are kept free for FIQ (RPI_GICD_IPRIORITYR_FIQ)
+#define IRQ_PRIORITY_HIGHEST 0x50
+/// @brief Default IRQ priority, same as RPI_GICD_IPRIORITYR_DEFAULT
+#define IRQ_PRIORITY_DEFAULT 0xA0
+/// @brief Lowest IRQ priority (highest value) that can be set, must be below the priority mask RPI_GICC_PMR_PRIORITY
+#define IRQ_PRIORITY_LOWEST  0xE0
+
 class IMemoryAccess;
 
 /// <summary>
@@ -99,6 +141,26 @@ class InterruptSystem
     IRQHandler* m_irqHandlers[IRQ_LINES];
     /// @brief Parameter to pass to registered IRQ handler
     void* m_irqHandlersParam[IRQ_LINES];
+    /// @brief True if the registered IRQ handler can be preempted by higher priority IRQs (GIC only)
+    bool m_irqPreemptible[IRQ_LINES];
+    /// @brief Number of IRQ exceptions taken
+    volatile uint64 m_interruptEntryCount;
+    /// @brief Number of IRQs handled
+    volatile uint64 m_handledIRQCount;
+    /// @brief Number of nested InterruptHandler() calls active, deferred work is only run by the outermost one
+    volatile unsigned m_nestingLevel;
+#if BAREMETAL_IRQ_STATS
+    /// @brief Statistics per IRQ, in order of first occurrence
+    IRQStatistics m_irqStatistics[IRQ_STATISTICS_MAX];
+    /// @brief Index in m_irqStatistics plus 1 for each IRQ, 0 if the IRQ has no statistics yet
+    uint8 m_irqStatisticsIndex[IRQ_LINES];
+    /// @brief Number of entries in use in m_irqStatistics
+    unsigned m_numIRQStatistics;
+    /// @brief Number of IRQs not recorded because all entries in m_irqStatistics are in use
+    uint64 m_unrecordedIRQs;
+    /// @brief Time from the physical timer compare value (CNTP_CVAL_EL0) to exception entry, for the timer IRQ
+    Histogram m_timerEntryLatency;
+#endif
 
     /// <summary>
     /// Construct the singleton InterruptSystem instance if needed, and return a reference to the instance. This is a friend function of class InterruptSystem
@@ -120,16 +182,36 @@ public:
     void DisableInterrupts();
     void EnableInterrupts();
 
-    void RegisterIRQHandler(IRQ_ID irqID, IRQHandler* handler, void* param);
+    void RegisterIRQHandler(IRQ_ID irqID, IRQHandler* handler, void* param, uint8 priority = IRQ_PRIORITY_DEFAULT, bool preemptible = false);
     void UnregisterIRQHandler(IRQ_ID irqID);
+    void SetIRQPriority(IRQ_ID irqID, uint8 priority);
+    void SetPriorityMask(uint8 mask);
+    void SetPriorityGrouping(uint8 binaryPoint);
 
     void RegisterFIQHandler(FIQ_ID fiqID, FIQHandler* handler, void* param);
     void UnregisterFIQHandler(FIQ_ID fiqID);
 
     void InterruptHandler();
+#if BAREMETAL_RPI_TARGET == 3
+#else
+    void HandleUnhandledFIQ(uint32 iarValue);
+#endif
+
+    uint64 GetInterruptEntryCount() const;
+    uint64 GetHandledIRQCount() const;
+
+#if BAREMETAL_IRQ_STATS
+    bool GetIRQStatistics(IRQ_ID irqID, IRQStatistics& statistics) const;
+    void GetTimerEntryLatency(Histogram& latency) const;
+    void ResetIRQStatistics();
+    void DumpIRQStatistics() const;
+#endif
 
 private:
-    bool CallIRQHandler(IRQ_ID irqID);
+    bool CallIRQHandler(IRQ_ID irqID, uint64 entryCounter, uint64 dispatchCounter);
+#if BAREMETAL_IRQ_STATS
+    void RecordIRQ(IRQ_ID irqID, uint64 dispatch, uint64 start, uint64 end);
+#endif
 };
 
 InterruptSystem& GetInterruptSystem();
@@ -138,3 +220,7 @@ InterruptSystem& GetInterruptSystem();
 
 /// @brief FIQ administration, see Exception.S
 extern baremetal::FIQData s_fiqData;
+#if BAREMETAL_IRQ_STATS
+/// @brief Counter value at the last IRQ exception entry, see ExceptionStub.S
+extern volatile uint64 s_irqEntryCounter;
+#endif
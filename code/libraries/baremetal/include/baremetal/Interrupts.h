@@ -40,6 +40,7 @@
 #pragma once
 
 #include "baremetal/BCMRegisters.h"
+#include "baremetal/MemoryAccess.h"
 
 namespace baremetal {
 
@@ -924,10 +925,10 @@ enum class FIQ_ID
 
 #endif
 
-void EnableIRQ(IRQ_ID irqID);
-void DisableIRQ(IRQ_ID irqID);
+void EnableIRQ(IRQ_ID irqID, IMemoryAccess& memoryAccess = GetMemoryAccess());
+void DisableIRQ(IRQ_ID irqID, IMemoryAccess& memoryAccess = GetMemoryAccess());
 
-void EnableFIQ(FIQ_ID fiqID);
-void DisableFIQ(FIQ_ID fiqID);
+void EnableFIQ(FIQ_ID fiqID, IMemoryAccess& memoryAccess = GetMemoryAccess());
+void DisableFIQ(FIQ_ID fiqID, IMemoryAccess& memoryAccess = GetMemoryAccess());
 
 } // namespace baremetal
@@ -42,6 +42,7 @@
 #include "baremetal/Console.h"
 #include "stdlib/StdArg.h"
 #include "stdlib/Types.h"
+#include "stdlib/Util.h"
 
 /// @file
 /// Logger functionality
@@ -67,8 +68,156 @@ enum class LogSeverity
     Data,
 };
 
+/// <summary>
+/// Format of the timestamp at the start of each log line
+/// </summary>
+enum class LogTimestampMode
+{
+    /// @brief No timestamp
+    None,
+    /// @brief Time since boot in seconds with microsecond resolution, taken from the ARM system counter
+    Uptime,
+    /// @brief Calendar date and time from the system timer, with millisecond resolution
+    Calendar,
+};
+
+/// <summary>
+/// Policy for asynchronous logging when the log line queue is full
+/// </summary>
+enum class LogOverflowPolicy
+{
+    /// @brief Discard the oldest queued line to make room for the new line
+    DropOldest,
+    /// @brief Discard the new line
+    DropNewest,
+    /// @brief Write queued lines to the console from the logging context until there is room for the new line
+    Block,
+};
+
+/// @brief Number of lines in the asynchronous log line queue
+#ifndef LOGGER_QUEUE_SIZE
+#define LOGGER_QUEUE_SIZE      32
+#endif
+/// @brief Maximum length of a line in the asynchronous log line queue, including the terminating null character. Longer lines are truncated
+#ifndef LOGGER_QUEUE_LINE_SIZE
+#define LOGGER_QUEUE_LINE_SIZE 256
+#endif
+/// @brief Maximum number of queued lines written to the console from the timer tick, see Logger::PeriodicHandler()
+#ifndef LOGGER_DRAIN_PER_TICK
+#define LOGGER_DRAIN_PER_TICK  8
+#endif
+
+/// <summary>
+/// Entry in the asynchronous log line queue
+/// </summary>
+struct LogQueueEntry
+{
+    /// @brief Set by the producer when the line is complete, cleared by the consumer when the line has been written
+    volatile bool isReady;
+    /// @brief Severity, used for selecting the color
+    LogSeverity severity;
+    /// @brief Formatted line, including the newline
+    char line[LOGGER_QUEUE_LINE_SIZE];
+};
+
+/// @brief Maximum number of modules with their own log level
+#ifndef LOGGER_MAX_MODULE_LEVELS
+#define LOGGER_MAX_MODULE_LEVELS     16
+#endif
+/// @brief Maximum length of a module name with its own log level, including the terminating null character
+#ifndef LOGGER_MODULE_NAME_SIZE
+#define LOGGER_MODULE_NAME_SIZE      32
+#endif
+/// @brief Default number of messages a single log statement can output in a burst before being rate limited. 0 disables rate limiting
+#ifndef LOGGER_RATE_LIMIT_BURST
+#define LOGGER_RATE_LIMIT_BURST      0
+#endif
+/// @brief Default number of messages per second a single log statement can output when rate limited
+#ifndef LOGGER_RATE_LIMIT_PER_SECOND
+#define LOGGER_RATE_LIMIT_PER_SECOND 10
+#endif
+
+/// <summary>
+/// Log level for a single module, overriding the global log level
+/// </summary>
+struct LogModuleLevel
+{
+    /// @brief Module name, as used in LOG_MODULE(), or source file name without extension for TRACE_* statements
+    char name[LOGGER_MODULE_NAME_SIZE];
+    /// @brief Log level for the module
+    LogSeverity level;
+};
+
+/// <summary>
+/// Rate limiting state for a single log statement (token bucket). Every LOG_* and TRACE_* statement has its own zero initialized instance
+/// </summary>
+struct LogCallSite
+{
+    /// @brief Timer counter value when tokens were last added
+    uint64 lastRefillTime;
+    /// @brief Number of messages that can still be output without waiting
+    uint32 tokens;
+    /// @brief Number of messages suppressed since the last message output
+    uint32 suppressedCount;
+};
+
 class Timer;
 
+#if BAREMETAL_BINARY_LOG
+
+/// @brief Size of the ring buffer holding encoded binary log records before they are written to the console
+#define LOGGER_BINARY_BUFFER_SIZE   4096
+/// @brief Maximum number of argument words stored in a binary log record. Any further arguments are dropped
+#define LOGGER_BINARY_MAX_ARGUMENTS 16
+
+/// <summary>
+/// Convert a log argument to a raw 64 bit argument word for a binary log record (integers and enumerations)
+/// </summary>
+/// <typeparam name="T">Type of argument</typeparam>
+/// <param name="value">Argument value</param>
+/// <returns>Argument word</returns>
+template <typename T>
+inline uint64 LogArgumentWord(T value)
+{
+    return static_cast<uint64>(value);
+}
+
+/// <summary>
+/// Convert a log argument to a raw 64 bit argument word for a binary log record (pointers, including strings)
+/// </summary>
+/// <typeparam name="T">Type pointed to</typeparam>
+/// <param name="value">Argument value</param>
+/// <returns>Argument word</returns>
+template <typename T>
+inline uint64 LogArgumentWord(T* value)
+{
+    return reinterpret_cast<uintptr>(value);
+}
+
+/// <summary>
+/// Convert a log argument to a raw 64 bit argument word for a binary log record (floating point, stored as IEEE 754 bit pattern)
+/// </summary>
+/// <param name="value">Argument value</param>
+/// <returns>Argument word</returns>
+inline uint64 LogArgumentWord(double value)
+{
+    uint64 result;
+    memcpy(&result, &value, sizeof(result));
+    return result;
+}
+
+/// <summary>
+/// Convert a log argument to a raw 64 bit argument word for a binary log record (floating point, stored as IEEE 754 bit pattern)
+/// </summary>
+/// <param name="value">Argument value</param>
+/// <returns>Argument word</returns>
+inline uint64 LogArgumentWord(float value)
+{
+    return LogArgumentWord(static_cast<double>(value));
+}
+
+#endif
+
 /// <summary>
 /// Logger class
 /// </summary>
@@ -87,6 +236,64 @@ private:
     Timer* m_timer;
     /// @brief Currently set logging severity level
     LogSeverity m_level;
+    /// @brief Format of the timestamp at the start of each log line
+    LogTimestampMode m_timestampMode;
+    /// @brief ARM system counter frequency in Hz, for converting timestamps
+    uint64 m_counterFrequency;
+    /// @brief Highest of the global log level and all module log levels, used for the inline check in IsEnabled()
+    LogSeverity m_maxLevel;
+    /// @brief Log levels for modules, overriding the global log level
+    LogModuleLevel m_moduleLevels[LOGGER_MAX_MODULE_LEVELS];
+    /// @brief Number of valid entries in m_moduleLevels
+    size_t m_moduleLevelCount;
+    /// @brief Number of messages a single log statement can output in a burst. 0 means no rate limiting
+    uint32 m_rateLimitBurst;
+    /// @brief Number of messages per second a single log statement can output when rate limited
+    uint32 m_rateLimitPerSecond;
+    /// @brief Number of messages suppressed by rate limiting, to be reported with the next message output
+    uint32 m_rateLimitedCount;
+    /// @brief Source of the log statement whose messages were last suppressed by rate limiting
+    const char* m_rateLimitedSource;
+    /// @brief Source line of the log statement whose messages were last suppressed by rate limiting
+    int m_rateLimitedLine;
+    /// @brief Source of the last message output, to detect repeated messages
+    const char* m_lastSource;
+    /// @brief Source line of the last message output, to detect repeated messages
+    int m_lastLine;
+    /// @brief Severity of the last message output
+    LogSeverity m_lastSeverity;
+    /// @brief Hash of the text of the last message output, to detect repeated messages
+    uint32 m_lastMessageHash;
+    /// @brief Number of times the last message was repeated and suppressed
+    uint32 m_repeatCount;
+    /// @brief True if lines are queued and written to the console later, false if lines are written immediately
+    bool m_isAsynchronous;
+    /// @brief Policy for asynchronous logging when the queue is full
+    LogOverflowPolicy m_overflowPolicy;
+    /// @brief Asynchronous log line queue
+    LogQueueEntry m_queue[LOGGER_QUEUE_SIZE];
+    /// @brief Number of lines ever reserved in the queue by producers. The next line is placed at index m_queueWriteCount % LOGGER_QUEUE_SIZE
+    volatile uint32 m_queueWriteCount;
+    /// @brief Number of lines ever removed from the queue. The next line to be written is at index m_queueReadCount % LOGGER_QUEUE_SIZE
+    volatile uint32 m_queueReadCount;
+    /// @brief Number of lines dropped due to a full queue
+    volatile uint32 m_droppedLineCount;
+    /// @brief Number of dropped lines already reported on the console
+    uint32 m_reportedDroppedLineCount;
+    /// @brief True while the queue is being written to the console, to prevent reentrant writes
+    volatile bool m_isDraining;
+#if BAREMETAL_BINARY_LOG
+    /// @brief Ring buffer with encoded binary log records, waiting to be written to the console
+    uint8 m_binaryBuffer[LOGGER_BINARY_BUFFER_SIZE];
+    /// @brief Write index into m_binaryBuffer. Only moved after a complete frame was copied, with interrupts disabled
+    volatile size_t m_binaryBufferHead;
+    /// @brief Read index into m_binaryBuffer. Only moved by the context writing the ring buffer to the console
+    volatile size_t m_binaryBufferTail;
+    /// @brief Number of binary log records dropped because the ring buffer was full
+    uint32 m_binaryRecordsDropped;
+    /// @brief True while the ring buffer is being written to the console, to prevent reentrant writes
+    volatile bool m_binaryBufferDraining;
+#endif
     /// @brief Singleton console instance
     static Console s_console;
     /// @brief Singleton logger instance
@@ -96,10 +303,42 @@ private:
 
 public:
     static bool HaveLogger();
+    /// <summary>
+    /// Check whether the logger exists and the specified severity is enabled. Inline, so it can be checked before evaluating any log statement arguments
+    /// </summary>
+    /// <param name="severity">Severity to check</param>
+    /// <returns>True if a log statement with the specified severity will be output, false otherwise</returns>
+    static bool IsEnabled(LogSeverity severity)
+    {
+        return (s_logger != nullptr) && s_logger->m_isInitialized && (static_cast<int>(severity) <= static_cast<int>(s_logger->m_maxLevel));
+    }
+    /// <summary>
+    /// Check whether a log statement may output a message, according to its rate limit. Must only be called after IsEnabled() returned true
+    /// </summary>
+    /// <param name="callSite">Rate limiting state of the log statement</param>
+    /// <param name="source">Source name or file name of the log statement</param>
+    /// <param name="line">Source line number of the log statement</param>
+    /// <returns>True if the message may be output, false if it is suppressed</returns>
+    static bool CheckRateLimit(LogCallSite& callSite, const char* source, int line)
+    {
+        return (s_logger->m_rateLimitBurst == 0) || s_logger->ConsumeRateLimitToken(callSite, source, line);
+    }
 
     bool Initialize();
     LogSeverity SetLogLevel(LogSeverity logLevel);
     bool IsLogSeverityEnabled(LogSeverity severity);
+    bool IsLogSeverityEnabled(const char* source, LogSeverity severity);
+    bool SetModuleLogLevel(const char* module, LogSeverity logLevel);
+    void ResetModuleLogLevel(const char* module);
+    LogSeverity GetModuleLogLevel(const char* module);
+    void SetRateLimit(uint32 burst, uint32 perSecond);
+    void SetTimestampMode(LogTimestampMode mode);
+
+    void SetAsynchronous(bool enable, LogOverflowPolicy policy = LogOverflowPolicy::DropNewest);
+    bool IsAsynchronous() const;
+    size_t ProcessQueue(size_t maxLines = LOGGER_QUEUE_SIZE);
+    void Flush();
+    uint32 GetDroppedLineCount() const;
 
     void Log(const char* from, int line, LogSeverity severity, const char* message, ...);
     void LogV(const char* from, int line, LogSeverity severity, const char* message, va_list args);
@@ -117,63 +356,268 @@ public:
     static void LogEntryNoAlloc(const char* from, int line, LogSeverity severity, const char* message, ...);
     static void TraceEntry(const char* filename, int line, const char* function, LogSeverity severity, const char* message, ...);
     static void TraceEntryNoAlloc(const char* filename, int line, const char* function, LogSeverity severity, const char* message, ...);
+
+private:
+    void UpdateMaxLevel();
+    void FormatTimestamp(char* buffer, size_t bufferSize, uint64 timestamp);
+    bool ConsumeRateLimitToken(LogCallSite& callSite, const char* source, int line);
+    bool IsRepeatedMessage(const char* source, int line, LogSeverity severity, const char* message);
+    void ReportRepeatedMessage();
+    void WriteRepeatedMessage(uint32 repeatCount, const char* source, int line, LogSeverity severity);
+    void WriteLine(LogSeverity severity, const char* line);
+    bool WriteLineToConsole(LogSeverity severity, const char* line, bool wait);
+    bool EnqueueLine(LogSeverity severity, const char* line);
+    static void PeriodicHandler();
+
+public:
+#if BAREMETAL_BINARY_LOG
+    void LogBinary(const char* source, int line, const char* function, LogSeverity severity, const char* message, size_t numArgs, const uint64* args);
+    void FlushBinary();
+    uint32 GetBinaryRecordsDropped() const;
+
+    static bool IsInternedString(const char* str);
+
+    /// <summary>
+    /// Write a binary log record to the logger. Static entry point for the LOG_* and TRACE_* macros in binary logging mode.
+    ///
+    /// The arguments are stored as raw 64 bit words, the message string is stored as an offset into the read only data section.
+    /// If the message string is not in the read only data section (e.g. a formatted String), the message is logged as text.
+    /// </summary>
+    /// <typeparam name="Args">Types of arguments</typeparam>
+    /// <param name="source">Source name or file name</param>
+    /// <param name="line">Source line number</param>
+    /// <param name="function">Function name for trace messages, nullptr for log messages</param>
+    /// <param name="severity">Severity to log with (log severity levels greater than the current set log level wil be ignored</param>
+    /// <param name="noAlloc">If true, use the non-allocating text log functions in case the message is logged as text</param>
+    /// <param name="message">Format string</param>
+    /// <param name="args">Arguments for format string</param>
+    template <typename... Args>
+    static void LogEntryBinary(const char* source, int line, const char* function, LogSeverity severity, bool noAlloc, const char* message, Args... args)
+    {
+        if (!HaveLogger())
+            return;
+        if (!IsInternedString(message))
+        {
+            if (function == nullptr)
+            {
+                if (noAlloc)
+                    s_logger->LogNoAlloc(source, line, severity, message, args...);
+                else
+                    s_logger->Log(source, line, severity, message, args...);
+            }
+            else
+            {
+                if (noAlloc)
+                    s_logger->TraceNoAlloc(source, line, function, severity, message, args...);
+                else
+                    s_logger->Trace(source, line, function, severity, message, args...);
+            }
+            return;
+        }
+        const uint64 argumentWords[sizeof...(Args) + 1]{LogArgumentWord(args)...};
+        s_logger->LogBinary(source, line, function, severity, message, sizeof...(Args), argumentWords);
+    }
+
+private:
+    void WriteBinaryRecord(const uint8* record, size_t size);
+#endif
 };
 
 Logger& GetLogger();
 
+void FormatUptimeTimestamp(char* buffer, size_t bufferSize, uint64 counter, uint64 frequency);
+
+#if BAREMETAL_BINARY_LOG
+size_t EncodeBinaryLogFrame(const uint8* record, size_t size, uint8* frame);
+#endif
+
+/// @brief Compile time log level for LogSeverity::Panic
+#define LOG_LEVEL_PANIC   0
+/// @brief Compile time log level for LogSeverity::Error
+#define LOG_LEVEL_ERROR   1
+/// @brief Compile time log level for LogSeverity::Warning
+#define LOG_LEVEL_WARNING 2
+/// @brief Compile time log level for LogSeverity::Info
+#define LOG_LEVEL_INFO    3
+/// @brief Compile time log level for LogSeverity::Debug
+#define LOG_LEVEL_DEBUG   4
+/// @brief Compile time log level for LogSeverity::Data
+#define LOG_LEVEL_DATA    5
+
+/// @brief Highest severity compiled in for all modules. Log statements with a higher severity are removed completely, including their arguments.
+/// Set through BAREMETAL_LOG_LEVEL in CMake
+#ifndef BAREMETAL_LOG_LEVEL
+#define BAREMETAL_LOG_LEVEL LOG_LEVEL_DATA
+#endif
+
 /// @brief Define the static variable From to the specified name, to support printing a different file specification in LOG_* macros
-#define LOG_MODULE(name)                  static const char From[] = name
+#define LOG_MODULE_NAME(name)             static const char From[] = name
+/// @brief Define the static variable From to the specified name, and set the highest severity compiled in for the module (one of the LOG_LEVEL_* values).
+/// The level can only lower BAREMETAL_LOG_LEVEL
+#define LOG_MODULE_NAME_LEVEL(name, level)                                      \
+    LOG_MODULE_NAME(name);                                                      \
+    [[maybe_unused]] static constexpr int CompiledLogLevel(int)                 \
+    {                                                                           \
+        return ((level) < BAREMETAL_LOG_LEVEL) ? (level) : BAREMETAL_LOG_LEVEL; \
+    }
+/// @brief Select LOG_MODULE_NAME or LOG_MODULE_NAME_LEVEL depending on the number of arguments to LOG_MODULE
+#define LOG_MODULE_SELECT(_1, _2, macro, ...) macro
+/// @brief Define the module name used in LOG_* macros, and optionally the highest severity compiled in for the module, e.g.
+/// LOG_MODULE("I2CMaster", LOG_LEVEL_INFO) removes all LOG_DEBUG and LOG_DATA statements in the source file following it. Without a level,
+/// BAREMETAL_LOG_LEVEL is used. Must be placed at namespace scope, before the first log statement.
+/// The level is looked up like From, so it applies to all log statements in the source file that see the module name
+#define LOG_MODULE(...) LOG_MODULE_SELECT(__VA_ARGS__, LOG_MODULE_NAME_LEVEL, LOG_MODULE_NAME, unused)(__VA_ARGS__)
+
+/// @brief Check whether log statements with the specified severity are compiled in for the current module
+#define LOG_SEVERITY_COMPILED_IN(severity) (static_cast<int>(severity) <= CompiledLogLevel(0))
+/// @brief Check whether log statements with the specified severity are compiled in and enabled. Use to guard code only needed for logging
+#define LOG_SEVERITY_ENABLED(severity)     (LOG_SEVERITY_COMPILED_IN(severity) && Logger::IsEnabled(severity))
+/// @brief Execute a log statement with a fixed severity only if compiled in, enabled and not rate limited. Arguments are not evaluated otherwise.
+/// The source name and line are used to report messages suppressed by rate limiting
+#define LOG_IF_ENABLED(severity, source, statement)                        \
+    do                                                                     \
+    {                                                                      \
+        if constexpr (LOG_SEVERITY_COMPILED_IN(severity))                  \
+        {                                                                  \
+            if (Logger::IsEnabled(severity))                               \
+            {                                                              \
+                static LogCallSite logCallSite;                            \
+                if (Logger::CheckRateLimit(logCallSite, source, __LINE__)) \
+                    statement;                                             \
+            }                                                              \
+        }                                                                  \
+    } while (false)
+/// @brief Execute a log statement with a severity determined at run time only if compiled in, enabled and not rate limited. Arguments are not evaluated otherwise.
+/// The source name and line are used to report messages suppressed by rate limiting
+#define LOG_IF_ENABLED_RUNTIME(severity, source, statement)            \
+    do                                                                 \
+    {                                                                  \
+        if (LOG_SEVERITY_ENABLED(severity))                            \
+        {                                                              \
+            static LogCallSite logCallSite;                            \
+            if (Logger::CheckRateLimit(logCallSite, source, __LINE__)) \
+                statement;                                             \
+        }                                                              \
+    } while (false)
+
+#if BAREMETAL_BINARY_LOG
 
 /// @brief Log a panic message
-#define LOG_PANIC(...)                    Logger::LogEntry(From, __LINE__, LogSeverity::Panic, __VA_ARGS__)
+#define LOG_PANIC(...)                    LOG_IF_ENABLED(LogSeverity::Panic, From, Logger::LogEntryBinary(From, __LINE__, nullptr, LogSeverity::Panic, false, __VA_ARGS__))
 /// @brief Log an error message
-#define LOG_ERROR(...)                    Logger::LogEntry(From, __LINE__, LogSeverity::Error, __VA_ARGS__)
+#define LOG_ERROR(...)                    LOG_IF_ENABLED(LogSeverity::Error, From, Logger::LogEntryBinary(From, __LINE__, nullptr, LogSeverity::Error, false, __VA_ARGS__))
 /// @brief Log a warning message
-#define LOG_WARNING(...)                  Logger::LogEntry(From, __LINE__, LogSeverity::Warning, __VA_ARGS__)
+#define LOG_WARNING(...)                  LOG_IF_ENABLED(LogSeverity::Warning, From, Logger::LogEntryBinary(From, __LINE__, nullptr, LogSeverity::Warning, false, __VA_ARGS__))
 /// @brief Log a info message
-#define LOG_INFO(...)                     Logger::LogEntry(From, __LINE__, LogSeverity::Info, __VA_ARGS__)
+#define LOG_INFO(...)                     LOG_IF_ENABLED(LogSeverity::Info, From, Logger::LogEntryBinary(From, __LINE__, nullptr, LogSeverity::Info, false, __VA_ARGS__))
 /// @brief Log a debug message
-#define LOG_DEBUG(...)                    Logger::LogEntry(From, __LINE__, LogSeverity::Debug, __VA_ARGS__)
+#define LOG_DEBUG(...)                    LOG_IF_ENABLED(LogSeverity::Debug, From, Logger::LogEntryBinary(From, __LINE__, nullptr, LogSeverity::Debug, false, __VA_ARGS__))
 
 /// @brief Log a message with specified severity and message string
-#define LOG(severity, message)            Logger::LogEntry(From, __LINE__, severity, message)
+#define LOG(severity, message)            LOG_IF_ENABLED_RUNTIME(severity, From, Logger::LogEntryBinary(From, __LINE__, nullptr, severity, false, message))
 
 /// @brief Log a panic message
-#define LOG_NO_ALLOC_PANIC(...)           Logger::LogEntryNoAlloc(From, __LINE__, LogSeverity::Panic, __VA_ARGS__)
+#define LOG_NO_ALLOC_PANIC(...)           LOG_IF_ENABLED(LogSeverity::Panic, From, Logger::LogEntryBinary(From, __LINE__, nullptr, LogSeverity::Panic, true, __VA_ARGS__))
 /// @brief Log an error message
-#define LOG_NO_ALLOC_ERROR(...)           Logger::LogEntryNoAlloc(From, __LINE__, LogSeverity::Error, __VA_ARGS__)
+#define LOG_NO_ALLOC_ERROR(...)           LOG_IF_ENABLED(LogSeverity::Error, From, Logger::LogEntryBinary(From, __LINE__, nullptr, LogSeverity::Error, true, __VA_ARGS__))
 /// @brief Log a warning message
-#define LOG_NO_ALLOC_WARNING(...)         Logger::LogEntryNoAlloc(From, __LINE__, LogSeverity::Warning, __VA_ARGS__)
+#define LOG_NO_ALLOC_WARNING(...)         LOG_IF_ENABLED(LogSeverity::Warning, From, Logger::LogEntryBinary(From, __LINE__, nullptr, LogSeverity::Warning, true, __VA_ARGS__))
 /// @brief Log a info message
-#define LOG_NO_ALLOC_INFO(...)            Logger::LogEntryNoAlloc(From, __LINE__, LogSeverity::Info, __VA_ARGS__)
+#define LOG_NO_ALLOC_INFO(...)            LOG_IF_ENABLED(LogSeverity::Info, From, Logger::LogEntryBinary(From, __LINE__, nullptr, LogSeverity::Info, true, __VA_ARGS__))
 /// @brief Log a debug message
-#define LOG_NO_ALLOC_DEBUG(...)           Logger::LogEntryNoAlloc(From, __LINE__, LogSeverity::Debug, __VA_ARGS__)
+#define LOG_NO_ALLOC_DEBUG(...)           LOG_IF_ENABLED(LogSeverity::Debug, From, Logger::LogEntryBinary(From, __LINE__, nullptr, LogSeverity::Debug, true, __VA_ARGS__))
 
 /// @brief Log a message with specified severity and message string
-#define LOG_NO_ALLOC(severity, message)   Logger::LogEntryNoAlloc(From, __LINE__, severity, message)
+#define LOG_NO_ALLOC(severity, message)   LOG_IF_ENABLED_RUNTIME(severity, From, Logger::LogEntryBinary(From, __LINE__, nullptr, severity, true, message))
 
 /// @brief Trace a warning message
-#define TRACE_WARNING(...)                Logger::TraceEntry(__FILE_NAME__, __LINE__, __func__, LogSeverity::Warning, __VA_ARGS__)
+#define TRACE_WARNING(...)                LOG_IF_ENABLED(LogSeverity::Warning, __FILE_NAME__, Logger::LogEntryBinary(__FILE_NAME__, __LINE__, __func__, LogSeverity::Warning, false, __VA_ARGS__))
 /// @brief Trace a info message
-#define TRACE_INFO(...)                   Logger::TraceEntry(__FILE_NAME__, __LINE__, __func__, LogSeverity::Info, __VA_ARGS__)
+#define TRACE_INFO(...)                   LOG_IF_ENABLED(LogSeverity::Info, __FILE_NAME__, Logger::LogEntryBinary(__FILE_NAME__, __LINE__, __func__, LogSeverity::Info, false, __VA_ARGS__))
 /// @brief Trace a debug message
-#define TRACE_DEBUG(...)                  Logger::TraceEntry(__FILE_NAME__, __LINE__, __func__, LogSeverity::Debug, __VA_ARGS__)
+#define TRACE_DEBUG(...)                  LOG_IF_ENABLED(LogSeverity::Debug, __FILE_NAME__, Logger::LogEntryBinary(__FILE_NAME__, __LINE__, __func__, LogSeverity::Debug, false, __VA_ARGS__))
 /// @brief Trace a data message
-#define TRACE_DATA(...)                   Logger::TraceEntry(__FILE_NAME__, __LINE__, __func__, LogSeverity::Data, __VA_ARGS__)
+#define TRACE_DATA(...)                   LOG_IF_ENABLED(LogSeverity::Data, __FILE_NAME__, Logger::LogEntryBinary(__FILE_NAME__, __LINE__, __func__, LogSeverity::Data, false, __VA_ARGS__))
 
 /// @brief Trace a message with specified severity and message string
-#define TRACE(severity, message)          Logger::TraceEntry(__FILE_NAME__, __LINE__, __func__, severity, message)
+#define TRACE(severity, message)          LOG_IF_ENABLED_RUNTIME(severity, __FILE_NAME__, Logger::LogEntryBinary(__FILE_NAME__, __LINE__, __func__, severity, false, message))
 
 /// @brief Trace a warning message
-#define TRACE_NO_ALLOC_WARNING(...)       Logger::TraceEntryNoAlloc(__FILE_NAME__, __LINE__, __func__, LogSeverity::Warning, __VA_ARGS__)
+#define TRACE_NO_ALLOC_WARNING(...)       LOG_IF_ENABLED(LogSeverity::Warning, __FILE_NAME__, Logger::LogEntryBinary(__FILE_NAME__, __LINE__, __func__, LogSeverity::Warning, true, __VA_ARGS__))
 /// @brief Trace a info message
-#define TRACE_NO_ALLOC_INFO(...)          Logger::TraceEntryNoAlloc(__FILE_NAME__, __LINE__, __func__, LogSeverity::Info, __VA_ARGS__)
+#define TRACE_NO_ALLOC_INFO(...)          LOG_IF_ENABLED(LogSeverity::Info, __FILE_NAME__, Logger::LogEntryBinary(__FILE_NAME__, __LINE__, __func__, LogSeverity::Info, true, __VA_ARGS__))
 /// @brief Trace a debug message
-#define TRACE_NO_ALLOC_DEBUG(...)         Logger::TraceEntryNoAlloc(__FILE_NAME__, __LINE__, __func__, LogSeverity::Debug, __VA_ARGS__)
+#define TRACE_NO_ALLOC_DEBUG(...)         LOG_IF_ENABLED(LogSeverity::Debug, __FILE_NAME__, Logger::LogEntryBinary(__FILE_NAME__, __LINE__, __func__, LogSeverity::Debug, true, __VA_ARGS__))
 /// @brief Trace a data message
-#define TRACE_NO_ALLOC_DATA(...)          Logger::TraceEntryNoAlloc(__FILE_NAME__, __LINE__, __func__, LogSeverity::Data, __VA_ARGS__)
+#define TRACE_NO_ALLOC_DATA(...)          LOG_IF_ENABLED(LogSeverity::Data, __FILE_NAME__, Logger::LogEntryBinary(__FILE_NAME__, __LINE__, __func__, LogSeverity::Data, true, __VA_ARGS__))
 
 /// @brief Trace a message with specified severity and message string
-#define TRACE_NO_ALLOC(severity, message) Logger::TraceEntryNoAlloc(__FILE_NAME__, __LINE__, __func__, severity, message)
+#define TRACE_NO_ALLOC(severity, message) LOG_IF_ENABLED_RUNTIME(severity, __FILE_NAME__, Logger::LogEntryBinary(__FILE_NAME__, __LINE__, __func__, severity, true, message))
+
+#else
+
+/// @brief Log a panic message
+#define LOG_PANIC(...)                    LOG_IF_ENABLED(LogSeverity::Panic, From, Logger::LogEntry(From, __LINE__, LogSeverity::Panic, __VA_ARGS__))
+/// @brief Log an error message
+#define LOG_ERROR(...)                    LOG_IF_ENABLED(LogSeverity::Error, From, Logger::LogEntry(From, __LINE__, LogSeverity::Error, __VA_ARGS__))
+/// @brief Log a warning message
+#define LOG_WARNING(...)                  LOG_IF_ENABLED(LogSeverity::Warning, From, Logger::LogEntry(From, __LINE__, LogSeverity::Warning, __VA_ARGS__))
+/// @brief Log a info message
+#define LOG_INFO(...)                     LOG_IF_ENABLED(LogSeverity::Info, From, Logger::LogEntry(From, __LINE__, LogSeverity::Info, __VA_ARGS__))
+/// @brief Log a debug message
+#define LOG_DEBUG(...)                    LOG_IF_ENABLED(LogSeverity::Debug, From, Logger::LogEntry(From, __LINE__, LogSeverity::Debug, __VA_ARGS__))
+
+/// @brief Log a message with specified severity and message string
+#define LOG(severity, message)            LOG_IF_ENABLED_RUNTIME(severity, From, Logger::LogEntry(From, __LINE__, severity, message))
+
+/// @brief Log a panic message
+#define LOG_NO_ALLOC_PANIC(...)           LOG_IF_ENABLED(LogSeverity::Panic, From, Logger::LogEntryNoAlloc(From, __LINE__, LogSeverity::Panic, __VA_ARGS__))
+/// @brief Log an error message
+#define LOG_NO_ALLOC_ERROR(...)           LOG_IF_ENABLED(LogSeverity::Error, From, Logger::LogEntryNoAlloc(From, __LINE__, LogSeverity::Error, __VA_ARGS__))
+/// @brief Log a warning message
+#define LOG_NO_ALLOC_WARNING(...)         LOG_IF_ENABLED(LogSeverity::Warning, From, Logger::LogEntryNoAlloc(From, __LINE__, LogSeverity::Warning, __VA_ARGS__))
+/// @brief Log a info message
+#define LOG_NO_ALLOC_INFO(...)            LOG_IF_ENABLED(LogSeverity::Info, From, Logger::LogEntryNoAlloc(From, __LINE__, LogSeverity::Info, __VA_ARGS__))
+/// @brief Log a debug message
+#define LOG_NO_ALLOC_DEBUG(...)           LOG_IF_ENABLED(LogSeverity::Debug, From, Logger::LogEntryNoAlloc(From, __LINE__, LogSeverity::Debug, __VA_ARGS__))
+
+/// @brief Log a message with specified severity and message string
+#define LOG_NO_ALLOC(severity, message)   LOG_IF_ENABLED_RUNTIME(severity, From, Logger::LogEntryNoAlloc(From, __LINE__, severity, message))
+
+/// @brief Trace a warning message
+#define TRACE_WARNING(...)                LOG_IF_ENABLED(LogSeverity::Warning, __FILE_NAME__, Logger::TraceEntry(__FILE_NAME__, __LINE__, __func__, LogSeverity::Warning, __VA_ARGS__))
+/// @brief Trace a info message
+#define TRACE_INFO(...)                   LOG_IF_ENABLED(LogSeverity::Info, __FILE_NAME__, Logger::TraceEntry(__FILE_NAME__, __LINE__, __func__, LogSeverity::Info, __VA_ARGS__))
+/// @brief Trace a debug message
+#define TRACE_DEBUG(...)                  LOG_IF_ENABLED(LogSeverity::Debug, __FILE_NAME__, Logger::TraceEntry(__FILE_NAME__, __LINE__, __func__, LogSeverity::Debug, __VA_ARGS__))
+/// @brief Trace a data message
+#define TRACE_DATA(...)                   LOG_IF_ENABLED(LogSeverity::Data, __FILE_NAME__, Logger::TraceEntry(__FILE_NAME__, __LINE__, __func__, LogSeverity::Data, __VA_ARGS__))
+
+/// @brief Trace a message with specified severity and message string
+#define TRACE(severity, message)          LOG_IF_ENABLED_RUNTIME(severity, __FILE_NAME__, Logger::TraceEntry(__FILE_NAME__, __LINE__, __func__, severity, message))
+
+/// @brief Trace a warning message
+#define TRACE_NO_ALLOC_WARNING(...)       LOG_IF_ENABLED(LogSeverity::Warning, __FILE_NAME__, Logger::TraceEntryNoAlloc(__FILE_NAME__, __LINE__, __func__, LogSeverity::Warning, __VA_ARGS__))
+/// @brief Trace a info message
+#define TRACE_NO_ALLOC_INFO(...)          LOG_IF_ENABLED(LogSeverity::Info, __FILE_NAME__, Logger::TraceEntryNoAlloc(__FILE_NAME__, __LINE__, __func__, LogSeverity::Info, __VA_ARGS__))
+/// @brief Trace a debug message
+#define TRACE_NO_ALLOC_DEBUG(...)         LOG_IF_ENABLED(LogSeverity::Debug, __FILE_NAME__, Logger::TraceEntryNoAlloc(__FILE_NAME__, __LINE__, __func__, LogSeverity::Debug, __VA_ARGS__))
+/// @brief Trace a data message
+#define TRACE_NO_ALLOC_DATA(...)          LOG_IF_ENABLED(LogSeverity::Data, __FILE_NAME__, Logger::TraceEntryNoAlloc(__FILE_NAME__, __LINE__, __func__, LogSeverity::Data, __VA_ARGS__))
+
+/// @brief Trace a message with specified severity and message string
+#define TRACE_NO_ALLOC(severity, message) LOG_IF_ENABLED_RUNTIME(severity, __FILE_NAME__, Logger::TraceEntryNoAlloc(__FILE_NAME__, __LINE__, __func__, severity, message))
+
+#endif
 
 } // namespace baremetal
+
+/// <summary>
+/// Highest severity compiled in for modules which do not specify a level in LOG_MODULE(). LOG_MODULE(name, level) defines an overload taking an int,
+/// which is preferred over this one. Declared in the global namespace, so it never hides a module level defined in an enclosing namespace
+/// </summary>
+/// <returns>BAREMETAL_LOG_LEVEL</returns>
+constexpr int CompiledLogLevel(...)
+{
+    return BAREMETAL_LOG_LEVEL;
+}
@@ -52,6 +52,8 @@ enum class CoherentPageSlot
 {
     /// @brief Coherent memory page slot for Raspberry Pi mailbox
     PropertyMailbox = 0,
+    /// @brief Coherent memory page slot for DMA control blocks
+    DMAControlBlocks = 1,
 };
 
 /// <summary>
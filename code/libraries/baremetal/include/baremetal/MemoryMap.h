@@ -79,6 +79,16 @@
 /// @brief Top of exception stack for all cores (stack grows down). Also includes the exception stacks for cores 1..CORES-1
 #define MEM_EXCEPTION_STACK_END (MEM_EXCEPTION_STACK + EXCEPTION_STACK_SIZE * (CORES - 1))
 
+/// @brief Size of the crash log region (if not already specified in SysConfig.h)
+#if !defined(CRASH_LOG_SIZE)
+#define CRASH_LOG_SIZE          0x10000 // 64 Kb
+#endif
+/// @brief Start of the crash log region, which holds a copy of the log output that survives a reboot. Placed in the spare space after the exception stacks,
+/// which is not cleared on startup
+#define MEM_CRASH_LOG_START     MEM_EXCEPTION_STACK_END
+/// @brief End of the crash log region
+#define MEM_CRASH_LOG_END       (MEM_CRASH_LOG_START + CRASH_LOG_SIZE)
+
 #if BAREMETAL_RPI_TARGET == 3
 /// @brief Region reserved for coherent memory (memory shared between ARM and GPU). We reserve 1 Mb, but make sure then end is rounded
 #define COHERENT_REGION_SIZE 1 * MEGABYTE
@@ -0,0 +1,172 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : PeriodicTaskService.h
+//
+// Namespace   : baremetal
+//
+// Class       : PeriodicTaskService
+//
+// Description : Deadline scheduled periodic tasks with timing statistics
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "baremetal/Histogram.h"
+#include "baremetal/TimerWheel.h"
+#include "stdlib/Types.h"
+
+/// @file
+/// Deadline scheduled periodic tasks with timing statistics
+
+/// @brief Number of periodic task administrations allocated at once when the pool of free tasks is empty
+#ifndef PERIODIC_TASK_POOL_CHUNK
+#define PERIODIC_TASK_POOL_CHUNK 16
+#endif
+
+namespace baremetal {
+
+class Timer;
+
+/// @brief Periodic task handler
+using PeriodicTaskHandler = void(void* context);
+
+/// <summary>
+/// Timing statistics of a periodic task. All times are in nanoseconds
+/// </summary>
+struct PeriodicTaskStatistics
+{
+    /// @brief Number of times the task handler was called
+    uint64 releases;
+    /// @brief Number of runs which did not finish before the next release
+    uint64 overruns;
+    /// @brief Number of releases skipped because of overruns (or because the task was started too late)
+    uint64 missedReleases;
+    /// @brief Time between the start and the end of the task handler
+    Histogram executionTime;
+    /// @brief Time between the scheduled release and the start of the task handler
+    Histogram releaseJitter;
+};
+
+/// <summary>
+/// Periodic task administration. Allocated from the pool in PeriodicTaskService, the fields are private to PeriodicTaskService
+/// </summary>
+struct PeriodicTask
+{
+    /// @brief Next task in the list of active tasks, or in the free list
+    PeriodicTask* m_next;
+    /// @brief Task name, for DumpStatistics()
+    const char* m_name;
+    /// @brief Task handler
+    PeriodicTaskHandler* m_handler;
+    /// @brief Task handler context
+    void* m_context;
+    /// @brief Task period in nanoseconds
+    uint64 m_periodNsec;
+    /// @brief Next scheduled release, in Clock nanoseconds
+    uint64 m_nextRelease;
+    /// @brief Kernel timer for the next release
+    KernelTimerHandle m_timer;
+    /// @brief Incremented when the task is added or removed, so that a task removed (and perhaps re-used) by its own handler is not restarted
+    uint32 m_generation;
+    /// @brief True while the task is scheduled
+    bool m_active;
+    /// @brief Timing statistics
+    PeriodicTaskStatistics m_statistics;
+};
+
+/// <summary>
+/// Runs periodic tasks, each with its own period and phase, and keeps timing statistics for each task.
+///
+/// Task releases are scheduled at absolute times: epoch + phase + n * period, where the epoch is the time the service was created. Tasks with the same
+/// phase therefore run in step (a 1 Hz task releases together with every tenth run of a 10 Hz task), and release times do not drift because of handler
+/// latency. If a run finishes after the next release, this is counted as an overrun, and the task continues at the first release after the current time,
+/// keeping its phase.
+///
+/// Task handlers are called from a kernel timer, so in interrupt context. In tick mode, releases are delayed to the next timer tick (USEC_PER_TICK), so
+/// periods below a few ticks are not accurate. Build with BAREMETAL_TICKLESS_TIMER for periods in the millisecond range or below (e.g. a 1 kHz task).
+///
+/// Tasks are allocated from a pool, which grows in chunks of PERIODIC_TASK_POOL_CHUNK tasks, so AddTask() must not be called from interrupt context.
+///
+/// Note that this class is created as a singleton, using the GetPeriodicTaskService() function.
+/// </summary>
+class PeriodicTaskService
+{
+    /// <summary>
+    /// Retrieves the singleton PeriodicTaskService instance. It is created in the first call to this function. This is a friend function of class PeriodicTaskService
+    /// </summary>
+    /// <returns>A reference to the singleton PeriodicTaskService</returns>
+    friend PeriodicTaskService& GetPeriodicTaskService();
+
+private:
+    /// <summary>
+    /// Block of task administrations allocated at once
+    /// </summary>
+    struct TaskChunk
+    {
+        /// @brief Next chunk
+        TaskChunk* m_next;
+        /// @brief Task administrations
+        PeriodicTask m_tasks[PERIODIC_TASK_POOL_CHUNK];
+    };
+
+    /// @brief Timer used to schedule releases
+    Timer& m_timer;
+    /// @brief Start time of the service, in Clock nanoseconds. Task phases are relative to this
+    uint64 m_epoch;
+    /// @brief Active tasks
+    PeriodicTask* m_activeTasks;
+    /// @brief Free task administrations
+    PeriodicTask* m_freeTasks;
+    /// @brief Allocated task chunks
+    TaskChunk* m_chunks;
+
+    PeriodicTaskService();
+
+public:
+    explicit PeriodicTaskService(Timer& timer);
+    ~PeriodicTaskService();
+
+    PeriodicTask* AddTask(const char* name, uint64 periodUsec, uint64 phaseUsec, PeriodicTaskHandler* handler, void* context = nullptr);
+    void RemoveTask(PeriodicTask* task);
+
+    void GetStatistics(const PeriodicTask* task, PeriodicTaskStatistics& statistics) const;
+    void ResetStatistics(PeriodicTask* task);
+    void DumpStatistics() const;
+
+private:
+    bool ScheduleRelease(PeriodicTask* task, uint64 now);
+    void RunTask(PeriodicTask* task);
+    static void TaskTimerHandler(KernelTimerHandle handle, void* param, void* context);
+};
+
+PeriodicTaskService& GetPeriodicTaskService();
+
+} // namespace baremetal
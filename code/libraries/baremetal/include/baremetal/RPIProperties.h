@@ -234,6 +234,7 @@ public:
     bool GetClockRate(ClockID clockID, uint32& freqHz);
     bool GetMeasuredClockRate(ClockID clockID, uint32& freqHz);
     bool SetClockRate(ClockID clockID, uint32 freqHz, bool skipTurbo);
+    bool GetDMAChannels(uint32& channelMask);
 };
 
 } // namespace baremetal
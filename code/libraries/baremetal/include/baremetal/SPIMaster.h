@@ -40,6 +40,7 @@
 #pragma once
 
 #include "baremetal/BCMRegisters.h"
+#include "baremetal/DMAChannel.h"
 #include "baremetal/ISPIMaster.h"
 #include "baremetal/IMemoryAccess.h"
 #include "baremetal/PhysicalGPIOPin.h"
@@ -47,6 +48,21 @@
 /// @file
 /// SPI Master
 
+/// @brief Minimum transfer size in bytes for which DMA is used, once enabled with SPIMaster::EnableDMA(). Can be changed at run time with
+/// SPIMaster::SetDMAThreshold()
+#ifndef SPI_DMA_THRESHOLD
+#define SPI_DMA_THRESHOLD 64
+#endif
+
+/// @brief Maximum number of bytes in a single SPI DMA transfer. The length is limited to 16 bits, and is kept a multiple of 4 so every
+/// transfer starts word aligned
+#define SPI_DMA_CHUNK_SIZE 0xFFFC
+
+/// @brief Time in milliseconds an SPI DMA transfer may take on top of its duration at the configured clock rate, before it is aborted
+#ifndef SPI_DMA_TIMEOUT
+#define SPI_DMA_TIMEOUT 100
+#endif
+
 namespace baremetal {
 
 /// <summary>
@@ -74,6 +90,10 @@ enum class SPIClockPhase
 /// <summary>
 /// Driver for SPI master devices
 ///
+/// Transfers are done by the CPU, one byte at a time. For SPI device 0, DMA can be enabled with EnableDMA(), after which transfers of at
+/// least the DMA threshold are done by two DMA channels paced by the SPI DREQ signals. DMA transfers can be longer than 65535 bytes, they
+/// are performed in chunks of SPI_DMA_CHUNK_SIZE bytes, with CS de-asserted briefly between chunks.
+///
 /// GPIO pin mapping (Raspberry Pi 3-4)
 /// Device | CE1    CE0    MISO   MOSI   SCLK   | Boards
 /// :----: | :--------------------------------: | :-----
@@ -131,6 +151,17 @@ private:
     /// @brief GPIO pin for CE1 wire
     PhysicalGPIOPin m_ce1Pin;
 
+    /// @brief DMA channel writing to the FIFO, nullptr if DMA is not enabled
+    DMAChannel* m_txDMAChannel;
+    /// @brief DMA channel reading from the FIFO, nullptr if DMA is not enabled
+    DMAChannel* m_rxDMAChannel;
+    /// @brief Minimum transfer size for DMA
+    size_t m_dmaThreshold;
+    /// @brief Length and CS word written to the FIFO before the data of a DMA transfer
+    uint32 m_dmaHeader;
+    /// @brief Data sent for DMA transfers without write buffer
+    uint32 m_dmaZero;
+
 public:
     SPIMaster(IMemoryAccess& memoryAccess = GetMemoryAccess());
 
@@ -145,7 +176,14 @@ public:
     size_t Write(SPI_CEIndex ceIndex, const void* buffer, size_t count) override;
     size_t WriteRead(SPI_CEIndex ceIndex, const void* writeBuffer, void* readBuffer, size_t count) override;
 
+    bool EnableDMA(DMAController& controller = GetDMAController());
+    void DisableDMA();
+    bool IsDMAEnabled() const;
+    void SetDMAThreshold(size_t threshold);
+
 private:
+    size_t WriteReadPolled(SPI_CEIndex ceIndex, const uint8* writeData, uint8* readData, size_t count);
+    size_t WriteReadDMA(SPI_CEIndex ceIndex, const uint8* writeData, uint8* readData, size_t count);
 };
 
 } // namespace baremetal
@@ -42,7 +42,7 @@
 /// @file
 /// Raspberry Pi Timer
 
-#include "baremetal/DoubleLinkedList.h"
+#include "baremetal/TimerWheel.h"
 #include "stdlib/Types.h"
 
 namespace baremetal {
@@ -57,6 +57,8 @@ namespace baremetal {
 #define TICKS_PER_SECOND 100
 /// @brief Convert milliseconds to timer ticks
 #define MSEC2TICKS(msec) (((msec) * TICKS_PER_SECOND) / MSEC_PER_SEC)
+/// @brief Number of microseconds in a timer tick
+#define USEC_PER_TICK    (USEC_PER_SEC / TICKS_PER_SECOND)
 
 class InterruptSystem;
 class IMemoryAccess;
@@ -67,16 +69,13 @@ using PeriodicTimerHandler = void(void);
 /// @brief Maximum number of periodic tick handlers which can be installed
 #define TIMER_MAX_PERIODIC_HANDLERS 4
 
-struct KernelTimer;
-
-/// @brief Handle to a kernel timer
-using KernelTimerHandle = uintptr;
-
-/// @brief Kernel timer handler
-using KernelTimerHandler = void(KernelTimerHandle timerHandle, void* param, void* context);
-
 /// <summary>
-/// Timer class. For now only contains busy waiting methods
+/// Timer class. Provides time keeping, kernel timers, periodic handlers and (sleeping) waits
+///
+/// By default, the timer interrupt fires every timer tick (TICKS_PER_SECOND times per second), and kernel timers have a resolution of one tick.
+/// When built with BAREMETAL_TICKLESS, the timer interrupt is only programmed for the next kernel timer deadline, time is read from the counter
+/// register, and kernel timers have microsecond resolution. The periodic handlers are then called from a kernel timer, which is only running while
+/// periodic handlers are registered.
 ///
 /// Note that this class is created as a singleton, using the GetTimer() function.
 /// </summary>
@@ -97,18 +96,33 @@ private:
     IMemoryAccess& m_memoryAccess;
     /// @brief Clock ticks per timer tick
     uint64 m_clockTicksPerSystemTick;
-    /// @brief Timer tick counter
+    /// @brief Timer tick counter (not used in tickless mode, where the tick count is derived from the counter register)
     volatile uint64 m_ticks;
-    /// @brief Uptime in seconds
+    /// @brief Uptime in seconds (not used in tickless mode, where the uptime is derived from the counter register)
     volatile uint32 m_upTime;
-    /// @brief Time in seconds (epoch time)
+    /// @brief Time in seconds (epoch time). In tickless mode, this is the time at startup
     volatile uint64 m_time;
+    /// @brief Number of timer interrupts handled
+    volatile uint64 m_interruptCount;
+    /// @brief Counter register value at initialization. Timer ticks are counted from this, in tickless mode kernel timer deadlines are in microseconds
+    /// relative to this
+    uint64 m_startCounter;
+#if BAREMETAL_TICKLESS
+    /// @brief Kernel timer calling the periodic handlers, 0 if not running
+    KernelTimerHandle m_periodicTimer;
+    /// @brief Next deadline of m_periodicTimer, in microseconds since initialization
+    uint64 m_periodicDeadline;
+#endif
+    /// @brief Cached calendar date for GetTimeString(), recomputed only when the day changes.
+    /// Bits 63..32 hold the number of days since epoch, bits 31..16 the year, bits 15..8 the month (0 = January) and bits 7..0 the day of the month.
+    /// Kept in a single word so it is read and written atomically
+    volatile uint64 m_calendarDate;
     /// @brief Periodic tick handler functions
     PeriodicTimerHandler* m_periodicHandlers[TIMER_MAX_PERIODIC_HANDLERS];
     /// @brief Number of periodic tick handler functions installed
     volatile unsigned m_numPeriodicHandlers;
-    /// @brief Kernel timer list
-    DoubleLinkedList<KernelTimer*> m_kernelTimerList;
+    /// @brief Kernel timers
+    TimerWheel m_kernelTimers;
     /// @brief Number of days is each month (0 = January, etc.)
     static const unsigned s_daysInMonth[12];
     /// @brief Name of each month (0 = January, etc.)
@@ -128,12 +142,17 @@ public:
 
     uint64 GetTime() const;
 
+    uint64 GetUptimeMicroSeconds() const;
+    uint64 GetInterruptCount() const;
+
     void GetTimeString(char* buffer, size_t bufferSize);
+    void GetTimeString(char* buffer, size_t bufferSize, uint64 counter);
 
     void RegisterPeriodicHandler(PeriodicTimerHandler* handler);
     void UnregisterPeriodicHandler(PeriodicTimerHandler* handler);
 
     KernelTimerHandle StartKernelTimer(uint32 delayTicks, KernelTimerHandler* handler, void* param = nullptr, void* context = nullptr);
+    KernelTimerHandle StartKernelTimerMicroSeconds(uint64 delayUsec, KernelTimerHandler* handler, void* param = nullptr, void* context = nullptr);
     void CancelKernelTimer(KernelTimerHandle handle);
 
     static void WaitCycles(uint32 numCycles);
@@ -147,7 +166,16 @@ public:
     static unsigned GetDaysInMonth(unsigned month, unsigned year);
 
 private:
+    void FormatTime(char* buffer, size_t bufferSize, uint64 time, unsigned milliSeconds);
+    uint64 GetCalendarDate(uint64 daysTotal);
+    KernelTimerHandle AddKernelTimer(uint64 elapsesAt, KernelTimerHandler* handler, void* param, void* context);
     void PollKernelTimers();
+#if BAREMETAL_TICKLESS
+    uint64 CounterToMicroSeconds(uint64 count) const;
+    uint64 MicroSecondsToCounter(uint64 usec) const;
+    void ProgramNextDeadline();
+    static void PeriodicKernelTimerHandler(KernelTimerHandle handle, void* param, void* context);
+#endif
     void InterruptHandler();
     static void InterruptHandler(void* param);
 };
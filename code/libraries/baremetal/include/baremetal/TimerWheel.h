@@ -0,0 +1,150 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : TimerWheel.h
+//
+// Namespace   : baremetal
+//
+// Class       : TimerWheel
+//
+// Description : Hierarchical timing wheel for kernel timers
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "stdlib/Types.h"
+
+/// @file
+/// Hierarchical timing wheel for kernel timers
+
+/// @brief Maximum number of kernel timers which can be active at the same time
+#ifndef KERNEL_TIMER_MAX
+#define KERNEL_TIMER_MAX 512
+#endif
+
+/// @brief Number of bits of the expiry tick used for the slot index on each level of the timer wheel
+#define TIMER_WHEEL_SLOT_BITS 6
+/// @brief Number of slots on each level of the timer wheel
+#define TIMER_WHEEL_SLOTS     (1 << TIMER_WHEEL_SLOT_BITS)
+/// @brief Number of levels of the timer wheel. Timers further out than TIMER_WHEEL_SLOTS ^ TIMER_WHEEL_LEVELS ticks are re-inserted on the top level until they come into range
+#define TIMER_WHEEL_LEVELS    4
+
+namespace baremetal {
+
+/// @brief Handle to a kernel timer. Holds the index of the timer in the timer pool (plus 1) in the low 32 bits, and the timer generation in the high 32 bits, so that a handle to a timer which has already expired or was cancelled is recognized
+using KernelTimerHandle = uintptr;
+
+/// @brief Kernel timer handler
+using KernelTimerHandler = void(KernelTimerHandle timerHandle, void* param, void* context);
+
+/// <summary>
+/// Kernel timer administration. Intrusive node, linked in one of the timer wheel slots while active, or in the free list while not in use
+/// </summary>
+struct KernelTimer
+{
+    /// @brief Previous timer in slot
+    KernelTimer* m_prev;
+    /// @brief Next timer in slot or free list
+    KernelTimer* m_next;
+    /// @brief Kernel timer deadline in timer ticks
+    uint64 m_elapsesAtTicks;
+    /// @brief Pointer to kernel timer handler
+    KernelTimerHandler* m_handler;
+    /// @brief Kernel timer handler parameter
+    void* m_param;
+    /// @brief Kernel timer handler context
+    void* m_context;
+    /// @brief Generation, incremented every time the timer is released, to detect stale handles
+    uint32 m_generation;
+    /// @brief Timer wheel slot (level * TIMER_WHEEL_SLOTS + slot) the timer is linked in, or one of the TimerWheel::Slot* values
+    uint16 m_slot;
+};
+
+/// <summary>
+/// Hierarchical timing wheel holding the kernel timers.
+///
+/// Timers are kept in TIMER_WHEEL_LEVELS levels of TIMER_WHEEL_SLOTS slots each. Level 0 has a slot per tick, every next level has a slot per
+/// TIMER_WHEEL_SLOTS slots of the level below. A timer is put in the lowest level that covers its deadline, and moved (cascaded) to a lower level
+/// when the level below wraps around. Starting, cancelling and expiring a timer are O(1), timers are taken from a fixed pool so no memory is allocated.
+///
+/// The timer wheel is not protected against concurrent access, the caller must make sure Add(), Cancel() and Advance() are not interrupted by each other.
+/// </summary>
+class TimerWheel
+{
+public:
+    /// @brief Slot value for a timer that is not in use
+    static constexpr uint16 SlotFree = 0xFFFF;
+    /// @brief Slot value for a timer that is due and waiting for its handler to be called
+    static constexpr uint16 SlotDue = 0xFFFE;
+
+private:
+    /// @brief Pool of kernel timers
+    KernelTimer m_timers[KERNEL_TIMER_MAX];
+    /// @brief First free kernel timer in the pool
+    KernelTimer* m_freeList;
+    /// @brief Circular list heads of the timer wheel slots
+    KernelTimer m_slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    /// @brief Bit mask of the non-empty slots per level
+    uint64 m_occupied[TIMER_WHEEL_LEVELS];
+    /// @brief Next tick to be handled
+    uint64 m_currentTick;
+    /// @brief Number of active timers
+    size_t m_activeCount;
+
+public:
+    TimerWheel();
+
+    void Clear();
+
+    KernelTimerHandle Add(uint64 elapsesAtTicks, KernelTimerHandler* handler, void* param, void* context);
+    bool Cancel(KernelTimerHandle handle);
+    bool IsActive(KernelTimerHandle handle) const;
+    void Advance(uint64 ticks);
+    bool GetNextEvent(uint64& ticks) const;
+
+    /// <summary>
+    /// Return the number of active timers
+    /// </summary>
+    /// <returns>Number of timers which have been started, and have not yet expired or been cancelled</returns>
+    size_t GetActiveCount() const
+    {
+        return m_activeCount;
+    }
+
+private:
+    KernelTimer* GetTimer(KernelTimerHandle handle) const;
+    KernelTimerHandle GetHandle(const KernelTimer* timer) const;
+    void Insert(KernelTimer* timer);
+    void Unlink(KernelTimer* timer);
+    void Release(KernelTimer* timer);
+    void Cascade(unsigned level, unsigned slot);
+};
+
+} // namespace baremetal
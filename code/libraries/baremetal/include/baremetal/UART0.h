@@ -40,10 +40,24 @@
 #pragma once
 
 #include "baremetal/CharDevice.h"
+#include "baremetal/UARTStatistics.h"
 
 /// @file
 /// Raspberry Pi UART0 serial device
 
+/// @brief Size of the UART0 transmit buffer in bytes used in interrupt mode, must be a power of 2
+#ifndef UART0_TX_BUFFER_SIZE
+#define UART0_TX_BUFFER_SIZE 2048
+#endif
+/// @brief Size of the UART0 receive buffer in bytes used in interrupt mode, must be a power of 2
+#ifndef UART0_RX_BUFFER_SIZE
+#define UART0_RX_BUFFER_SIZE 512
+#endif
+/// @brief Maximum deviation of the actual baud rate from the requested one in ppm. A baud rate which cannot be reached within this limit is rejected
+#ifndef UART0_MAX_BAUD_ERROR_PPM
+#define UART0_MAX_BAUD_ERROR_PPM 20000
+#endif
+
 namespace baremetal {
 
 class IMemoryAccess;
@@ -53,6 +67,12 @@ class IMemoryAccess;
 ///
 /// This is a pseudo singleton, in that it is not possible to create a default instance (GetUART0() needs to be used for this),
 /// but it is possible to create an instance with a custom IMemoryAccess instance for testing.
+///
+/// By default the device is polled. After EnableInterruptMode() transmit and receive are handled by the UART0 interrupt through software ring
+/// buffers, and Read(void*, size_t) and Write(const void*, size_t) no longer block, but return the number of bytes actually transferred.
+///
+/// The UART clock is selected together with the baud rate divisor, so that baud rates up to 4 Mbaud can be used. The baud rate can be changed
+/// at runtime with SetBaudRate(), which first sends all pending data.
 /// </summary>
 class UART0 : public CharDevice
 {
@@ -69,18 +89,63 @@ private:
     IMemoryAccess& m_memoryAccess;
     /// @brief Baud rate set for this device
     unsigned m_baudRate;
+    /// @brief UART clock rate in Hz set for this device
+    uint32 m_baudClock;
+    /// @brief Deviation of the actual baud rate from m_baudRate in ppm
+    int m_baudRateError;
+    /// @brief Flags if transmit and receive are interrupt driven
+    bool m_isInterruptMode;
+    /// @brief Transmit ring buffer (interrupt mode)
+    uint8 m_txBuffer[UART0_TX_BUFFER_SIZE];
+    /// @brief Total number of bytes ever stored in the transmit buffer (free running, only changed by the writer)
+    uint32 m_txWriteCount;
+    /// @brief Total number of bytes ever taken from the transmit buffer (free running, only changed with IRQs disabled)
+    uint32 m_txReadCount;
+    /// @brief Receive ring buffer (interrupt mode)
+    uint8 m_rxBuffer[UART0_RX_BUFFER_SIZE];
+    /// @brief Total number of bytes ever stored in the receive buffer (free running, only changed by the interrupt handler)
+    uint32 m_rxWriteCount;
+    /// @brief Total number of bytes ever taken from the receive buffer (free running, only changed by the reader)
+    uint32 m_rxReadCount;
+    /// @brief Transfer and error statistics (interrupt mode)
+    UARTStatistics m_statistics;
 
     UART0();
 
 public:
     UART0(IMemoryAccess& memoryAccess);
+    ~UART0();
 
     void Initialize(unsigned baudrate);
     unsigned GetBaudRate() const;
+    bool SetBaudRate(unsigned baudrate);
+    int GetBaudRateError() const;
     char Read() override;
     void Write(char c) override;
+    ssize_t Read(void* buffer, size_t count) override;
+    ssize_t Write(const void* buffer, size_t count) override;
+    ssize_t WriteV(const IOVector* vectors, size_t vectorCount) override;
     void WriteString(const char* str);
     void Flush() override;
+
+    bool EnableInterruptMode();
+    void DisableInterruptMode();
+    bool IsInterruptMode() const;
+    size_t GetRxAvailable() const;
+    size_t GetTxFree() const;
+    const UARTStatistics& GetStatistics() const;
+    void ResetStatistics();
+    void InterruptHandler();
+
+private:
+    bool ApplyBaudRate(unsigned baudrate, uint32 baudClock, uint32 divisor, int errorPPM);
+    static void IRQHandler(void* param);
+    void ReceiveFromFIFO();
+    void TransmitToFIFO();
+    void StartTransmit();
+    bool PutTxByte(uint8 data);
+    void WriteToFIFO(const char* buffer, size_t count, size_t& fifoSpace);
+    size_t PutTxData(const char* buffer, size_t count);
 };
 
 UART0& GetUART0();
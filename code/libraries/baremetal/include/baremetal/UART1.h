@@ -40,20 +40,49 @@
 #pragma once
 
 #include "baremetal/CharDevice.h"
+#include "baremetal/UARTStatistics.h"
 
 /// @file
 /// Raspberry Pi UART1 serial device declaration
 
+/// @brief Size of the UART1 receive buffer in bytes used when the receive interrupt is enabled, must be a power of 2
+#ifndef UART1_RX_BUFFER_SIZE
+#define UART1_RX_BUFFER_SIZE 512
+#endif
+/// @brief Maximum length of a line in line assembly mode, including the terminating null character. Longer lines are truncated
+#ifndef UART1_LINE_SIZE
+#define UART1_LINE_SIZE 256
+#endif
+/// @brief Maximum deviation of the actual baud rate from the requested one in ppm. A baud rate which cannot be reached within this limit is rejected
+#ifndef UART1_MAX_BAUD_ERROR_PPM
+#define UART1_MAX_BAUD_ERROR_PPM 20000
+#endif
+
 /// @brief baremetal namespace
 namespace baremetal {
 
 class IMemoryAccess;
 
+/// <summary>
+/// Callback for a complete line received in line assembly mode. Called from the interrupt handler
+/// </summary>
+/// <param name="line">Received line, null terminated, without line ending</param>
+/// <param name="length">Length of the line in characters</param>
+/// <param name="param">Parameter passed to UART1::SetLineCallback()</param>
+using UART1LineCallback = void(const char* line, size_t length, void* param);
+
 /// <summary>
 /// Encapsulation for the UART1 device.
 ///
 /// This is a pseudo singleton, in that it is not possible to create a default instance (GetUART1() needs to be used for this),
 /// but it is possible to create an instance with a custom IMemoryAccess instance for testing.
+///
+/// By default the device is polled. After EnableReceiveInterrupt() received data is collected by the AUX interrupt into a ring buffer, so the
+/// 8 byte receive FIFO no longer overflows when nobody is reading. Read(void*, size_t) then returns the bytes received so far without waiting.
+/// With a line callback set (SetLineCallback()), received data is instead assembled into lines, and every complete line is passed to the callback.
+///
+/// The baud rate is derived from the core clock, the divisor is rounded to the nearest value. The baud rate can be changed at runtime with
+/// SetBaudrate(), which first waits until all pending data is sent.
 /// </summary>
 class UART1 : public CharDevice
 {
@@ -70,18 +99,62 @@ private:
     IMemoryAccess& m_memoryAccess;
     /// @brief Baudrate set for device
     unsigned m_baudrate;
+    /// @brief Deviation of the actual baud rate from m_baudrate in ppm
+    int m_baudrateError;
+    /// @brief Flags if receive is interrupt driven
+    bool m_isReceiveInterruptEnabled;
+    /// @brief Receive ring buffer
+    uint8 m_rxBuffer[UART1_RX_BUFFER_SIZE];
+    /// @brief Total number of bytes ever stored in the receive buffer (free running, only changed by the interrupt handler)
+    uint32 m_rxWriteCount;
+    /// @brief Total number of bytes ever taken from the receive buffer (free running, only changed by the reader)
+    uint32 m_rxReadCount;
+    /// @brief Callback for complete lines, if set line assembly mode is active
+    UART1LineCallback* m_lineCallback;
+    /// @brief Parameter passed to line callback
+    void* m_lineCallbackParam;
+    /// @brief Line being assembled
+    char m_line[UART1_LINE_SIZE];
+    /// @brief Number of characters in m_line
+    size_t m_lineLength;
+    /// @brief Flags the line being assembled was truncated
+    bool m_lineOverflow;
+    /// @brief Flags the last character received was a carriage return, so that a following newline does not end another line
+    bool m_lastWasCarriageReturn;
+    /// @brief Receive and error statistics
+    UARTStatistics m_statistics;
 
     UART1();
 
 public:
     UART1(IMemoryAccess& memoryAccess);
+    ~UART1();
 
     void Initialize(unsigned baudrate);
     unsigned GetBaudrate() const;
+    bool SetBaudrate(unsigned baudrate);
+    int GetBaudrateError() const;
     char Read() override;
     void Write(char c) override;
+    ssize_t Read(void* buffer, size_t count) override;
+    ssize_t Write(const void* buffer, size_t count) override;
+    ssize_t WriteV(const IOVector* vectors, size_t vectorCount) override;
     void WriteString(const char* str);
     void Flush() override;
+
+    bool EnableReceiveInterrupt();
+    void DisableReceiveInterrupt();
+    bool IsReceiveInterruptEnabled() const;
+    void SetLineCallback(UART1LineCallback* callback, void* param);
+    size_t GetRxAvailable() const;
+    const UARTStatistics& GetStatistics() const;
+    void ResetStatistics();
+    void InterruptHandler();
+
+private:
+    static void IRQHandler(void* param);
+    void StoreReceivedByte(uint8 data);
+    void AssembleLine(char c);
 };
 
 UART1& GetUART1();
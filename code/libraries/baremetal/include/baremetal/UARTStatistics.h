@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : UARTStatistics.h
+//
+// Namespace   : baremetal
+//
+// Class       : UARTStatistics
+//
+// Description : UART transfer and error statistics
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "stdlib/Types.h"
+
+/// @file
+/// UART transfer and error statistics
+
+namespace baremetal {
+
+/// <summary>
+/// Transfer and error counters for an interrupt driven UART
+/// </summary>
+struct UARTStatistics
+{
+    /// @brief Number of bytes written to the transmit FIFO
+    uint64 bytesSent;
+    /// @brief Number of bytes read from the receive FIFO and stored in the receive buffer
+    uint64 bytesReceived;
+    /// @brief Number of interrupts handled
+    uint64 interruptCount;
+    /// @brief Number of writes that could not be (completely) stored as the transmit buffer was full
+    uint32 txBufferFull;
+    /// @brief Number of received bytes lost as the receive buffer was full
+    uint32 rxBufferOverrun;
+    /// @brief Number of receive FIFO overruns reported by the UART (bytes lost in hardware)
+    uint32 rxFIFOOverrun;
+    /// @brief Number of bytes received with framing error
+    uint32 framingErrors;
+    /// @brief Number of bytes received with parity error
+    uint32 parityErrors;
+    /// @brief Number of break conditions received
+    uint32 breakErrors;
+    /// @brief Number of received lines that did not fit in the line buffer and were truncated (line assembly mode)
+    uint32 lineOverflows;
+};
+
+} // namespace baremetal
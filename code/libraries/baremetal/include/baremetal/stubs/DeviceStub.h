@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : DeviceStub.h
+//
+// Namespace   : baremetal
+//
+// Class       : DeviceStub
+//
+// Description : Device stub collecting written data
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "baremetal/Device.h"
+
+/// @file
+/// DeviceStub
+
+/// @brief Maximum number of bytes written to the device kept by the device stub
+#ifndef DEVICE_STUB_DATA_SIZE
+#define DEVICE_STUB_DATA_SIZE 8192
+#endif
+
+namespace baremetal {
+
+class DeviceStub;
+
+/// <summary>
+/// Handler called by DeviceStub at the start of every write, e.g. to simulate an interrupt arriving while the device is written
+/// </summary>
+/// <param name="device">Device being written</param>
+/// <param name="param">Parameter passed to DeviceStub::SetWriteHandler()</param>
+using DeviceStubWriteHandler = void(DeviceStub& device, void* param);
+
+/// <summary>
+/// Character device stub, used as console device in tests.
+///
+/// Collects the bytes written to it, so that they can be checked with GetData() and Find(). Bytes written after the buffer is full are accepted but not kept.
+/// A gather write (WriteV()) counts as a single write. The number of bytes accepted per write can be limited with SetWriteLimit(), to simulate a non-blocking device with a full transmit buffer.
+/// </summary>
+class DeviceStub : public Device
+{
+private:
+    /// @brief Bytes written to the device
+    char m_data[DEVICE_STUB_DATA_SIZE];
+    /// @brief Number of valid bytes in m_data
+    size_t m_dataCount;
+    /// @brief Number of calls to Write() and WriteV()
+    size_t m_writeCount;
+    /// @brief Maximum number of bytes accepted by a single call to Write() or WriteV()
+    size_t m_writeLimit;
+    /// @brief Handler called at the start of every write
+    DeviceStubWriteHandler* m_writeHandler;
+    /// @brief Parameter for write handler
+    void* m_writeHandlerParam;
+
+public:
+    DeviceStub();
+
+    bool IsBlockDevice() override;
+    ssize_t Write(const void* buffer, size_t count) override;
+    ssize_t WriteV(const IOVector* vectors, size_t vectorCount) override;
+
+    void SetWriteLimit(size_t limit = static_cast<size_t>(-1));
+    void SetWriteHandler(DeviceStubWriteHandler* handler, void* param);
+    void Clear();
+    const char* GetData() const;
+    size_t GetDataCount() const;
+    size_t GetWriteCount() const;
+    ssize_t Find(const char* str, size_t start = 0) const;
+
+private:
+    void Store(const void* buffer, size_t count);
+};
+
+} // namespace baremetal
@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : MemoryAccessStubDMA.h
+//
+// Namespace   : baremetal
+//
+// Class       : MemoryAccessStubDMA
+//
+// Description : DMA controller stub
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "baremetal/DMAController.h"
+#include "baremetal/stubs/MemoryAccessStubMailbox.h"
+
+/// @file
+/// MemoryAccessStubDMA
+
+/// @brief Maximum number of bytes written to peripherals kept by the DMA stub
+#define DMA_STUB_PERIPHERAL_DATA_SIZE 4096
+
+namespace baremetal {
+
+/// @brief DMA channel registers storage
+struct DMAChannelRegisters
+{
+    /// @brief Control and Status register (CS)
+    uint32 ControlStatus;
+    /// @brief Control Block Address register (CONBLK_AD)
+    uint32 ControlBlockAddress;
+    /// @brief Number of control blocks executed since the last reset
+    uint32 ControlBlockCount;
+};
+
+/// <summary>
+/// MemoryAccess implementation for DMA controller stub
+///
+/// Simulates DMA channels 0-14 by executing the control block chain when a channel is activated, either immediately (the default) or
+/// when the test calls CompleteTransfers(), so that busy and interrupt behaviour can be tested. Memory to memory transfers are executed
+/// on the real memory, bytes written to a peripheral are collected and can be retrieved with GetPeripheralData(), bytes read from a
+/// peripheral are taken from the buffer set with SetPeripheralReadData(). Transfer errors can be simulated with SetTransferError().
+/// Property mailbox requests and GPIO register accesses are handled by MemoryAccessStubMailbox.
+/// </summary>
+class MemoryAccessStubDMA : public MemoryAccessStubMailbox
+{
+private:
+    /// @brief Storage for DMA channel registers
+    DMAChannelRegisters m_channels[DMA_CHANNELS];
+    /// @brief Global enable register
+    uint32 m_enable;
+    /// @brief Flags that transfers are executed as soon as a channel is activated
+    bool m_autoComplete;
+    /// @brief Flags that transfers end with an error
+    bool m_transferError;
+    /// @brief Bytes written to peripherals
+    uint8 m_peripheralData[DMA_STUB_PERIPHERAL_DATA_SIZE];
+    /// @brief Number of valid bytes in m_peripheralData
+    size_t m_peripheralDataCount;
+    /// @brief Bytes returned for reads from peripherals
+    const uint8* m_peripheralReadData;
+    /// @brief Number of bytes in m_peripheralReadData
+    size_t m_peripheralReadSize;
+    /// @brief Number of bytes read from m_peripheralReadData
+    size_t m_peripheralReadCount;
+
+public:
+    MemoryAccessStubDMA();
+
+    uint32 Read32(regaddr address) override;
+    void Write32(regaddr address, uint32 data) override;
+
+    void SetAutoComplete(bool autoComplete);
+    void CompleteTransfers();
+    void SetTransferError(bool transferError);
+    uint32 GetControlBlockCount(uint32 channel) const;
+    const uint8* GetPeripheralData() const;
+    size_t GetPeripheralDataCount() const;
+    void SetPeripheralReadData(const void* data, size_t size);
+
+private:
+    void RunChannel(uint32 channel);
+    void ExecuteControlBlock(const DMAControlBlock& controlBlock);
+    uint8 ReadByte(uint32 busAddress, uint32 offset, uint32 transferInformation);
+    void WriteByte(uint32 busAddress, uint32 offset, uint32 transferInformation, uint8 data);
+};
+
+} // namespace baremetal
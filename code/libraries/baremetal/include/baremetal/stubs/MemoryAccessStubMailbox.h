@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : MemoryAccessStubMailbox.h
+//
+// Namespace   : baremetal
+//
+// Class       : MemoryAccessStubMailbox
+//
+// Description : Memory access stub answering property mailbox requests
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "baremetal/RPIProperties.h"
+#include "baremetal/stubs/MemoryAccessStubGPIO.h"
+
+/// @file
+/// MemoryAccessStubMailbox
+
+/// @brief Number of clocks for which the stub keeps a clock rate (clock IDs 0 up to and including ClockID::EMMC2)
+#define MAILBOX_STUB_CLOCK_COUNT 13
+/// @brief DMA channels reported as usable by the stub (the set the firmware normally reports)
+#define MAILBOX_STUB_DMA_CHANNELS 0x7F35
+
+namespace baremetal {
+
+/// <summary>
+/// MemoryAccess implementation for property mailbox stub
+///
+/// Answers all property mailbox requests with success without changing any value, so that device initialization which sets clocks can run
+/// against a stub. The exception are clock rates: a rate set is remembered and returned when the clock rate is requested, after being
+/// limited to the maximum set with SetMaxClockRate(), and the DMA channel mask request returns MAILBOX_STUB_DMA_CHANNELS.
+/// GPIO register accesses are handled by MemoryAccessStubGPIO. Used as base class for device stubs.
+/// </summary>
+class MemoryAccessStubMailbox : public MemoryAccessStubGPIO
+{
+private:
+    /// @brief Last value written to the property mailbox
+    uint32 m_mailboxData;
+    /// @brief Flags a property mailbox response is waiting to be read
+    bool m_mailboxResponsePending;
+    /// @brief Current clock rate in Hz for each clock
+    uint32 m_clockRates[MAILBOX_STUB_CLOCK_COUNT];
+    /// @brief Maximum clock rate in Hz the stub sets for each clock, 0 for no limit
+    uint32 m_maxClockRates[MAILBOX_STUB_CLOCK_COUNT];
+
+public:
+    MemoryAccessStubMailbox();
+
+    uint32 Read32(regaddr address) override;
+    void Write32(regaddr address, uint32 data) override;
+
+    uint32 GetClockRate(ClockID clockID) const;
+    void SetMaxClockRate(ClockID clockID, uint32 rate);
+
+private:
+    void HandleMailboxWrite(uint32 data);
+};
+
+} // namespace baremetal
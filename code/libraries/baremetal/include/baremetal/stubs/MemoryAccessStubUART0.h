@@ -0,0 +1,141 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : MemoryAccessStubUART0.h
+//
+// Namespace   : baremetal
+//
+// Class       : MemoryAccessStubUART0
+//
+// Description : Memory access stub for UART0 (PL011)
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "baremetal/BCMRegisters.h"
+#include "baremetal/mocks/FIFO.h"
+#include "baremetal/stubs/MemoryAccessStubMailbox.h"
+
+/// @file
+/// MemoryAccessStubUART0
+
+/// @brief Maximum number of transmitted bytes kept by the UART0 stub
+#define UART0_STUB_LINE_SIZE 4096
+
+namespace baremetal {
+
+/// @brief UART0 registers storage
+struct UART0Registers
+{
+    /// @brief UART0 Integer Baud Rate Divisor Register (IBRD)
+    uint32 IntegerBaudRateDivisor;
+    /// @brief UART0 Fractional Baud Rate Divisor Register (FBRD)
+    uint32 FractionalBaudRateDivisor;
+    /// @brief UART0 Line Control Register (LCRH)
+    uint32 LineControl;
+    /// @brief UART0 Control Register (CR)
+    uint32 Control;
+    /// @brief UART0 Interrupt FIFO Level Select Register (IFLS)
+    uint32 InterruptFIFOLevelSelect;
+    /// @brief UART0 Interrupt Mask Set/Clear Register (IMSC)
+    uint32 InterruptMask;
+    /// @brief UART0 latched error interrupt status bits (part of RIS)
+    uint32 ErrorInterruptStatus;
+    /// @brief UART0 DMA Control Register (DMACR)
+    uint32 DMAControl;
+
+    /// <summary>
+    /// Constructor for UART0Registers
+    ///
+    /// Sets default register values
+    /// </summary>
+    UART0Registers()
+        : IntegerBaudRateDivisor{}
+        , FractionalBaudRateDivisor{}
+        , LineControl{}
+        , Control{0x00000300}
+        , InterruptFIFOLevelSelect{0x00000012}
+        , InterruptMask{}
+        , ErrorInterruptStatus{}
+        , DMAControl{}
+    {
+    }
+};
+
+/// <summary>
+/// MemoryAccess implementation for UART0 stub
+///
+/// Simulates the PL011 FIFOs, flag register and FIFO level interrupt status, so that a UART0 instance can be tested in polled and interrupt mode.
+/// The test pushes bytes onto the line with ReceiveData() and takes bytes off the line with TransmitData(). Property mailbox requests (used to set the
+/// UART clock) and GPIO register accesses are handled by MemoryAccessStubMailbox.
+/// </summary>
+class MemoryAccessStubUART0 : public MemoryAccessStubMailbox
+{
+private:
+    /// @brief Storage for UART0 registers
+    UART0Registers m_registers;
+    /// @brief Receive FIFO data
+    FIFO<RPI_UART0_FIFO_SIZE> m_rxFifo;
+    /// @brief Receive FIFO error flags (DR bits 8..11 shifted down by 8), kept in lockstep with m_rxFifo
+    FIFO<RPI_UART0_FIFO_SIZE> m_rxFifoErrors;
+    /// @brief Transmit FIFO
+    FIFO<RPI_UART0_FIFO_SIZE> m_txFifo;
+    /// @brief Flags a receive overrun, reported with the next byte entering the receive FIFO
+    bool m_rxOverrunPending;
+    /// @brief Bytes taken off the line by TransmitData()
+    uint8 m_txData[UART0_STUB_LINE_SIZE];
+    /// @brief Number of valid bytes in m_txData
+    size_t m_txDataCount;
+
+public:
+    MemoryAccessStubUART0();
+
+    uint8 Read8(regaddr address) override;
+    void Write8(regaddr address, uint8 data) override;
+
+    uint16 Read16(regaddr address) override;
+    void Write16(regaddr address, uint16 data) override;
+
+    uint32 Read32(regaddr address) override;
+    void Write32(regaddr address, uint32 data) override;
+
+    size_t ReceiveData(const void* data, size_t count, uint32 errorFlags = 0);
+    size_t TransmitData(size_t maxCount = UART0_STUB_LINE_SIZE);
+    const uint8* GetTransmittedData() const;
+    size_t GetTransmittedCount() const;
+    void ClearTransmittedData();
+
+private:
+    uint32 GetFlags();
+    uint32 GetRawInterruptStatus();
+    uint32 ReadData();
+};
+
+} // namespace baremetal
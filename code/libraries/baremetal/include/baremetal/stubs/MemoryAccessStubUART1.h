@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : MemoryAccessStubUART1.h
+//
+// Namespace   : baremetal
+//
+// Class       : MemoryAccessStubUART1
+//
+// Description : Memory access stub for UART1 (mini UART)
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#pragma once
+
+#include "baremetal/BCMRegisters.h"
+#include "baremetal/mocks/FIFO.h"
+#include "baremetal/stubs/MemoryAccessStubMailbox.h"
+
+/// @file
+/// MemoryAccessStubUART1
+
+/// @brief Maximum number of transmitted bytes kept by the UART1 stub
+#define UART1_STUB_LINE_SIZE 1024
+
+namespace baremetal {
+
+/// @brief UART1 (mini UART) registers storage
+struct UART1Registers
+{
+    /// @brief Auxiliary Enable Register (AUXENB)
+    uint32 AuxEnables;
+    /// @brief Mini UART Interrupt Enable Register (AUX_MU_IER)
+    uint32 InterruptEnable;
+    /// @brief Mini UART Line Control Register (AUX_MU_LCR)
+    uint32 LineControl;
+    /// @brief Mini UART Modem Control Register (AUX_MU_MCR)
+    uint32 ModemControl;
+    /// @brief Mini UART Extra Control Register (AUX_MU_CNTL)
+    uint32 ExtraControl;
+    /// @brief Mini UART Baudrate Register (AUX_MU_BAUD)
+    uint32 Baudrate;
+
+    /// <summary>
+    /// Constructor for UART1Registers
+    ///
+    /// Sets default register values
+    /// </summary>
+    UART1Registers()
+        : AuxEnables{}
+        , InterruptEnable{}
+        , LineControl{}
+        , ModemControl{}
+        , ExtraControl{0x00000003}
+        , Baudrate{}
+    {
+    }
+};
+
+/// <summary>
+/// MemoryAccess implementation for UART1 stub
+///
+/// Simulates the mini UART FIFOs, line status, extra status and the UART1 bit of the AUX interrupt register, so that a UART1 instance can be
+/// tested in polled and interrupt mode. The test pushes bytes onto the line with ReceiveData() and takes bytes off the line with TransmitData().
+/// Property mailbox requests and GPIO register accesses are handled by MemoryAccessStubMailbox.
+/// </summary>
+class MemoryAccessStubUART1 : public MemoryAccessStubMailbox
+{
+private:
+    /// @brief Storage for UART1 registers
+    UART1Registers m_registers;
+    /// @brief Receive FIFO
+    FIFO<RPI_AUX_MU_FIFO_SIZE> m_rxFifo;
+    /// @brief Transmit FIFO
+    FIFO<RPI_AUX_MU_FIFO_SIZE> m_txFifo;
+    /// @brief Flags a receive overrun, cleared when reading the line status register
+    bool m_rxOverrun;
+    /// @brief Bytes taken off the line by TransmitData()
+    uint8 m_txData[UART1_STUB_LINE_SIZE];
+    /// @brief Number of valid bytes in m_txData
+    size_t m_txDataCount;
+
+public:
+    MemoryAccessStubUART1();
+
+    uint8 Read8(regaddr address) override;
+    void Write8(regaddr address, uint8 data) override;
+
+    uint16 Read16(regaddr address) override;
+    void Write16(regaddr address, uint16 data) override;
+
+    uint32 Read32(regaddr address) override;
+    void Write32(regaddr address, uint32 data) override;
+
+    size_t ReceiveData(const void* data, size_t count);
+    size_t TransmitData(size_t maxCount = UART1_STUB_LINE_SIZE);
+    const uint8* GetTransmittedData() const;
+    size_t GetTransmittedCount() const;
+
+private:
+    uint32 GetLineStatus();
+    uint32 GetExtraStatus();
+};
+
+} // namespace baremetal
@@ -0,0 +1,322 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : AsyncMemory.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : AsyncMemory
+//
+// Description : Asynchronous memory copy and fill, offloaded to DMA
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/AsyncMemory.h"
+
+#include "stdlib/Util.h"
+
+/// @file
+/// Asynchronous memory copy and fill, offloaded to DMA implementation
+
+namespace baremetal {
+
+/// @brief Alignment for which the DMA engine can use 128 bit wide bursts
+static const uintptr WideAlignment = 16;
+/// @brief Number of operations for which the result is kept, the number of bits in AsyncMemory::m_failureHistory
+static const uint32 FailureHistorySize = 64;
+
+/// <summary>
+/// Constructs a handle for a submitted operation
+/// </summary>
+/// <param name="owner">Instance the operation was submitted to</param>
+/// <param name="sequence">Sequence number of the operation</param>
+AsyncMemoryHandle::AsyncMemoryHandle(AsyncMemory* owner, uint32 sequence)
+    : m_owner{owner}
+    , m_sequence{sequence}
+{
+}
+
+/// <summary>
+/// Constructs a handle for an operation that has completed
+/// </summary>
+AsyncMemoryHandle::AsyncMemoryHandle()
+    : m_owner{}
+    , m_sequence{}
+{
+}
+
+/// <summary>
+/// Check whether the operation has completed, without waiting
+/// </summary>
+/// <returns>True if the operation has completed</returns>
+bool AsyncMemoryHandle::IsDone() const
+{
+    return (m_owner == nullptr) || m_owner->IsDone(m_sequence);
+}
+
+/// <summary>
+/// Wait for the operation to complete
+/// </summary>
+/// <returns>True if the operation completed successfully, false if the DMA transfer failed</returns>
+bool AsyncMemoryHandle::Wait() const
+{
+    return (m_owner == nullptr) || m_owner->Wait(m_sequence);
+}
+
+/// <summary>
+/// Constructs an AsyncMemory instance, allocating a DMA channel. If no channel is available, all operations are performed by the CPU
+/// </summary>
+/// <param name="type">Type of DMA channel to use. DMA Lite channels have less bandwidth and do not support 2D copies</param>
+/// <param name="controller">DMA controller to allocate the channel from</param>
+AsyncMemory::AsyncMemory(DMAChannelType type, DMAController& controller)
+    : m_channel{type, controller}
+    , m_threshold{ASYNC_MEMORY_DMA_THRESHOLD}
+    , m_submittedSequence{}
+    , m_completedSequence{}
+    , m_failureHistory{}
+    , m_olderFailure{}
+    , m_fillPattern{}
+{
+}
+
+/// <summary>
+/// Set the minimum size for operations performed by DMA
+/// </summary>
+/// <param name="threshold">Minimum size in bytes</param>
+void AsyncMemory::SetThreshold(size_t threshold)
+{
+    m_threshold = threshold;
+}
+
+/// <summary>
+/// Return the minimum size for operations performed by DMA
+/// </summary>
+/// <returns>Minimum size in bytes</returns>
+size_t AsyncMemory::GetThreshold() const
+{
+    return m_threshold;
+}
+
+/// <summary>
+/// Copy memory asynchronously. If source and destination have the same alignment, the unaligned head and tail are copied by the CPU,
+/// so that the DMA engine can use wide bursts for the rest
+/// </summary>
+/// <param name="destination">Destination buffer, below 1 Gb for DMA</param>
+/// <param name="source">Source buffer, below 1 Gb for DMA</param>
+/// <param name="length">Number of bytes to copy</param>
+/// <returns>Completion handle</returns>
+AsyncMemoryHandle AsyncMemory::AsyncCopy(void* destination, const void* source, size_t length)
+{
+    WaitAll();
+    if ((length < m_threshold) || !m_channel.IsAllocated())
+    {
+        memcpy(destination, source, length);
+        return Completed();
+    }
+
+    uint8* destinationBytes = reinterpret_cast<uint8*>(destination);
+    const uint8* sourceBytes = reinterpret_cast<const uint8*>(source);
+    if (((reinterpret_cast<uintptr>(destinationBytes) ^ reinterpret_cast<uintptr>(sourceBytes)) & (WideAlignment - 1)) == 0)
+    {
+        size_t head = MIN((WideAlignment - (reinterpret_cast<uintptr>(destinationBytes) & (WideAlignment - 1))) & (WideAlignment - 1), length);
+        memcpy(destinationBytes, sourceBytes, head);
+        destinationBytes += head;
+        sourceBytes += head;
+        length -= head;
+        size_t tail = length & (WideAlignment - 1);
+        length -= tail;
+        memcpy(destinationBytes + length, sourceBytes + length, tail);
+    }
+    if (length == 0)
+        return Completed();
+
+    m_channel.ClearControlBlocks();
+    if (!m_channel.AddMemoryCopy(destinationBytes, sourceBytes, length))
+    {
+        memcpy(destinationBytes, sourceBytes, length);
+        return Completed();
+    }
+    return StartDMA();
+}
+
+/// <summary>
+/// Fill memory asynchronously. The unaligned head and tail are filled by the CPU, so that the DMA engine can use wide bursts for the rest
+/// </summary>
+/// <param name="destination">Destination buffer, below 1 Gb for DMA</param>
+/// <param name="value">Value to fill with</param>
+/// <param name="length">Number of bytes to fill</param>
+/// <returns>Completion handle</returns>
+AsyncMemoryHandle AsyncMemory::AsyncFill(void* destination, uint8 value, size_t length)
+{
+    WaitAll();
+    if ((length < m_threshold) || !m_channel.IsAllocated())
+    {
+        memset(destination, value, length);
+        return Completed();
+    }
+
+    uint8* destinationBytes = reinterpret_cast<uint8*>(destination);
+    size_t head = MIN((WideAlignment - (reinterpret_cast<uintptr>(destinationBytes) & (WideAlignment - 1))) & (WideAlignment - 1), length);
+    memset(destinationBytes, value, head);
+    destinationBytes += head;
+    length -= head;
+    size_t tail = length & (WideAlignment - 1);
+    length -= tail;
+    memset(destinationBytes + length, value, tail);
+    if (length == 0)
+        return Completed();
+
+    // The previous operation has completed, so the pattern is no longer in use
+    memset(m_fillPattern, value, sizeof(m_fillPattern));
+    m_channel.ClearControlBlocks();
+    if (!m_channel.AddMemoryFill(destinationBytes, m_fillPattern, length))
+    {
+        memset(destinationBytes, value, length);
+        return Completed();
+    }
+    return StartDMA();
+}
+
+/// <summary>
+/// Copy a rectangle asynchronously, e.g. part of a framebuffer. Each of the height rows of width bytes is copied, after which source and
+/// destination are advanced by their pitch. If the DMA channel cannot handle the copy in 2D mode, the CPU copies the rows
+/// </summary>
+/// <param name="destination">Start of first destination row, below 1 Gb for DMA</param>
+/// <param name="destinationPitch">Distance between the start of destination rows in bytes</param>
+/// <param name="source">Start of first source row, below 1 Gb for DMA</param>
+/// <param name="sourcePitch">Distance between the start of source rows in bytes</param>
+/// <param name="width">Number of bytes to copy per row</param>
+/// <param name="height">Number of rows to copy</param>
+/// <returns>Completion handle</returns>
+AsyncMemoryHandle AsyncMemory::AsyncCopy2D(void* destination, size_t destinationPitch, const void* source, size_t sourcePitch, size_t width,
+                                           size_t height)
+{
+    WaitAll();
+    if ((width * height >= m_threshold) && m_channel.IsAllocated())
+    {
+        m_channel.ClearControlBlocks();
+        if (m_channel.AddMemoryCopy2D(destination, destinationPitch, source, sourcePitch, width, height))
+            return StartDMA();
+    }
+
+    uint8* destinationBytes = reinterpret_cast<uint8*>(destination);
+    const uint8* sourceBytes = reinterpret_cast<const uint8*>(source);
+    for (size_t row = 0; row < height; ++row)
+    {
+        memcpy(destinationBytes, sourceBytes, width);
+        destinationBytes += destinationPitch;
+        sourceBytes += sourcePitch;
+    }
+    return Completed();
+}
+
+/// <summary>
+/// Wait until all submitted operations have completed
+/// </summary>
+void AsyncMemory::WaitAll()
+{
+    FinishDMA();
+}
+
+/// <summary>
+/// Check whether an operation has completed, without waiting
+/// </summary>
+/// <param name="sequence">Sequence number of the operation</param>
+/// <returns>True if the operation has completed</returns>
+bool AsyncMemory::IsDone(uint32 sequence)
+{
+    if (static_cast<int32>(sequence - m_completedSequence) <= 0)
+        return true;
+    if (m_channel.IsBusy())
+        return false;
+    FinishDMA();
+    return true;
+}
+
+/// <summary>
+/// Wait for an operation to complete
+/// </summary>
+/// <param name="sequence">Sequence number of the operation</param>
+/// <returns>True if the operation completed successfully</returns>
+bool AsyncMemory::Wait(uint32 sequence)
+{
+    if (static_cast<int32>(sequence - m_completedSequence) > 0)
+        FinishDMA();
+    uint32 age = m_completedSequence - sequence;
+    if (age >= FailureHistorySize)
+        return !m_olderFailure;
+    return (m_failureHistory & (uint64{1} << age)) == 0;
+}
+
+/// <summary>
+/// Register an operation performed by the CPU, which has completed already
+/// </summary>
+/// <returns>Completion handle</returns>
+AsyncMemoryHandle AsyncMemory::Completed()
+{
+    ++m_submittedSequence;
+    RecordResult(true);
+    return AsyncMemoryHandle(this, m_submittedSequence);
+}
+
+/// <summary>
+/// Start the DMA transfer set up in the channel
+/// </summary>
+/// <returns>Completion handle</returns>
+AsyncMemoryHandle AsyncMemory::StartDMA()
+{
+    ++m_submittedSequence;
+    if (!m_channel.Start())
+        RecordResult(false);
+    return AsyncMemoryHandle(this, m_submittedSequence);
+}
+
+/// <summary>
+/// Wait for the DMA transfer in flight, if any, and record its result
+/// </summary>
+void AsyncMemory::FinishDMA()
+{
+    if (m_completedSequence == m_submittedSequence)
+        return;
+    RecordResult(m_channel.Wait());
+}
+
+/// <summary>
+/// Mark the last operation submitted as completed, and record its result. Operations complete one at a time, in order
+/// </summary>
+/// <param name="success">True if the operation completed successfully</param>
+void AsyncMemory::RecordResult(bool success)
+{
+    if (m_failureHistory & (uint64{1} << (FailureHistorySize - 1)))
+        m_olderFailure = true;
+    m_failureHistory = (m_failureHistory << 1) | (success ? 0 : 1);
+    m_completedSequence = m_submittedSequence;
+}
+
+} // namespace baremetal
@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : Clock.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : Clock
+//
+// Description : Monotonic high resolution clock
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/Clock.h"
+
+/// @file
+/// Monotonic high resolution clock implementation
+
+namespace baremetal {
+
+uint64 Clock::s_nanoSecondsPerCycle{};
+uint64 Clock::s_cyclesPerNanoSecond{};
+uint64 Clock::s_eventPeriodCycles{};
+
+/// <summary>
+/// Compute the conversion factors from the counter frequency. Called on first use, can be called explicitly to keep the first conversion short
+/// </summary>
+void Clock::Initialize()
+{
+    uint64 frequency = GetFrequency();
+    s_cyclesPerNanoSecond = static_cast<uint64>(((static_cast<unsigned __int128>(frequency) << 64) + NSEC_PER_SEC - 1) / NSEC_PER_SEC);
+    s_nanoSecondsPerCycle = static_cast<uint64>(((static_cast<unsigned __int128>(NSEC_PER_SEC) << 32) + frequency - 1) / frequency);
+}
+
+/// <summary>
+/// Return the counter frequency
+/// </summary>
+/// <returns>Counter frequency in Hz</returns>
+uint64 Clock::GetFrequency()
+{
+    uint64 frequency;
+    GetTimerFrequency(frequency);
+    return frequency;
+}
+
+/// <summary>
+/// Sleep for the specified duration. See WaitUntil()
+/// </summary>
+/// <param name="duration">Time to wait, nothing is done if zero or negative</param>
+void Clock::Wait(const Duration& duration)
+{
+    if (duration.NanoSeconds() <= 0)
+        return;
+    WaitUntil(TimePoint(Cycles() + NanoSecondsToCycles(static_cast<uint64>(duration.NanoSeconds()))));
+}
+
+/// <summary>
+/// Sleep until the specified time. The core waits for events (WFE) while more than one event period remains, and spins for the remainder.
+/// </summary>
+/// <param name="deadline">Time to wait for</param>
+void Clock::WaitUntil(const TimePoint& deadline)
+{
+    EnableEventStream();
+
+    uint64 end = deadline.Cycles();
+    uint64 now = Cycles();
+    // An event arrives at least once per event period, so the core never sleeps past the deadline
+    while (static_cast<int64>(end - now) > static_cast<int64>(s_eventPeriodCycles))
+    {
+        WaitForEvent();
+        now = Cycles();
+    }
+    while (static_cast<int64>(end - now) > 0)
+    {
+        now = Cycles();
+    }
+}
+
+/// <summary>
+/// Return the period of the timer event stream, which is the granularity with which waiting cores are woken up
+/// </summary>
+/// <returns>Event stream period</returns>
+Duration Clock::GetEventPeriod()
+{
+    EnableEventStream();
+    return Duration(static_cast<int64>(CyclesToNanoSeconds(s_eventPeriodCycles)));
+}
+
+/// <summary>
+/// Enable the timer event stream on the current core, if not enabled yet. The event stream is a per core setting
+/// </summary>
+void Clock::EnableEventStream()
+{
+    uint64 control;
+    GetTimerKernelControl(control);
+    if ((control & CNTKCTL_EL1_EVNTEN) && (s_eventPeriodCycles != 0))
+        return;
+
+    uint64 targetCycles = NanoSecondsToCycles(CLOCK_EVENT_STREAM_PERIOD_USEC * NSEC_PER_USEC);
+    unsigned bit = 0;
+    while ((bit < 15) && ((1ULL << (bit + 2)) <= targetCycles))
+        bit++;
+    control = (control & ~CNTKCTL_EL1_EVNTI_MASK) | CNTKCTL_EL1_EVNTI(bit) | CNTKCTL_EL1_EVNTEN;
+    SetTimerKernelControl(control);
+    InstructionSyncBarrier();
+    s_eventPeriodCycles = 1ULL << (bit + 1);
+}
+
+} // namespace baremetal
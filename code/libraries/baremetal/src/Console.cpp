@@ -39,8 +39,8 @@
 
 #include "baremetal/Console.h"
 
+#include "baremetal/ARMInstructions.h"
 #include "baremetal/Serialization.h"
-#include "baremetal/Timer.h"
 #include "baremetal/UART0.h"
 #include "baremetal/UART1.h"
 #include "stdlib/Util.h"
@@ -88,17 +88,83 @@ static const char* GetAnsiColorCode(ConsoleColor color)
     };
 }
 
+/// <summary>
+/// Header of a record in the console output queue. The data follows the header, the record is padded to a multiple of 8 bytes
+/// </summary>
+struct ConsoleQueueRecordHeader
+{
+    /// @brief Record state, one of the RecordState... values
+    volatile uint32 state;
+    /// @brief Number of data bytes following the header
+    uint32 length;
+};
+
+/// @brief Record is reserved but not yet complete, or has been written to the device
+static constexpr uint32 RecordStateEmpty = 0;
+/// @brief Record is complete and can be written to the device
+static constexpr uint32 RecordStateReady = 1;
+/// @brief Record only fills up the end of the queue, and is skipped by the consumer
+static constexpr uint32 RecordStatePadding = 2;
+
+static_assert((CONSOLE_QUEUE_SIZE & (CONSOLE_QUEUE_SIZE - 1)) == 0, "CONSOLE_QUEUE_SIZE must be a power of 2");
+
+/// <summary>
+/// Determine the size of a queue record holding the specified number of data bytes
+/// </summary>
+/// <param name="length">Number of data bytes</param>
+/// <returns>Record size including header and padding</returns>
+static uint32 RecordSize(size_t length)
+{
+    return static_cast<uint32>((sizeof(ConsoleQueueRecordHeader) + length + 7) & ~static_cast<size_t>(7));
+}
+
+/// <summary>
+/// Build the ANSI escape sequence for the specified foreground and background color
+/// </summary>
+/// <param name="buffer">Buffer to receive the escape sequence</param>
+/// <param name="bufferSize">Size of the buffer</param>
+/// <param name="foregroundColor">Foreground color to use. Default brings the color back to the color originally set</param>
+/// <param name="backgroundColor">Background color to use. Default brings the color back to the color originally set</param>
+static void FormatTerminalColor(char* buffer, size_t bufferSize, ConsoleColor foregroundColor, ConsoleColor backgroundColor)
+{
+    buffer[0] = '\0';
+    strncat(buffer, "\033[0", bufferSize);
+    if (foregroundColor != ConsoleColor::Default)
+    {
+        strncat(buffer, (foregroundColor <= ConsoleColor::LightGray) ? ";3" : ";9", bufferSize);
+        strncat(buffer, GetAnsiColorCode(foregroundColor), bufferSize);
+    }
+    if (backgroundColor != ConsoleColor::Default)
+    {
+        strncat(buffer, (backgroundColor <= ConsoleColor::LightGray) ? ";4" : ";10", bufferSize);
+        strncat(buffer, GetAnsiColorCode(backgroundColor), bufferSize);
+    }
+    strncat(buffer, "m", bufferSize);
+}
+
+/// @brief Size of buffer for an ANSI color escape sequence
+static constexpr size_t ColorCodeBufferSize = 16;
+/// @brief ANSI escape sequence to reset colors
+static const char ResetColorCode[] = "\033[0m";
+
 Console* Console::s_instance{};
 
 /// <summary>
-/// Create a console linked to the specified character device. Note that the constructor is private, so GetConsole() is needed to instantiate the console
+/// Create a console linked to the specified character device. The first console created becomes the singleton returned by GetConsole()
 /// </summary>
 /// <param name="device">Character device used for output</param>
 Console::Console(Device* device)
     : m_defaultDevice{device}
     , m_device{device}
+    , m_queue{}
+    , m_queueWriteCount{}
+    , m_queueReadCount{}
+    , m_isDraining{}
+    , m_droppedWriteCount{}
 {
-    s_instance = this;
+    // The first console created is the singleton, further instances (e.g. in tests) are independent
+    if (s_instance == nullptr)
+        s_instance = this;
 }
 
 /// <summary>
@@ -112,6 +178,15 @@ void Console::AssignDevice(Device* device)
         m_device = m_defaultDevice;
 }
 
+/// <summary>
+/// Return the attached device
+/// </summary>
+/// <returns>Character device used for output</returns>
+Device* Console::GetDevice() const
+{
+    return m_device;
+}
+
 /// <summary>
 /// Set console foreground and background color (will output ANSI color codes)
 /// </summary>
@@ -119,86 +194,415 @@ void Console::AssignDevice(Device* device)
 /// <param name="backgroundColor">Background color to use. Default brings the color back to the color originally set</param>
 void Console::SetTerminalColor(ConsoleColor foregroundColor /*= ConsoleColor::Default*/, ConsoleColor backgroundColor /*= ConsoleColor::Default*/)
 {
-    Write("\033[0");
-    if (foregroundColor != ConsoleColor::Default)
+    char colorCode[ColorCodeBufferSize];
+    FormatTerminalColor(colorCode, sizeof(colorCode), foregroundColor, backgroundColor);
+    Write(colorCode);
+}
+
+/// <summary>
+/// Reset console foreground and background back to original (will output ANSI color codes)
+/// </summary>
+void Console::ResetTerminalColor()
+{
+    SetTerminalColor();
+}
+
+/// <summary>
+/// Write a string, using the specified foreground and background color. The color codes and the string are written as one unit
+/// </summary>
+/// <param name="str">String to be written</param>
+/// <param name="foregroundColor">Foreground color to use. Default brings the color back to the color originally set</param>
+/// <param name="backgroundColor">Background color to use. Default brings the color back to the color originally set</param>
+void Console::Write(const char* str, ConsoleColor foregroundColor, ConsoleColor backgroundColor /*= ConsoleColor::Default*/)
+{
+    char colorCode[ColorCodeBufferSize];
+    FormatTerminalColor(colorCode, sizeof(colorCode), foregroundColor, backgroundColor);
+    Enqueue(colorCode, str, strlen(str), ResetColorCode, true);
+}
+
+/// <summary>
+/// Write a string, using the specified foreground and background color, if there is room in the output queue.
+///
+/// This never waits, so it can be used from interrupt context.
+/// </summary>
+/// <param name="str">String to be written</param>
+/// <param name="foregroundColor">Foreground color to use. Default brings the color back to the color originally set</param>
+/// <param name="backgroundColor">Background color to use. Default brings the color back to the color originally set</param>
+/// <returns>True if the string was written or queued, false if the output queue is full</returns>
+bool Console::TryWrite(const char* str, ConsoleColor foregroundColor, ConsoleColor backgroundColor /*= ConsoleColor::Default*/)
+{
+    char colorCode[ColorCodeBufferSize];
+    FormatTerminalColor(colorCode, sizeof(colorCode), foregroundColor, backgroundColor);
+    return Enqueue(colorCode, str, strlen(str), ResetColorCode, false);
+}
+
+/// <summary>
+/// Write a string without changing the foreground and background color
+/// </summary>
+/// <param name="str">String to be written</param>
+void Console::Write(const char* str)
+{
+    Enqueue("", str, strlen(str), "", true);
+}
+
+/// <summary>
+/// Write a number of bytes without changing the foreground and background color. The data may contain null characters
+/// </summary>
+/// <param name="data">Data to be written</param>
+/// <param name="count">Number of bytes to be written</param>
+void Console::Write(const char* data, size_t count)
+{
+    Enqueue("", data, count, "", true);
+}
+
+/// <summary>
+/// Write all queued output, and flush the device buffers
+/// </summary>
+void Console::Flush()
+{
+    Drain();
+    if (m_device != nullptr)
     {
-        if (foregroundColor <= ConsoleColor::LightGray)
+        m_device->Flush();
+    }
+}
+
+/// <summary>
+/// Return the number of writes dropped because the output queue was full and did not drain
+/// </summary>
+/// <returns>Number of dropped writes</returns>
+uint32 Console::GetDroppedWriteCount() const
+{
+    return m_droppedWriteCount;
+}
+
+/// <summary>
+/// Place a record consisting of prefix, data and suffix in the output queue, and write the queue to the device if no other writer is doing so.
+///
+/// Records larger than half the queue are written directly to the device after taking over the consumer role.
+/// </summary>
+/// <param name="prefix">Null terminated string to write before the data</param>
+/// <param name="data">Data to be written</param>
+/// <param name="count">Number of data bytes</param>
+/// <param name="suffix">Null terminated string to write after the data</param>
+/// <param name="wait">If true, wait for room in the queue while the consumer makes progress, if false, return false immediately if the queue is full</param>
+/// <returns>True if the record was written or queued, false if it was dropped</returns>
+bool Console::Enqueue(const char* prefix, const char* data, size_t count, const char* suffix, bool wait)
+{
+    size_t prefixLength = strlen(prefix);
+    size_t suffixLength = strlen(suffix);
+    size_t length = prefixLength + count + suffixLength;
+    if (length == 0)
+        return true;
+
+    // A record larger than half the queue may not fit at all, depending on where the padding record at the end of the queue ends up
+    if (RecordSize(length) > CONSOLE_QUEUE_SIZE / 2)
+    {
+        if (!AcquireConsumer(wait))
         {
-            Write(";3");
+            CountDroppedWrite();
+            return false;
         }
-        else
+        WriteRecords();
+        if (m_device != nullptr)
         {
-            Write(";9");
+            IOVector vectors[]{{prefix, prefixLength}, {data, count}, {suffix, suffixLength}};
+            WriteToDevice(vectors, sizeof(vectors) / sizeof(vectors[0]));
         }
-        Write(GetAnsiColorCode(foregroundColor));
+        ReleaseConsumer();
+        TryDrain();
+        return true;
     }
-    if (backgroundColor != ConsoleColor::Default)
+
+    uint32 offset{};
+    if (!Reserve(RecordSize(length), offset, wait))
+        return false;
+
+    auto header = reinterpret_cast<ConsoleQueueRecordHeader*>(&m_queue[offset]);
+    char* recordData = reinterpret_cast<char*>(header + 1);
+    memcpy(recordData, prefix, prefixLength);
+    memcpy(recordData + prefixLength, data, count);
+    memcpy(recordData + prefixLength + count, suffix, suffixLength);
+    header->length = static_cast<uint32>(length);
+    __atomic_store_n(&header->state, RecordStateReady, __ATOMIC_RELEASE);
+
+    TryDrain();
+    return true;
+}
+
+/// <summary>
+/// Reserve space for a record in the output queue. If the record does not fit before the end of the queue, a padding record is placed first.
+/// </summary>
+/// <param name="size">Record size including header and padding</param>
+/// <param name="offset">Offset of the reserved record in the queue</param>
+/// <param name="wait">If true, wait for room in the queue while the consumer makes progress, if false, return false immediately if the queue is full</param>
+/// <returns>True if the space was reserved, false if the queue is full</returns>
+bool Console::Reserve(size_t size, uint32& offset, bool wait)
+{
+    uint64 frequency{};
+    GetTimerFrequency(frequency);
+    uint64 stallTimeout = frequency * CONSOLE_QUEUE_STALL_TIMEOUT / 1000;
+    uint64 stallStart{};
+    GetTimerCounter(stallStart);
+    uint32 lastReadCount = __atomic_load_n(&m_queueReadCount, __ATOMIC_ACQUIRE);
+
+    for (;;)
     {
-        if (backgroundColor <= ConsoleColor::LightGray)
+        // Exclusive load/store (and so compare-and-swap) is not reliable on Device memory, which all memory is while the MMU is off.
+        // There is only one core running, so the reservation is made with IRQs disabled instead
+        uint64 daif;
+        GetDAIF(daif);
+        DisableIRQs();
+        uint32 writeCount = m_queueWriteCount;
+        uint32 readCount = __atomic_load_n(&m_queueReadCount, __ATOMIC_ACQUIRE);
+        uint32 position = writeCount % CONSOLE_QUEUE_SIZE;
+        uint32 spaceAtEnd = CONSOLE_QUEUE_SIZE - position;
+        uint32 total = (size > spaceAtEnd) ? spaceAtEnd + static_cast<uint32>(size) : static_cast<uint32>(size);
+        if (writeCount + total - readCount <= CONSOLE_QUEUE_SIZE)
         {
-            Write(";4");
+            __atomic_store_n(&m_queueWriteCount, writeCount + total, __ATOMIC_RELEASE);
+            SetDAIF(daif);
+            if (total != size)
+            {
+                auto padding = reinterpret_cast<ConsoleQueueRecordHeader*>(&m_queue[position]);
+                padding->length = spaceAtEnd - sizeof(ConsoleQueueRecordHeader);
+                __atomic_store_n(&padding->state, RecordStatePadding, __ATOMIC_RELEASE);
+                position = 0;
+            }
+            offset = position;
+            return true;
         }
-        else
+        SetDAIF(daif);
+
+        TryDrain();
+        // If another writer is draining, or the oldest record is still being filled, and that writer is the context we interrupted, there will be no
+        // progress until we give up
+        readCount = __atomic_load_n(&m_queueReadCount, __ATOMIC_ACQUIRE);
+        uint64 now{};
+        GetTimerCounter(now);
+        if (readCount != lastReadCount)
         {
-            Write(";10");
+            lastReadCount = readCount;
+            stallStart = now;
+        }
+        else if (!wait || (now - stallStart > stallTimeout))
+        {
+            CountDroppedWrite();
+            return false;
         }
-        Write(GetAnsiColorCode(backgroundColor));
     }
-    Write("m");
 }
 
 /// <summary>
-/// Reset console foreground and background back to original (will output ANSI color codes)
+/// Take the consumer role of the queue.
+///
+/// When waiting, the wait ends if the current consumer makes no progress within CONSOLE_QUEUE_STALL_TIMEOUT milliseconds, as the current consumer may be the
+/// context interrupted by the caller.
 /// </summary>
-void Console::ResetTerminalColor()
+/// <param name="wait">If true, wait for the current consumer to finish, if false, return false immediately if there is a consumer</param>
+/// <returns>True if the consumer role was taken, false otherwise</returns>
+bool Console::AcquireConsumer(bool wait)
 {
-    SetTerminalColor();
+    if (TryAcquireConsumer())
+        return true;
+    if (!wait)
+        return false;
+
+    uint64 frequency{};
+    GetTimerFrequency(frequency);
+    uint64 stallTimeout = frequency * CONSOLE_QUEUE_STALL_TIMEOUT / 1000;
+    uint64 stallStart{};
+    GetTimerCounter(stallStart);
+    uint32 lastReadCount = __atomic_load_n(&m_queueReadCount, __ATOMIC_ACQUIRE);
+    while (!TryAcquireConsumer())
+    {
+        uint64 now{};
+        GetTimerCounter(now);
+        uint32 readCount = __atomic_load_n(&m_queueReadCount, __ATOMIC_ACQUIRE);
+        if (readCount != lastReadCount)
+        {
+            lastReadCount = readCount;
+            stallStart = now;
+        }
+        else if (now - stallStart > stallTimeout)
+            return false;
+    }
+    return true;
 }
 
 /// <summary>
-/// Write a string, using the specified foreground and background color
+/// Take the consumer role of the queue if no other writer has it. The flag is tested and set with IRQs disabled, as exclusive load/store is not reliable
+/// on Device memory (the MMU is off), and only one core is running
 /// </summary>
-/// <param name="str">String to be written</param>
-/// <param name="foregroundColor">Foreground color to use. Default brings the color back to the color originally set</param>
-/// <param name="backgroundColor">Background color to use. Default brings the color back to the color originally set</param>
-void Console::Write(const char* str, ConsoleColor foregroundColor, ConsoleColor backgroundColor /*= ConsoleColor::Default*/)
+/// <returns>True if the consumer role was taken, false if another writer is the consumer</returns>
+bool Console::TryAcquireConsumer()
+{
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    bool isAcquired = !m_isDraining;
+    m_isDraining = true;
+    SetDAIF(daif);
+    return isAcquired;
+}
+
+/// <summary>
+/// Give up the consumer role of the queue
+/// </summary>
+void Console::ReleaseConsumer()
+{
+    __atomic_store_n(&m_isDraining, false, __ATOMIC_RELEASE);
+}
+
+/// <summary>
+/// Count a (partly) dropped write. Incremented with IRQs disabled, as writers in interrupt context may also drop writes
+/// </summary>
+void Console::CountDroppedWrite()
 {
-    static volatile bool inUse{};
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    m_droppedWriteCount = m_droppedWriteCount + 1;
+    SetDAIF(daif);
+}
 
-    while (inUse)
+/// <summary>
+/// Write all complete records at the start of the queue to the device. Up to CONSOLE_GATHER_RECORDS records are written with a single gather write.
+/// Must only be called by the consumer
+/// </summary>
+void Console::WriteRecords()
+{
+    for (;;)
     {
-        Timer::WaitMilliSeconds(1);
-    }
-    inUse = true;
+        IOVector vectors[CONSOLE_GATHER_RECORDS];
+        size_t vectorCount{};
+        uint32 readCount = m_queueReadCount;
+        uint32 endCount = readCount;
+        uint32 writeCount = __atomic_load_n(&m_queueWriteCount, __ATOMIC_ACQUIRE);
+        while ((endCount != writeCount) && (vectorCount < CONSOLE_GATHER_RECORDS))
+        {
+            auto header = reinterpret_cast<ConsoleQueueRecordHeader*>(&m_queue[endCount % CONSOLE_QUEUE_SIZE]);
+            uint32 state = __atomic_load_n(&header->state, __ATOMIC_ACQUIRE);
+            if (state == RecordStateEmpty)
+                break;
+            if (state == RecordStateReady)
+                vectors[vectorCount++] = {header + 1, header->length};
+            endCount += RecordSize(header->length);
+        }
+        if (endCount == readCount)
+            break;
 
-    SetTerminalColor(foregroundColor, backgroundColor);
-    Write(str);
-    SetTerminalColor();
+        if ((vectorCount > 0) && (m_device != nullptr))
+            WriteToDevice(vectors, vectorCount);
 
-    inUse = false;
+        while (readCount != endCount)
+        {
+            auto header = reinterpret_cast<ConsoleQueueRecordHeader*>(&m_queue[readCount % CONSOLE_QUEUE_SIZE]);
+            uint32 size = RecordSize(header->length);
+            // Clear the complete record, so that any future record header placed in this area starts out empty
+            memset(reinterpret_cast<void*>(header), 0, size);
+            readCount += size;
+        }
+        __atomic_store_n(&m_queueReadCount, readCount, __ATOMIC_RELEASE);
+    }
 }
 
 /// <summary>
-/// Write a string without changing the foreground and background color
+/// Write a gather list to the device. A non-blocking device (e.g. a UART in interrupt mode) may accept only part of the data,
+/// in that case the write is repeated for the remaining data. If the device accepts no data at all for CONSOLE_DEVICE_STALL_TIMEOUT milliseconds,
+/// e.g. because its transmit interrupt is masked, the remaining data is dropped
 /// </summary>
-/// <param name="str">String to be written</param>
-void Console::Write(const char* str)
+/// <param name="vectors">List of buffers to write, adjusted while writing</param>
+/// <param name="vectorCount">Number of buffers in list</param>
+void Console::WriteToDevice(IOVector* vectors, size_t vectorCount)
 {
-    if (m_device != nullptr)
+    uint64 frequency{};
+    GetTimerFrequency(frequency);
+    uint64 stallTimeout = frequency * CONSOLE_DEVICE_STALL_TIMEOUT / 1000;
+    bool isStalled = false;
+    uint64 stallStart{};
+    while (vectorCount > 0)
     {
-        m_device->Write(str, strlen(str));
+        ssize_t written = m_device->WriteV(vectors, vectorCount);
+        if (written < 0)
+            return;
+        if (written == 0)
+        {
+            uint64 now{};
+            GetTimerCounter(now);
+            if (!isStalled)
+            {
+                isStalled = true;
+                stallStart = now;
+            }
+            else if (now - stallStart > stallTimeout)
+            {
+                CountDroppedWrite();
+                return;
+            }
+            continue;
+        }
+        isStalled = false;
+        size_t remaining = static_cast<size_t>(written);
+        while ((vectorCount > 0) && (remaining >= vectors->count))
+        {
+            remaining -= vectors->count;
+            ++vectors;
+            --vectorCount;
+        }
+        if (vectorCount > 0)
+        {
+            vectors->buffer = reinterpret_cast<const uint8*>(vectors->buffer) + remaining;
+            vectors->count -= remaining;
+        }
     }
 }
 
 /// <summary>
-/// Flush the device buffers
+/// Check whether the queue starts with a complete record
 /// </summary>
-void Console::Flush()
+/// <returns>True if a complete record is waiting to be written, false otherwise</returns>
+bool Console::HaveReadyRecord() const
 {
-    if (m_device != nullptr)
+    uint32 readCount = __atomic_load_n(&m_queueReadCount, __ATOMIC_ACQUIRE);
+    if (readCount == __atomic_load_n(&m_queueWriteCount, __ATOMIC_ACQUIRE))
+        return false;
+    auto header = reinterpret_cast<const ConsoleQueueRecordHeader*>(&m_queue[readCount % CONSOLE_QUEUE_SIZE]);
+    return __atomic_load_n(&header->state, __ATOMIC_ACQUIRE) != RecordStateEmpty;
+}
+
+/// <summary>
+/// Become the consumer of the queue if no other writer is, and write all complete records to the device.
+///
+/// After giving up the consumer role, the queue is checked again, to catch records completed by writers which found the consumer role taken just before it
+/// was given up.
+/// </summary>
+/// <returns>True if this writer was consumer, false if another writer is draining the queue</returns>
+bool Console::TryDrain()
+{
+    bool result = false;
+    do
     {
-        m_device->Flush();
+        if (!AcquireConsumer(false))
+            break;
+        result = true;
+        WriteRecords();
+        ReleaseConsumer();
+    } while (HaveReadyRecord());
+    return result;
+}
+
+/// <summary>
+/// Write all complete records to the device, waiting for another writer to finish draining if needed
+/// </summary>
+void Console::Drain()
+{
+    if (AcquireConsumer(true))
+    {
+        WriteRecords();
+        ReleaseConsumer();
     }
+    TryDrain();
 }
 
 /// <summary>
@@ -210,7 +614,11 @@ char Console::ReadChar()
     char ch{};
     if (m_device != nullptr)
     {
-        m_device->Read(&ch, 1);
+        // A non-blocking device returns 0 if nothing was received yet
+        while (m_device->Read(&ch, 1) == 0)
+        {
+            NOP();
+        }
     }
     return ch;
 }
@@ -220,10 +628,7 @@ char Console::ReadChar()
 /// <param name="ch">Character to be written</param>
 void Console::WriteChar(char ch)
 {
-    if (m_device != nullptr)
-    {
-        m_device->Write(&ch, 1);
-    }
+    Write(&ch, 1);
 }
 
 /// <summary>
@@ -0,0 +1,263 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : CrashLog.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : CrashLog
+//
+// Description : Log copy in RAM which survives a reboot
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/CrashLog.h"
+
+#include "baremetal/ARMInstructions.h"
+#include "baremetal/Console.h"
+#include "baremetal/Format.h"
+#include "baremetal/SysConfig.h"
+#include "stdlib/Util.h"
+
+/// @file
+/// Crash log implementation
+
+using namespace baremetal;
+
+static_assert(MEM_CRASH_LOG_END <= MEM_COHERENT_REGION, "Crash log region overlaps coherent memory region, reduce CRASH_LOG_SIZE");
+
+/// <summary>
+/// Calculate the check value for a crash log header
+/// </summary>
+/// <param name="header">Crash log header</param>
+/// <returns>Check value</returns>
+static uint32 CalculateCheck(const CrashLogHeader& header)
+{
+    return ~(header.magic ^ header.size ^ header.bootSequence);
+}
+
+/// <summary>
+/// Constructs a default CrashLog instance (a singleton), using the reserved crash log region. Note that the constructor is private, so GetCrashLog() is
+/// needed to instantiate the CrashLog.
+/// </summary>
+CrashLog::CrashLog()
+    : CrashLog(reinterpret_cast<void*>(MEM_CRASH_LOG_START), CRASH_LOG_SIZE)
+{
+}
+
+/// <summary>
+/// Constructs a specialized CrashLog instance using a custom memory region. This is intended for testing.
+/// </summary>
+/// <param name="buffer">Memory region to use, must be 8 byte aligned</param>
+/// <param name="size">Size of memory region in bytes, including the header</param>
+CrashLog::CrashLog(void* buffer, size_t size)
+    : m_header{reinterpret_cast<CrashLogHeader*>(buffer)}
+    , m_data{reinterpret_cast<uint8*>(buffer) + sizeof(CrashLogHeader)}
+    , m_dataSize{size - sizeof(CrashLogHeader)}
+    , m_hasPreviousLog{}
+    , m_previousBootSequence{}
+    , m_previousWriteCount{}
+    , m_isStarted{}
+{
+}
+
+/// <summary>
+/// Check whether the crash log region holds a valid crash log from the previous boot. The contents are left untouched until Start() is called
+/// </summary>
+/// <returns>True if a crash log of the previous boot was found, false otherwise</returns>
+bool CrashLog::Initialize()
+{
+    const CrashLogHeader& header = *m_header;
+    m_hasPreviousLog = (header.magic == CRASH_LOG_MAGIC) && (header.size == m_dataSize) && (header.check == CalculateCheck(header)) && (header.writeCount > 0);
+    m_previousBootSequence = m_hasPreviousLog ? header.bootSequence : 0;
+    m_previousWriteCount = m_hasPreviousLog ? header.writeCount : 0;
+    return m_hasPreviousLog;
+}
+
+/// <summary>
+/// Start a new crash log for this boot. Any crash log of the previous boot is lost after this
+/// </summary>
+void CrashLog::Start()
+{
+    CrashLogHeader header{};
+    header.magic = CRASH_LOG_MAGIC;
+    header.size = static_cast<uint32>(m_dataSize);
+    header.bootSequence = m_previousBootSequence + 1;
+    header.check = CalculateCheck(header);
+    header.writeCount = 0;
+    *m_header = header;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    m_isStarted = true;
+}
+
+/// <summary>
+/// Check whether a crash log of the previous boot was found
+/// </summary>
+/// <returns>True if a crash log of the previous boot was found, false otherwise</returns>
+bool CrashLog::HasPreviousLog() const
+{
+    return m_hasPreviousLog;
+}
+
+/// <summary>
+/// Return the boot sequence number of the previous boot
+/// </summary>
+/// <returns>Boot sequence number of the previous boot, 0 if no crash log of the previous boot was found</returns>
+uint32 CrashLog::GetPreviousBootSequence() const
+{
+    return m_previousBootSequence;
+}
+
+/// <summary>
+/// Return the boot sequence number of this boot
+/// </summary>
+/// <returns>Boot sequence number of this boot</returns>
+uint32 CrashLog::GetBootSequence() const
+{
+    return m_previousBootSequence + 1;
+}
+
+/// <summary>
+/// Determine the part of the data area holding the crash log of the previous boot. If the ring buffer wrapped, the partially overwritten first line is
+/// skipped
+/// </summary>
+/// <param name="start">Write count of the first byte of the previous log</param>
+/// <param name="length">Length of the previous log in bytes</param>
+void CrashLog::GetPreviousLogRange(uint64& start, size_t& length) const
+{
+    start = 0;
+    length = 0;
+    if (!m_hasPreviousLog)
+        return;
+    length = (m_previousWriteCount > m_dataSize) ? m_dataSize : static_cast<size_t>(m_previousWriteCount);
+    start = m_previousWriteCount - length;
+    if (start > 0)
+    {
+        while ((length > 0) && (m_data[start % m_dataSize] != '\n'))
+        {
+            ++start;
+            --length;
+        }
+        if (length > 0)
+        {
+            ++start;
+            --length;
+        }
+    }
+}
+
+/// <summary>
+/// Copy the crash log of the previous boot to a buffer. Must be called before Start()
+/// </summary>
+/// <param name="buffer">Buffer to copy to, will be null terminated</param>
+/// <param name="bufferSize">Size of the buffer</param>
+/// <returns>Number of characters copied, excluding the terminating null character</returns>
+size_t CrashLog::ReadPreviousLog(char* buffer, size_t bufferSize) const
+{
+    if (bufferSize == 0)
+        return 0;
+    uint64 start{};
+    size_t length{};
+    GetPreviousLogRange(start, length);
+    if (length > bufferSize - 1)
+    {
+        start += length - (bufferSize - 1);
+        length = bufferSize - 1;
+    }
+    for (size_t i = 0; i < length; ++i)
+    {
+        buffer[i] = static_cast<char>(m_data[(start + i) % m_dataSize]);
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+/// <summary>
+/// Write the crash log of the previous boot to the console, if found. Must be called before Start()
+/// </summary>
+void CrashLog::DumpPreviousLog() const
+{
+    if (!m_hasPreviousLog)
+        return;
+    uint64 start{};
+    size_t length{};
+    GetPreviousLogRange(start, length);
+
+    auto& console = GetConsole();
+    char line[64]{};
+    FormatNoAlloc(line, sizeof(line), "---- Log of previous boot %u ----\n", m_previousBootSequence);
+    console.Write(line);
+    while (length > 0)
+    {
+        size_t offset = start % m_dataSize;
+        size_t chunk = (offset + length > m_dataSize) ? m_dataSize - offset : length;
+        console.Write(reinterpret_cast<const char*>(m_data + offset), chunk);
+        start += chunk;
+        length -= chunk;
+    }
+    console.Write("---- End of log of previous boot ----\n");
+    console.Flush();
+}
+
+/// <summary>
+/// Add data to the crash log. Space is reserved with IRQs disabled, so this can be called from any context. Exclusive load/store (and so an atomic add) is
+/// not reliable on Device memory, which all memory is while the MMU is off, and only one core is running
+/// </summary>
+/// <param name="data">Data to write</param>
+/// <param name="count">Number of bytes to write</param>
+void CrashLog::Write(const char* data, size_t count)
+{
+    if (!m_isStarted || (count == 0))
+        return;
+    if (count > m_dataSize)
+    {
+        data += count - m_dataSize;
+        count = m_dataSize;
+    }
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    uint64 start = m_header->writeCount;
+    m_header->writeCount = start + count;
+    SetDAIF(daif);
+    size_t offset = start % m_dataSize;
+    size_t firstPart = (offset + count > m_dataSize) ? m_dataSize - offset : count;
+    memcpy(m_data + offset, data, firstPart);
+    memcpy(m_data, data + firstPart, count - firstPart);
+}
+
+/// <summary>
+/// Construct the singleton crash log if needed, and return a reference to the instance
+/// </summary>
+/// <returns>Reference to the singleton crash log</returns>
+CrashLog& baremetal::GetCrashLog()
+{
+    static CrashLog crashLog;
+    return crashLog;
+}
@@ -0,0 +1,510 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : DMAChannel.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : DMAChannel
+//
+// Description : DMA channel with chained control blocks
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/DMAChannel.h"
+
+#include "baremetal/ARMInstructions.h"
+#include "baremetal/Assert.h"
+#include "baremetal/BCMRegisters.h"
+#include "baremetal/IMemoryAccess.h"
+#include "baremetal/SysConfig.h"
+#include "stdlib/Macros.h"
+
+/// @file
+/// DMA channel with chained control blocks implementation
+
+namespace baremetal {
+
+/// @brief Burst length used for memory to memory copies with 128 bit wide transfers
+static const uint32 MemoryCopyBurstLength = 2;
+/// @brief Priority for AXI transactions of the channel
+static const uint32 DefaultPriority = 1;
+/// @brief Priority for AXI transactions of the channel when a peripheral signals panic
+static const uint32 DefaultPanicPriority = 15;
+
+/// <summary>
+/// Constructs a DMA channel, allocating a channel of the requested type from the DMA controller.
+/// If no channel is available, IsAllocated() returns false and all operations on the channel fail
+/// </summary>
+/// <param name="type">Type of channel requested</param>
+/// <param name="controller">DMA controller to allocate the channel from</param>
+DMAChannel::DMAChannel(DMAChannelType type, DMAController& controller)
+    : m_controller{controller}
+    , m_memoryAccess{controller.m_memoryAccess}
+    , m_channel{controller.AllocateChannel(type)}
+    , m_maxTransferLength{}
+    , m_controlBlocks{}
+    , m_numControlBlocks{}
+    , m_completionHandler{}
+    , m_completionParam{}
+    , m_isRunning{}
+    , m_hasError{}
+{
+    if (!IsAllocated())
+        return;
+
+    m_controlBlocks = m_controller.GetControlBlocks(m_channel);
+    m_maxTransferLength = m_controller.IsLiteChannel(m_channel) ? RPI_DMA_TXFR_LEN_MAX_LITE : RPI_DMA_TXFR_LEN_MAX;
+    m_memoryAccess.Write32(RPI_DMA_ENABLE, m_memoryAccess.Read32(RPI_DMA_ENABLE) | BIT1(m_channel));
+    m_memoryAccess.Write32(RPI_DMA_CS(m_channel), RPI_DMA_CS_RESET);
+}
+
+/// <summary>
+/// Destructs a DMA channel. A running transfer is aborted, and the channel is returned to the DMA controller
+/// </summary>
+DMAChannel::~DMAChannel()
+{
+    if (!IsAllocated())
+        return;
+
+    if (m_isRunning)
+        Abort();
+    m_controller.DisconnectInterrupt(m_channel);
+    m_controller.FreeChannel(m_channel);
+    m_channel = DMA_CHANNEL_NONE;
+}
+
+/// <summary>
+/// Check whether a channel was allocated
+/// </summary>
+/// <returns>True if a channel was allocated, false otherwise</returns>
+bool DMAChannel::IsAllocated() const
+{
+    return m_channel != DMA_CHANNEL_NONE;
+}
+
+/// <summary>
+/// Return the allocated channel number
+/// </summary>
+/// <returns>Channel number, or DMA_CHANNEL_NONE if no channel was allocated</returns>
+uint32 DMAChannel::GetChannel() const
+{
+    return m_channel;
+}
+
+/// <summary>
+/// Check whether the allocated channel is a DMA Lite channel. DMA Lite channels have a maximum transfer length of 64 Kb per control
+/// block and do not support 2D mode
+/// </summary>
+/// <returns>True if the channel is a DMA Lite channel</returns>
+bool DMAChannel::IsLite() const
+{
+    return IsAllocated() && m_controller.IsLiteChannel(m_channel);
+}
+
+/// <summary>
+/// Remove all control blocks, to start building a new transfer. Must not be called while a transfer is running
+/// </summary>
+void DMAChannel::ClearControlBlocks()
+{
+    assert(!m_isRunning);
+    m_numControlBlocks = 0;
+}
+
+/// <summary>
+/// Return the number of control blocks in use
+/// </summary>
+/// <returns>Number of control blocks in use</returns>
+size_t DMAChannel::GetNumControlBlocks() const
+{
+    return m_numControlBlocks;
+}
+
+/// <summary>
+/// Add a single control block to the chain. The control block is linked to the previous one, if any
+/// </summary>
+/// <param name="transferInformation">Transfer information (RPI_DMA_TI_... bits). RPI_DMA_TI_INTEN is handled by Start()</param>
+/// <param name="sourceAddress">Source bus address</param>
+/// <param name="destinationAddress">Destination bus address</param>
+/// <param name="transferLength">Transfer length, see RPI_DMA_TXFR_LEN_2D for 2D mode</param>
+/// <param name="stride">Stride for 2D mode, see RPI_DMA_STRIDE_2D</param>
+/// <returns>True if the control block was added, false if no channel is allocated, all control blocks are in use, or the transfer
+/// is not supported by the channel</returns>
+bool DMAChannel::AddTransfer(uint32 transferInformation, uint32 sourceAddress, uint32 destinationAddress, uint32 transferLength, uint32 stride)
+{
+    assert(!m_isRunning);
+    if (!IsAllocated() || (m_numControlBlocks >= DMA_CONTROL_BLOCKS_PER_CHANNEL))
+        return false;
+    if (transferInformation & RPI_DMA_TI_TDMODE)
+    {
+        if (IsLite())
+            return false;
+    }
+    else if ((transferLength == 0) || (transferLength > m_maxTransferLength))
+        return false;
+
+    DMAControlBlock* controlBlock = &m_controlBlocks[m_numControlBlocks];
+    controlBlock->transferInformation = transferInformation & ~RPI_DMA_TI_INTEN;
+    controlBlock->sourceAddress = sourceAddress;
+    controlBlock->destinationAddress = destinationAddress;
+    controlBlock->transferLength = transferLength;
+    controlBlock->stride = stride;
+    controlBlock->nextControlBlockAddress = 0;
+    controlBlock->reserved[0] = 0;
+    controlBlock->reserved[1] = 0;
+    if (m_numControlBlocks > 0)
+        m_controlBlocks[m_numControlBlocks - 1].nextControlBlockAddress = GetBusAddress(controlBlock);
+    ++m_numControlBlocks;
+    return true;
+}
+
+/// <summary>
+/// Add a memory to memory copy. Buffers that are 16 byte aligned are copied with 128 bit wide bursts on full channels
+/// </summary>
+/// <param name="destination">Destination buffer</param>
+/// <param name="source">Source buffer</param>
+/// <param name="length">Number of bytes to copy</param>
+/// <returns>True if the copy was added, false otherwise</returns>
+bool DMAChannel::AddMemoryCopy(void* destination, const void* source, size_t length)
+{
+    uint32 transferInformation = RPI_DMA_TI_SRC_INC | RPI_DMA_TI_DEST_INC;
+    if (!IsLite() && (((reinterpret_cast<uintptr>(destination) | reinterpret_cast<uintptr>(source) | length) & 0x0F) == 0))
+        transferInformation |= RPI_DMA_TI_SRC_WIDTH | RPI_DMA_TI_DEST_WIDTH | RPI_DMA_TI_BURST_LENGTH(MemoryCopyBurstLength);
+    return AddSplitTransfer(transferInformation, GetBusAddress(source), GetBusAddress(destination), length);
+}
+
+/// <summary>
+/// Add a rectangular memory to memory copy, using 2D mode. Each of the height rows of width bytes is copied from source to destination,
+/// after which the source and destination addresses are advanced by their pitch. Not supported on DMA Lite channels
+/// </summary>
+/// <param name="destination">Start of first destination row</param>
+/// <param name="destinationPitch">Distance between the start of destination rows in bytes</param>
+/// <param name="source">Start of first source row</param>
+/// <param name="sourcePitch">Distance between the start of source rows in bytes</param>
+/// <param name="width">Number of bytes to copy per row, at most 65535</param>
+/// <param name="height">Number of rows to copy</param>
+/// <returns>True if the copy was added, false if the channel is a DMA Lite channel, or the width or pitch cannot be handled in 2D mode</returns>
+bool DMAChannel::AddMemoryCopy2D(void* destination, size_t destinationPitch, const void* source, size_t sourcePitch, size_t width, size_t height)
+{
+    if (IsLite() || (width == 0) || (width > 0xFFFF) || (height == 0))
+        return false;
+    // After each row the address has been advanced by the width, the stride adds the remainder of the pitch
+    int64 sourceStride = static_cast<int64>(sourcePitch) - static_cast<int64>(width);
+    int64 destinationStride = static_cast<int64>(destinationPitch) - static_cast<int64>(width);
+    if ((sourceStride < -32768) || (sourceStride > 32767) || (destinationStride < -32768) || (destinationStride > 32767))
+        return false;
+
+    uint32 transferInformation = RPI_DMA_TI_TDMODE | RPI_DMA_TI_SRC_INC | RPI_DMA_TI_DEST_INC;
+    if (((reinterpret_cast<uintptr>(destination) | reinterpret_cast<uintptr>(source) | width | sourcePitch | destinationPitch) & 0x0F) == 0)
+        transferInformation |= RPI_DMA_TI_SRC_WIDTH | RPI_DMA_TI_DEST_WIDTH | RPI_DMA_TI_BURST_LENGTH(MemoryCopyBurstLength);
+    uint32 sourceAddress = GetBusAddress(source);
+    uint32 destinationAddress = GetBusAddress(destination);
+    size_t numControlBlocks = m_numControlBlocks;
+    // A control block handles at most 16384 rows
+    while (height > 0)
+    {
+        uint32 rows = static_cast<uint32>(MIN(height, size_t{0x4000}));
+        if (!AddTransfer(transferInformation, sourceAddress, destinationAddress, RPI_DMA_TXFR_LEN_2D(width, rows - 1),
+                         RPI_DMA_STRIDE_2D(sourceStride, destinationStride)))
+        {
+            RemoveControlBlocks(numControlBlocks);
+            return false;
+        }
+        sourceAddress += static_cast<uint32>(rows * sourcePitch);
+        destinationAddress += static_cast<uint32>(rows * destinationPitch);
+        height -= rows;
+    }
+    return true;
+}
+
+/// <summary>
+/// Add a memory fill, repeating a 16 byte pattern. Destinations that are 16 byte aligned are filled with 128 bit wide bursts on full channels
+/// </summary>
+/// <param name="destination">Destination buffer</param>
+/// <param name="pattern">Pattern of 16 bytes, 16 byte aligned. Must stay unchanged until the transfer has completed</param>
+/// <param name="length">Number of bytes to fill</param>
+/// <returns>True if the fill was added, false otherwise</returns>
+bool DMAChannel::AddMemoryFill(void* destination, const void* pattern, size_t length)
+{
+    assert((reinterpret_cast<uintptr>(pattern) & 0x0F) == 0);
+    uint32 transferInformation = RPI_DMA_TI_DEST_INC;
+    if (!IsLite() && (((reinterpret_cast<uintptr>(destination) | length) & 0x0F) == 0))
+        transferInformation |= RPI_DMA_TI_SRC_WIDTH | RPI_DMA_TI_DEST_WIDTH | RPI_DMA_TI_BURST_LENGTH(MemoryCopyBurstLength);
+    return AddSplitTransfer(transferInformation, GetBusAddress(pattern), GetBusAddress(destination), length);
+}
+
+/// <summary>
+/// Add a write from memory to a peripheral FIFO, paced by the peripheral's DREQ signal
+/// </summary>
+/// <param name="peripheral">Peripheral register to write to</param>
+/// <param name="source">Source buffer</param>
+/// <param name="length">Number of bytes to write</param>
+/// <param name="dreq">DREQ signal of the peripheral</param>
+/// <returns>True if the write was added, false otherwise</returns>
+bool DMAChannel::AddPeripheralWrite(regaddr peripheral, const void* source, size_t length, DMADREQ dreq)
+{
+    uint32 transferInformation = RPI_DMA_TI_SRC_INC | RPI_DMA_TI_DEST_DREQ | RPI_DMA_TI_PERMAP(static_cast<uint32>(dreq)) | RPI_DMA_TI_WAIT_RESP;
+    return AddSplitTransfer(transferInformation, GetBusAddress(source), GetPeripheralBusAddress(peripheral), length);
+}
+
+/// <summary>
+/// Add a read from a peripheral FIFO to memory, paced by the peripheral's DREQ signal
+/// </summary>
+/// <param name="destination">Destination buffer</param>
+/// <param name="peripheral">Peripheral register to read from</param>
+/// <param name="length">Number of bytes to read</param>
+/// <param name="dreq">DREQ signal of the peripheral</param>
+/// <returns>True if the read was added, false otherwise</returns>
+bool DMAChannel::AddPeripheralRead(void* destination, regaddr peripheral, size_t length, DMADREQ dreq)
+{
+    uint32 transferInformation = RPI_DMA_TI_DEST_INC | RPI_DMA_TI_SRC_DREQ | RPI_DMA_TI_PERMAP(static_cast<uint32>(dreq));
+    return AddSplitTransfer(transferInformation, GetPeripheralBusAddress(peripheral), GetBusAddress(destination), length);
+}
+
+/// <summary>
+/// Set the completion handler. If a handler is set, the channel interrupt is enabled and the handler is called when a transfer ends.
+/// Passing nullptr disables the interrupt again
+/// </summary>
+/// <param name="handler">Completion handler, or nullptr</param>
+/// <param name="param">Parameter passed to the completion handler</param>
+void DMAChannel::SetCompletionHandler(DMACompletionHandler* handler, void* param)
+{
+    assert(!m_isRunning);
+    if (!IsAllocated())
+        return;
+
+    m_controller.DisconnectInterrupt(m_channel);
+    m_completionHandler = handler;
+    m_completionParam = param;
+    if (m_completionHandler != nullptr)
+        m_controller.ConnectInterrupt(m_channel, this);
+}
+
+/// <summary>
+/// Start executing the control block chain
+/// </summary>
+/// <returns>True if the transfer was started, false if there is no channel, no control blocks, or a transfer is already running</returns>
+bool DMAChannel::Start()
+{
+    if (!IsAllocated() || (m_numControlBlocks == 0) || m_isRunning)
+        return false;
+
+    DMAControlBlock* lastControlBlock = &m_controlBlocks[m_numControlBlocks - 1];
+    lastControlBlock->nextControlBlockAddress = 0;
+    if (m_completionHandler != nullptr)
+        lastControlBlock->transferInformation |= RPI_DMA_TI_INTEN;
+    else
+        lastControlBlock->transferInformation &= ~RPI_DMA_TI_INTEN;
+
+    // Caches are disabled, so the control blocks and buffers only need to be written out before the DMA engine reads them
+    DataSyncBarrier();
+
+    m_hasError = false;
+    m_isRunning = true;
+    m_memoryAccess.Write32(RPI_DMA_DEBUG(m_channel), RPI_DMA_DEBUG_ERRORS);
+    m_memoryAccess.Write32(RPI_DMA_CONBLK_AD(m_channel), GetBusAddress(m_controlBlocks));
+    m_memoryAccess.Write32(RPI_DMA_CS(m_channel), RPI_DMA_CS_WAIT_FOR_OUTSTANDING_WRITES | RPI_DMA_CS_PANIC_PRIORITY(DefaultPanicPriority) |
+                                                      RPI_DMA_CS_PRIORITY(DefaultPriority) | RPI_DMA_CS_INT | RPI_DMA_CS_END | RPI_DMA_CS_ACTIVE);
+    return true;
+}
+
+/// <summary>
+/// Check whether the DMA engine is still executing the control block chain
+/// </summary>
+/// <returns>True if the channel is active</returns>
+bool DMAChannel::IsBusy()
+{
+    if (!IsAllocated())
+        return false;
+    return (m_memoryAccess.Read32(RPI_DMA_CS(m_channel)) & RPI_DMA_CS_ACTIVE) != 0;
+}
+
+/// <summary>
+/// Wait for the running transfer to end. If a completion handler is set and the interrupt was not handled yet, the handler is called
+/// from here, so it is called exactly once per transfer.
+///
+/// If the transfer does not end within the timeout, e.g. because the peripheral never raises its DREQ, the transfer is aborted (see Abort()).
+/// </summary>
+/// <param name="timeoutMilliSeconds">Maximum time to wait in milliseconds, 0 to wait without limit</param>
+/// <returns>True if the transfer completed without errors, false if it ended with an error or timed out</returns>
+bool DMAChannel::Wait(uint32 timeoutMilliSeconds /*= 0*/)
+{
+    if (timeoutMilliSeconds != 0)
+    {
+        uint64 frequency{};
+        GetTimerFrequency(frequency);
+        uint64 timeout = frequency * timeoutMilliSeconds / 1000;
+        uint64 start{};
+        GetTimerCounter(start);
+        while (IsBusy())
+        {
+            uint64 now{};
+            GetTimerCounter(now);
+            if (now - start > timeout)
+            {
+                Abort();
+                return false;
+            }
+        }
+    }
+    while (IsBusy())
+        NOP();
+
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    bool wasRunning = m_isRunning;
+    if (wasRunning)
+        Finish();
+    SetDAIF(daif);
+
+    if (wasRunning && (m_completionHandler != nullptr))
+        (*m_completionHandler)(*this, !m_hasError, m_completionParam);
+    return !m_hasError;
+}
+
+/// <summary>
+/// Abort the running transfer. The channel is reset, and the transfer is marked as failed. The completion handler is not called
+/// </summary>
+void DMAChannel::Abort()
+{
+    if (!IsAllocated())
+        return;
+
+    m_memoryAccess.Write32(RPI_DMA_CS(m_channel), RPI_DMA_CS_RESET);
+    while (m_memoryAccess.Read32(RPI_DMA_CS(m_channel)) & RPI_DMA_CS_RESET)
+        NOP();
+    m_hasError = m_isRunning;
+    m_isRunning = false;
+}
+
+/// <summary>
+/// Check whether the last transfer ended with an error
+/// </summary>
+/// <returns>True if the last transfer ended with an error or was aborted</returns>
+bool DMAChannel::HasError() const
+{
+    return m_hasError;
+}
+
+/// <summary>
+/// Handle the channel interrupt, called by the DMA controller. Calls the completion handler if the running transfer has ended
+/// </summary>
+void DMAChannel::InterruptHandler()
+{
+    if (!(m_memoryAccess.Read32(RPI_DMA_CS(m_channel)) & RPI_DMA_CS_INT) || !m_isRunning)
+        return;
+
+    Finish();
+    if (m_completionHandler != nullptr)
+        (*m_completionHandler)(*this, !m_hasError, m_completionParam);
+}
+
+/// <summary>
+/// Convert an ARM physical memory address to a bus address as seen by the DMA engine (uncached alias)
+/// </summary>
+/// <param name="address">ARM physical address, must be below 1 Gb</param>
+/// <returns>Bus address</returns>
+uint32 DMAChannel::GetBusAddress(const void* address)
+{
+    uintptr physicalAddress = reinterpret_cast<uintptr>(address);
+    assert(physicalAddress < GIGABYTE);
+    return static_cast<uint32>(ARM_TO_GPU(physicalAddress));
+}
+
+/// <summary>
+/// Convert an ARM peripheral register address to a bus address as seen by the DMA engine
+/// </summary>
+/// <param name="address">Peripheral register address</param>
+/// <returns>Bus address</returns>
+uint32 DMAChannel::GetPeripheralBusAddress(regaddr address)
+{
+    return static_cast<uint32>(ARM_IO_TO_GPU(reinterpret_cast<uintptr>(address)));
+}
+
+/// <summary>
+/// Add a transfer of any length, split into multiple control blocks if it is longer than a single control block can handle.
+/// The source and destination address are advanced for each control block if they are incremented
+/// </summary>
+/// <param name="transferInformation">Transfer information (RPI_DMA_TI_... bits)</param>
+/// <param name="sourceAddress">Source bus address</param>
+/// <param name="destinationAddress">Destination bus address</param>
+/// <param name="length">Total transfer length in bytes</param>
+/// <returns>True if all control blocks were added, false otherwise. In that case the chain is left unchanged</returns>
+bool DMAChannel::AddSplitTransfer(uint32 transferInformation, uint32 sourceAddress, uint32 destinationAddress, size_t length)
+{
+    if (!IsAllocated() || (length == 0))
+        return false;
+
+    // Keep chunks 32 byte aligned, so wide bursts are not broken up at the boundaries
+    size_t maxChunkLength = m_maxTransferLength & ~0x1FU;
+    size_t numControlBlocks = m_numControlBlocks;
+    while (length > 0)
+    {
+        uint32 chunkLength = static_cast<uint32>(MIN(length, maxChunkLength));
+        if (!AddTransfer(transferInformation, sourceAddress, destinationAddress, chunkLength))
+        {
+            RemoveControlBlocks(numControlBlocks);
+            return false;
+        }
+        if (transferInformation & RPI_DMA_TI_SRC_INC)
+            sourceAddress += chunkLength;
+        if (transferInformation & RPI_DMA_TI_DEST_INC)
+            destinationAddress += chunkLength;
+        length -= chunkLength;
+    }
+    return true;
+}
+
+/// <summary>
+/// Remove control blocks added after a failed Add...() call, so the chain is left as it was
+/// </summary>
+/// <param name="numControlBlocks">Number of control blocks to keep</param>
+void DMAChannel::RemoveControlBlocks(size_t numControlBlocks)
+{
+    m_numControlBlocks = numControlBlocks;
+    if (numControlBlocks > 0)
+        m_controlBlocks[numControlBlocks - 1].nextControlBlockAddress = 0;
+}
+
+/// <summary>
+/// Bookkeeping when a transfer has ended: check for errors and acknowledge the end and interrupt flags
+/// </summary>
+void DMAChannel::Finish()
+{
+    uint32 status = m_memoryAccess.Read32(RPI_DMA_CS(m_channel));
+    uint32 debug = m_memoryAccess.Read32(RPI_DMA_DEBUG(m_channel));
+    m_hasError = ((status & RPI_DMA_CS_ERROR) != 0) || ((debug & RPI_DMA_DEBUG_ERRORS) != 0);
+    m_memoryAccess.Write32(RPI_DMA_CS(m_channel), RPI_DMA_CS_INT | RPI_DMA_CS_END);
+    if (debug & RPI_DMA_DEBUG_ERRORS)
+        m_memoryAccess.Write32(RPI_DMA_DEBUG(m_channel), debug & RPI_DMA_DEBUG_ERRORS);
+    m_isRunning = false;
+}
+
+} // namespace baremetal
@@ -0,0 +1,269 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : DMAController.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : DMAController
+//
+// Description : DMA controller channel allocation and interrupt dispatch
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/DMAController.h"
+
+#include "baremetal/Assert.h"
+#include "baremetal/BCMRegisters.h"
+#include "baremetal/DMAChannel.h"
+#include "baremetal/InterruptHandler.h"
+#include "baremetal/Logger.h"
+#include "baremetal/Mailbox.h"
+#include "baremetal/MemoryManager.h"
+#include "baremetal/MemoryMap.h"
+#include "baremetal/RPIProperties.h"
+
+/// @file
+/// DMA controller channel allocation and interrupt dispatch implementation
+
+/// @brief Define log name
+LOG_MODULE("DMAController");
+
+namespace baremetal {
+
+static_assert(DMA_CHANNELS * DMA_CONTROL_BLOCKS_PER_CHANNEL * sizeof(DMAControlBlock) <= PAGE_SIZE,
+              "DMA control blocks do not fit in a coherent page, reduce DMA_CONTROL_BLOCKS_PER_CHANNEL");
+
+#if BAREMETAL_RPI_TARGET == 3
+/// @brief Full DMA channels (0-6)
+static const uint32 NormalChannelMask = 0x007F;
+/// @brief DMA Lite channels (7-14)
+static const uint32 LiteChannelMask = 0x7F80;
+#else
+/// @brief Full DMA channels (0-6)
+static const uint32 NormalChannelMask = 0x007F;
+/// @brief DMA Lite channels (7-10). Channels 11-14 are DMA4 channels with a different register layout, which are not supported
+static const uint32 LiteChannelMask = 0x0780;
+#endif
+/// @brief Channels used if the firmware cannot be asked, this is the set the firmware normally reports as free
+static const uint32 DefaultChannelMask = 0x7F35;
+
+/// @brief IRQ line for each DMA channel. Some channels share an IRQ line
+static const IRQ_ID DMAChannelIRQ[DMA_CHANNELS] = {
+    IRQ_ID::IRQ_DMA0, IRQ_ID::IRQ_DMA1, IRQ_ID::IRQ_DMA2,  IRQ_ID::IRQ_DMA3,  IRQ_ID::IRQ_DMA4,  IRQ_ID::IRQ_DMA5,  IRQ_ID::IRQ_DMA6,  IRQ_ID::IRQ_DMA7,
+    IRQ_ID::IRQ_DMA8, IRQ_ID::IRQ_DMA9, IRQ_ID::IRQ_DMA10, IRQ_ID::IRQ_DMA11, IRQ_ID::IRQ_DMA12, IRQ_ID::IRQ_DMA13, IRQ_ID::IRQ_DMA14,
+};
+
+/// <summary>
+/// Constructs a default DMAController instance.
+///
+/// Note that the constructor is private, so GetDMAController() is needed to instantiate the DMAController.
+/// </summary>
+DMAController::DMAController()
+    : m_isInitialized{}
+    , m_memoryAccess{GetMemoryAccess()}
+    , m_channelMask{}
+    , m_allocatedMask{}
+    , m_interruptChannels{}
+{
+}
+
+/// <summary>
+/// Constructs a specialized DMAController instance with a custom IMemoryAccess instance. This is intended for testing.
+/// </summary>
+/// <param name="memoryAccess">Memory access interface</param>
+DMAController::DMAController(IMemoryAccess& memoryAccess)
+    : m_isInitialized{}
+    , m_memoryAccess{memoryAccess}
+    , m_channelMask{}
+    , m_allocatedMask{}
+    , m_interruptChannels{}
+{
+}
+
+/// <summary>
+/// Request the channels usable by the ARM from the firmware. Only performed once, guarded by m_isInitialized.
+/// </summary>
+void DMAController::Initialize()
+{
+    if (m_isInitialized)
+        return;
+
+    Mailbox       mailbox(MailboxChannel::ARM_MAILBOX_CH_PROP_OUT, m_memoryAccess);
+    RPIProperties properties(mailbox);
+    uint32        channelMask{};
+    if (!properties.GetDMAChannels(channelMask))
+    {
+        LOG_WARNING("Cannot request DMA channels, using default set");
+        channelMask = DefaultChannelMask;
+    }
+    m_channelMask = channelMask & (NormalChannelMask | LiteChannelMask);
+    LOG_DEBUG("Usable DMA channels %04x", m_channelMask);
+    m_isInitialized = true;
+}
+
+/// <summary>
+/// Allocate a DMA channel. The lowest free channel of the requested type is returned
+/// </summary>
+/// <param name="type">Type of channel requested</param>
+/// <returns>Channel number, or DMA_CHANNEL_NONE if no channel of the requested type is free</returns>
+uint32 DMAController::AllocateChannel(DMAChannelType type)
+{
+    Initialize();
+
+    uint32 typeMask{};
+    switch (type)
+    {
+    case DMAChannelType::Normal:
+        typeMask = NormalChannelMask;
+        break;
+    case DMAChannelType::Lite:
+        typeMask = LiteChannelMask;
+        break;
+    case DMAChannelType::Any:
+        typeMask = NormalChannelMask | LiteChannelMask;
+        break;
+    }
+    uint32 freeMask = m_channelMask & ~m_allocatedMask & typeMask;
+    if (freeMask == 0)
+    {
+        LOG_WARNING("No free DMA channel");
+        return DMA_CHANNEL_NONE;
+    }
+    uint32 channel = static_cast<uint32>(__builtin_ctz(freeMask));
+    m_allocatedMask |= BIT1(channel);
+    return channel;
+}
+
+/// <summary>
+/// Return an allocated DMA channel
+/// </summary>
+/// <param name="channel">Channel number returned by AllocateChannel()</param>
+void DMAController::FreeChannel(uint32 channel)
+{
+    assert(channel < DMA_CHANNELS);
+    assert(m_allocatedMask & BIT1(channel));
+    assert(m_interruptChannels[channel] == nullptr);
+    m_allocatedMask &= ~BIT1(channel);
+}
+
+/// <summary>
+/// Check whether a channel is a DMA Lite channel
+/// </summary>
+/// <param name="channel">Channel number</param>
+/// <returns>True for a DMA Lite channel, false for a full channel</returns>
+bool DMAController::IsLiteChannel(uint32 channel) const
+{
+    return (LiteChannelMask & BIT1(channel)) != 0;
+}
+
+/// <summary>
+/// Return the control blocks for a channel. Each channel has DMA_CONTROL_BLOCKS_PER_CHANNEL control blocks, located in coherent memory
+/// </summary>
+/// <param name="channel">Channel number</param>
+/// <returns>Pointer to the first control block of the channel</returns>
+DMAControlBlock* DMAController::GetControlBlocks(uint32 channel) const
+{
+    assert(channel < DMA_CHANNELS);
+    auto controlBlocks = reinterpret_cast<DMAControlBlock*>(MemoryManager::GetCoherentPage(CoherentPageSlot::DMAControlBlocks));
+    return controlBlocks + channel * DMA_CONTROL_BLOCKS_PER_CHANNEL;
+}
+
+/// <summary>
+/// Connect the completion interrupt of a channel. The IRQ line is registered when the first channel using it is connected
+/// </summary>
+/// <param name="channel">Channel number</param>
+/// <param name="dmaChannel">Channel to call the interrupt handler of</param>
+void DMAController::ConnectInterrupt(uint32 channel, DMAChannel* dmaChannel)
+{
+    assert(channel < DMA_CHANNELS);
+    assert(m_interruptChannels[channel] == nullptr);
+    bool irqInUse{};
+    for (uint32 i = 0; i < DMA_CHANNELS; ++i)
+    {
+        if ((m_interruptChannels[i] != nullptr) && (DMAChannelIRQ[i] == DMAChannelIRQ[channel]))
+            irqInUse = true;
+    }
+    m_interruptChannels[channel] = dmaChannel;
+    if (!irqInUse)
+        GetInterruptSystem().RegisterIRQHandler(DMAChannelIRQ[channel], IRQHandler, this);
+}
+
+/// <summary>
+/// Disconnect the completion interrupt of a channel. The IRQ line is unregistered when no other channel uses it
+/// </summary>
+/// <param name="channel">Channel number</param>
+void DMAController::DisconnectInterrupt(uint32 channel)
+{
+    assert(channel < DMA_CHANNELS);
+    if (m_interruptChannels[channel] == nullptr)
+        return;
+    m_interruptChannels[channel] = nullptr;
+    for (uint32 i = 0; i < DMA_CHANNELS; ++i)
+    {
+        if ((m_interruptChannels[i] != nullptr) && (DMAChannelIRQ[i] == DMAChannelIRQ[channel]))
+            return;
+    }
+    GetInterruptSystem().UnregisterIRQHandler(DMAChannelIRQ[channel]);
+}
+
+/// <summary>
+/// Handle DMA interrupts. As IRQ lines can be shared, the interrupt status of all channels is checked, and the interrupt handler of each
+/// connected channel with a pending interrupt is called
+/// </summary>
+void DMAController::InterruptHandler()
+{
+    uint32 status = m_memoryAccess.Read32(RPI_DMA_INT_STATUS);
+    for (uint32 channel = 0; channel < DMA_CHANNELS; ++channel)
+    {
+        if ((status & BIT1(channel)) && (m_interruptChannels[channel] != nullptr))
+            m_interruptChannels[channel]->InterruptHandler();
+    }
+}
+
+/// <summary>
+/// IRQ handler for all DMA IRQ lines
+/// </summary>
+/// <param name="param">Pointer to DMAController instance</param>
+void DMAController::IRQHandler(void* param)
+{
+    reinterpret_cast<DMAController*>(param)->InterruptHandler();
+}
+
+/// <summary>
+/// Construct the singleton DMA controller if needed, and return a reference to the instance
+/// </summary>
+/// <returns>Reference to the singleton DMA controller</returns>
+DMAController& GetDMAController()
+{
+    static DMAController value;
+    return value;
+}
+
+} // namespace baremetal
@@ -0,0 +1,242 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : DeferredWork.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : DeferredWorkQueue
+//
+// Description : Deferred work queue, to move work out of interrupt handlers
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/DeferredWork.h"
+
+#include "baremetal/ARMInstructions.h"
+#include "baremetal/Assert.h"
+#include "baremetal/Clock.h"
+#include "baremetal/Logger.h"
+
+/// @file
+/// Deferred work queue implementation
+
+static_assert((DEFERRED_WORK_QUEUE_SIZE & (DEFERRED_WORK_QUEUE_SIZE - 1)) == 0, "DEFERRED_WORK_QUEUE_SIZE must be a power of 2");
+
+/// @brief Mask to convert a queue position into a slot index
+static const uint32 QueueIndexMask = DEFERRED_WORK_QUEUE_SIZE - 1;
+
+namespace baremetal {
+
+/// @brief Define log name
+LOG_MODULE("DeferredWork");
+
+/// <summary>
+/// Constructs a DeferredWorkQueue instance. Normally the singleton is used through GetDeferredWorkQueue(), separate instances are intended for testing.
+/// </summary>
+DeferredWorkQueue::DeferredWorkQueue()
+    : m_items{}
+    , m_enqueueCount{}
+    , m_dequeueCount{}
+    , m_isRunning{}
+    , m_droppedCount{}
+    , m_statistics{}
+    , m_enqueueCountAtReset{}
+    , m_droppedCountAtReset{}
+{
+    for (uint32 index = 0; index < DEFERRED_WORK_QUEUE_SIZE; ++index)
+        m_items[index].sequence = index;
+}
+
+/// <summary>
+/// Queue a work item. Can be called from interrupt handlers at any priority, as well as from task level. Does not allocate.
+///
+/// A slot is claimed by advancing the enqueue position with IRQs disabled, then filled in, and then published by setting its sequence number.
+/// IRQs are only disabled for the claim, as exclusive load/store (and so compare-and-swap) is not reliable on Device memory, which all memory is while
+/// the MMU is off, and only one core is running.
+/// A handler preempting another Enqueue() claims the next slot, Run() stops at a claimed slot which is not yet published and continues there later.
+/// </summary>
+/// <param name="handler">Work handler, called from Run()</param>
+/// <param name="param">Parameter passed to the work handler</param>
+/// <param name="value">Value passed to the work handler, e.g. an event or a sampled register</param>
+/// <returns>True if the work item was queued, false if the queue was full (the item is dropped)</returns>
+bool DeferredWorkQueue::Enqueue(DeferredWorkHandler* handler, void* param, uintptr value)
+{
+    assert(handler != nullptr);
+
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    uint32 position = m_enqueueCount;
+    WorkItem& item = m_items[position & QueueIndexMask];
+    if (__atomic_load_n(&item.sequence, __ATOMIC_ACQUIRE) != position)
+    {
+        // Slot still holds an item from the previous round, so the queue is full
+        m_droppedCount = m_droppedCount + 1;
+        SetDAIF(daif);
+        return false;
+    }
+    m_enqueueCount = position + 1;
+    SetDAIF(daif);
+
+    item.handler = handler;
+    item.param = param;
+    item.value = value;
+    item.queuedCycles = Clock::Cycles();
+    __atomic_store_n(&item.sequence, position + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/// <summary>
+/// Run all queued work items, in the order they were queued. Work items queued while running (e.g. by interrupt handlers) are run in the same pass.
+///
+/// If another pass is already active (this call interrupted it), returns immediately, the active pass will run the queued items.
+/// Also stops at an item which is claimed but not yet published, as its Enqueue() call may be the code this call interrupted. That item and the ones
+/// after it are run by the next Run() call.
+/// </summary>
+/// <returns>Number of work items run</returns>
+unsigned DeferredWorkQueue::Run()
+{
+    unsigned count{};
+    while (GetReadyItem() != nullptr)
+    {
+        // Test and set the running flag with IRQs disabled, exclusive load/store is not reliable on Device memory (the MMU is off)
+        uint64 daif;
+        GetDAIF(daif);
+        DisableIRQs();
+        bool isRunning = m_isRunning;
+        m_isRunning = true;
+        SetDAIF(daif);
+        if (isRunning)
+            break;
+
+        WorkItem* item;
+        while ((item = GetReadyItem()) != nullptr)
+        {
+            uint32 position = m_dequeueCount;
+            DeferredWorkHandler* handler = item->handler;
+            void* param = item->param;
+            uintptr value = item->value;
+            uint64 queuedCycles = item->queuedCycles;
+            uint32 depth = __atomic_load_n(&m_enqueueCount, __ATOMIC_RELAXED) - position;
+            // Free the slot before running the handler, so the handler can queue new work
+            __atomic_store_n(&item->sequence, position + DEFERRED_WORK_QUEUE_SIZE, __ATOMIC_RELEASE);
+            __atomic_store_n(&m_dequeueCount, position + 1, __ATOMIC_RELEASE);
+
+            m_statistics.depth.Add(depth);
+            m_statistics.latency.Add(Clock::CyclesToNanoSeconds(Clock::Cycles() - queuedCycles));
+            (*handler)(param, value);
+            m_statistics.executed++;
+            count++;
+        }
+
+        __atomic_store_n(&m_isRunning, false, __ATOMIC_RELEASE);
+        // An interrupt may have queued work after the last check, but before m_isRunning was cleared, so its own Run() call returned. Check again
+    }
+    return count;
+}
+
+/// <summary>
+/// Check whether there is any queued work
+/// </summary>
+/// <returns>True if no work items are queued</returns>
+bool DeferredWorkQueue::IsEmpty() const
+{
+    return __atomic_load_n(&m_dequeueCount, __ATOMIC_ACQUIRE) == __atomic_load_n(&m_enqueueCount, __ATOMIC_ACQUIRE);
+}
+
+/// <summary>
+/// Return the work item at the dequeue position if it is published
+/// </summary>
+/// <returns>Work item to run next, or nullptr if the queue is empty or the next item is not yet published</returns>
+DeferredWorkQueue::WorkItem* DeferredWorkQueue::GetReadyItem()
+{
+    uint32 position = __atomic_load_n(&m_dequeueCount, __ATOMIC_ACQUIRE);
+    WorkItem& item = m_items[position & QueueIndexMask];
+    if (__atomic_load_n(&item.sequence, __ATOMIC_ACQUIRE) != position + 1)
+        return nullptr;
+    return &item;
+}
+
+/// <summary>
+/// Return a consistent copy of the deferred work statistics
+/// </summary>
+/// <param name="statistics">Receives the statistics</param>
+void DeferredWorkQueue::GetStatistics(DeferredWorkStatistics& statistics) const
+{
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    statistics = m_statistics;
+    statistics.queued = __atomic_load_n(&m_enqueueCount, __ATOMIC_RELAXED) - m_enqueueCountAtReset;
+    statistics.dropped = __atomic_load_n(&m_droppedCount, __ATOMIC_RELAXED) - m_droppedCountAtReset;
+    SetDAIF(daif);
+}
+
+/// <summary>
+/// Clear the deferred work statistics
+/// </summary>
+void DeferredWorkQueue::ResetStatistics()
+{
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    m_statistics.executed = 0;
+    m_statistics.depth.Reset();
+    m_statistics.latency.Reset();
+    m_enqueueCountAtReset = __atomic_load_n(&m_enqueueCount, __ATOMIC_RELAXED);
+    m_droppedCountAtReset = __atomic_load_n(&m_droppedCount, __ATOMIC_RELAXED);
+    SetDAIF(daif);
+}
+
+/// <summary>
+/// Log the deferred work statistics. Times are in nanoseconds
+/// </summary>
+void DeferredWorkQueue::DumpStatistics() const
+{
+    DeferredWorkStatistics statistics;
+    GetStatistics(statistics);
+    const Histogram& depth = statistics.depth;
+    const Histogram& latency = statistics.latency;
+    LOG_INFO("Deferred work: queued %llu, executed %llu, dropped %llu", statistics.queued, statistics.executed, statistics.dropped);
+    LOG_INFO("Queue depth min/p50/p99/max %llu/%llu/%llu/%llu, latency min/p50/p99/max %llu/%llu/%llu/%llu", depth.GetMin(), depth.GetPercentile(50),
+             depth.GetPercentile(99), depth.GetMax(), latency.GetMin(), latency.GetPercentile(50), latency.GetPercentile(99), latency.GetMax());
+}
+
+/// <summary>
+/// Construct the singleton DeferredWorkQueue instance if needed, and return a reference to the instance
+/// </summary>
+/// <returns>Reference to the singleton DeferredWorkQueue instance</returns>
+DeferredWorkQueue& GetDeferredWorkQueue()
+{
+    static DeferredWorkQueue singleton;
+    return singleton;
+}
+
+} // namespace baremetal
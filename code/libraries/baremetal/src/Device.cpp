@@ -66,6 +66,32 @@ ssize_t Device::Write(const void* buffer, size_t count)
     return static_cast<ssize_t>(-1);
 }
 
+/// <summary>
+/// Write a list of buffers to the device in one call (gather write). Devices can override this to write all buffers in one burst, the default
+/// implementation calls Write() for each buffer
+/// </summary>
+/// <param name="vectors">List of buffers to write</param>
+/// <param name="vectorCount">Number of buffers in list</param>
+/// <returns>Total number of written bytes or < 0 on failure</returns>
+ssize_t Device::WriteV(const IOVector* vectors, size_t vectorCount)
+{
+    if (vectors == nullptr)
+        return static_cast<ssize_t>(-1);
+    ssize_t total{};
+    for (size_t i = 0; i < vectorCount; ++i)
+    {
+        if (vectors[i].count == 0)
+            continue;
+        ssize_t result = Write(vectors[i].buffer, vectors[i].count);
+        if (result < 0)
+            return (total > 0) ? total : result;
+        total += result;
+        if (static_cast<size_t>(result) < vectors[i].count)
+            break;
+    }
+    return total;
+}
+
 /// <summary>
 /// Flush any buffers for device
 /// </summary>
@@ -40,7 +40,9 @@
 #include "baremetal/GPIOManager.h"
 
 #include "baremetal/ARMInstructions.h"
+#include "baremetal/Assert.h"
 #include "baremetal/BCMRegisters.h"
+#include "baremetal/DeferredWork.h"
 #include "baremetal/InterruptHandler.h"
 #include "baremetal/Logger.h"
 #include "baremetal/MemoryAccess.h"
@@ -54,6 +56,7 @@ static const int WaitCycles = 150;
 static const IRQ_ID GPIO_IRQ{IRQ_ID::IRQ_GPIO3}; // shared IRQ line for all GPIOs
 
 static void GPIOInterruptHandler(void* param);
+static void UnknownPinInterruptWork(void* param, uintptr value);
 
 /// @brief Define log name
 LOG_MODULE("GPIOManager");
@@ -204,7 +207,8 @@ void GPIOManager::InterruptHandler()
         }
         else
         {
-            LOG_ERROR("No pin found for interrupt");
+            // Logging takes too long for interrupt context, so it is deferred
+            GetDeferredWorkQueue().Enqueue(UnknownPinInterruptWork, nullptr, pinNumber);
 
             uint32 regOffset{static_cast<uint32>((pinNumber / 32) * 4)};
             uint32 regMask{static_cast<uint32>(1 << (pinNumber % 32))};
@@ -241,6 +245,16 @@ void GPIOInterruptHandler(void* param)
     pThis->InterruptHandler();
 }
 
+/// <summary>
+/// Deferred work queued by the GPIO interrupt handler for an interrupt on a pin without an interrupt handler
+/// </summary>
+/// <param name="param">Unused</param>
+/// <param name="value">GPIO pin number</param>
+void UnknownPinInterruptWork(void* /*param*/, uintptr value)
+{
+    LOG_ERROR("No pin found for interrupt on GPIO %d", static_cast<int>(value));
+}
+
 /// <summary>
 /// Create a singleton GPIOManager if neededm and return the singleton instance
 /// </summary>
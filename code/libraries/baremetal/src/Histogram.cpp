@@ -0,0 +1,150 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : Histogram.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : Histogram
+//
+// Description : Log-linear histogram for timing statistics
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/Histogram.h"
+
+#include "stdlib/Util.h"
+
+/// @file
+/// Log-linear histogram for timing statistics implementation
+
+namespace baremetal {
+
+/// <summary>
+/// Constructs an empty histogram
+/// </summary>
+Histogram::Histogram()
+    : m_count{}
+    , m_sum{}
+    , m_min{}
+    , m_max{}
+    , m_buckets{}
+{
+}
+
+/// <summary>
+/// Remove all values
+/// </summary>
+void Histogram::Reset()
+{
+    m_count = 0;
+    m_sum = 0;
+    m_min = 0;
+    m_max = 0;
+    memset(m_buckets, 0, sizeof(m_buckets));
+}
+
+/// <summary>
+/// Add a value
+/// </summary>
+/// <param name="value">Value to add</param>
+void Histogram::Add(uint64 value)
+{
+    if ((m_count == 0) || (value < m_min))
+        m_min = value;
+    if (value > m_max)
+        m_max = value;
+    m_sum += value;
+    m_buckets[GetBucketIndex(value)]++;
+    m_count++;
+}
+
+/// <summary>
+/// Return an upper bound for the specified percentile of the values added: at least percent % of the values is smaller than or equal to the value returned.
+/// The value returned is the upper bound of the bucket holding the percentile, limited to the largest value added
+/// </summary>
+/// <param name="percent">Percentile, 0 to 100. 50 gives the median</param>
+/// <returns>Upper bound for the percentile, 0 if no values were added</returns>
+uint64 Histogram::GetPercentile(unsigned percent) const
+{
+    if (m_count == 0)
+        return 0;
+    if (percent > 100)
+        percent = 100;
+
+    uint64 target = (m_count * percent + 99) / 100;
+    if (target == 0)
+        return GetMin();
+    uint64 cumulative{};
+    for (unsigned index = 0; index < HISTOGRAM_BUCKETS; ++index)
+    {
+        cumulative += m_buckets[index];
+        if (cumulative >= target)
+        {
+            uint64 upperBound = GetBucketUpperBound(index);
+            return (upperBound < m_max) ? upperBound : m_max;
+        }
+    }
+    return m_max;
+}
+
+/// <summary>
+/// Determine the bucket a value is counted in
+/// </summary>
+/// <param name="value">Value</param>
+/// <returns>Bucket index</returns>
+unsigned Histogram::GetBucketIndex(uint64 value)
+{
+    if (value < HISTOGRAM_SUB_BUCKETS)
+        return static_cast<unsigned>(value);
+    unsigned msb = 63 - static_cast<unsigned>(__builtin_clzll(value));
+    if (msb >= HISTOGRAM_MAX_BITS)
+        return HISTOGRAM_BUCKETS - 1;
+    unsigned subBucket = static_cast<unsigned>(value >> (msb - HISTOGRAM_SUB_BUCKET_BITS)) & (HISTOGRAM_SUB_BUCKETS - 1);
+    return (msb - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKETS + subBucket;
+}
+
+/// <summary>
+/// Return the largest value counted in a bucket
+/// </summary>
+/// <param name="index">Bucket index</param>
+/// <returns>Largest value in the bucket</returns>
+uint64 Histogram::GetBucketUpperBound(unsigned index)
+{
+    if (index < HISTOGRAM_SUB_BUCKETS)
+        return index;
+    if (index >= HISTOGRAM_BUCKETS - 1)
+        return ~0ULL;
+    unsigned msb = index / HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BUCKET_BITS - 1;
+    unsigned subBucket = index % HISTOGRAM_SUB_BUCKETS;
+    uint64 width = 1ULL << (msb - HISTOGRAM_SUB_BUCKET_BITS);
+    return ((static_cast<uint64>(HISTOGRAM_SUB_BUCKETS + subBucket)) << (msb - HISTOGRAM_SUB_BUCKET_BITS)) + width - 1;
+}
+
+} // namespace baremetal
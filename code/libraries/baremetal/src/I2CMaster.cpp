@@ -555,7 +555,7 @@ size_t I2CMaster::WriteReadRepeatedStart(uint16 address, const void* writeBuffer
 uint32 I2CMaster::ReadControlRegister()
 {
     auto result = m_memoryAccess.Read32(RPI_I2C_REG_ADDRESS(m_baseAddress, RPI_I2C_C_OFFSET));
-    if (GetLogger().IsLogSeverityEnabled(LogSeverity::Data))
+    if (LOG_SEVERITY_ENABLED(LogSeverity::Data))
     {
         String text;
         text += (result & RPI_I2C_C_ENABLE) ? "EN " : "   ";
@@ -577,7 +577,7 @@ uint32 I2CMaster::ReadControlRegister()
 void I2CMaster::WriteControlRegister(uint32 data)
 {
     m_memoryAccess.Write32(RPI_I2C_REG_ADDRESS(m_baseAddress, RPI_I2C_C_OFFSET), data);
-    if (GetLogger().IsLogSeverityEnabled(LogSeverity::Data))
+    if (LOG_SEVERITY_ENABLED(LogSeverity::Data))
     {
         String text;
         text += (data & RPI_I2C_C_ENABLE) ? "EN " : "   ";
@@ -642,7 +642,7 @@ void I2CMaster::WriteDataLengthRegister(uint8 data)
 uint32 I2CMaster::ReadStatusRegister()
 {
     auto data = m_memoryAccess.Read32(RPI_I2C_REG_ADDRESS(m_baseAddress, RPI_I2C_S_OFFSET));
-    if (GetLogger().IsLogSeverityEnabled(LogSeverity::Data))
+    if (LOG_SEVERITY_ENABLED(LogSeverity::Data))
     {
         String text;
         text += (data & RPI_I2C_S_CLKT) ? "CLKT " : "     ";
@@ -667,7 +667,7 @@ uint32 I2CMaster::ReadStatusRegister()
 void I2CMaster::WriteStatusRegister(uint32 data)
 {
     m_memoryAccess.Write32(RPI_I2C_REG_ADDRESS(m_baseAddress, RPI_I2C_S_OFFSET), data);
-    if (GetLogger().IsLogSeverityEnabled(LogSeverity::Data))
+    if (LOG_SEVERITY_ENABLED(LogSeverity::Data))
     {
         String text;
         text += (data & RPI_I2C_S_CLKT) ? "CLKT " : "     ";
@@ -43,6 +43,8 @@
 #include "baremetal/ARMRegisters.h"
 #include "baremetal/Assert.h"
 #include "baremetal/BCMRegisters.h"
+#include "baremetal/Clock.h"
+#include "baremetal/DeferredWork.h"
 #include "baremetal/Interrupts.h"
 #include "baremetal/Logger.h"
 #include "baremetal/MemoryAccess.h"
@@ -66,6 +68,20 @@ void InterruptHandler()
     GetInterruptSystem().InterruptHandler();
 }
 
+#if BAREMETAL_RPI_TARGET == 3
+#else
+/// <summary>
+/// Global unhandled FIQ function
+///
+/// Is called by FIQStub if a FIQ was acknowledged on the GIC while no FIQ handler is registered, and relays the call to the singleton InterruptHandler instance
+/// </summary>
+/// <param name="iarValue">Value read from the GIC interrupt acknowledge register</param>
+void UnhandledFIQ(uint32 iarValue)
+{
+    GetInterruptSystem().HandleUnhandledFIQ(iarValue);
+}
+#endif
+
 /// <summary>
 /// Create a interrupt system
 ///
@@ -76,6 +92,17 @@ InterruptSystem::InterruptSystem()
     , m_memoryAccess{GetMemoryAccess()}
     , m_irqHandlers{}
     , m_irqHandlersParam{}
+    , m_irqPreemptible{}
+    , m_interruptEntryCount{}
+    , m_handledIRQCount{}
+    , m_nestingLevel{}
+#if BAREMETAL_IRQ_STATS
+    , m_irqStatistics{}
+    , m_irqStatisticsIndex{}
+    , m_numIRQStatistics{}
+    , m_unrecordedIRQs{}
+    , m_timerEntryLatency{}
+#endif
 {
 }
 
@@ -88,6 +115,17 @@ InterruptSystem::InterruptSystem(IMemoryAccess& memoryAccess)
     , m_memoryAccess{memoryAccess}
     , m_irqHandlers{}
     , m_irqHandlersParam{}
+    , m_irqPreemptible{}
+    , m_interruptEntryCount{}
+    , m_handledIRQCount{}
+    , m_nestingLevel{}
+#if BAREMETAL_IRQ_STATS
+    , m_irqStatistics{}
+    , m_irqStatisticsIndex{}
+    , m_numIRQStatistics{}
+    , m_unrecordedIRQs{}
+    , m_timerEntryLatency{}
+#endif
 {
 }
 
@@ -108,6 +146,10 @@ void InterruptSystem::Initialize()
 
     memset(m_irqHandlers, 0, IRQ_LINES * sizeof(IRQHandler*));
     memset(m_irqHandlersParam, 0, IRQ_LINES * sizeof(void*));
+    memset(m_irqPreemptible, 0, IRQ_LINES * sizeof(bool));
+#if BAREMETAL_IRQ_STATS
+    ResetIRQStatistics();
+#endif
 
     DisableInterrupts();
 
@@ -132,6 +174,7 @@ void InterruptSystem::Initialize()
     // initialize core 0 CPU interface:
 
     m_memoryAccess.Write32(RPI_GICC_PMR, RPI_GICC_PMR_PRIORITY);
+    m_memoryAccess.Write32(RPI_GICC_BPR, RPI_GICC_BPR_ALL_GROUP_PRIORITY);
 #endif
 
     EnableInterrupts();
@@ -166,6 +209,7 @@ void InterruptSystem::DisableInterrupts()
     m_memoryAccess.Write32(RPI_INTRCTRL_DISABLE_IRQS_2, static_cast<uint32>(-1));
     m_memoryAccess.Write32(RPI_INTRCTRL_DISABLE_BASIC_IRQS, static_cast<uint32>(-1));
     m_memoryAccess.Write32(ARM_LOCAL_TIMER_INT_CONTROL0, 0);
+    m_memoryAccess.Write32(ARM_LOCAL_MAILBOX_INT_CONTROL0, 0);
 #else
     // initialize distributor:
 
@@ -198,23 +242,33 @@ void InterruptSystem::EnableInterrupts()
 /// <summary>
 /// Enable and register an IRQ handler
 ///
-/// Enable the IRQ with specified index, and register its handler.
+/// Enable the IRQ with specified index, set its priority, and register its handler.
+///
+/// IRQ handlers run with IRQs disabled, unless they are registered as preemptible. On the GIC (Raspberry Pi 4), a preemptible handler runs with
+/// IRQs enabled, so that an IRQ with a higher priority (lower value) preempts the handler. IRQs with the same or a lower priority wait until the
+/// handler is done. A preemptible handler sharing data with a handler of a higher priority IRQ must therefore protect it by disabling IRQs,
+/// as task level code does. The Raspberry Pi 3 interrupt controller has no priorities, so there the priority and preemptible flag are ignored,
+/// and handlers are never preempted by other IRQs.
 /// </summary>
 /// <param name="irqID">IRQ ID</param>
 /// <param name="handler">Handler to register for this IRQ</param>
 /// <param name="param">Parameter to pass to IRQ handler</param>
-void InterruptSystem::RegisterIRQHandler(IRQ_ID irqID, IRQHandler* handler, void* param)
+/// <param name="priority">Priority of the IRQ, from IRQ_PRIORITY_HIGHEST to IRQ_PRIORITY_LOWEST</param>
+/// <param name="preemptible">If true, the handler can be preempted by IRQs with a higher priority</param>
+void InterruptSystem::RegisterIRQHandler(IRQ_ID irqID, IRQHandler* handler, void* param, uint8 priority, bool preemptible)
 {
     uint32 irq = static_cast<int>(irqID);
     assert(irq < IRQ_LINES);
     if (Logger::HaveLogger())
-        LOG_DEBUG("InterruptSystem::RegisterIRQHandler IRQ=%d", irq);
+        LOG_DEBUG("InterruptSystem::RegisterIRQHandler IRQ=%d priority=%02x preemptible=%d", irq, priority, preemptible);
     assert(m_irqHandlers[irq] == nullptr);
 
-    EnableIRQ(irqID);
+    SetIRQPriority(irqID, priority);
+    EnableIRQ(irqID, m_memoryAccess);
 
     m_irqHandlers[irq] = handler;
     m_irqHandlersParam[irq] = param;
+    m_irqPreemptible[irq] = preemptible;
 }
 
 /// <summary>
@@ -233,12 +287,75 @@ void InterruptSystem::UnregisterIRQHandler(IRQ_ID irqID)
 
     m_irqHandlers[irq] = nullptr;
     m_irqHandlersParam[irq] = nullptr;
+    m_irqPreemptible[irq] = false;
+
+    DisableIRQ(irqID, m_memoryAccess);
+    SetIRQPriority(irqID, IRQ_PRIORITY_DEFAULT);
+}
 
-    DisableIRQ(irqID);
+/// <summary>
+/// Change the priority of an IRQ. Only has effect on the GIC (Raspberry Pi 4), see RegisterIRQHandler()
+/// </summary>
+/// <param name="irqID">IRQ ID</param>
+/// <param name="priority">Priority of the IRQ, from IRQ_PRIORITY_HIGHEST to IRQ_PRIORITY_LOWEST. Lower values have a higher priority</param>
+void InterruptSystem::SetIRQPriority(IRQ_ID irqID, uint8 priority)
+{
+    uint32 irq = static_cast<int>(irqID);
+    assert(irq < IRQ_LINES);
+    assert((priority >= IRQ_PRIORITY_HIGHEST) && (priority <= IRQ_PRIORITY_LOWEST));
+#if BAREMETAL_RPI_TARGET == 3
+    (void)irq;
+    (void)priority;
+#else
+    regaddr address = RPI_GICD_IPRIORITYR0 + 4 * (irq / 4);
+    unsigned shift = 8 * (irq % 4);
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    uint32 value = m_memoryAccess.Read32(address);
+    value = (value & ~(static_cast<uint32>(0xFF) << shift)) | (static_cast<uint32>(priority) << shift);
+    m_memoryAccess.Write32(address, value);
+    SetDAIF(daif);
+#endif
+}
+
+/// <summary>
+/// Set the priority mask of the GIC CPU interface. Only IRQs with a priority value lower than the mask are signalled.
+/// Can be used to hold off all IRQs below a priority level, while still allowing higher priority IRQs. Only has effect on the GIC (Raspberry Pi 4)
+/// </summary>
+/// <param name="mask">Priority mask. The default is RPI_GICC_PMR_PRIORITY, which allows all priorities</param>
+void InterruptSystem::SetPriorityMask(uint8 mask)
+{
+#if BAREMETAL_RPI_TARGET == 3
+    (void)mask;
+#else
+    m_memoryAccess.Write32(RPI_GICC_PMR, mask);
+#endif
+}
+
+/// <summary>
+/// Set the binary point of the GIC CPU interface, which selects the priority bits that determine preemption (the group priority).
+/// IRQs only preempt a running handler if their group priority is higher. Only has effect on the GIC (Raspberry Pi 4)
+/// </summary>
+/// <param name="binaryPoint">Binary point. Priority bits above bit binaryPoint are group priority bits. The default is RPI_GICC_BPR_ALL_GROUP_PRIORITY,
+/// for which every priority level preempts lower levels</param>
+void InterruptSystem::SetPriorityGrouping(uint8 binaryPoint)
+{
+#if BAREMETAL_RPI_TARGET == 3
+    (void)binaryPoint;
+#else
+    assert(binaryPoint < 8);
+    m_memoryAccess.Write32(RPI_GICC_BPR, binaryPoint);
+#endif
 }
 
 /// <summary>
 /// Enable and register a FIQ interrupt handler. Only one can be enabled at any time.
+///
+/// This promotes a single interrupt source to the FIQ fast path: FIQStub calls the handler directly, saving only the caller-saved registers,
+/// and FIQ is not masked by DisableIRQs() or during IRQ handlers. The source must not also be registered as IRQ.
+/// On the GIC (Raspberry Pi 4), the interrupt is only signalled as FIQ if the kernel has secure access to the GIC (see EnableFIQ()), otherwise
+/// it is signalled as the highest priority IRQ, and InterruptHandler() calls the FIQ handler directly.
 /// </summary>
 /// <param name="fiqID">FIQ interrupt number</param>
 /// <param name="handler">FIQ interrupt handler</param>
@@ -252,12 +369,13 @@ void InterruptSystem::RegisterFIQHandler(FIQ_ID fiqID, FIQHandler* handler, void
         LOG_DEBUG("InterruptSystem::RegisterFIQHandler IRQ=%d", fiq);
     assert(handler != nullptr);
     assert(s_fiqData.handler == nullptr);
+    assert((fiq >= IRQ_LINES) || (m_irqHandlers[fiq] == nullptr));
 
     s_fiqData.handler = handler;
     s_fiqData.param = param;
     s_fiqData.fiqID = fiq;
 
-    EnableFIQ(fiqID);
+    EnableFIQ(fiqID, m_memoryAccess);
 }
 
 /// <summary>
@@ -271,7 +389,7 @@ void InterruptSystem::UnregisterFIQHandler(FIQ_ID fiqID)
     assert(s_fiqData.fiqID == fiq);
     if (Logger::HaveLogger())
         LOG_DEBUG("InterruptSystem::UnregisterFIQHandler IRQ=%d", fiq);
-    DisableFIQ(fiqID);
+    DisableFIQ(fiqID, m_memoryAccess);
 
     s_fiqData.handler = nullptr;
     s_fiqData.param = nullptr;
@@ -280,80 +398,175 @@ void InterruptSystem::UnregisterFIQHandler(FIQ_ID fiqID)
 /// <summary>
 /// Handles an interrupt.
 ///
-/// The interrupt handler is called from assembly code (ExceptionStub.S)
+/// The interrupt handler is called from assembly code (ExceptionStub.S). All pending IRQs are handled before returning,
+/// so a burst of interrupts costs a single exception entry and exit, instead of one for each interrupt.
+/// After that, the outermost call runs the work queued by the IRQ handlers in the DeferredWorkQueue (if DEFERRED_WORK_RUN_AT_IRQ_EXIT is set).
 /// </summary>
 void InterruptSystem::InterruptHandler()
 {
+    m_nestingLevel++;
+    unsigned handledIRQs{};
+    uint64 entryCounter{};
+    uint64 dispatchCounter{};
+#if BAREMETAL_IRQ_STATS
+    // Read before handlers run, as a nested IRQ overwrites s_irqEntryCounter
+    entryCounter = s_irqEntryCounter;
+    // The dispatch latency of the first IRQ is measured from exception entry, that of every next IRQ from the end of the IRQ handled before it.
+    // So it includes acknowledging the IRQ (GIC) or reading the pending registers (Raspberry Pi 3), but not the time spent waiting for earlier handlers
+    dispatchCounter = entryCounter;
+#endif
+
 #if BAREMETAL_RPI_TARGET == 3
-    uint32 localpendingIRQs = m_memoryAccess.Read32(ARM_LOCAL_IRQ_PENDING0);
-    if (localpendingIRQs & ARM_LOCAL_INTSRC_TIMER1) // the only implemented local IRQ so far
+    for (;;)
     {
-        CallIRQHandler(IRQ_ID::IRQ_LOCAL_CNTPNS);
-
-        return;
-    }
+        uint32 localPendingIRQs = m_memoryAccess.Read32(ARM_LOCAL_IRQ_PENDING0);
+        if ((localPendingIRQs & (ARM_LOCAL_INTSRC_TIMER1 | ARM_LOCAL_INTSRC_GPU)) == 0)
+            break;
 
-    uint32 pendingIRQs[ARM_IRQS_NUM_REGS];
-    pendingIRQs[0] = m_memoryAccess.Read32(RPI_INTRCTRL_IRQ_PENDING_1);
-    pendingIRQs[1] = m_memoryAccess.Read32(RPI_INTRCTRL_IRQ_PENDING_2);
-    pendingIRQs[2] = m_memoryAccess.Read32(RPI_INTRCTRL_IRQ_BASIC_PENDING) & 0xFF; // Only 8 basic interrupts
+        if (localPendingIRQs & ARM_LOCAL_INTSRC_TIMER1) // the only implemented local IRQ so far
+        {
+            CallIRQHandler(IRQ_ID::IRQ_LOCAL_CNTPNS, entryCounter, dispatchCounter);
+            handledIRQs++;
+#if BAREMETAL_IRQ_STATS
+            dispatchCounter = Clock::Cycles();
+#endif
+        }
 
-    for (unsigned reg = 0; reg < ARM_IRQS_NUM_REGS; reg++)
-    {
-        uint32 pendingIRQ = pendingIRQs[reg];
-        if (pendingIRQ != 0)
+        // The GPU pending registers only need to be read if any GPU interrupt is pending
+        if (localPendingIRQs & ARM_LOCAL_INTSRC_GPU)
         {
-            unsigned irqID = reg * ARM_IRQS_PER_REG;
+            uint32 pendingIRQs[ARM_IRQS_NUM_REGS];
+            pendingIRQs[0] = m_memoryAccess.Read32(RPI_INTRCTRL_IRQ_PENDING_1);
+            pendingIRQs[1] = m_memoryAccess.Read32(RPI_INTRCTRL_IRQ_PENDING_2);
+            pendingIRQs[2] = m_memoryAccess.Read32(RPI_INTRCTRL_IRQ_BASIC_PENDING) & 0xFF; // Only 8 basic interrupts
 
-            do
+            for (unsigned reg = 0; reg < ARM_IRQS_NUM_REGS; reg++)
             {
-                if ((pendingIRQ & 1) && CallIRQHandler(static_cast<IRQ_ID>(irqID)))
+                uint32 pendingIRQ = pendingIRQs[reg];
+                while (pendingIRQ != 0)
                 {
-                    return;
+                    unsigned bit = static_cast<unsigned>(__builtin_ctz(pendingIRQ));
+                    pendingIRQ &= pendingIRQ - 1;
+                    CallIRQHandler(static_cast<IRQ_ID>(reg * ARM_IRQS_PER_REG + bit), entryCounter, dispatchCounter);
+                    handledIRQs++;
+#if BAREMETAL_IRQ_STATS
+                    dispatchCounter = Clock::Cycles();
+#endif
                 }
-
-                pendingIRQ >>= 1;
-                irqID++;
-            } while (pendingIRQ != 0);
+            }
         }
     }
 
 #else
 
-    uint32 iarValue = m_memoryAccess.Read32(RPI_GICC_IAR); // Read Interrupt Acknowledge Register
-
-    uint32 irq = iarValue & RPI_GICC_IAR_INTERRUPT_ID_MASK; // Select the currently active interrupt
-    if (irq < IRQ_LINES)
+    for (;;)
     {
-        if (irq >= GIC_PPI(0))
+        uint32 iarValue = m_memoryAccess.Read32(RPI_GICC_IAR); // Read Interrupt Acknowledge Register
+
+        uint32 irq = iarValue & RPI_GICC_IAR_INTERRUPT_ID_MASK; // Select the currently active interrupt
+        if (irq >= IRQ_LINES)
+        {
+            // No more pending interrupts. This is only a spurious interrupt if nothing was handled in this exception
+#ifndef NDEBUG
+            if (handledIRQs == 0)
+            {
+                assert(irq >= 1020);
+                LOG_INFO("Received spurious interrupt %d", iarValue);
+            }
+#endif
+            break;
+        }
+
+        if ((irq == s_fiqData.fiqID) && (s_fiqData.handler != nullptr))
+        {
+            // FIQ source signalled as IRQ, as the kernel has no secure access to the GIC (see EnableFIQ()).
+            // It has the highest priority, so it is handled with IRQs masked
+            (*s_fiqData.handler)(s_fiqData.param);
+        }
+        else if (irq >= GIC_PPI(0))
         {
             // Peripheral interrupts (PPI and SPI)
-            CallIRQHandler(static_cast<IRQ_ID>(irq));
+            CallIRQHandler(static_cast<IRQ_ID>(irq), entryCounter, dispatchCounter);
         }
         else
         {
             // Handle SGI interrupt
         }
         m_memoryAccess.Write32(RPI_GICC_EOIR, iarValue); // Flag end of interrupt
+        handledIRQs++;
+#if BAREMETAL_IRQ_STATS
+        dispatchCounter = Clock::Cycles();
+#endif
     }
-#ifndef NDEBUG
-    else
+
+#endif
+
+    m_interruptEntryCount++;
+    m_handledIRQCount += handledIRQs;
+
+#if DEFERRED_WORK_RUN_AT_IRQ_EXIT
+    // Softirq pass: all pending IRQs are acknowledged, so run deferred work with IRQs enabled. IRQs taken meanwhile are nested, and
+    // do not run a pass of their own, their deferred work is picked up by this pass
+    if (m_nestingLevel == 1)
     {
-        // spurious interrupts
-        assert(irq >= 1020);
-        LOG_INFO("Received spurious interrupt %d", iarValue);
+        DeferredWorkQueue& deferredWork = GetDeferredWorkQueue();
+        if (!deferredWork.IsEmpty())
+        {
+            EnableIRQs();
+            deferredWork.Run();
+            DisableIRQs();
+        }
     }
 #endif
+    m_nestingLevel--;
+}
 
+#if BAREMETAL_RPI_TARGET == 3
+#else
+/// <summary>
+/// Handle a FIQ acknowledged on the GIC while no FIQ handler is registered, by disabling the interrupt, so that it is not signalled again.
+/// Called from FIQStub with IRQ and FIQ masked, so must not log
+/// </summary>
+/// <param name="iarValue">Value read from the GIC interrupt acknowledge register</param>
+void InterruptSystem::HandleUnhandledFIQ(uint32 iarValue)
+{
+    uint32 irq = iarValue & RPI_GICC_IAR_INTERRUPT_ID_MASK;
+    // Spurious interrupt IDs are 1020 and up, there is nothing to disable
+    if (irq < IRQ_LINES)
+        DisableIRQ(static_cast<IRQ_ID>(irq), m_memoryAccess);
+}
 #endif
+
+/// <summary>
+/// Return the number of IRQ exceptions taken
+/// </summary>
+/// <returns>Number of IRQ exceptions taken</returns>
+uint64 InterruptSystem::GetInterruptEntryCount() const
+{
+    return m_interruptEntryCount;
+}
+
+/// <summary>
+/// Return the number of IRQs handled. This is larger than GetInterruptEntryCount() if multiple IRQs were handled in one exception
+/// </summary>
+/// <returns>Number of IRQs handled</returns>
+uint64 InterruptSystem::GetHandledIRQCount() const
+{
+    return m_handledIRQCount;
 }
 
 /// <summary>
 /// Call the IRQ handler for the specified IRQ ID
+///
+/// On the GIC, a handler registered as preemptible is called with IRQs enabled. The GIC only signals IRQs with a higher priority than the one
+/// being handled, so these preempt the handler. The IRQ exception stub has saved the exception state on the stack before, so nested exceptions
+/// are safe, and nesting depth is limited by the number of priority levels. Other handlers are called with IRQs disabled
 /// </summary>
 /// <param name="irqID">ID of the IRQ</param>
+/// <param name="entryCounter">Counter value at exception entry, for the timer entry latency</param>
+/// <param name="dispatchCounter">Counter value from which the dispatch latency of this IRQ is measured, for IRQ statistics</param>
 /// <returns>True if a IRQ handler was found, false if not</returns>
-bool InterruptSystem::CallIRQHandler(IRQ_ID irqID)
+bool InterruptSystem::CallIRQHandler(IRQ_ID irqID, uint64 entryCounter, uint64 dispatchCounter)
 {
     uint32 irq = static_cast<int>(irqID);
     assert(irq < IRQ_LINES);
@@ -361,7 +574,37 @@ bool InterruptSystem::CallIRQHandler(IRQ_ID irqID)
 
     if (handler != nullptr)
     {
+#if BAREMETAL_IRQ_STATS
+        if (irqID == IRQ_ID::IRQ_LOCAL_CNTPNS)
+        {
+            // Read the compare value before the timer handler re-programs it
+            uint64 compareValue;
+            GetTimerCompareValue(compareValue);
+            if (entryCounter >= compareValue)
+                m_timerEntryLatency.Add(entryCounter - compareValue);
+        }
+        uint64 start = Clock::Cycles();
+#else
+        (void)entryCounter;
+        (void)dispatchCounter;
+#endif
+#if BAREMETAL_RPI_TARGET == 3
         (*handler)(m_irqHandlersParam[irq]);
+#else
+        if (m_irqPreemptible[irq])
+        {
+            EnableIRQs();
+            (*handler)(m_irqHandlersParam[irq]);
+            DisableIRQs();
+        }
+        else
+        {
+            (*handler)(m_irqHandlersParam[irq]);
+        }
+#endif
+#if BAREMETAL_IRQ_STATS
+        RecordIRQ(irqID, dispatchCounter, start, Clock::Cycles());
+#endif
 
         return true;
     }
@@ -369,11 +612,135 @@ bool InterruptSystem::CallIRQHandler(IRQ_ID irqID)
     LOG_INFO("Unhandled interrupt %d", irq);
 #endif
 
-    DisableIRQ(irqID);
+    DisableIRQ(irqID, m_memoryAccess);
 
     return false;
 }
 
+#if BAREMETAL_IRQ_STATS
+
+static_assert(IRQ_STATISTICS_MAX < 256, "IRQ statistics index must fit in 8 bits");
+
+/// <summary>
+/// Record the timing of an IRQ handler call. Called in interrupt context
+/// </summary>
+/// <param name="irqID">ID of the IRQ</param>
+/// <param name="dispatch">Counter value from which the dispatch latency is measured, see InterruptHandler()</param>
+/// <param name="start">Counter value at the start of the IRQ handler</param>
+/// <param name="end">Counter value at the end of the IRQ handler</param>
+void InterruptSystem::RecordIRQ(IRQ_ID irqID, uint64 dispatch, uint64 start, uint64 end)
+{
+    uint32 irq = static_cast<int>(irqID);
+    unsigned index = m_irqStatisticsIndex[irq];
+    if (index == 0)
+    {
+        if (m_numIRQStatistics >= IRQ_STATISTICS_MAX)
+        {
+            m_unrecordedIRQs++;
+            return;
+        }
+        IRQStatistics& statistics = m_irqStatistics[m_numIRQStatistics++];
+        statistics.irqID = irqID;
+        statistics.count = 0;
+        statistics.dispatchLatency.Reset();
+        statistics.duration.Reset();
+        index = m_numIRQStatistics;
+        m_irqStatisticsIndex[irq] = static_cast<uint8>(index);
+    }
+    IRQStatistics& statistics = m_irqStatistics[index - 1];
+    statistics.count++;
+    statistics.dispatchLatency.Add((start > dispatch) ? start - dispatch : 0);
+    statistics.duration.Add(end - start);
+}
+
+/// <summary>
+/// Return a consistent copy of the timing statistics of an IRQ
+/// </summary>
+/// <param name="irqID">ID of the IRQ</param>
+/// <param name="statistics">Receives the IRQ statistics</param>
+/// <returns>True if statistics were recorded for the IRQ, false if not (IRQ did not occur, or IRQ_STATISTICS_MAX was reached)</returns>
+bool InterruptSystem::GetIRQStatistics(IRQ_ID irqID, IRQStatistics& statistics) const
+{
+    uint32 irq = static_cast<int>(irqID);
+    assert(irq < IRQ_LINES);
+
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    unsigned index = m_irqStatisticsIndex[irq];
+    if (index != 0)
+        statistics = m_irqStatistics[index - 1];
+    SetDAIF(daif);
+    return index != 0;
+}
+
+/// <summary>
+/// Return a consistent copy of the timer interrupt entry latency: the time from the physical timer compare value to exception entry
+/// </summary>
+/// <param name="latency">Receives the latency histogram, in counter cycles</param>
+void InterruptSystem::GetTimerEntryLatency(Histogram& latency) const
+{
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    latency = m_timerEntryLatency;
+    SetDAIF(daif);
+}
+
+/// <summary>
+/// Clear all IRQ statistics
+/// </summary>
+void InterruptSystem::ResetIRQStatistics()
+{
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    memset(m_irqStatisticsIndex, 0, sizeof(m_irqStatisticsIndex));
+    m_numIRQStatistics = 0;
+    m_unrecordedIRQs = 0;
+    m_timerEntryLatency.Reset();
+    SetDAIF(daif);
+}
+
+/// <summary>
+/// Log the statistics of all IRQs that occurred. Times are in nanoseconds
+/// </summary>
+void InterruptSystem::DumpIRQStatistics() const
+{
+    LOG_INFO("IRQ       Count  Dispatch min/p50/p99/max  Duration min/p50/p99/max");
+    for (unsigned index = 0; index < IRQ_STATISTICS_MAX; ++index)
+    {
+        IRQStatistics statistics;
+        uint64 daif;
+        GetDAIF(daif);
+        DisableIRQs();
+        bool valid = index < m_numIRQStatistics;
+        if (valid)
+            statistics = m_irqStatistics[index];
+        SetDAIF(daif);
+        if (!valid)
+            break;
+
+        const Histogram& dispatch = statistics.dispatchLatency;
+        const Histogram& duration = statistics.duration;
+        LOG_INFO("%3u %11llu  %llu/%llu/%llu/%llu  %llu/%llu/%llu/%llu", static_cast<unsigned>(statistics.irqID), statistics.count,
+                 Clock::CyclesToNanoSeconds(dispatch.GetMin()), Clock::CyclesToNanoSeconds(dispatch.GetPercentile(50)),
+                 Clock::CyclesToNanoSeconds(dispatch.GetPercentile(99)), Clock::CyclesToNanoSeconds(dispatch.GetMax()),
+                 Clock::CyclesToNanoSeconds(duration.GetMin()), Clock::CyclesToNanoSeconds(duration.GetPercentile(50)),
+                 Clock::CyclesToNanoSeconds(duration.GetPercentile(99)), Clock::CyclesToNanoSeconds(duration.GetMax()));
+    }
+
+    Histogram latency;
+    GetTimerEntryLatency(latency);
+    LOG_INFO("Timer entry latency %llu/%llu/%llu/%llu ns (%llu interrupts)", Clock::CyclesToNanoSeconds(latency.GetMin()),
+             Clock::CyclesToNanoSeconds(latency.GetPercentile(50)), Clock::CyclesToNanoSeconds(latency.GetPercentile(99)),
+             Clock::CyclesToNanoSeconds(latency.GetMax()), latency.GetCount());
+    if (m_unrecordedIRQs != 0)
+        LOG_WARNING("%llu IRQs not recorded, increase IRQ_STATISTICS_MAX", m_unrecordedIRQs);
+}
+
+#endif
+
 /// <summary>
 /// Construct the singleton interrupt system instance if needed, initialize it, and return a reference to the instance
 ///
@@ -57,27 +57,27 @@ LOG_MODULE("Interrupts");
 /// Enable the requested IRQ
 /// </summary>
 /// <param name="irqID">IRQ to enable</param>
-void baremetal::EnableIRQ(IRQ_ID irqID)
+/// <param name="memoryAccess">Memory access interface, can be overridden for testing</param>
+void baremetal::EnableIRQ(IRQ_ID irqID, IMemoryAccess& memoryAccess)
 {
     int irq = static_cast<int>(irqID);
     assert(irq < IRQ_LINES);
-    MemoryAccess mem;
 #if BAREMETAL_RPI_TARGET == 3
 
     if (irq < ARM_IRQ_LOCAL_BASE)
     {
-        mem.Write32(ARM_IC_IRQS_ENABLE(irq), ARM_IRQ_MASK(irq));
+        memoryAccess.Write32(ARM_IC_IRQS_ENABLE(irq), ARM_IRQ_MASK(irq));
     }
     else
     {
         // The only implemented local IRQs so far
         assert(irqID == IRQ_ID::IRQ_LOCAL_CNTPNS);
-        mem.Write32(ARM_LOCAL_TIMER_INT_CONTROL0, mem.Read32(ARM_LOCAL_TIMER_INT_CONTROL0) | BIT1(irq - ARM_IRQ_LOCAL_BASE));
+        memoryAccess.Write32(ARM_LOCAL_TIMER_INT_CONTROL0, memoryAccess.Read32(ARM_LOCAL_TIMER_INT_CONTROL0) | BIT1(irq - ARM_IRQ_LOCAL_BASE));
     }
 
 #else
 
-    mem.Write32(RPI_GICD_ISENABLER0 + 4 * (irq / 32), RPI_GICD_IRQ_MASK(irq));
+    memoryAccess.Write32(RPI_GICD_ISENABLER0 + 4 * (irq / 32), RPI_GICD_IRQ_MASK(irq));
 
 #endif
 }
@@ -86,57 +86,74 @@ void baremetal::EnableIRQ(IRQ_ID irqID)
 /// Disable the requested IRQ
 /// </summary>
 /// <param name="irqID">IRQ to disable</param>
-void baremetal::DisableIRQ(IRQ_ID irqID)
+/// <param name="memoryAccess">Memory access interface, can be overridden for testing</param>
+void baremetal::DisableIRQ(IRQ_ID irqID, IMemoryAccess& memoryAccess)
 {
     int irq = static_cast<int>(irqID);
     assert(irq < IRQ_LINES);
-    MemoryAccess mem;
 #if BAREMETAL_RPI_TARGET == 3
 
     if (irq < ARM_IRQ_LOCAL_BASE)
     {
-        mem.Write32(ARM_IC_IRQS_DISABLE(irq), ARM_IRQ_MASK(irq));
+        memoryAccess.Write32(ARM_IC_IRQS_DISABLE(irq), ARM_IRQ_MASK(irq));
     }
     else
     {
         // The only implemented local IRQs so far
         assert(irqID == IRQ_ID::IRQ_LOCAL_CNTPNS);
-        mem.Write32(ARM_LOCAL_TIMER_INT_CONTROL0, mem.Read32(ARM_LOCAL_TIMER_INT_CONTROL0) & ~BIT1(irq - ARM_IRQ_LOCAL_BASE));
+        memoryAccess.Write32(ARM_LOCAL_TIMER_INT_CONTROL0, memoryAccess.Read32(ARM_LOCAL_TIMER_INT_CONTROL0) & ~BIT1(irq - ARM_IRQ_LOCAL_BASE));
     }
 
 #else
 
-    mem.Write32(RPI_GICD_ICENABLER0 + 4 * (irq / 32), RPI_GICD_IRQ_MASK(irq));
+    memoryAccess.Write32(RPI_GICD_ICENABLER0 + 4 * (irq / 32), RPI_GICD_IRQ_MASK(irq));
 
 #endif
 }
 
 /// <summary>
 /// Enable the requested FIQ
+///
+/// On Raspberry Pi 3, any of the GPU interrupts can be selected as FIQ source, as well as the ARM local timer and core 0 mailbox interrupts.
+/// On the GIC (Raspberry Pi 4), the interrupt is made a group 0 interrupt with priority RPI_GICD_IPRIORITYR_FIQ, and group 0 interrupts are
+/// signalled as FIQ. The group and FIQ settings are only accessible from the secure world, with the standard armstub the kernel runs
+/// non-secure, and these writes are ignored. The interrupt is then signalled as IRQ with a priority above all other IRQs, and
+/// InterruptSystem::InterruptHandler() calls the FIQ handler
 /// </summary>
 /// <param name="fiqID">FIQ to enable</param>
-void baremetal::EnableFIQ(FIQ_ID fiqID)
+/// <param name="memoryAccess">Memory access interface, can be overridden for testing</param>
+void baremetal::EnableFIQ(FIQ_ID fiqID, IMemoryAccess& memoryAccess)
 {
     int fiq = static_cast<int>(fiqID);
     assert(fiq <= IRQ_LINES);
-    MemoryAccess mem;
 #if BAREMETAL_RPI_TARGET == 3
 
     if (fiq < ARM_IRQ_LOCAL_BASE)
     {
-        mem.Write32(RPI_INTRCTRL_FIQ_CONTROL, fiq | BIT1(7));
+        memoryAccess.Write32(RPI_INTRCTRL_FIQ_CONTROL, fiq | BIT1(7));
+    }
+    else if ((fiqID >= FIQ_ID::FIQ_LOCAL_MAILBOX0) && (fiqID <= FIQ_ID::FIQ_LOCAL_MAILBOX3))
+    {
+        memoryAccess.Write32(ARM_LOCAL_MAILBOX_INT_CONTROL0,
+                    memoryAccess.Read32(ARM_LOCAL_MAILBOX_INT_CONTROL0) | BIT1(fiq - static_cast<int>(FIQ_ID::FIQ_LOCAL_MAILBOX0) + 4)); // FIQ enable bits are bit 4..7
     }
     else
     {
         // The only implemented local IRQs so far
         assert(fiqID == FIQ_ID::FIQ_LOCAL_CNTPNS);
-        mem.Write32(ARM_LOCAL_TIMER_INT_CONTROL0,
-                    mem.Read32(ARM_LOCAL_TIMER_INT_CONTROL0) | BIT1(fiq - ARM_IRQ_LOCAL_BASE + 4)); // FIQ enable bits are bit 4..7
+        memoryAccess.Write32(ARM_LOCAL_TIMER_INT_CONTROL0,
+                    memoryAccess.Read32(ARM_LOCAL_TIMER_INT_CONTROL0) | BIT1(fiq - ARM_IRQ_LOCAL_BASE + 4)); // FIQ enable bits are bit 4..7
     }
 
 #else
 
-    LOG_PANIC("FIQ not supported yet");
+    regaddr priorityAddress = RPI_GICD_IPRIORITYR0 + 4 * (fiq / 4);
+    unsigned shift = static_cast<unsigned>((fiq % 4) * 8);
+    memoryAccess.Write32(priorityAddress, (memoryAccess.Read32(priorityAddress) & ~(0xFFU << shift)) | (RPI_GICD_IPRIORITYR_FIQ << shift));
+    memoryAccess.Write32(RPI_GICD_IGROUPR0 + 4 * (fiq / 32), memoryAccess.Read32(RPI_GICD_IGROUPR0 + 4 * (fiq / 32)) & ~RPI_GICD_IRQ_MASK(fiq));
+    memoryAccess.Write32(RPI_GICD_CTLR, RPI_GICD_CTLR_ENABLE_GROUP0 | RPI_GICD_CTLR_ENABLE_GROUP1);
+    memoryAccess.Write32(RPI_GICC_CTLR, RPI_GICC_CTLR_ENABLE_GROUP0 | RPI_GICC_CTLR_ENABLE_GROUP1 | RPI_GICC_CTLR_FIQ_ENABLE);
+    memoryAccess.Write32(RPI_GICD_ISENABLER0 + 4 * (fiq / 32), RPI_GICD_IRQ_MASK(fiq));
 
 #endif
 }
@@ -145,28 +162,37 @@ void baremetal::EnableFIQ(FIQ_ID fiqID)
 /// Disable the requested FIQ
 /// </summary>
 /// <param name="fiqID">FIQ to disable</param>
-void baremetal::DisableFIQ(FIQ_ID fiqID)
+/// <param name="memoryAccess">Memory access interface, can be overridden for testing</param>
+void baremetal::DisableFIQ(FIQ_ID fiqID, IMemoryAccess& memoryAccess)
 {
     int fiq = static_cast<int>(fiqID);
     assert(fiq <= IRQ_LINES);
-    MemoryAccess mem;
 #if BAREMETAL_RPI_TARGET == 3
 
     if (fiq < ARM_IRQ_LOCAL_BASE)
     {
-        mem.Write32(RPI_INTRCTRL_FIQ_CONTROL, 0);
+        memoryAccess.Write32(RPI_INTRCTRL_FIQ_CONTROL, 0);
+    }
+    else if ((fiqID >= FIQ_ID::FIQ_LOCAL_MAILBOX0) && (fiqID <= FIQ_ID::FIQ_LOCAL_MAILBOX3))
+    {
+        memoryAccess.Write32(ARM_LOCAL_MAILBOX_INT_CONTROL0,
+                    memoryAccess.Read32(ARM_LOCAL_MAILBOX_INT_CONTROL0) & ~BIT1(fiq - static_cast<int>(FIQ_ID::FIQ_LOCAL_MAILBOX0) + 4)); // FIQ enable bits are bit 4..7
     }
     else
     {
         // The only implemented local IRQs so far
         assert(fiqID == FIQ_ID::FIQ_LOCAL_CNTPNS);
-        mem.Write32(ARM_LOCAL_TIMER_INT_CONTROL0,
-                    mem.Read32(ARM_LOCAL_TIMER_INT_CONTROL0) & ~BIT1(fiq - ARM_IRQ_LOCAL_BASE + 4)); // FIQ enable bits are bit 4..7
+        memoryAccess.Write32(ARM_LOCAL_TIMER_INT_CONTROL0,
+                    memoryAccess.Read32(ARM_LOCAL_TIMER_INT_CONTROL0) & ~BIT1(fiq - ARM_IRQ_LOCAL_BASE + 4)); // FIQ enable bits are bit 4..7
     }
 
 #else
 
-    LOG_PANIC("FIQ not supported yet");
+    memoryAccess.Write32(RPI_GICD_ICENABLER0 + 4 * (fiq / 32), RPI_GICD_IRQ_MASK(fiq));
+    memoryAccess.Write32(RPI_GICD_IGROUPR0 + 4 * (fiq / 32), memoryAccess.Read32(RPI_GICD_IGROUPR0 + 4 * (fiq / 32)) | RPI_GICD_IRQ_MASK(fiq));
+    regaddr priorityAddress = RPI_GICD_IPRIORITYR0 + 4 * (fiq / 4);
+    unsigned shift = static_cast<unsigned>((fiq % 4) * 8);
+    memoryAccess.Write32(priorityAddress, (memoryAccess.Read32(priorityAddress) & ~(0xFFU << shift)) | (RPI_GICD_IPRIORITYR_DEFAULT << shift));
 
 #endif
 }
@@ -39,7 +39,9 @@
 
 #include "baremetal/Logger.h"
 
+#include "baremetal/ARMInstructions.h"
 #include "baremetal/Console.h"
+#include "baremetal/CrashLog.h"
 #include "baremetal/Format.h"
 #include "baremetal/MachineInfo.h"
 #include "baremetal/String.h"
@@ -59,6 +61,100 @@ LOG_MODULE("Logger");
 Console Logger::s_console(nullptr);
 Logger* Logger::s_logger{};
 
+#if BAREMETAL_BINARY_LOG
+
+/// @brief Start of the read only data section, defined by the linker script. Message, source and function strings are stored as offsets relative to this address
+extern "C" const char __rodata_start[];
+/// @brief End of the read only data section, defined by the linker script
+extern "C" const char __rodata_end[];
+
+/// @brief Format ID used in a binary log record to signal a time base record. The first argument holds the counter frequency in Hz
+static const uint32 BinaryLogTimeBaseID = 0xFFFFFFFE;
+/// @brief String ID used in a binary log record for a string which is not in the read only data section (e.g. no function name)
+static const uint32 BinaryLogNoStringID = 0xFFFFFFFF;
+/// @brief Byte used to terminate an encoded binary log record. This byte never occurs inside an encoded record
+static const uint8 BinaryLogFrameEnd = '\n';
+
+/// <summary>
+/// Binary log record header. The header is followed by numArgs 64 bit argument words. All values are little endian.
+/// </summary>
+struct BinaryLogRecordHeader
+{
+    /// @brief Offset of format string relative to start of read only data section
+    uint32 formatID;
+    /// @brief Offset of source name or file name relative to start of read only data section
+    uint32 sourceID;
+    /// @brief Offset of function name relative to start of read only data section, BinaryLogNoStringID for log messages
+    uint32 functionID;
+    /// @brief Physical counter value (CNTPCT_EL0) at time of logging
+    uint64 timestamp;
+    /// @brief Source line number
+    uint16 line;
+    /// @brief Log severity
+    uint8 severity;
+    /// @brief Number of 64 bit argument words following the header
+    uint8 numArgs;
+} PACKED;
+
+/// @brief Maximum size of an unencoded binary log record
+static const size_t BinaryLogRecordMaxSize = sizeof(BinaryLogRecordHeader) + LOGGER_BINARY_MAX_ARGUMENTS * sizeof(uint64);
+/// @brief Maximum size of an encoded binary log record, including the frame end byte
+static const size_t BinaryLogFrameMaxSize = BinaryLogRecordMaxSize + BinaryLogRecordMaxSize / 254 + 2;
+
+/// <summary>
+/// Convert a string pointer to an offset into the read only data section
+/// </summary>
+/// <param name="str">String pointer</param>
+/// <returns>Offset into the read only data section, or BinaryLogNoStringID if the string is not located in the read only data section</returns>
+static uint32 GetInternedStringID(const char* str)
+{
+    if (!Logger::IsInternedString(str))
+        return BinaryLogNoStringID;
+    return static_cast<uint32>(str - __rodata_start);
+}
+
+/// <summary>
+/// Encode a binary log record into a frame which does not contain the frame end byte.
+///
+/// The record is encoded using Consistent Overhead Byte Stuffing (COBS), which removes all zero bytes,
+/// after which all bytes are XOR-ed with the frame end byte. The frame end byte is appended.
+/// As the console device converts every newline into carriage return + newline, the decoder must strip the carriage return before the frame end.
+/// </summary>
+/// <param name="record">Record to encode</param>
+/// <param name="size">Size of record in bytes</param>
+/// <param name="frame">Buffer receiving the encoded frame, at least size + size / 254 + 2 bytes</param>
+/// <returns>Size of encoded frame in bytes</returns>
+size_t baremetal::EncodeBinaryLogFrame(const uint8* record, size_t size, uint8* frame)
+{
+    size_t codeIndex = 0;
+    size_t outIndex = 1;
+    uint8 code = 1;
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (record[i] == 0)
+        {
+            frame[codeIndex] = code;
+            codeIndex = outIndex++;
+            code = 1;
+            continue;
+        }
+        frame[outIndex++] = record[i];
+        if (++code == 0xFF)
+        {
+            frame[codeIndex] = code;
+            codeIndex = outIndex++;
+            code = 1;
+        }
+    }
+    frame[codeIndex] = code;
+    for (size_t i = 0; i < outIndex; ++i)
+        frame[i] ^= BinaryLogFrameEnd;
+    frame[outIndex++] = BinaryLogFrameEnd;
+    return outIndex;
+}
+
+#endif
+
 /// <summary>
 /// Construct a logger
 /// </summary>
@@ -68,6 +164,36 @@ Logger::Logger(LogSeverity logLevel, Timer* timer /*= nullptr*/)
     : m_isInitialized{}
     , m_timer{timer}
     , m_level{logLevel}
+    , m_timestampMode{LogTimestampMode::Uptime}
+    , m_counterFrequency{}
+    , m_maxLevel{logLevel}
+    , m_moduleLevels{}
+    , m_moduleLevelCount{}
+    , m_rateLimitBurst{LOGGER_RATE_LIMIT_BURST}
+    , m_rateLimitPerSecond{LOGGER_RATE_LIMIT_PER_SECOND}
+    , m_rateLimitedCount{}
+    , m_rateLimitedSource{}
+    , m_rateLimitedLine{}
+    , m_lastSource{}
+    , m_lastLine{}
+    , m_lastSeverity{}
+    , m_lastMessageHash{}
+    , m_repeatCount{}
+    , m_isAsynchronous{}
+    , m_overflowPolicy{LogOverflowPolicy::DropNewest}
+    , m_queue{}
+    , m_queueWriteCount{}
+    , m_queueReadCount{}
+    , m_droppedLineCount{}
+    , m_reportedDroppedLineCount{}
+    , m_isDraining{}
+#if BAREMETAL_BINARY_LOG
+    , m_binaryBuffer{}
+    , m_binaryBufferHead{}
+    , m_binaryBufferTail{}
+    , m_binaryRecordsDropped{}
+    , m_binaryBufferDraining{}
+#endif
 {
 }
 
@@ -89,7 +215,22 @@ bool Logger::Initialize()
     if (m_isInitialized)
         return true;
     SetupVersion();
+    GetTimerFrequency(m_counterFrequency);
     m_isInitialized = true; // Stop reentrant calls from happening
+#if BAREMETAL_BINARY_LOG
+    // Tell the decoder how to convert timestamps
+    BinaryLogRecordHeader header{};
+    uint64 counterFrequency{};
+    GetTimerFrequency(counterFrequency);
+    uint8 record[sizeof(header) + sizeof(counterFrequency)];
+    header.formatID = BinaryLogTimeBaseID;
+    header.sourceID = BinaryLogNoStringID;
+    header.functionID = BinaryLogNoStringID;
+    header.numArgs = 1;
+    memcpy(record, &header, sizeof(header));
+    memcpy(record + sizeof(header), &counterFrequency, sizeof(counterFrequency));
+    WriteBinaryRecord(record, sizeof(record));
+#endif
     LOG_NO_ALLOC_INFO(BAREMETAL_NAME " %s started on %s (AArch64) using %s SoC", BAREMETAL_VERSION_STRING, GetMachineInfo().GetName(), GetMachineInfo().GetSoCName());
 
     return true;
@@ -104,6 +245,7 @@ LogSeverity Logger::SetLogLevel(LogSeverity logLevel)
 {
     LogSeverity previousLevel = m_level;
     m_level = logLevel;
+    UpdateMaxLevel();
     return previousLevel;
 }
 
@@ -117,6 +259,590 @@ bool Logger::IsLogSeverityEnabled(LogSeverity severity)
     return (static_cast<int>(severity) <= static_cast<int>(m_level));
 }
 
+/// <summary>
+/// Check whether a module name matches a log source. The source matches if it is equal to the module name (LOG_* statements), or if it is the module name
+/// followed by a file extension (TRACE_* statements)
+/// </summary>
+/// <param name="source">Source name or file name of log statement</param>
+/// <param name="module">Module name</param>
+/// <returns>True if the source belongs to the module, false otherwise</returns>
+static bool IsSourceInModule(const char* source, const char* module)
+{
+    size_t length = strlen(module);
+    return (strncmp(source, module, length) == 0) && ((source[length] == '\0') || (source[length] == '.'));
+}
+
+/// <summary>
+/// Check if the log level for the specified source will result in output. Module log levels set with SetModuleLogLevel() override the global log level
+/// </summary>
+/// <param name="source">Source name or file name of log statement</param>
+/// <param name="severity">Severity level to check</param>
+/// <returns>True is the severity level is enabled for the source, false if not</returns>
+bool Logger::IsLogSeverityEnabled(const char* source, LogSeverity severity)
+{
+    LogSeverity level = m_level;
+    for (size_t i = 0; i < m_moduleLevelCount; ++i)
+    {
+        if (IsSourceInModule(source, m_moduleLevels[i].name))
+        {
+            level = m_moduleLevels[i].level;
+            break;
+        }
+    }
+    return (static_cast<int>(severity) <= static_cast<int>(level));
+}
+
+/// <summary>
+/// Set the log level for a single module, overriding the global log level. This can both raise and lower the log level for the module
+/// </summary>
+/// <param name="module">Module name, as specified in LOG_MODULE(). TRACE_* statements in a source file with the module name plus extension are also affected</param>
+/// <param name="logLevel">Log level for the module</param>
+/// <returns>True if the log level was set, false if the maximum number of module log levels (LOGGER_MAX_MODULE_LEVELS) is reached</returns>
+bool Logger::SetModuleLogLevel(const char* module, LogSeverity logLevel)
+{
+    size_t index{};
+    for (index = 0; index < m_moduleLevelCount; ++index)
+    {
+        if (strcmp(m_moduleLevels[index].name, module) == 0)
+            break;
+    }
+    if (index >= LOGGER_MAX_MODULE_LEVELS)
+        return false;
+    if (index == m_moduleLevelCount)
+    {
+        m_moduleLevels[index].name[0] = '\0';
+        strncat(m_moduleLevels[index].name, module, LOGGER_MODULE_NAME_SIZE - 1);
+    }
+    m_moduleLevels[index].level = logLevel;
+    if (index == m_moduleLevelCount)
+        ++m_moduleLevelCount;
+    UpdateMaxLevel();
+    return true;
+}
+
+/// <summary>
+/// Remove the log level for a single module, the module will use the global log level again
+/// </summary>
+/// <param name="module">Module name</param>
+void Logger::ResetModuleLogLevel(const char* module)
+{
+    for (size_t index = 0; index < m_moduleLevelCount; ++index)
+    {
+        if (strcmp(m_moduleLevels[index].name, module) == 0)
+        {
+            m_moduleLevels[index] = m_moduleLevels[m_moduleLevelCount - 1];
+            --m_moduleLevelCount;
+            break;
+        }
+    }
+    UpdateMaxLevel();
+}
+
+/// <summary>
+/// Return the log level for a single module
+/// </summary>
+/// <param name="module">Module name</param>
+/// <returns>Log level set for the module, or the global log level if not set</returns>
+LogSeverity Logger::GetModuleLogLevel(const char* module)
+{
+    for (size_t index = 0; index < m_moduleLevelCount; ++index)
+    {
+        if (strcmp(m_moduleLevels[index].name, module) == 0)
+            return m_moduleLevels[index].level;
+    }
+    return m_level;
+}
+
+/// <summary>
+/// Set the rate limit for log statements. Every log statement can output a burst of messages, after which it is limited to a number of messages per second.
+/// Suppressed messages are counted and reported with the next message output
+/// </summary>
+/// <param name="burst">Number of messages a log statement can output in a burst. 0 disables rate limiting</param>
+/// <param name="perSecond">Number of messages per second a log statement can output when rate limited</param>
+void Logger::SetRateLimit(uint32 burst, uint32 perSecond)
+{
+    m_rateLimitPerSecond = (perSecond > 0) ? perSecond : 1;
+    m_rateLimitBurst = burst;
+}
+
+/// <summary>
+/// Set the format of the timestamp at the start of each log line
+/// </summary>
+/// <param name="mode">Timestamp format</param>
+void Logger::SetTimestampMode(LogTimestampMode mode)
+{
+    m_timestampMode = mode;
+}
+
+/// <summary>
+/// Format a timestamp for a log line. Both modes use the ARM system counter value captured when the log statement was executed, so that the time shown is
+/// when the message was logged, also if the line is written later from the asynchronous queue. In uptime mode, it is written as seconds and microseconds
+/// since boot. In calendar mode, it is converted to the system timer time string, if a timer is set.
+/// </summary>
+/// <param name="buffer">Buffer to receive the timestamp, empty if there is no timestamp</param>
+/// <param name="bufferSize">Size of the buffer</param>
+/// <param name="timestamp">ARM system counter value</param>
+void Logger::FormatTimestamp(char* buffer, size_t bufferSize, uint64 timestamp)
+{
+    buffer[0] = '\0';
+    switch (m_timestampMode)
+    {
+    case LogTimestampMode::Uptime:
+        FormatUptimeTimestamp(buffer, bufferSize, timestamp, m_counterFrequency);
+        break;
+    case LogTimestampMode::Calendar:
+        if (m_timer != nullptr)
+            m_timer->GetTimeString(buffer, bufferSize, timestamp);
+        break;
+    default:
+        break;
+    }
+}
+
+/// <summary>
+/// Format an ARM system counter value as seconds and microseconds since boot ("s.uuuuuu")
+/// </summary>
+/// <param name="buffer">Buffer to receive the timestamp, empty if the frequency is not known</param>
+/// <param name="bufferSize">Size of the buffer</param>
+/// <param name="counter">ARM system counter value</param>
+/// <param name="frequency">ARM system counter frequency in Hz</param>
+void baremetal::FormatUptimeTimestamp(char* buffer, size_t bufferSize, uint64 counter, uint64 frequency)
+{
+    buffer[0] = '\0';
+    if (frequency == 0)
+        return;
+    uint64 seconds = counter / frequency;
+    uint64 microSeconds = (counter % frequency) * USEC_PER_SEC / frequency;
+    FormatNoAlloc(buffer, bufferSize, "%llu.%06llu", seconds, microSeconds);
+}
+
+/// <summary>
+/// Determine the highest log level of the global log level and all module log levels
+/// </summary>
+void Logger::UpdateMaxLevel()
+{
+    LogSeverity maxLevel = m_level;
+    for (size_t i = 0; i < m_moduleLevelCount; ++i)
+    {
+        if (static_cast<int>(m_moduleLevels[i].level) > static_cast<int>(maxLevel))
+            maxLevel = m_moduleLevels[i].level;
+    }
+    m_maxLevel = maxLevel;
+}
+
+/// <summary>
+/// Take a token from the token bucket of a log statement, refilling the bucket for the time passed since the last refill.
+/// When a log statement outputs again after messages were suppressed, the suppressed messages are counted, with the location of the log statement,
+/// to be reported with the next message output. The call site and counters are updated with IRQs disabled, as the same log statement may be executed from
+/// an interrupt handler
+/// </summary>
+/// <param name="callSite">Rate limiting state of the log statement</param>
+/// <param name="source">Source name or file name of the log statement</param>
+/// <param name="line">Source line number of the log statement</param>
+/// <returns>True if a token was available and the message may be output, false if it is suppressed</returns>
+bool Logger::ConsumeRateLimitToken(LogCallSite& callSite, const char* source, int line)
+{
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    uint64 now{};
+    GetTimerCounter(now);
+    if (callSite.tokens < m_rateLimitBurst)
+    {
+        uint64 frequency{};
+        GetTimerFrequency(frequency);
+        uint64 elapsed = now - callSite.lastRefillTime;
+        // Limit elapsed time to the time needed to refill the complete bucket, to prevent overflow
+        uint64 fullRefillTime = frequency * m_rateLimitBurst / m_rateLimitPerSecond;
+        if (elapsed > fullRefillTime)
+            elapsed = fullRefillTime;
+        uint64 newTokens = elapsed * m_rateLimitPerSecond / frequency;
+        if (newTokens > 0)
+        {
+            callSite.tokens = MIN(callSite.tokens + static_cast<uint32>(newTokens), m_rateLimitBurst);
+            callSite.lastRefillTime = now;
+        }
+    }
+    else
+        callSite.lastRefillTime = now;
+    if (callSite.tokens == 0)
+    {
+        ++callSite.suppressedCount;
+        SetDAIF(daif);
+        return false;
+    }
+    --callSite.tokens;
+    if (callSite.suppressedCount > 0)
+    {
+        m_rateLimitedCount += callSite.suppressedCount;
+        m_rateLimitedSource = source;
+        m_rateLimitedLine = line;
+        callSite.suppressedCount = 0;
+    }
+    SetDAIF(daif);
+    return true;
+}
+
+/// <summary>
+/// Calculate FNV-1a hash of a string
+/// </summary>
+/// <param name="str">String to calculate hash of</param>
+/// <returns>Hash value</returns>
+static uint32 HashString(const char* str)
+{
+    uint32 hash = 2166136261u;
+    while (*str != '\0')
+    {
+        hash ^= static_cast<uint8>(*str++);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/// <summary>
+/// Check whether a message is an exact repeat of the last message output from the same log statement. Repeated messages are counted and reported as
+/// "Last message repeated N times" when a different message is output, or when the logger is flushed. Also reports messages suppressed by rate limiting,
+/// with the location of the log statement they were suppressed at. Panic messages are never suppressed.
+/// The repeat and rate limiting state is updated with IRQs disabled, as log statements may also be executed from interrupt handlers. The reports are
+/// written afterwards
+/// </summary>
+/// <param name="source">Source name or file name of log statement</param>
+/// <param name="line">Source line number of log statement</param>
+/// <param name="severity">Severity of message</param>
+/// <param name="message">Formatted message text</param>
+/// <returns>True if the message is a repeat and must be suppressed, false if it must be output</returns>
+bool Logger::IsRepeatedMessage(const char* source, int line, LogSeverity severity, const char* message)
+{
+    uint32 hash = HashString(message);
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    if ((severity != LogSeverity::Panic) && (source == m_lastSource) && (line == m_lastLine) && (hash == m_lastMessageHash))
+    {
+        ++m_repeatCount;
+        SetDAIF(daif);
+        return true;
+    }
+    uint32 repeatCount = m_repeatCount;
+    const char* lastSource = m_lastSource;
+    int lastLine = m_lastLine;
+    LogSeverity lastSeverity = m_lastSeverity;
+    m_repeatCount = 0;
+    m_lastSource = source;
+    m_lastLine = line;
+    m_lastSeverity = severity;
+    m_lastMessageHash = hash;
+    uint32 rateLimitedCount = m_rateLimitedCount;
+    const char* rateLimitedSource = m_rateLimitedSource;
+    int rateLimitedLine = m_rateLimitedLine;
+    m_rateLimitedCount = 0;
+    SetDAIF(daif);
+
+    WriteRepeatedMessage(repeatCount, lastSource, lastLine, lastSeverity);
+    if (rateLimitedCount > 0)
+    {
+        static const size_t BufferSize = 128;
+        char buffer[BufferSize]{};
+        FormatNoAlloc(buffer, BufferSize, "Warning %u messages suppressed by rate limit (%s:%d)\n", rateLimitedCount, rateLimitedSource, rateLimitedLine);
+        WriteLine(LogSeverity::Warning, buffer);
+    }
+    return false;
+}
+
+/// <summary>
+/// Output the number of times the last message was repeated, if any
+/// </summary>
+void Logger::ReportRepeatedMessage()
+{
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    uint32 repeatCount = m_repeatCount;
+    const char* lastSource = m_lastSource;
+    int lastLine = m_lastLine;
+    LogSeverity lastSeverity = m_lastSeverity;
+    m_repeatCount = 0;
+    SetDAIF(daif);
+    WriteRepeatedMessage(repeatCount, lastSource, lastLine, lastSeverity);
+}
+
+/// <summary>
+/// Output the number of times a message was repeated, if not 0
+/// </summary>
+/// <param name="repeatCount">Number of times the message was repeated and suppressed</param>
+/// <param name="source">Source name or file name of the log statement of the message</param>
+/// <param name="line">Source line number of the log statement of the message</param>
+/// <param name="severity">Severity of the message</param>
+void Logger::WriteRepeatedMessage(uint32 repeatCount, const char* source, int line, LogSeverity severity)
+{
+    if (repeatCount == 0)
+        return;
+    static const size_t BufferSize = 128;
+    char buffer[BufferSize]{};
+    FormatNoAlloc(buffer, BufferSize, "Last message repeated %u times (%s:%d)\n", repeatCount, source, line);
+    WriteLine(severity, buffer);
+}
+
+/// <summary>
+/// Switch between synchronous and asynchronous logging.
+///
+/// In synchronous mode (the default), every log line is written to the console before the log call returns.
+/// In asynchronous mode, log lines are formatted into a preallocated queue and the log call returns immediately.
+/// The queue is written to the console by ProcessQueue() (e.g. from the application idle loop), and up to LOGGER_DRAIN_PER_TICK lines per timer tick from the timer interrupt.
+/// Switching back to synchronous mode writes all queued lines.
+/// </summary>
+/// <param name="enable">If true, switch to asynchronous mode, if false, switch to synchronous mode</param>
+/// <param name="policy">Policy to use when the queue is full. Defaults to LogOverflowPolicy::DropNewest</param>
+void Logger::SetAsynchronous(bool enable, LogOverflowPolicy policy /*= LogOverflowPolicy::DropNewest*/)
+{
+    m_overflowPolicy = policy;
+    if (enable == m_isAsynchronous)
+        return;
+    if (enable)
+    {
+        m_isAsynchronous = true;
+        if (m_timer != nullptr)
+            m_timer->RegisterPeriodicHandler(PeriodicHandler);
+    }
+    else
+    {
+        if (m_timer != nullptr)
+            m_timer->UnregisterPeriodicHandler(PeriodicHandler);
+        m_isAsynchronous = false;
+        Flush();
+    }
+}
+
+/// <summary>
+/// Check whether asynchronous logging is enabled
+/// </summary>
+/// <returns>True if log lines are queued, false if they are written immediately</returns>
+bool Logger::IsAsynchronous() const
+{
+    return m_isAsynchronous;
+}
+
+/// <summary>
+/// Write queued log lines to the console. Only one context can write the queue at a time, nested calls return immediately.
+/// </summary>
+/// <param name="maxLines">Maximum number of lines to write. Defaults to LOGGER_QUEUE_SIZE</param>
+/// <returns>Number of lines written</returns>
+size_t Logger::ProcessQueue(size_t maxLines /*= LOGGER_QUEUE_SIZE*/)
+{
+    // Exclusive load/store is not reliable on Device memory (the MMU is off), so the flag is tested and set with IRQs disabled. Only one core is running
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    bool isDraining = m_isDraining;
+    m_isDraining = true;
+    SetDAIF(daif);
+    if (isDraining)
+        return 0;
+
+    size_t count{};
+    uint32 dropped = m_droppedLineCount;
+    if (dropped != m_reportedDroppedLineCount)
+    {
+        char buffer[64]{};
+        FormatNoAlloc(buffer, sizeof(buffer), "Warning %u log lines dropped\n", dropped - m_reportedDroppedLineCount);
+        if (WriteLineToConsole(LogSeverity::Warning, buffer, false))
+            m_reportedDroppedLineCount = dropped;
+    }
+    while (count < maxLines)
+    {
+        LogQueueEntry& entry = m_queue[m_queueReadCount % LOGGER_QUEUE_SIZE];
+        if ((m_queueReadCount == m_queueWriteCount) || !__atomic_load_n(&entry.isReady, __ATOMIC_ACQUIRE))
+            break;
+        if (!WriteLineToConsole(entry.severity, entry.line, false))
+            break;
+        __atomic_store_n(&entry.isReady, false, __ATOMIC_RELAXED);
+        __atomic_store_n(&m_queueReadCount, m_queueReadCount + 1, __ATOMIC_RELEASE);
+        ++count;
+    }
+
+    __atomic_store_n(&m_isDraining, false, __ATOMIC_RELEASE);
+    return count;
+}
+
+/// <summary>
+/// Write all queued log lines to the console. Intended for panic and shutdown paths, to make sure nothing is lost
+/// </summary>
+void Logger::Flush()
+{
+    ReportRepeatedMessage();
+    while (ProcessQueue() != 0)
+    {
+    }
+#if BAREMETAL_BINARY_LOG
+    FlushBinary();
+#endif
+    s_console.Flush();
+}
+
+/// <summary>
+/// Return the number of log lines dropped because the asynchronous queue was full
+/// </summary>
+/// <returns>Number of dropped log lines</returns>
+uint32 Logger::GetDroppedLineCount() const
+{
+    return m_droppedLineCount;
+}
+
+/// <summary>
+/// Output a formatted log line, either directly to the console, or through the asynchronous queue. A copy is kept in the crash log if enabled
+/// </summary>
+/// <param name="severity">Severity of the line, used for selecting the color</param>
+/// <param name="line">Formatted line, including newline</param>
+void Logger::WriteLine(LogSeverity severity, const char* line)
+{
+#if BAREMETAL_CRASH_LOG
+    GetCrashLog().Write(line, strlen(line));
+#endif
+    if (m_isAsynchronous)
+    {
+        if ((severity != LogSeverity::Panic) && EnqueueLine(severity, line))
+            return;
+        // Write the lines leading up to a panic first, so that the panic line is the last one
+        if (severity == LogSeverity::Panic)
+        {
+            while (ProcessQueue() != 0)
+            {
+            }
+        }
+    }
+    WriteLineToConsole(severity, line, true);
+}
+
+/// <summary>
+/// Write a formatted log line to the console, using a severity specific color if BAREMETAL_COLOR_OUTPUT is set
+/// </summary>
+/// <param name="severity">Severity of the line, used for selecting the color</param>
+/// <param name="line">Formatted line, including newline</param>
+/// <param name="wait">If true, wait until the console is free, if false, return false if the console is in use</param>
+/// <returns>True if the line was written, false otherwise</returns>
+bool Logger::WriteLineToConsole(LogSeverity severity, const char* line, bool wait)
+{
+#if BAREMETAL_COLOR_OUTPUT
+    ConsoleColor color{ConsoleColor::White};
+    switch (severity)
+    {
+    case LogSeverity::Panic:
+        color = ConsoleColor::BrightRed;
+        break;
+    case LogSeverity::Error:
+        color = ConsoleColor::Red;
+        break;
+    case LogSeverity::Warning:
+        color = ConsoleColor::BrightYellow;
+        break;
+    case LogSeverity::Info:
+        color = ConsoleColor::Cyan;
+        break;
+    case LogSeverity::Debug:
+        color = ConsoleColor::Yellow;
+        break;
+    case LogSeverity::Data:
+        color = ConsoleColor::Magenta;
+        break;
+    }
+    if (!wait)
+        return s_console.TryWrite(line, color);
+    s_console.Write(line, color);
+#else
+    s_console.Write(line);
+#endif
+    return true;
+}
+
+/// <summary>
+/// Add a formatted log line to the asynchronous queue. Safe to call from interrupt context.
+///
+/// A slot is reserved by incrementing the write count with IRQs disabled, after which the line is copied and the slot is marked ready.
+/// Exclusive load/store (and so compare-and-swap) is not reliable on Device memory, which all memory is while the MMU is off, and only one core is running.
+/// If the queue is full, the overflow policy decides whether the oldest line is dropped, the new line is dropped, or the queue is written to the console
+/// first. Dropping the oldest line is only possible if the queue is not being written at the same time, and the oldest line is complete, otherwise the new
+/// line is dropped.
+/// </summary>
+/// <param name="severity">Severity of the line, used for selecting the color</param>
+/// <param name="line">Formatted line, including newline</param>
+/// <returns>True if the line was queued or dropped, false if it must be written directly</returns>
+bool Logger::EnqueueLine(LogSeverity severity, const char* line)
+{
+    uint32 writeCount{};
+    for (;;)
+    {
+        uint64 daif;
+        GetDAIF(daif);
+        DisableIRQs();
+        writeCount = m_queueWriteCount;
+        uint32 readCount = m_queueReadCount;
+        if (writeCount - readCount < LOGGER_QUEUE_SIZE)
+        {
+            __atomic_store_n(&m_queueWriteCount, writeCount + 1, __ATOMIC_RELEASE);
+            SetDAIF(daif);
+            break;
+        }
+
+        bool isDropped{};
+        switch (m_overflowPolicy)
+        {
+        case LogOverflowPolicy::Block:
+            // Logging from within the console write (e.g. an interrupt), cannot wait for ourselves
+            isDropped = m_isDraining;
+            break;
+        case LogOverflowPolicy::DropOldest:
+        {
+            LogQueueEntry& oldest = m_queue[readCount % LOGGER_QUEUE_SIZE];
+            if (!m_isDraining && oldest.isReady)
+            {
+                // Invalidate the oldest line before removing it from the queue, so that the slot is never handed to a new line while still marked ready
+                oldest.isReady = false;
+                __atomic_store_n(&m_queueReadCount, readCount + 1, __ATOMIC_RELEASE);
+            }
+            else
+            {
+                isDropped = true;
+            }
+            m_droppedLineCount = m_droppedLineCount + 1;
+            SetDAIF(daif);
+            if (isDropped)
+                return true;
+            continue;
+        }
+        case LogOverflowPolicy::DropNewest:
+            isDropped = true;
+            break;
+        }
+        if (isDropped)
+            m_droppedLineCount = m_droppedLineCount + 1;
+        SetDAIF(daif);
+        if (isDropped)
+            return true;
+        if (ProcessQueue(1) == 0)
+            return false;
+    }
+
+    LogQueueEntry& entry = m_queue[writeCount % LOGGER_QUEUE_SIZE];
+    entry.severity = severity;
+    strncpy(entry.line, line, LOGGER_QUEUE_LINE_SIZE - 1);
+    entry.line[LOGGER_QUEUE_LINE_SIZE - 1] = '\0';
+    size_t length = strlen(entry.line);
+    if ((length > 0) && (entry.line[length - 1] != '\n'))
+        entry.line[length - 1] = '\n';
+    __atomic_store_n(&entry.isReady, true, __ATOMIC_RELEASE);
+    return true;
+}
+
+/// <summary>
+/// Timer tick handler for asynchronous logging. Writes at most LOGGER_DRAIN_PER_TICK queued lines per tick, and only while the console is not in use,
+/// to limit the time spent in interrupt context
+/// </summary>
+void Logger::PeriodicHandler()
+{
+    if (HaveLogger())
+        s_logger->ProcessQueue(LOGGER_DRAIN_PER_TICK);
+}
+
 /// <summary>
 /// Write a string with variable arguments to the logger
 /// </summary>
@@ -142,14 +868,19 @@ void Logger::Log(const char* source, int line, LogSeverity severity, const char*
 /// <param name="args">Variable argument list</param>
 void Logger::LogV(const char* source, int line, LogSeverity severity, const char* message, va_list args)
 {
-    if (!IsLogSeverityEnabled(severity))
+    if (!IsLogSeverityEnabled(source, severity))
         return;
 
+    uint64 timestamp{};
+    GetTimerCounter(timestamp);
+
     String lineBuffer;
 
     auto sourceString = Format(" (%s:%d)", source, line);
 
     auto messageBuffer = FormatV(message, args);
+    if (IsRepeatedMessage(source, line, severity, messageBuffer.c_str()))
+        return;
 
     switch (severity)
     {
@@ -173,53 +904,24 @@ void Logger::LogV(const char* source, int line, LogSeverity severity, const char
         break;
     }
 
-    if (m_timer != nullptr)
+    const size_t TimeBufferSize = 32;
+    char timeBuffer[TimeBufferSize]{};
+    FormatTimestamp(timeBuffer, TimeBufferSize, timestamp);
+    if (strlen(timeBuffer) > 0)
     {
-        const size_t TimeBufferSize = 32;
-        char timeBuffer[TimeBufferSize]{};
-        m_timer->GetTimeString(timeBuffer, TimeBufferSize);
-        if (strlen(timeBuffer) > 0)
-        {
-            lineBuffer += timeBuffer;
-            lineBuffer += ' ';
-        }
+        lineBuffer += timeBuffer;
+        lineBuffer += ' ';
     }
 
     lineBuffer += messageBuffer;
     lineBuffer += sourceString;
     lineBuffer += "\n";
 
-#if BAREMETAL_COLOR_OUTPUT
-    switch (severity)
-    {
-    case LogSeverity::Panic:
-        s_console.Write(lineBuffer, ConsoleColor::BrightRed);
-        break;
-    case LogSeverity::Error:
-        s_console.Write(lineBuffer, ConsoleColor::Red);
-        break;
-    case LogSeverity::Warning:
-        s_console.Write(lineBuffer, ConsoleColor::BrightYellow);
-        break;
-    case LogSeverity::Info:
-        s_console.Write(lineBuffer, ConsoleColor::Cyan);
-        break;
-    case LogSeverity::Debug:
-        s_console.Write(lineBuffer, ConsoleColor::Yellow);
-        break;
-    case LogSeverity::Data:
-        s_console.Write(lineBuffer, ConsoleColor::Magenta);
-        break;
-    default:
-        s_console.Write(lineBuffer, ConsoleColor::White);
-        break;
-    }
-#else
-    s_console.Write(lineBuffer);
-#endif
+    WriteLine(severity, lineBuffer.c_str());
 
     if (severity == LogSeverity::Panic)
     {
+        Flush();
         GetSystem().Halt();
     }
 }
@@ -249,9 +951,12 @@ void Logger::LogNoAlloc(const char* source, int line, LogSeverity severity, cons
 /// <param name="args">Variable argument list</param>
 void Logger::LogNoAllocV(const char* source, int line, LogSeverity severity, const char* message, va_list args)
 {
-    if (!IsLogSeverityEnabled(severity))
+    if (!IsLogSeverityEnabled(source, severity))
         return;
 
+    uint64 timestamp{};
+    GetTimerCounter(timestamp);
+
     static const size_t BufferSize = 1024;
     char buffer[BufferSize]{};
 
@@ -260,6 +965,8 @@ void Logger::LogNoAllocV(const char* source, int line, LogSeverity severity, con
 
     char messageBuffer[BufferSize]{};
     FormatNoAllocV(messageBuffer, BufferSize, message, args);
+    if (IsRepeatedMessage(source, line, severity, messageBuffer))
+        return;
 
     switch (severity)
     {
@@ -283,53 +990,24 @@ void Logger::LogNoAllocV(const char* source, int line, LogSeverity severity, con
         break;
     }
 
-    if (m_timer != nullptr)
+    const size_t TimeBufferSize = 32;
+    char timeBuffer[TimeBufferSize]{};
+    FormatTimestamp(timeBuffer, TimeBufferSize, timestamp);
+    if (strlen(timeBuffer) > 0)
     {
-        const size_t TimeBufferSize = 32;
-        char timeBuffer[TimeBufferSize]{};
-        m_timer->GetTimeString(timeBuffer, TimeBufferSize);
-        if (strlen(timeBuffer) > 0)
-        {
-            strncat(buffer, timeBuffer, BufferSize);
-            strncat(buffer, " ", BufferSize);
-        }
+        strncat(buffer, timeBuffer, BufferSize);
+        strncat(buffer, " ", BufferSize);
     }
 
     strncat(buffer, messageBuffer, BufferSize);
     strncat(buffer, sourceString, BufferSize);
     strncat(buffer, "\n", BufferSize);
 
-#if BAREMETAL_COLOR_OUTPUT
-    switch (severity)
-    {
-    case LogSeverity::Panic:
-        s_console.Write(buffer, ConsoleColor::BrightRed);
-        break;
-    case LogSeverity::Error:
-        s_console.Write(buffer, ConsoleColor::Red);
-        break;
-    case LogSeverity::Warning:
-        s_console.Write(buffer, ConsoleColor::BrightYellow);
-        break;
-    case LogSeverity::Info:
-        s_console.Write(buffer, ConsoleColor::Cyan);
-        break;
-    case LogSeverity::Debug:
-        s_console.Write(buffer, ConsoleColor::Yellow);
-        break;
-    case LogSeverity::Data:
-        s_console.Write(buffer, ConsoleColor::Magenta);
-        break;
-    default:
-        s_console.Write(buffer, ConsoleColor::White);
-        break;
-    }
-#else
-    s_console.Write(buffer);
-#endif
+    WriteLine(severity, buffer);
 
     if (severity == LogSeverity::Panic)
     {
+        Flush();
         GetSystem().Halt();
     }
 }
@@ -361,14 +1039,19 @@ void Logger::Trace(const char* filename, int line, const char* function, LogSeve
 /// <param name="args">Variable argument list</param>
 void Logger::TraceV(const char* filename, int line, const char* function, LogSeverity severity, const char* message, va_list args)
 {
-    if (!IsLogSeverityEnabled(severity))
+    if (!IsLogSeverityEnabled(filename, severity))
         return;
 
+    uint64 timestamp{};
+    GetTimerCounter(timestamp);
+
     String lineBuffer;
 
     auto sourceString = Format(" (%s:%d)", filename, line);
 
     auto messageBuffer = FormatV(message, args);
+    if (IsRepeatedMessage(filename, line, severity, messageBuffer.c_str()))
+        return;
 
     switch (severity)
     {
@@ -388,44 +1071,20 @@ void Logger::TraceV(const char* filename, int line, const char* function, LogSev
         break;
     }
 
-    if (m_timer != nullptr)
+    const size_t TimeBufferSize = 32;
+    char timeBuffer[TimeBufferSize]{};
+    FormatTimestamp(timeBuffer, TimeBufferSize, timestamp);
+    if (strlen(timeBuffer) > 0)
     {
-        const size_t TimeBufferSize = 32;
-        char timeBuffer[TimeBufferSize]{};
-        m_timer->GetTimeString(timeBuffer, TimeBufferSize);
-        if (strlen(timeBuffer) > 0)
-        {
-            lineBuffer += timeBuffer;
-            lineBuffer += ' ';
-        }
+        lineBuffer += timeBuffer;
+        lineBuffer += ' ';
     }
 
     lineBuffer += messageBuffer;
     lineBuffer += sourceString;
     lineBuffer += "\n";
 
-#if BAREMETAL_COLOR_OUTPUT
-    switch (severity)
-    {
-    case LogSeverity::Warning:
-        s_console.Write(lineBuffer, ConsoleColor::BrightYellow);
-        break;
-    case LogSeverity::Info:
-        s_console.Write(lineBuffer, ConsoleColor::Cyan);
-        break;
-    case LogSeverity::Debug:
-        s_console.Write(lineBuffer, ConsoleColor::Yellow);
-        break;
-    case LogSeverity::Data:
-        s_console.Write(lineBuffer, ConsoleColor::Magenta);
-        break;
-    default:
-        s_console.Write(lineBuffer, ConsoleColor::White);
-        break;
-    }
-#else
-    s_console.Write(lineBuffer);
-#endif
+    WriteLine(severity, lineBuffer.c_str());
 }
 
 /// <summary>
@@ -455,9 +1114,12 @@ void Logger::TraceNoAlloc(const char* filename, int line, const char* function,
 /// <param name="args">Variable argument list</param>
 void Logger::TraceNoAllocV(const char* filename, int line, const char* function, LogSeverity severity, const char* message, va_list args)
 {
-    if (!IsLogSeverityEnabled(severity))
+    if (!IsLogSeverityEnabled(filename, severity))
         return;
 
+    uint64 timestamp{};
+    GetTimerCounter(timestamp);
+
     static const size_t BufferSize = 1024;
     char buffer[BufferSize]{};
 
@@ -466,6 +1128,8 @@ void Logger::TraceNoAllocV(const char* filename, int line, const char* function,
 
     char messageBuffer[BufferSize]{};
     FormatNoAllocV(messageBuffer, BufferSize, message, args);
+    if (IsRepeatedMessage(filename, line, severity, messageBuffer))
+        return;
 
     switch (severity)
     {
@@ -485,44 +1149,20 @@ void Logger::TraceNoAllocV(const char* filename, int line, const char* function,
         break;
     }
 
-    if (m_timer != nullptr)
+    const size_t TimeBufferSize = 32;
+    char timeBuffer[TimeBufferSize]{};
+    FormatTimestamp(timeBuffer, TimeBufferSize, timestamp);
+    if (strlen(timeBuffer) > 0)
     {
-        const size_t TimeBufferSize = 32;
-        char timeBuffer[TimeBufferSize]{};
-        m_timer->GetTimeString(timeBuffer, TimeBufferSize);
-        if (strlen(timeBuffer) > 0)
-        {
-            strncat(buffer, timeBuffer, BufferSize);
-            strncat(buffer, " ", BufferSize);
-        }
+        strncat(buffer, timeBuffer, BufferSize);
+        strncat(buffer, " ", BufferSize);
     }
 
     strncat(buffer, sourceString, BufferSize);
     strncat(buffer, messageBuffer, BufferSize);
     strncat(buffer, "\n", BufferSize);
 
-#if BAREMETAL_COLOR_OUTPUT
-    switch (severity)
-    {
-    case LogSeverity::Warning:
-        s_console.Write(buffer, ConsoleColor::BrightYellow);
-        break;
-    case LogSeverity::Info:
-        s_console.Write(buffer, ConsoleColor::Cyan);
-        break;
-    case LogSeverity::Debug:
-        s_console.Write(buffer, ConsoleColor::Yellow);
-        break;
-    case LogSeverity::Data:
-        s_console.Write(buffer, ConsoleColor::Magenta);
-        break;
-    default:
-        s_console.Write(buffer, ConsoleColor::White);
-        break;
-    }
-#else
-    s_console.Write(buffer);
-#endif
+    WriteLine(severity, buffer);
 }
 
 /// <summary>
@@ -599,6 +1239,136 @@ void Logger::TraceEntryNoAlloc(const char* filename, int line, const char* funct
     }
 }
 
+#if BAREMETAL_BINARY_LOG
+
+/// <summary>
+/// Write a binary log record. The record is encoded, added to the ring buffer, and the ring buffer is written to the console.
+/// </summary>
+/// <param name="source">Source name or file name</param>
+/// <param name="line">Source line number</param>
+/// <param name="function">Function name for trace messages, nullptr for log messages</param>
+/// <param name="severity">Severity to log with (log severity levels greater than the current set log level wil be ignored</param>
+/// <param name="message">Format string, must be located in the read only data section</param>
+/// <param name="numArgs">Number of argument words</param>
+/// <param name="args">Argument words</param>
+void Logger::LogBinary(const char* source, int line, const char* function, LogSeverity severity, const char* message, size_t numArgs, const uint64* args)
+{
+    if (!IsLogSeverityEnabled(source, severity))
+        return;
+
+    if (numArgs > LOGGER_BINARY_MAX_ARGUMENTS)
+        numArgs = LOGGER_BINARY_MAX_ARGUMENTS;
+
+    BinaryLogRecordHeader header{};
+    header.formatID = GetInternedStringID(message);
+    header.sourceID = GetInternedStringID(source);
+    header.functionID = (function != nullptr) ? GetInternedStringID(function) : BinaryLogNoStringID;
+    GetTimerCounter(header.timestamp);
+    header.line = static_cast<uint16>(line);
+    header.severity = static_cast<uint8>(severity);
+    header.numArgs = static_cast<uint8>(numArgs);
+
+    uint8 record[BinaryLogRecordMaxSize];
+    memcpy(record, &header, sizeof(header));
+    memcpy(record + sizeof(header), args, numArgs * sizeof(uint64));
+    WriteBinaryRecord(record, sizeof(header) + numArgs * sizeof(uint64));
+
+    if (severity == LogSeverity::Panic)
+    {
+        GetSystem().Halt();
+    }
+}
+
+/// <summary>
+/// Encode a binary log record, add it to the ring buffer, and write the ring buffer contents to the console
+/// </summary>
+/// <param name="record">Unencoded record</param>
+/// <param name="size">Size of record in bytes</param>
+void Logger::WriteBinaryRecord(const uint8* record, size_t size)
+{
+    uint8 frame[BinaryLogFrameMaxSize];
+    size_t frameSize = EncodeBinaryLogFrame(record, size, frame);
+#if BAREMETAL_CRASH_LOG
+    GetCrashLog().Write(reinterpret_cast<const char*>(frame), frameSize);
+#endif
+
+    // Interrupts are disabled while the frame is copied, so that a record logged from an interrupt handler cannot end up in the middle of this one
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    size_t head = m_binaryBufferHead;
+    size_t used = (head - __atomic_load_n(&m_binaryBufferTail, __ATOMIC_ACQUIRE) + LOGGER_BINARY_BUFFER_SIZE) % LOGGER_BINARY_BUFFER_SIZE;
+    if (used + frameSize >= LOGGER_BINARY_BUFFER_SIZE)
+    {
+        m_binaryRecordsDropped++;
+        SetDAIF(daif);
+        return;
+    }
+    size_t firstPart = LOGGER_BINARY_BUFFER_SIZE - head;
+    if (firstPart > frameSize)
+        firstPart = frameSize;
+    memcpy(m_binaryBuffer + head, frame, firstPart);
+    memcpy(m_binaryBuffer, frame + firstPart, frameSize - firstPart);
+    __atomic_store_n(&m_binaryBufferHead, (head + frameSize) % LOGGER_BINARY_BUFFER_SIZE, __ATOMIC_RELEASE);
+    SetDAIF(daif);
+
+    FlushBinary();
+}
+
+/// <summary>
+/// Write all encoded binary log records in the ring buffer to the console. Reentrant calls (e.g. logging from an interrupt while flushing) only add to the
+/// ring buffer, the outer call writes their records.
+///
+/// After giving up the draining role, the ring buffer is checked again, to catch records added by a context which found the ring buffer being drained just
+/// before the role was given up.
+/// </summary>
+void Logger::FlushBinary()
+{
+    do
+    {
+        // Test and set the draining flag with IRQs disabled, exclusive load/store is not reliable on Device memory (the MMU is off)
+        uint64 daif;
+        GetDAIF(daif);
+        DisableIRQs();
+        bool isDraining = m_binaryBufferDraining;
+        m_binaryBufferDraining = true;
+        SetDAIF(daif);
+        if (isDraining)
+            return;
+        size_t tail = m_binaryBufferTail;
+        size_t head;
+        while (tail != (head = __atomic_load_n(&m_binaryBufferHead, __ATOMIC_ACQUIRE)))
+        {
+            size_t end = (head > tail) ? head : LOGGER_BINARY_BUFFER_SIZE;
+            s_console.Write(reinterpret_cast<const char*>(m_binaryBuffer + tail), end - tail);
+            tail = end % LOGGER_BINARY_BUFFER_SIZE;
+            __atomic_store_n(&m_binaryBufferTail, tail, __ATOMIC_RELEASE);
+        }
+        __atomic_store_n(&m_binaryBufferDraining, false, __ATOMIC_RELEASE);
+    } while (__atomic_load_n(&m_binaryBufferTail, __ATOMIC_ACQUIRE) != __atomic_load_n(&m_binaryBufferHead, __ATOMIC_ACQUIRE));
+}
+
+/// <summary>
+/// Return the number of binary log records dropped because the ring buffer was full
+/// </summary>
+/// <returns>Number of dropped binary log records</returns>
+uint32 Logger::GetBinaryRecordsDropped() const
+{
+    return m_binaryRecordsDropped;
+}
+
+/// <summary>
+/// Check whether a string is located in the read only data section, so it can be stored in a binary log record as an offset
+/// </summary>
+/// <param name="str">String to check</param>
+/// <returns>True if the string is located in the read only data section, false otherwise</returns>
+bool Logger::IsInternedString(const char* str)
+{
+    return (str >= __rodata_start) && (str < __rodata_end);
+}
+
+#endif
+
 /// <summary>
 /// Construct the singleton logger and initializat it if needed, and return a reference to the instance
 /// </summary>
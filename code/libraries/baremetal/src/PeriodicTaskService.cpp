@@ -0,0 +1,320 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : PeriodicTaskService.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : PeriodicTaskService
+//
+// Description : Deadline scheduled periodic tasks with timing statistics
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/PeriodicTaskService.h"
+
+#include "baremetal/ARMInstructions.h"
+#include "baremetal/Assert.h"
+#include "baremetal/Clock.h"
+#include "baremetal/Logger.h"
+#include "baremetal/Timer.h"
+
+/// @file
+/// Deadline scheduled periodic tasks with timing statistics implementation
+
+namespace baremetal {
+
+/// @brief Define log name
+LOG_MODULE("PeriodicTaskService");
+
+/// <summary>
+/// Constructs a default PeriodicTaskService instance (a singleton), using the singleton Timer. Note that the constructor is private, so GetPeriodicTaskService() is needed to instantiate the PeriodicTaskService.
+/// </summary>
+PeriodicTaskService::PeriodicTaskService()
+    : PeriodicTaskService(GetTimer())
+{
+}
+
+/// <summary>
+/// Constructs a specialized PeriodicTaskService instance with a custom Timer instance. This is intended for testing.
+/// </summary>
+/// <param name="timer">Timer used to schedule task releases</param>
+PeriodicTaskService::PeriodicTaskService(Timer& timer)
+    : m_timer{timer}
+    , m_epoch{Clock::NowNanoSeconds()}
+    , m_activeTasks{}
+    , m_freeTasks{}
+    , m_chunks{}
+{
+}
+
+/// <summary>
+/// Destructor. Stops all tasks and frees the task pool
+/// </summary>
+PeriodicTaskService::~PeriodicTaskService()
+{
+    while (m_activeTasks != nullptr)
+        RemoveTask(m_activeTasks);
+    while (m_chunks != nullptr)
+    {
+        TaskChunk* chunk = m_chunks;
+        m_chunks = chunk->m_next;
+        delete chunk;
+    }
+    m_freeTasks = nullptr;
+}
+
+/// <summary>
+/// Add and start a periodic task. The task is released at epoch + phaseUsec + n * periodUsec, the first release is the first of these after the current time
+/// </summary>
+/// <param name="name">Task name, used in DumpStatistics(). Must stay valid while the task exists</param>
+/// <param name="periodUsec">Task period in microseconds, must be non-zero</param>
+/// <param name="phaseUsec">Phase offset of the releases in microseconds</param>
+/// <param name="handler">Task handler, called in interrupt context on every release</param>
+/// <param name="context">Context passed to the task handler</param>
+/// <returns>Task, to be used in RemoveTask() and GetStatistics(), or nullptr if no kernel timer is available</returns>
+PeriodicTask* PeriodicTaskService::AddTask(const char* name, uint64 periodUsec, uint64 phaseUsec, PeriodicTaskHandler* handler, void* context)
+{
+    assert(periodUsec != 0);
+    assert(handler != nullptr);
+
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    if (m_freeTasks == nullptr)
+    {
+        SetDAIF(daif);
+        TaskChunk* chunk = new TaskChunk;
+        assert(chunk != nullptr);
+        DisableIRQs();
+        chunk->m_next = m_chunks;
+        m_chunks = chunk;
+        for (size_t index = PERIODIC_TASK_POOL_CHUNK; index-- > 0;)
+        {
+            chunk->m_tasks[index].m_next = m_freeTasks;
+            chunk->m_tasks[index].m_generation = 0;
+            m_freeTasks = &chunk->m_tasks[index];
+        }
+    }
+    PeriodicTask* task = m_freeTasks;
+    m_freeTasks = task->m_next;
+
+    task->m_name = name;
+    task->m_handler = handler;
+    task->m_context = context;
+    task->m_periodNsec = periodUsec * NSEC_PER_USEC;
+    task->m_nextRelease = m_epoch + phaseUsec * NSEC_PER_USEC;
+    task->m_timer = 0;
+    task->m_generation++;
+    task->m_active = true;
+    task->m_statistics.releases = 0;
+    task->m_statistics.overruns = 0;
+    task->m_statistics.missedReleases = 0;
+    task->m_statistics.executionTime.Reset();
+    task->m_statistics.releaseJitter.Reset();
+
+    // Releases before now are not missed, the task simply was not running yet
+    uint64 now = Clock::NowNanoSeconds();
+    if (task->m_nextRelease < now)
+        task->m_nextRelease += ((now - task->m_nextRelease) / task->m_periodNsec + 1) * task->m_periodNsec;
+
+    task->m_next = m_activeTasks;
+    m_activeTasks = task;
+    bool scheduled = ScheduleRelease(task, now);
+    SetDAIF(daif);
+
+    if (!scheduled)
+    {
+        RemoveTask(task);
+        return nullptr;
+    }
+    LOG_DEBUG("Add task %s, period %llu us, phase %llu us", name, periodUsec, phaseUsec);
+    return task;
+}
+
+/// <summary>
+/// Stop and remove a periodic task. Can be called from the task handler itself.
+/// The statistics of the task can still be read with GetStatistics() until the next call to AddTask()
+/// </summary>
+/// <param name="task">Task returned by AddTask()</param>
+void PeriodicTaskService::RemoveTask(PeriodicTask* task)
+{
+    assert(task != nullptr);
+
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    assert(task->m_active);
+    PeriodicTask** link = &m_activeTasks;
+    while ((*link != nullptr) && (*link != task))
+        link = &(*link)->m_next;
+    assert(*link == task);
+    *link = task->m_next;
+
+    if (task->m_timer != 0)
+        m_timer.CancelKernelTimer(task->m_timer);
+    task->m_timer = 0;
+    task->m_active = false;
+    task->m_generation++;
+    task->m_next = m_freeTasks;
+    m_freeTasks = task;
+    SetDAIF(daif);
+}
+
+/// <summary>
+/// Return a consistent copy of the statistics of a task
+/// </summary>
+/// <param name="task">Task returned by AddTask()</param>
+/// <param name="statistics">Receives the task statistics</param>
+void PeriodicTaskService::GetStatistics(const PeriodicTask* task, PeriodicTaskStatistics& statistics) const
+{
+    assert(task != nullptr);
+
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    statistics = task->m_statistics;
+    SetDAIF(daif);
+}
+
+/// <summary>
+/// Clear the statistics of a task
+/// </summary>
+/// <param name="task">Task returned by AddTask()</param>
+void PeriodicTaskService::ResetStatistics(PeriodicTask* task)
+{
+    assert(task != nullptr);
+
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    task->m_statistics.releases = 0;
+    task->m_statistics.overruns = 0;
+    task->m_statistics.missedReleases = 0;
+    task->m_statistics.executionTime.Reset();
+    task->m_statistics.releaseJitter.Reset();
+    SetDAIF(daif);
+}
+
+/// <summary>
+/// Log the statistics of all active tasks. Times are in nanoseconds
+/// </summary>
+void PeriodicTaskService::DumpStatistics() const
+{
+    LOG_INFO("Task                 Period(us)   Releases  Overruns    Missed  Execution min/p50/p99/max  Jitter min/p50/p99/max");
+    for (const PeriodicTask* task = m_activeTasks; task != nullptr; task = task->m_next)
+    {
+        PeriodicTaskStatistics statistics;
+        GetStatistics(task, statistics);
+        const Histogram& execution = statistics.executionTime;
+        const Histogram& jitter = statistics.releaseJitter;
+        LOG_INFO("%-20s %10llu %10llu %9llu %9llu  %llu/%llu/%llu/%llu  %llu/%llu/%llu/%llu", task->m_name, task->m_periodNsec / NSEC_PER_USEC,
+                 statistics.releases, statistics.overruns, statistics.missedReleases, execution.GetMin(), execution.GetPercentile(50),
+                 execution.GetPercentile(99), execution.GetMax(), jitter.GetMin(), jitter.GetPercentile(50), jitter.GetPercentile(99), jitter.GetMax());
+    }
+}
+
+/// <summary>
+/// Start the kernel timer for the next release of a task. Must be called with interrupts disabled
+/// </summary>
+/// <param name="task">Task to schedule</param>
+/// <param name="now">Current time in Clock nanoseconds</param>
+/// <returns>True if a kernel timer was started, false if no kernel timer is available</returns>
+bool PeriodicTaskService::ScheduleRelease(PeriodicTask* task, uint64 now)
+{
+    uint64 delayUsec = (task->m_nextRelease > now) ? (task->m_nextRelease - now + NSEC_PER_USEC - 1) / NSEC_PER_USEC : 0;
+    task->m_timer = m_timer.StartKernelTimerMicroSeconds(delayUsec, TaskTimerHandler, task, this);
+    if (task->m_timer == 0)
+    {
+        LOG_ERROR("No kernel timer available for task %s", task->m_name);
+        return false;
+    }
+    return true;
+}
+
+/// <summary>
+/// Run a released task, update its statistics and schedule the next release. Called in interrupt context
+/// </summary>
+/// <param name="task">Task to run</param>
+void PeriodicTaskService::RunTask(PeriodicTask* task)
+{
+    uint64 start = Clock::NowNanoSeconds();
+    uint64 release = task->m_nextRelease;
+    uint32 generation = task->m_generation;
+    task->m_timer = 0;
+
+    task->m_handler(task->m_context);
+
+    // The handler may have removed the task (and even re-used its administration for a new task)
+    if (!task->m_active || (task->m_generation != generation))
+        return;
+
+    uint64 end = Clock::NowNanoSeconds();
+    PeriodicTaskStatistics& statistics = task->m_statistics;
+    statistics.releases++;
+    // The kernel timer can elapse slightly before the release, as it is rounded to microseconds
+    statistics.releaseJitter.Add((start > release) ? start - release : 0);
+    statistics.executionTime.Add(end - start);
+
+    task->m_nextRelease = release + task->m_periodNsec;
+    if (end >= task->m_nextRelease)
+    {
+        uint64 missed = (end - task->m_nextRelease) / task->m_periodNsec + 1;
+        statistics.overruns++;
+        statistics.missedReleases += missed;
+        task->m_nextRelease += missed * task->m_periodNsec;
+    }
+    if (!ScheduleRelease(task, end))
+        RemoveTask(task);
+}
+
+/// <summary>
+/// Kernel timer handler for task releases
+/// </summary>
+/// <param name="handle">Kernel timer handle</param>
+/// <param name="param">Task released</param>
+/// <param name="context">PeriodicTaskService instance</param>
+void PeriodicTaskService::TaskTimerHandler(KernelTimerHandle /*handle*/, void* param, void* context)
+{
+    PeriodicTaskService* service = reinterpret_cast<PeriodicTaskService*>(context);
+    assert(service != nullptr);
+    service->RunTask(reinterpret_cast<PeriodicTask*>(param));
+}
+
+/// <summary>
+/// Create the singleton PeriodicTaskService instance if needed, and return a reference to it
+/// </summary>
+/// <returns>Reference to the singleton PeriodicTaskService instance</returns>
+PeriodicTaskService& GetPeriodicTaskService()
+{
+    static PeriodicTaskService service;
+    return service;
+}
+
+} // namespace baremetal
@@ -40,6 +40,7 @@
 #include "baremetal/PhysicalGPIOPin.h"
 
 #include "baremetal/ARMInstructions.h"
+#include "baremetal/Assert.h"
 #include "baremetal/BCMRegisters.h"
 #include "baremetal/GPIOManager.h"
 #include "baremetal/Logger.h"
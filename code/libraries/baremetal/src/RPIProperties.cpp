@@ -367,4 +367,28 @@ bool RPIProperties::SetClockRate(ClockID clockID, uint32 freqHz, bool skipTurbo)
     return result;
 }
 
+/// <summary>
+/// Retrieve the DMA channels which can be used by the ARM
+/// </summary>
+/// <param name="channelMask">Bit mask of usable DMA channels, bit n set means channel n can be used (out)</param>
+/// <returns>Return true on success, false on failure</returns>
+bool RPIProperties::GetDMAChannels(uint32& channelMask)
+{
+    PropertyTagSimple tag{};
+    RPIPropertiesInterface interface(m_mailbox);
+
+    auto result = interface.GetTag(PropertyID::PROPTAG_GET_DMA_CHANNELS, &tag, sizeof(tag));
+
+    TRACE_DEBUG("GetDMAChannels");
+    TRACE_DEBUG("Result: %s", result ? "OK" : "Fail");
+
+    if (result)
+    {
+        channelMask = tag.value;
+        TRACE_DEBUG("Channels: %08lx", tag.value);
+    }
+
+    return result;
+}
+
 } // namespace baremetal
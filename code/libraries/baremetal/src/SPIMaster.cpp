@@ -42,6 +42,7 @@
 #include "baremetal/Assert.h"
 #include "baremetal/Logger.h"
 #include "baremetal/MachineInfo.h"
+#include "baremetal/New.h"
 #include "baremetal/String.h"
 #include "baremetal/Timer.h"
 
@@ -137,6 +138,11 @@ SPIMaster::SPIMaster(IMemoryAccess& memoryAccess /* = GetMemoryAccess()*/)
     , m_misoPin{memoryAccess}
     , m_ce0Pin{memoryAccess}
     , m_ce1Pin{memoryAccess}
+    , m_txDMAChannel{}
+    , m_rxDMAChannel{}
+    , m_dmaThreshold{SPI_DMA_THRESHOLD}
+    , m_dmaHeader{}
+    , m_dmaZero{}
 {
 }
 
@@ -145,6 +151,7 @@ SPIMaster::SPIMaster(IMemoryAccess& memoryAccess /* = GetMemoryAccess()*/)
 /// </summary>
 SPIMaster::~SPIMaster()
 {
+    DisableDMA();
     if (m_isInitialized)
     {
         m_ce1Pin.SetMode(GPIOMode::InputPullUp);
@@ -279,6 +286,7 @@ size_t SPIMaster::Write(SPI_CEIndex ceIndex, const void* buffer, size_t count)
 /// Read / Write bytes from / to device
 /// Data on SPI is always transferred in both directions at the same time, so every byte written will also cause a byte to be read. If the caller is
 /// only interested in writing or reading, the other buffer can be set to nullptr. In this case, the bytes read or written will be discarded.
+/// If DMA is enabled, transfers of at least the DMA threshold are done by DMA, otherwise transfers are limited to 65535 bytes.
 /// </summary>
 /// <param name="ceIndex">CE / CS pin to activate</param>
 /// <param name="writeBuffer">Buffer containing data to send</param>
@@ -291,16 +299,92 @@ size_t SPIMaster::WriteRead(SPI_CEIndex ceIndex, const void* writeBuffer, void*
     assert(m_baseAddress != nullptr);
     assert(writeBuffer != nullptr || readBuffer != nullptr);
 
+    assert(ceIndex <= SPI_CEIndex::CE1 || ceIndex == SPI_CEIndex::None);
+    assert(count > 0);
+
     const uint8* writeData = reinterpret_cast<const uint8*>(writeBuffer);
     uint8* readData = reinterpret_cast<uint8*>(readBuffer);
 
-    assert(count > 0);
+    // The CS hold time cannot be honoured with DMA, as CS is de-asserted by the hardware at the end of the transfer
+    if ((m_txDMAChannel != nullptr) && (count >= m_dmaThreshold) && (m_csHoldTimeMicroSeconds == 0))
+        return WriteReadDMA(ceIndex, writeData, readData, count);
+    return WriteReadPolled(ceIndex, writeData, readData, count);
+}
+
+/// <summary>
+/// Enable DMA transfers, for SPI device 0 only. Two DMA channels are allocated, one to write to and one to read from the FIFO
+/// </summary>
+/// <param name="controller">DMA controller to allocate the channels from</param>
+/// <returns>True if DMA is enabled, false if the device does not support DMA or no DMA channels are available</returns>
+bool SPIMaster::EnableDMA(DMAController& controller /*= GetDMAController()*/)
+{
+    assert(m_isInitialized);
+    if (m_txDMAChannel != nullptr)
+        return true;
+    if (m_device != 0)
+        return false;
+
+    // SPI is slow compared to the DMA engine, so DMA Lite channels are good enough
+    m_txDMAChannel = new DMAChannel(DMAChannelType::Lite, controller);
+    m_rxDMAChannel = new DMAChannel(DMAChannelType::Lite, controller);
+    if (!m_txDMAChannel->IsAllocated() || !m_rxDMAChannel->IsAllocated())
+    {
+        LOG_WARNING("Cannot allocate DMA channels for SPI");
+        DisableDMA();
+        return false;
+    }
+
+    m_memoryAccess.Write32(RPI_SPI_REG_ADDRESS(m_baseAddress, RPI_SPI_DC_OFFSET),
+                           (0x30 << RPI_SPI_DC_RPANIC_SHIFT) | (0x20 << RPI_SPI_DC_RDREQ_SHIFT) | (0x10 << RPI_SPI_DC_TPANIC_SHIFT) |
+                               (0x20 << RPI_SPI_DC_TDREQ_SHIFT));
+    LOG_INFO("SPI DMA enabled, TX channel %d, RX channel %d", m_txDMAChannel->GetChannel(), m_rxDMAChannel->GetChannel());
+    return true;
+}
+
+/// <summary>
+/// Disable DMA transfers, returning the DMA channels
+/// </summary>
+void SPIMaster::DisableDMA()
+{
+    delete m_txDMAChannel;
+    m_txDMAChannel = nullptr;
+    delete m_rxDMAChannel;
+    m_rxDMAChannel = nullptr;
+}
+
+/// <summary>
+/// Check whether DMA transfers are enabled
+/// </summary>
+/// <returns>True if DMA is enabled</returns>
+bool SPIMaster::IsDMAEnabled() const
+{
+    return m_txDMAChannel != nullptr;
+}
+
+/// <summary>
+/// Set the minimum transfer size for which DMA is used
+/// </summary>
+/// <param name="threshold">Minimum transfer size in bytes</param>
+void SPIMaster::SetDMAThreshold(size_t threshold)
+{
+    m_dmaThreshold = threshold;
+}
+
+/// <summary>
+/// Read / Write bytes from / to device, moving every byte through the FIFO by the CPU
+/// </summary>
+/// <param name="ceIndex">CE / CS pin to activate</param>
+/// <param name="writeData">Data to send, or nullptr to send zeros</param>
+/// <param name="readData">Buffer for data to be received, or nullptr to discard</param>
+/// <param name="count">Number of bytes to send / receive, at most 65535</param>
+/// <returns>Number of bytes transferred</returns>
+size_t SPIMaster::WriteReadPolled(SPI_CEIndex ceIndex, const uint8* writeData, uint8* readData, size_t count)
+{
     assert(count <= 0xFFFF);
     TRACE_DEBUG("Set data size %d", count);
     m_memoryAccess.Write32(RPI_SPI_REG_ADDRESS(m_baseAddress, RPI_SPI_DLEN_OFFSET), count);
 
     TRACE_DEBUG("Start transfer");
-    assert(ceIndex <= SPI_CEIndex::CE1 || ceIndex == SPI_CEIndex::None);
     uint32 value = (m_memoryAccess.Read32(RPI_SPI_REG_ADDRESS(m_baseAddress, RPI_SPI_CS_OFFSET)) & ~RPI_SPI_CS_ACTIVATE_NONE)
                  | (static_cast<uint32>(ceIndex) << RPI_SPI_CS_ACTIVATE_SHIFT)
                  | RPI_SPI_CS_CLEAR | RPI_SPI_CS_TA;
@@ -364,3 +448,70 @@ size_t SPIMaster::WriteRead(SPI_CEIndex ceIndex, const void* writeBuffer, void*
 
     return static_cast<size_t>(count);
 }
+
+/// <summary>
+/// Read / Write bytes from / to device using DMA. The transfer is split into chunks of at most SPI_DMA_CHUNK_SIZE bytes.
+/// For each chunk the TX channel writes a word holding the length and CS settings to the FIFO, followed by the data, while the RX channel
+/// reads the received data. The hardware de-asserts CS at the end of each chunk, as the next length word is only accepted when the
+/// previous transfer has ended.
+/// </summary>
+/// <param name="ceIndex">CE / CS pin to activate</param>
+/// <param name="writeData">Data to send, or nullptr to send zeros</param>
+/// <param name="readData">Buffer for data to be received, or nullptr to discard</param>
+/// <param name="count">Number of bytes to send / receive</param>
+/// <returns>Number of bytes transferred. This is less than count if a chunk failed or did not complete within its timeout, in that case both DMA channels
+/// are aborted</returns>
+size_t SPIMaster::WriteReadDMA(SPI_CEIndex ceIndex, const uint8* writeData, uint8* readData, size_t count)
+{
+    regaddr fifo = RPI_SPI_REG_ADDRESS(m_baseAddress, RPI_SPI_FIFO_OFFSET);
+    uint32 csBits = (m_memoryAccess.Read32(RPI_SPI_REG_ADDRESS(m_baseAddress, RPI_SPI_CS_OFFSET)) & (RPI_SPI_CS_CPOL | RPI_SPI_CS_CPHA))
+                  | (static_cast<uint32>(ceIndex) << RPI_SPI_CS_ACTIVATE_SHIFT);
+    m_memoryAccess.Write32(RPI_SPI_REG_ADDRESS(m_baseAddress, RPI_SPI_CS_OFFSET), csBits | RPI_SPI_CS_CLEAR | RPI_SPI_CS_DMAEN | RPI_SPI_CS_ADCS);
+
+    size_t offset = 0;
+    while (offset < count)
+    {
+        size_t length = MIN(count - offset, size_t{SPI_DMA_CHUNK_SIZE});
+        m_dmaHeader = (static_cast<uint32>(length) << 16) | csBits | RPI_SPI_CS_TA;
+
+        m_txDMAChannel->ClearControlBlocks();
+        m_txDMAChannel->AddPeripheralWrite(fifo, &m_dmaHeader, sizeof(m_dmaHeader), DMADREQ::SPITX);
+        if (writeData != nullptr)
+            m_txDMAChannel->AddPeripheralWrite(fifo, writeData + offset, length, DMADREQ::SPITX);
+        else
+            m_txDMAChannel->AddTransfer(RPI_DMA_TI_DEST_DREQ | RPI_DMA_TI_PERMAP(static_cast<uint32>(DMADREQ::SPITX)) | RPI_DMA_TI_WAIT_RESP,
+                                        DMAChannel::GetBusAddress(&m_dmaZero), DMAChannel::GetPeripheralBusAddress(fifo), static_cast<uint32>(length));
+
+        m_rxDMAChannel->ClearControlBlocks();
+        if (readData != nullptr)
+            m_rxDMAChannel->AddPeripheralRead(readData + offset, fifo, length, DMADREQ::SPIRX);
+        else
+            m_rxDMAChannel->AddTransfer(RPI_DMA_TI_SRC_DREQ | RPI_DMA_TI_PERMAP(static_cast<uint32>(DMADREQ::SPIRX)) | RPI_DMA_TI_DEST_IGNORE,
+                                        DMAChannel::GetPeripheralBusAddress(fifo), 0, static_cast<uint32>(length));
+
+        // Start receiving first, so no received data is lost
+        m_rxDMAChannel->Start();
+        m_txDMAChannel->Start();
+        // The RX channel ends last, as it waits for the last byte to be clocked in
+        uint32 timeout = static_cast<uint32>((static_cast<uint64>(length) * 8 * 1000 + m_clockRate - 1) / m_clockRate) + SPI_DMA_TIMEOUT;
+        bool rxSuccess = m_rxDMAChannel->Wait(timeout);
+        bool txSuccess = rxSuccess && m_txDMAChannel->Wait(timeout);
+        if (!rxSuccess || !txSuccess)
+        {
+            // A failed or timed out channel is already stopped, the other one may still be waiting for its DREQ
+            m_rxDMAChannel->Abort();
+            m_txDMAChannel->Abort();
+            LOG_ERROR("SPI DMA transfer failed at offset %d", offset);
+            break;
+        }
+        offset += length;
+    }
+
+    uint32 value = m_memoryAccess.Read32(RPI_SPI_REG_ADDRESS(m_baseAddress, RPI_SPI_CS_OFFSET)) & ~(RPI_SPI_CS_TA | RPI_SPI_CS_DMAEN | RPI_SPI_CS_ADCS);
+    // Discard whatever an aborted transfer left behind in the FIFOs
+    if (offset < count)
+        value |= RPI_SPI_CS_CLEAR;
+    m_memoryAccess.Write32(RPI_SPI_REG_ADDRESS(m_baseAddress, RPI_SPI_CS_OFFSET), value);
+
+    return offset;
+}
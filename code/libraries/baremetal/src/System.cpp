@@ -41,6 +41,7 @@
 
 #include "baremetal/ARMInstructions.h"
 #include "baremetal/BCMRegisters.h"
+#include "baremetal/CrashLog.h"
 #include "baremetal/InterruptHandler.h"
 #include "baremetal/Logger.h"
 #include "baremetal/MemoryAccess.h"
@@ -60,6 +61,11 @@ using namespace baremetal;
 /// @brief Define log name for this module
 LOG_MODULE("System");
 
+/// @brief Baud rate of the console UART. Set through BAREMETAL_CONSOLE_BAUD in CMake
+#ifndef BAREMETAL_CONSOLE_BAUD
+#define BAREMETAL_CONSOLE_BAUD 115200
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -119,6 +125,8 @@ System::System(IMemoryAccess& memoryAccess)
 void System::Halt()
 {
     LOG_INFO("Halt");
+    if (Logger::HaveLogger())
+        GetLogger().Flush();
     Timer::WaitMilliSeconds(WaitTime);
 
     // power off the SoC (GPU + CPU)
@@ -142,6 +150,8 @@ void System::Halt()
 void System::Reboot()
 {
     LOG_INFO("Reboot");
+    if (Logger::HaveLogger())
+        GetLogger().Flush();
     Timer::WaitMilliSeconds(WaitTime);
 
     DisableIRQs();
@@ -197,16 +207,23 @@ void sysinit()
     Device* logDevice{};
 #if defined(BAREMETAL_CONSOLE_UART0)
     auto& uart = GetUART0();
-    uart.Initialize(115200);
+    uart.Initialize(BAREMETAL_CONSOLE_BAUD);
     uart.WriteString("\nSetting up UART0\n");
     logDevice = &uart;
 #elif defined(BAREMETAL_CONSOLE_UART1)
     auto& uart = GetUART1();
-    uart.Initialize(115200);
+    uart.Initialize(BAREMETAL_CONSOLE_BAUD);
     uart.WriteString("\nSetting up UART1\n");
     logDevice = &uart;
 #endif
     GetConsole().AssignDevice(logDevice);
+#if BAREMETAL_CRASH_LOG
+    // Show the log of the previous boot, if it survived the reboot, before the logger starts writing to the crash log
+    auto& crashLog = GetCrashLog();
+    crashLog.Initialize();
+    crashLog.DumpPreviousLog();
+    crashLog.Start();
+#endif
     GetLogger().Initialize();
     GetInterruptSystem();
 
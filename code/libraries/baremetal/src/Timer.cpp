@@ -42,6 +42,7 @@
 #include "baremetal/ARMInstructions.h"
 #include "baremetal/Assert.h"
 #include "baremetal/BCMRegisters.h"
+#include "baremetal/Clock.h"
 #include "baremetal/Format.h"
 #include "baremetal/InterruptHandler.h"
 #include "baremetal/Logger.h"
@@ -56,54 +57,6 @@ namespace baremetal {
 /// @brief Define log name
 LOG_MODULE("Timer");
 
-/// @brief Magic number for kernel timer (KTMC)
-#define KERNEL_TIMER_MAGIC 0x4B544D43
-
-/// <summary>
-/// Kernel timer administration
-/// </summary>
-/// <typeparam name="Pointer"></typeparam>
-struct KernelTimer
-{
-    /// @brief Magic number to check if element is valid
-    unsigned m_magic;
-    /// @brief Kernel timer deadline in timer ticks
-    unsigned m_elapsesAtTicks;
-    /// @brief Pointer to kernel timer handler
-    KernelTimerHandler* m_handler;
-    /// @brief Kernel timer handler parameter
-    void* m_param;
-    /// @brief Kernel timer handler context
-    void* m_context;
-
-    /// <summary>
-    /// Construct a kernel timer administration element
-    /// </summary>
-    /// <param name="elapseTimeTicks">Timer deadline in timer ticks</param>
-    /// <param name="handler">Kernel timer handler pointer</param>
-    /// <param name="param">Kernel timer handler parameter</param>
-    /// <param name="context">Kernerl timer handler context</param>
-    KernelTimer(unsigned elapseTimeTicks, KernelTimerHandler* handler, void* param, void* context)
-        : m_magic{KERNEL_TIMER_MAGIC}
-        , m_elapsesAtTicks{elapseTimeTicks}
-        , m_handler{handler}
-        , m_param{param}
-        , m_context{context}
-
-    {
-    }
-    /// <summary>
-    /// Verify magic number
-    /// </summary>
-    /// <returns>True if the magic number is correct, false otherwise</returns>
-    bool CheckMagic() const
-    {
-        return m_magic == KERNEL_TIMER_MAGIC;
-    }
-};
-/// @brief Kernel timer element, element which is stored in the kernel time list
-using KernelTimerElement = DoubleLinkedList<KernelTimer*>::Element;
-
 const unsigned Timer::s_daysInMonth[12]{31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
 
 const char* Timer::s_monthName[12]{"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
@@ -118,9 +71,16 @@ Timer::Timer()
     , m_ticks{}
     , m_upTime{}
     , m_time{}
+    , m_interruptCount{}
+    , m_startCounter{}
+#if BAREMETAL_TICKLESS
+    , m_periodicTimer{}
+    , m_periodicDeadline{}
+#endif
+    , m_calendarDate{~0ULL}
     , m_periodicHandlers{}
     , m_numPeriodicHandlers{}
-    , m_kernelTimerList{}
+    , m_kernelTimers{}
 {
 }
 
@@ -135,9 +95,16 @@ Timer::Timer(IMemoryAccess& memoryAccess)
     , m_ticks{}
     , m_upTime{}
     , m_time{}
+    , m_interruptCount{}
+    , m_startCounter{}
+#if BAREMETAL_TICKLESS
+    , m_periodicTimer{}
+    , m_periodicDeadline{}
+#endif
+    , m_calendarDate{~0ULL}
     , m_periodicHandlers{}
     , m_numPeriodicHandlers{}
-    , m_kernelTimerList{}
+    , m_kernelTimers{}
 {
 }
 
@@ -152,11 +119,7 @@ Timer::~Timer()
 
     m_interruptSystem.UnregisterIRQHandler(IRQ_ID::IRQ_LOCAL_CNTPNS);
 
-    KernelTimerElement* element;
-    while ((element = m_kernelTimerList.GetFirst()) != 0)
-    {
-        CancelKernelTimer(reinterpret_cast<KernelTimerHandle>(m_kernelTimerList.GetPointer(element)));
-    }
+    m_kernelTimers.Clear();
 }
 
 /// <summary>
@@ -177,11 +140,17 @@ void Timer::Initialize()
     GetTimerFrequency(counterFreq);
     assert(counterFreq % TICKS_PER_SECOND == 0);
     m_clockTicksPerSystemTick = counterFreq / TICKS_PER_SECOND;
+    Clock::Initialize();
 
     uint64 counter{};
     GetTimerCounter(counter);
+    m_startCounter = counter;
+#if BAREMETAL_TICKLESS
+    ProgramNextDeadline();
+#else
     SetTimerCompareValue(counter + m_clockTicksPerSystemTick);
     SetTimerControl(CNTP_CTL_EL0_ENABLE);
+#endif
 
     m_isInitialized = true;
 }
@@ -192,7 +161,11 @@ void Timer::Initialize()
 /// <returns>The current timer tick count</returns>
 uint64 Timer::GetTicks() const
 {
+#if BAREMETAL_TICKLESS
+    return GetUptimeMicroSeconds() / USEC_PER_TICK;
+#else
     return m_ticks;
+#endif
 }
 
 /// <summary>
@@ -201,7 +174,11 @@ uint64 Timer::GetTicks() const
 /// <returns>Uptime in seconds</returns>
 uint32 Timer::GetUptime() const
 {
+#if BAREMETAL_TICKLESS
+    return static_cast<uint32>(GetUptimeMicroSeconds() / USEC_PER_SEC);
+#else
     return m_upTime;
+#endif
 }
 
 /// <summary>
@@ -210,7 +187,35 @@ uint32 Timer::GetUptime() const
 /// <returns>Current time in seconds (epoch time)</returns>
 uint64 Timer::GetTime() const
 {
+#if BAREMETAL_TICKLESS
+    return m_time + GetUptimeMicroSeconds() / USEC_PER_SEC;
+#else
     return m_time;
+#endif
+}
+
+/// <summary>
+/// Return the time since initialization in microseconds. In tickless mode this is read from the counter register, otherwise it has a resolution of one timer tick
+/// </summary>
+/// <returns>Time since initialization in microseconds</returns>
+uint64 Timer::GetUptimeMicroSeconds() const
+{
+#if BAREMETAL_TICKLESS
+    uint64 counter{};
+    GetTimerCounter(counter);
+    return CounterToMicroSeconds(counter - m_startCounter);
+#else
+    return m_ticks * USEC_PER_TICK;
+#endif
+}
+
+/// <summary>
+/// Return the number of timer interrupts handled. In tickless mode, this shows how often the core was woken up for timers
+/// </summary>
+/// <returns>Number of timer interrupts handled since initialization</returns>
+uint64 Timer::GetInterruptCount() const
+{
+    return m_interruptCount;
 }
 
 /// <summary>
@@ -224,9 +229,36 @@ uint64 Timer::GetTime() const
 /// <param name="bufferSize">Size of the buffer</param>
 void Timer::GetTimeString(char* buffer, size_t bufferSize)
 {
-    uint64 time = m_time;
-    uint64 ticks = m_ticks;
+    uint64 time = GetTime();
+    uint64 ticks = GetTicks();
+
+    if (bufferSize == 0)
+    {
+        return;
+    }
+    if (!m_isInitialized)
+    {
+        *buffer = '\0';
+        return;
+    }
+
+#if (TICKS_PER_SECOND != MSEC_PER_SEC)
+    ticks = ticks * MSEC_PER_SEC / TICKS_PER_SECOND;
+#endif
+    FormatTime(buffer, bufferSize, time, static_cast<unsigned>(ticks % MSEC_PER_SEC));
+}
 
+/// <summary>
+/// Writes a representation of the time at which the ARM system counter had the specified value to a buffer, in the same format as GetTimeString().
+///
+/// This is intended for timestamps captured earlier, e.g. by the logger, so that the time shown is when the event happened, not when it was formatted.
+/// The resolution is a millisecond, also when not in tickless mode
+/// </summary>
+/// <param name="buffer">Buffer to write the time string to</param>
+/// <param name="bufferSize">Size of the buffer</param>
+/// <param name="counter">ARM system counter value</param>
+void Timer::GetTimeString(char* buffer, size_t bufferSize, uint64 counter)
+{
     if (bufferSize == 0)
     {
         return;
@@ -237,6 +269,30 @@ void Timer::GetTimeString(char* buffer, size_t bufferSize)
         return;
     }
 
+#if BAREMETAL_TICKLESS
+    uint64 startTime = m_time;
+#else
+    // The time and uptime are incremented together in the timer interrupt
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    uint64 startTime = m_time - m_upTime;
+    SetDAIF(daif);
+#endif
+    // A counter value captured before initialization is shown as the time of initialization
+    uint64 uptimeMicroSeconds = (counter > m_startCounter) ? Clock::CyclesToNanoSeconds(counter - m_startCounter) / NSEC_PER_USEC : 0;
+    FormatTime(buffer, bufferSize, startTime + uptimeMicroSeconds / USEC_PER_SEC, static_cast<unsigned>((uptimeMicroSeconds % USEC_PER_SEC) * MSEC_PER_SEC / USEC_PER_SEC));
+}
+
+/// <summary>
+/// Writes a representation of a time to a buffer, as "MMM dd, yyyy HH:MM:SS.mmm" if the time is a valid calendar time, or as "ddd.HH:MM:SS.mmm" otherwise
+/// </summary>
+/// <param name="buffer">Buffer to write the time string to</param>
+/// <param name="bufferSize">Size of the buffer</param>
+/// <param name="time">Time in seconds (epoch time)</param>
+/// <param name="milliSeconds">Milliseconds within the second</param>
+void Timer::FormatTime(char* buffer, size_t bufferSize, uint64 time, unsigned milliSeconds)
+{
     unsigned second = time % 60;
     time /= 60; // Time is now in minute
     unsigned minute = time % 60;
@@ -245,6 +301,33 @@ void Timer::GetTimeString(char* buffer, size_t bufferSize)
     time /= 24; // Time is now in days
     unsigned daysTotal = time;
 
+    uint64 calendarDate = GetCalendarDate(daysTotal);
+    unsigned year = (calendarDate >> 16) & 0xFFFF;
+    unsigned month = (calendarDate >> 8) & 0xFF;
+    unsigned monthDay = calendarDate & 0xFF;
+
+    if (year > 1975) // Just a sanity check to see if we have an actual time
+    {
+        FormatNoAlloc(buffer, bufferSize, "%s %2u, %04u %02u:%02u:%02u.%03u", s_monthName[month], monthDay, year, hour, minute, second, milliSeconds);
+    }
+    else
+    {
+        FormatNoAlloc(buffer, bufferSize, "%u.%02u:%02u:%02u.%03u", daysTotal, hour, minute, second, milliSeconds);
+    }
+}
+
+/// <summary>
+/// Return the calendar date for the specified number of days since epoch. The date is cached, and only recomputed when the day changes
+/// </summary>
+/// <param name="daysTotal">Number of days since epoch</param>
+/// <returns>Calendar date, in the format of m_calendarDate</returns>
+uint64 Timer::GetCalendarDate(uint64 daysTotal)
+{
+    uint64 calendarDate = m_calendarDate;
+    if ((calendarDate >> 32) == daysTotal)
+        return calendarDate;
+
+    uint64 time = daysTotal;
     unsigned year = 1970; // Epoch start
     while (true)
     {
@@ -272,26 +355,16 @@ void Timer::GetTimeString(char* buffer, size_t bufferSize)
     }
 
     unsigned monthDay = time + 1;
-
-#if (TICKS_PER_SECOND != MSEC_PER_SEC)
-    ticks = ticks * MSEC_PER_SEC / TICKS_PER_SECOND;
-#endif
-    auto milliSeconds = ticks % MSEC_PER_SEC;
-
-    if (year > 1975) // Just a sanity check to see if we have an actual time
-    {
-        FormatNoAlloc(buffer, bufferSize, "%s %2u, %04u %02u:%02u:%02u.%03u", s_monthName[month], monthDay, year, hour, minute, second, milliSeconds);
-    }
-    else
-    {
-        FormatNoAlloc(buffer, bufferSize, "%u.%02u:%02u:%02u.%03u", daysTotal, hour, minute, second, milliSeconds);
-    }
+    calendarDate = (daysTotal << 32) | (static_cast<uint64>(year) << 16) | (month << 8) | monthDay;
+    m_calendarDate = calendarDate;
+    return calendarDate;
 }
 
 /// <summary>
 /// Register a periodic timer handler
 ///
 /// Registers a periodic timer handler function. The handler function will be called every timer tick.
+/// For tasks with their own period and phase, and timing statistics, use PeriodicTaskService instead.
 /// </summary>
 /// <param name="handler">Pointer to periodic timer handler to register</param>
 void Timer::RegisterPeriodicHandler(PeriodicTimerHandler* handler)
@@ -311,6 +384,18 @@ void Timer::RegisterPeriodicHandler(PeriodicTimerHandler* handler)
     DataSyncBarrier();
 
     m_numPeriodicHandlers++;
+
+#if BAREMETAL_TICKLESS
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    if (m_periodicTimer == 0)
+    {
+        m_periodicDeadline = GetUptimeMicroSeconds() + USEC_PER_TICK;
+        m_periodicTimer = AddKernelTimer(m_periodicDeadline, PeriodicKernelTimerHandler, nullptr, this);
+    }
+    SetDAIF(daif);
+#endif
 }
 
 /// <summary>
@@ -336,111 +421,190 @@ void Timer::UnregisterPeriodicHandler(const PeriodicTimerHandler* handler)
     DataSyncBarrier();
 
     m_numPeriodicHandlers--;
+
+#if BAREMETAL_TICKLESS
+    if (m_numPeriodicHandlers == 0)
+    {
+        uint64 daif;
+        GetDAIF(daif);
+        DisableIRQs();
+        if (m_periodicTimer != 0)
+            CancelKernelTimer(m_periodicTimer);
+        m_periodicTimer = 0;
+        SetDAIF(daif);
+    }
+#endif
 }
 
 /// <summary>
 /// Starts a kernel timer. After delayTicks timer ticks, it elapses and call the kernel timer handler.
+///
+/// The timer is added to the timer wheel, which takes constant time regardless of the number of active timers. Can be called from interrupt context.
 /// </summary>
 /// <param name="delayTicks">Delay time for timer in timer ticks</param>
 /// <param name="handler">Kernel timer handler to call when time elapses</param>
 /// <param name="param">Parameter to pass to kernel timer handler</param>
 /// <param name="context">Kernel timer handler context</param>
-/// <returns>Handle to kernel timer</returns>
+/// <returns>Handle to kernel timer, 0 if no more timers are available (see KERNEL_TIMER_MAX)</returns>
 KernelTimerHandle Timer::StartKernelTimer(unsigned delayTicks, KernelTimerHandler* handler, void* param, void* context)
 {
-    unsigned elapseTimeTicks = m_ticks + delayTicks;
-    assert(handler != nullptr);
-
-    KernelTimer* timer = new KernelTimer(elapseTimeTicks, handler, param, context);
-    assert(timer != nullptr);
-    LOG_DEBUG("Create new timer to expire at %d ticks, handle %p", elapseTimeTicks, timer);
-
-    KernelTimerElement* prevElement{};
-    KernelTimerElement* element = m_kernelTimerList.GetFirst();
-    while (element != nullptr)
-    {
-        const KernelTimer* timer2 = m_kernelTimerList.GetPointer(element);
-        assert(timer2 != nullptr);
-        assert(timer2->m_magic == KERNEL_TIMER_MAGIC);
+#if BAREMETAL_TICKLESS
+    return AddKernelTimer(GetUptimeMicroSeconds() + static_cast<uint64>(delayTicks) * USEC_PER_TICK, handler, param, context);
+#else
+    return AddKernelTimer(m_ticks + delayTicks, handler, param, context);
+#endif
+}
 
-        if (static_cast<int>(timer2->m_elapsesAtTicks - elapseTimeTicks) > 0)
-        {
-            break;
-        }
+/// <summary>
+/// Starts a kernel timer with a delay in microseconds. In tickless mode the timer elapses at the requested time (plus interrupt latency),
+/// otherwise the delay is rounded up to whole timer ticks.
+/// </summary>
+/// <param name="delayUsec">Delay time for timer in microseconds</param>
+/// <param name="handler">Kernel timer handler to call when time elapses</param>
+/// <param name="param">Parameter to pass to kernel timer handler</param>
+/// <param name="context">Kernel timer handler context</param>
+/// <returns>Handle to kernel timer, 0 if no more timers are available (see KERNEL_TIMER_MAX)</returns>
+KernelTimerHandle Timer::StartKernelTimerMicroSeconds(uint64 delayUsec, KernelTimerHandler* handler, void* param, void* context)
+{
+#if BAREMETAL_TICKLESS
+    return AddKernelTimer(GetUptimeMicroSeconds() + delayUsec, handler, param, context);
+#else
+    return AddKernelTimer(m_ticks + (delayUsec + USEC_PER_TICK - 1) / USEC_PER_TICK, handler, param, context);
+#endif
+}
 
-        prevElement = element;
-        element = m_kernelTimerList.GetNext(element);
-    }
+/// <summary>
+/// Add a kernel timer to the timer wheel, and in tickless mode re-program the timer interrupt if the new timer is the first to elapse
+/// </summary>
+/// <param name="elapsesAt">Deadline, in timer ticks, or in microseconds since initialization in tickless mode</param>
+/// <param name="handler">Kernel timer handler to call when time elapses</param>
+/// <param name="param">Parameter to pass to kernel timer handler</param>
+/// <param name="context">Kernel timer handler context</param>
+/// <returns>Handle to kernel timer, 0 if no more timers are available (see KERNEL_TIMER_MAX)</returns>
+KernelTimerHandle Timer::AddKernelTimer(uint64 elapsesAt, KernelTimerHandler* handler, void* param, void* context)
+{
+    assert(handler != nullptr);
 
-    if (element != nullptr)
-    {
-        m_kernelTimerList.InsertBefore(element, timer);
-    }
-    else
-    {
-        m_kernelTimerList.InsertAfter(prevElement, timer);
-    }
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    KernelTimerHandle handle = m_kernelTimers.Add(elapsesAt, handler, param, context);
+#if BAREMETAL_TICKLESS
+    ProgramNextDeadline();
+#endif
+    SetDAIF(daif);
 
-    return reinterpret_cast<KernelTimerHandle>(timer);
+    LOG_DEBUG("Create new timer to expire at %llu, handle %llx", elapsesAt, handle);
+    return handle;
 }
 
 /// <summary>
-/// Cancels and removes a kernel timer.
+/// Cancels and removes a kernel timer. Cancelling a timer that has already elapsed or was already cancelled has no effect,
+/// even if the timer administration has been re-used for a new timer in the meantime.
 /// </summary>
 /// <param name="handle">Handle to kernel timer to cancel</param>
 void Timer::CancelKernelTimer(KernelTimerHandle handle)
 {
-    KernelTimer* timer = reinterpret_cast<KernelTimer*>(handle);
-    assert(timer != 0);
-    LOG_DEBUG("Cancel timer, expire time %d ticks, handle %p", timer->m_elapsesAtTicks, timer);
-
-    KernelTimerElement* element = m_kernelTimerList.Find(timer);
-    if (element != nullptr)
-    {
-        assert(timer->m_magic == KERNEL_TIMER_MAGIC);
-
-        m_kernelTimerList.Remove(element);
+    assert(handle != 0);
+
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    bool cancelled = m_kernelTimers.Cancel(handle);
+#if BAREMETAL_TICKLESS
+    if (cancelled)
+        ProgramNextDeadline();
+#endif
+    SetDAIF(daif);
 
-        timer->m_magic = 0;
-        delete timer;
-    }
+    LOG_DEBUG("Cancel timer, handle %llx%s", handle, cancelled ? "" : " (not active)");
 }
 
 /// <summary>
-/// Update all registered kernel timers, and handle expiration of timers
+/// Handle expiration of kernel timers. Only the timer wheel slots which are due are visited
 /// </summary>
 void Timer::PollKernelTimers()
 {
-    auto element = m_kernelTimerList.GetFirst();
-    while (element != nullptr)
-    {
-        KernelTimer* timer = m_kernelTimerList.GetPointer(element);
-        assert(timer != nullptr);
-        assert(timer->m_magic == KERNEL_TIMER_MAGIC);
+#if BAREMETAL_TICKLESS
+    m_kernelTimers.Advance(GetUptimeMicroSeconds());
+#else
+    m_kernelTimers.Advance(m_ticks);
+#endif
+}
 
-        if (static_cast<int>(timer->m_elapsesAtTicks - m_ticks) > 0)
-        {
-            break;
-        }
+#if BAREMETAL_TICKLESS
+/// <summary>
+/// Convert a number of counter register ticks to microseconds
+/// </summary>
+/// <param name="count">Number of counter ticks</param>
+/// <returns>Number of microseconds, rounded down</returns>
+uint64 Timer::CounterToMicroSeconds(uint64 count) const
+{
+    return Clock::CyclesToNanoSeconds(count) / NSEC_PER_USEC;
+}
 
-        LOG_DEBUG("Expire timer, expire time %d ticks, handle %p", timer->m_elapsesAtTicks, timer);
+/// <summary>
+/// Convert a number of microseconds to counter register ticks
+/// </summary>
+/// <param name="usec">Number of microseconds</param>
+/// <returns>Number of counter ticks, rounded up, so that the converted time is never before the requested time</returns>
+uint64 Timer::MicroSecondsToCounter(uint64 usec) const
+{
+    return Clock::NanoSecondsToCycles(usec * NSEC_PER_USEC) + 1;
+}
 
-        m_kernelTimerList.Remove(element);
+/// <summary>
+/// Program the timer interrupt for the next timer wheel event, or mask the timer interrupt if no kernel timers are active. Must be called with interrupts disabled.
+///
+/// If the deadline has already passed, the interrupt fires immediately.
+/// </summary>
+void Timer::ProgramNextDeadline()
+{
+    uint64 deadline{};
+    if (m_kernelTimers.GetNextEvent(deadline))
+    {
+        SetTimerCompareValue(m_startCounter + MicroSecondsToCounter(deadline));
+        SetTimerControl(CNTP_CTL_EL0_ENABLE);
+    }
+    else
+    {
+        SetTimerControl(CNTP_CTL_EL0_ENABLE | CNTP_CTL_EL0_IMASK);
+    }
+}
 
-        KernelTimerHandler* handler = timer->m_handler;
-        assert(handler != nullptr);
-        (*handler)(reinterpret_cast<KernelTimerHandle>(timer), timer->m_param, timer->m_context);
+/// <summary>
+/// Kernel timer handler calling the periodic handlers in tickless mode. Restarts itself relative to the previous deadline, so the period does not drift
+/// </summary>
+/// <param name="handle">Handle of the periodic kernel timer</param>
+/// <param name="param">Not used</param>
+/// <param name="context">Timer instance</param>
+void Timer::PeriodicKernelTimerHandler(KernelTimerHandle /*handle*/, void* /*param*/, void* context)
+{
+    Timer* instance = reinterpret_cast<Timer*>(context);
+    assert(instance != nullptr);
 
-        timer->m_magic = 0;
-        delete timer;
+    for (unsigned i = 0; i < instance->m_numPeriodicHandlers; i++)
+    {
+        if (instance->m_periodicHandlers[i] != nullptr)
+            (*instance->m_periodicHandlers[i])();
+    }
 
-        // The list may have changed due to the handler callback, so re-initialize
-        element = m_kernelTimerList.GetFirst();
+    if (instance->m_numPeriodicHandlers == 0)
+    {
+        instance->m_periodicTimer = 0;
+        return;
     }
+    uint64 now = instance->GetUptimeMicroSeconds();
+    instance->m_periodicDeadline += USEC_PER_TICK;
+    // Skip periods that were missed completely, rather than calling the handlers in a burst
+    if (instance->m_periodicDeadline <= now)
+        instance->m_periodicDeadline = now + USEC_PER_TICK - (now - instance->m_periodicDeadline) % USEC_PER_TICK;
+    instance->m_periodicTimer = instance->AddKernelTimer(instance->m_periodicDeadline, PeriodicKernelTimerHandler, nullptr, instance);
 }
+#endif
 
 /// <summary>
-/// Wait for specified number of NOP statements. Busy wait
+/// Wait for specified number of NOP statements. Busy wait, only intended for very short delays (e.g. GPIO setup times)
 /// </summary>
 /// <param name="numCycles">Number of cycles to wait</param>
 void Timer::WaitCycles(uint32 numCycles)
@@ -455,9 +619,7 @@ void Timer::WaitCycles(uint32 numCycles)
 }
 
 /// <summary>
-/// Wait for msec milliseconds using ARM timer registers (when not using physical counter) or BCM2835 system timer peripheral (when using physical counter). Busy wait
-///
-/// The timer used for the delays is the ARM built-in timer.
+/// Wait for msec milliseconds. The core sleeps until the deadline, see WaitMicroSeconds()
 /// </summary>
 /// <param name="msec">Wait time in milliseconds</param>
 void Timer::WaitMilliSeconds(uint64 msec)
@@ -466,23 +628,16 @@ void Timer::WaitMilliSeconds(uint64 msec)
 }
 
 /// <summary>
-/// Wait for usec microseconds using ARM timer registers (when not using physical counter) or BCM2835 system timer peripheral (when using physical
-/// counter). Busy wait
+/// Wait for usec microseconds, using the ARM generic timer counter.
 ///
-/// The timer used is the ARM built-in timer.
+/// The core sleeps (WFE) until the deadline, woken up by the timer event stream and interrupts, and only spins for the last event period
+/// (see Clock::WaitUntil()). Delays shorter than the event period (CLOCK_EVENT_STREAM_PERIOD_USEC) are spun. The wait ends at most a few counter
+/// cycles after the deadline, unless an interrupt handler runs at that time.
 /// </summary>
 /// <param name="usec">Wait time in microseconds</param>
 void Timer::WaitMicroSeconds(uint64 usec)
 {
-    auto& timer = GetTimer();
-    uint64 startTime = timer.GetSystemTimer();
-    uint64 currentTime{};
-    // Loop while counter elapse time is less than wait
-    // Careful: busy wait
-    do
-    {
-        currentTime = timer.GetSystemTimer();
-    } while (currentTime - startTime < usec);
+    Clock::Wait(Duration::FromMicroSeconds(static_cast<int64>(usec)));
 }
 
 /// <summary>
@@ -541,9 +696,16 @@ unsigned Timer::GetDaysInMonth(unsigned month, unsigned year)
 /// Interrupt handler for the timer
 ///
 /// Sets the next timer deadline, increments the timer tick count, as well as the time if needed, and calls the periodic handlers.
+/// In tickless mode, handles the kernel timers which have elapsed (including the one calling the periodic handlers), and programs the next deadline.
 /// </summary>
 void Timer::InterruptHandler()
 {
+    m_interruptCount++;
+
+#if BAREMETAL_TICKLESS
+    PollKernelTimers();
+    ProgramNextDeadline();
+#else
     uint64 compareValue;
     GetTimerCompareValue(compareValue);
     SetTimerCompareValue(compareValue + m_clockTicksPerSystemTick);
@@ -561,6 +723,7 @@ void Timer::InterruptHandler()
         if (m_periodicHandlers[i] != nullptr)
             (*m_periodicHandlers[i])();
     }
+#endif
 }
 
 /// <summary>
@@ -574,6 +737,8 @@ void Timer::InterruptHandler(void* param)
     Timer* instance = reinterpret_cast<Timer*>(param);
     assert(instance != nullptr);
 
+    // The timer handler is registered as not preemptible (see InterruptSystem::RegisterIRQHandler()), as the kernel timer administration is also
+    // changed from other IRQ handlers, and the kernel timer and periodic handlers have always run with IRQs disabled
     instance->InterruptHandler();
 }
 
@@ -0,0 +1,396 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : TimerWheel.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : TimerWheel
+//
+// Description : Hierarchical timing wheel for kernel timers
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/TimerWheel.h"
+
+#include "baremetal/Assert.h"
+
+/// @file
+/// Hierarchical timing wheel for kernel timers implementation
+
+/// @brief Mask for the slot index on a timer wheel level
+#define TIMER_WHEEL_SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+/// @brief Number of ticks covered by the complete timer wheel
+#define TIMER_WHEEL_RANGE     (1ULL << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS))
+
+namespace baremetal {
+
+/// <summary>
+/// Initialize a circular list head, or unlink a timer
+/// </summary>
+/// <param name="head">List head</param>
+static void InitList(KernelTimer* head)
+{
+    head->m_prev = head;
+    head->m_next = head;
+}
+
+/// <summary>
+/// Append a timer to a circular list
+/// </summary>
+/// <param name="head">List head</param>
+/// <param name="timer">Timer to append</param>
+static void AppendToList(KernelTimer* head, KernelTimer* timer)
+{
+    timer->m_prev = head->m_prev;
+    timer->m_next = head;
+    head->m_prev->m_next = timer;
+    head->m_prev = timer;
+}
+
+/// <summary>
+/// Move all timers from one circular list to another (empty) list
+/// </summary>
+/// <param name="from">List head to move timers from, will be empty afterwards</param>
+/// <param name="to">Empty list head to move timers to</param>
+static void MoveList(KernelTimer* from, KernelTimer* to)
+{
+    if (from->m_next == from)
+    {
+        InitList(to);
+        return;
+    }
+    to->m_next = from->m_next;
+    to->m_prev = from->m_prev;
+    to->m_next->m_prev = to;
+    to->m_prev->m_next = to;
+    InitList(from);
+}
+
+/// <summary>
+/// Constructs a timer wheel, with all timers in the free list
+/// </summary>
+TimerWheel::TimerWheel()
+    : m_timers{}
+    , m_freeList{}
+    , m_slots{}
+    , m_occupied{}
+    , m_currentTick{}
+    , m_activeCount{}
+{
+    for (unsigned level = 0; level < TIMER_WHEEL_LEVELS; ++level)
+    {
+        for (unsigned slot = 0; slot < TIMER_WHEEL_SLOTS; ++slot)
+        {
+            InitList(&m_slots[level][slot]);
+        }
+    }
+    for (size_t index = KERNEL_TIMER_MAX; index-- > 0;)
+    {
+        m_timers[index].m_slot = SlotFree;
+        m_timers[index].m_next = m_freeList;
+        m_freeList = &m_timers[index];
+    }
+}
+
+/// <summary>
+/// Cancel all active timers
+/// </summary>
+void TimerWheel::Clear()
+{
+    for (size_t index = 0; index < KERNEL_TIMER_MAX; ++index)
+    {
+        KernelTimer* timer = &m_timers[index];
+        if (timer->m_slot != SlotFree)
+        {
+            Unlink(timer);
+            Release(timer);
+        }
+    }
+}
+
+/// <summary>
+/// Add a timer to the timer wheel
+/// </summary>
+/// <param name="elapsesAtTicks">Tick at which the timer elapses. If this tick has already been handled, the timer elapses on the next call to Advance()</param>
+/// <param name="handler">Kernel timer handler to call when time elapses</param>
+/// <param name="param">Parameter to pass to kernel timer handler</param>
+/// <param name="context">Kernel timer handler context</param>
+/// <returns>Handle to kernel timer, 0 if no timer is available</returns>
+KernelTimerHandle TimerWheel::Add(uint64 elapsesAtTicks, KernelTimerHandler* handler, void* param, void* context)
+{
+    assert(handler != nullptr);
+
+    KernelTimer* timer = m_freeList;
+    assert(timer != nullptr);
+    if (timer == nullptr)
+        return 0;
+    m_freeList = timer->m_next;
+
+    timer->m_elapsesAtTicks = elapsesAtTicks;
+    timer->m_handler = handler;
+    timer->m_param = param;
+    timer->m_context = context;
+    Insert(timer);
+    m_activeCount++;
+
+    return GetHandle(timer);
+}
+
+/// <summary>
+/// Cancel a timer
+/// </summary>
+/// <param name="handle">Handle to the timer to cancel</param>
+/// <returns>True if the timer was active and is now cancelled, false if the handle is not valid, or the timer has already elapsed or was cancelled before</returns>
+bool TimerWheel::Cancel(KernelTimerHandle handle)
+{
+    KernelTimer* timer = GetTimer(handle);
+    if (timer == nullptr)
+        return false;
+
+    Unlink(timer);
+    Release(timer);
+    return true;
+}
+
+/// <summary>
+/// Check whether a timer is still active
+/// </summary>
+/// <param name="handle">Handle to the timer</param>
+/// <returns>True if the timer has not yet elapsed or been cancelled, false otherwise</returns>
+bool TimerWheel::IsActive(KernelTimerHandle handle) const
+{
+    return GetTimer(handle) != nullptr;
+}
+
+/// <summary>
+/// Handle all ticks up to and including the specified tick, and call the handlers of the timers which have elapsed.
+///
+/// Only the ticks at which there is work to do are visited: the current tick moves straight to the next occupied slot or cascade point on any level,
+/// as determined by GetNextEvent(), so the cost does not depend on the number of ticks passed. This matters in tickless mode, where a tick is a microsecond.
+/// A handler may start and cancel timers, including other timers elapsing at the same tick.
+/// </summary>
+/// <param name="ticks">Current tick</param>
+void TimerWheel::Advance(uint64 ticks)
+{
+    while (m_currentTick <= ticks)
+    {
+        uint64 nextEvent{};
+        if (!GetNextEvent(nextEvent) || (nextEvent > ticks))
+        {
+            m_currentTick = ticks + 1;
+            break;
+        }
+        if (nextEvent > m_currentTick)
+            m_currentTick = nextEvent;
+
+        unsigned slot = m_currentTick & TIMER_WHEEL_SLOT_MASK;
+        if (slot == 0)
+        {
+            for (unsigned level = 1; level < TIMER_WHEEL_LEVELS; ++level)
+            {
+                unsigned levelSlot = (m_currentTick >> (level * TIMER_WHEEL_SLOT_BITS)) & TIMER_WHEEL_SLOT_MASK;
+                Cascade(level, levelSlot);
+                if (levelSlot != 0)
+                    break;
+            }
+        }
+
+        KernelTimer dueList;
+        MoveList(&m_slots[0][slot], &dueList);
+        m_occupied[0] &= ~(1ULL << slot);
+        m_currentTick++;
+
+        for (KernelTimer* timer = dueList.m_next; timer != &dueList; timer = timer->m_next)
+        {
+            timer->m_slot = SlotDue;
+        }
+        while (dueList.m_next != &dueList)
+        {
+            KernelTimer* timer = dueList.m_next;
+            KernelTimerHandle handle = GetHandle(timer);
+            KernelTimerHandler* handler = timer->m_handler;
+            void* param = timer->m_param;
+            void* context = timer->m_context;
+
+            // Release the timer before calling the handler, so the handler can immediately re-use it
+            Unlink(timer);
+            Release(timer);
+            assert(handler != nullptr);
+            (*handler)(handle, param, context);
+        }
+    }
+}
+
+/// <summary>
+/// Determine the first tick at which Advance() has work to do: either a timer elapses, or a slot on a higher level is cascaded.
+/// This is never later than the first timer deadline, so it can be used to program a one shot timer interrupt.
+/// </summary>
+/// <param name="ticks">First tick to be handled, only valid if true is returned</param>
+/// <returns>True if there are active timers, false otherwise</returns>
+bool TimerWheel::GetNextEvent(uint64& ticks) const
+{
+    if (m_activeCount == 0)
+        return false;
+
+    bool found{};
+    for (unsigned level = 0; level < TIMER_WHEEL_LEVELS; ++level)
+    {
+        uint64 occupied = m_occupied[level];
+        if (occupied == 0)
+            continue;
+
+        unsigned shift = level * TIMER_WHEEL_SLOT_BITS;
+        uint64 block = m_currentTick >> shift;
+        // The slot for the current block is still to be handled only if we are at the start of the block
+        if ((m_currentTick & ((1ULL << shift) - 1)) != 0)
+            block++;
+        unsigned first = block & TIMER_WHEEL_SLOT_MASK;
+        uint64 rotated = (first == 0) ? occupied : ((occupied >> first) | (occupied << (TIMER_WHEEL_SLOTS - first)));
+        uint64 eventTicks = (block + static_cast<uint64>(__builtin_ctzll(rotated))) << shift;
+        if (!found || (eventTicks < ticks))
+            ticks = eventTicks;
+        found = true;
+    }
+    return found;
+}
+
+/// <summary>
+/// Look up the active timer for a handle
+/// </summary>
+/// <param name="handle">Handle to the timer</param>
+/// <returns>Pointer to the timer, or nullptr if the handle is not valid or stale</returns>
+KernelTimer* TimerWheel::GetTimer(KernelTimerHandle handle) const
+{
+    size_t index = static_cast<size_t>(handle & 0xFFFFFFFF);
+    if ((index == 0) || (index > KERNEL_TIMER_MAX))
+        return nullptr;
+    const KernelTimer* timer = &m_timers[index - 1];
+    if ((timer->m_slot == SlotFree) || (timer->m_generation != static_cast<uint32>(handle >> 32)))
+        return nullptr;
+    return const_cast<KernelTimer*>(timer);
+}
+
+/// <summary>
+/// Build the handle for a timer
+/// </summary>
+/// <param name="timer">Timer</param>
+/// <returns>Handle holding the timer index and generation</returns>
+KernelTimerHandle TimerWheel::GetHandle(const KernelTimer* timer) const
+{
+    return (static_cast<KernelTimerHandle>(timer->m_generation) << 32) | static_cast<KernelTimerHandle>(timer - m_timers + 1);
+}
+
+/// <summary>
+/// Link a timer in the slot that covers its deadline
+/// </summary>
+/// <param name="timer">Timer to insert</param>
+void TimerWheel::Insert(KernelTimer* timer)
+{
+    uint64 elapsesAtTicks = timer->m_elapsesAtTicks;
+    unsigned level = 0;
+    unsigned slot{};
+    if (static_cast<int64>(elapsesAtTicks - m_currentTick) < 0)
+    {
+        // Already due, handle on the next tick
+        slot = m_currentTick & TIMER_WHEEL_SLOT_MASK;
+    }
+    else
+    {
+        uint64 delta = elapsesAtTicks - m_currentTick;
+        if (delta >= TIMER_WHEEL_RANGE)
+        {
+            // Out of range, park on the top level, the timer is inserted again when that slot is cascaded
+            delta = TIMER_WHEEL_RANGE - 1;
+            elapsesAtTicks = m_currentTick + delta;
+        }
+        while ((level < TIMER_WHEEL_LEVELS - 1) && (delta >= (1ULL << ((level + 1) * TIMER_WHEEL_SLOT_BITS))))
+            level++;
+        slot = (elapsesAtTicks >> (level * TIMER_WHEEL_SLOT_BITS)) & TIMER_WHEEL_SLOT_MASK;
+    }
+
+    AppendToList(&m_slots[level][slot], timer);
+    timer->m_slot = static_cast<uint16>(level * TIMER_WHEEL_SLOTS + slot);
+    m_occupied[level] |= 1ULL << slot;
+}
+
+/// <summary>
+/// Unlink a timer from the slot it is in, or from the list of due timers
+/// </summary>
+/// <param name="timer">Timer to unlink</param>
+void TimerWheel::Unlink(KernelTimer* timer)
+{
+    timer->m_prev->m_next = timer->m_next;
+    timer->m_next->m_prev = timer->m_prev;
+    if (timer->m_slot < TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS)
+    {
+        unsigned level = timer->m_slot / TIMER_WHEEL_SLOTS;
+        unsigned slot = timer->m_slot % TIMER_WHEEL_SLOTS;
+        if (m_slots[level][slot].m_next == &m_slots[level][slot])
+            m_occupied[level] &= ~(1ULL << slot);
+    }
+}
+
+/// <summary>
+/// Return an unlinked timer to the free list. The generation is incremented, so any outstanding handle becomes stale
+/// </summary>
+/// <param name="timer">Timer to release</param>
+void TimerWheel::Release(KernelTimer* timer)
+{
+    timer->m_generation++;
+    timer->m_slot = SlotFree;
+    timer->m_prev = nullptr;
+    timer->m_next = m_freeList;
+    m_freeList = timer;
+    m_activeCount--;
+}
+
+/// <summary>
+/// Re-insert all timers of a slot on a higher level, which will then end up on a lower level
+/// </summary>
+/// <param name="level">Level of the slot to cascade</param>
+/// <param name="slot">Slot index</param>
+void TimerWheel::Cascade(unsigned level, unsigned slot)
+{
+    if ((m_occupied[level] & (1ULL << slot)) == 0)
+        return;
+
+    KernelTimer list;
+    MoveList(&m_slots[level][slot], &list);
+    m_occupied[level] &= ~(1ULL << slot);
+    while (list.m_next != &list)
+    {
+        KernelTimer* timer = list.m_next;
+        timer->m_prev->m_next = timer->m_next;
+        timer->m_next->m_prev = timer->m_prev;
+        Insert(timer);
+    }
+}
+
+} // namespace baremetal
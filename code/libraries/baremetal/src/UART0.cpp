@@ -41,16 +41,22 @@
 
 #include "baremetal/ARMInstructions.h"
 #include "baremetal/BCMRegisters.h"
+#include "baremetal/InterruptHandler.h"
 #include "baremetal/Mailbox.h"
 #include "baremetal/MemoryAccess.h"
 #include "baremetal/PhysicalGPIOPin.h"
 #include "baremetal/RPIProperties.h"
+#include "stdlib/Macros.h"
+#include "stdlib/Util.h"
 
 /// @file
 /// Raspberry Pi UART0 serial device implementation
 
 namespace baremetal {
 
+static_assert((UART0_TX_BUFFER_SIZE & (UART0_TX_BUFFER_SIZE - 1)) == 0, "UART0_TX_BUFFER_SIZE must be a power of 2");
+static_assert((UART0_RX_BUFFER_SIZE & (UART0_RX_BUFFER_SIZE - 1)) == 0, "UART0_RX_BUFFER_SIZE must be a power of 2");
+
 /// <summary>
 /// Constructs a default UART0 instance.
 ///
@@ -60,33 +66,101 @@ UART0::UART0()
     : m_isInitialized{}
     , m_memoryAccess{GetMemoryAccess()}
     , m_baudRate{}
+    , m_baudClock{}
+    , m_baudRateError{}
+    , m_isInterruptMode{}
+    , m_txBuffer{}
+    , m_txWriteCount{}
+    , m_txReadCount{}
+    , m_rxBuffer{}
+    , m_rxWriteCount{}
+    , m_rxReadCount{}
+    , m_statistics{}
 {
 }
 
 /// <summary>
-/// Constructs a specialized UART1 instance with a custom IMemoryAccess instance. This is intended for testing.
+/// Constructs a specialized UART0 instance with a custom IMemoryAccess instance. This is intended for testing.
 /// </summary>
 /// <param name="memoryAccess">Memory access interface</param>
 UART0::UART0(IMemoryAccess& memoryAccess)
     : m_isInitialized{}
     , m_memoryAccess{memoryAccess}
     , m_baudRate{}
+    , m_baudClock{}
+    , m_baudRateError{}
+    , m_isInterruptMode{}
+    , m_txBuffer{}
+    , m_txWriteCount{}
+    , m_txReadCount{}
+    , m_rxBuffer{}
+    , m_rxWriteCount{}
+    , m_rxReadCount{}
+    , m_statistics{}
+{
+}
+
+/// <summary>
+/// Destructs a UART0 instance. If interrupt mode is still enabled, it is disabled, which disconnects the interrupt handler
+/// </summary>
+UART0::~UART0()
 {
+    DisableInterruptMode();
 }
 
+/// @brief UART0 clock rates which are tried when searching for a baud rate divisor, in order of preference.
+/// The baud rate can be at most 1/16 of the UART clock, so the higher rates are needed for 3 and 4 Mbaud
+static const uint32 UART0ClockRates[] = {32000000, 48000000, 64000000};
+
 /// <summary>
-/// Convert the requested baudrate to the values for the integer and fractional part of the divisor to be set for UART0
+/// Calculate the baud rate divisor closest to the requested baud rate for a UART0 clock rate
 /// </summary>
 /// <param name="baudrate">Requested baud rate</param>
 /// <param name="baudClock">UART0 clock rate</param>
-/// <param name="intPart">Integral part of divisor</param>
-/// <param name="fracPart">Fractional part of divisor</param>
-static void ConvertBaudrate(unsigned baudrate, unsigned baudClock, uint32& intPart, uint32& fracPart)
+/// <param name="divisor">Divisor in units of 1/64, the upper bits are the integral part (IBRD), the lower 6 bits the fractional part (FBRD)</param>
+/// <param name="errorPPM">Deviation of the resulting baud rate from the requested baud rate in ppm, positive if the resulting baud rate is
+/// higher</param>
+/// <returns>True if the baud rate can be set with this clock rate, false if the divisor is out of range</returns>
+static bool CalculateDivisor(unsigned baudrate, uint32 baudClock, uint32& divisor, int& errorPPM)
 {
-    unsigned divisor = 16 * baudrate;
-    unsigned quotient = baudClock * 128 / divisor;
-    intPart = quotient / 128;                      // 16 bits
-    fracPart = (quotient - 128 * intPart + 1) / 2; // 6 bits, round
+    if (baudrate == 0)
+        return false;
+    // Divisor is baudClock / (16 * baudrate), so in units of 1/64 it is baudClock * 4 / baudrate, rounded
+    uint64 value = (static_cast<uint64>(baudClock) * 4 + baudrate / 2) / baudrate;
+    // The divisor must be at least 1, and if the integral part is at its maximum the fractional part must be 0
+    if ((value < 64) || (value > 0xFFFF * 64))
+        return false;
+    divisor = static_cast<uint32>(value);
+    int64 requested = static_cast<int64>(value) * baudrate;
+    errorPPM = static_cast<int>((static_cast<int64>(baudClock) * 4 - requested) * 1000000 / requested);
+    return true;
+}
+
+/// <summary>
+/// Find the UART0 clock rate and divisor giving the lowest baud rate error
+/// </summary>
+/// <param name="baudrate">Requested baud rate</param>
+/// <param name="baudClock">Selected UART0 clock rate</param>
+/// <param name="divisor">Divisor for the selected clock rate, in units of 1/64</param>
+/// <param name="errorPPM">Deviation of the resulting baud rate from the requested baud rate in ppm</param>
+/// <returns>True if a divisor is found with an error within UART0_MAX_BAUD_ERROR_PPM, false otherwise</returns>
+static bool SelectBaudClock(unsigned baudrate, uint32& baudClock, uint32& divisor, int& errorPPM)
+{
+    bool found{};
+    for (auto clockRate : UART0ClockRates)
+    {
+        uint32 clockDivisor{};
+        int clockError{};
+        if (!CalculateDivisor(baudrate, clockRate, clockDivisor, clockError))
+            continue;
+        if (found && (ABS(clockError) >= ABS(errorPPM)))
+            continue;
+        baudClock = clockRate;
+        divisor = clockDivisor;
+        errorPPM = clockError;
+        found = true;
+    }
+    return found && (ABS(errorPPM) <= UART0_MAX_BAUD_ERROR_PPM);
 }
 
 /// <summary>
@@ -94,33 +168,29 @@ static void ConvertBaudrate(unsigned baudrate, unsigned baudClock, uint32& intPa
 ///
 ///  Set baud rate and characteristics (8N1) and map to GPIO
 /// </summary>
-/// <param name="baudrate">Baud rate to set, maximum is 921600</param>
+/// <param name="baudrate">Baud rate to set, maximum is 4000000</param>
 void UART0::Initialize(unsigned baudrate)
 {
     if (m_isInitialized)
         return;
+    uint32 baudClock{};
+    uint32 divisor{};
+    int errorPPM{};
+    if (!SelectBaudClock(baudrate, baudClock, divisor, errorPPM))
+        return;
     // initialize UART
     m_memoryAccess.Write32(RPI_UART0_CR, 0); // turn off UART0
 
-    Mailbox       mailbox(MailboxChannel::ARM_MAILBOX_CH_PROP_OUT, m_memoryAccess);
-    RPIProperties properties(mailbox);
-    unsigned baudClock = 32000000;
-    if (!properties.SetClockRate(ClockID::UART, baudClock, false))
+    if (!ApplyBaudRate(baudrate, baudClock, divisor, errorPPM))
         return;
 
     // map UART0 to GPIO pins
     PhysicalGPIOPin txdPin(14, GPIOMode::AlternateFunction0, m_memoryAccess);
     PhysicalGPIOPin rxdPin(15, GPIOMode::AlternateFunction0, m_memoryAccess);
-    m_memoryAccess.Write32(RPI_UART0_ICR, 0x7FF); // clear interrupts
-    uint32 intPart{};
-    uint32 fracPart{};
-    ConvertBaudrate(baudrate, baudClock, intPart, fracPart);
-    m_memoryAccess.Write32(RPI_UART0_IBRD, intPart);
-    m_memoryAccess.Write32(RPI_UART0_FBRD, fracPart);
-    m_memoryAccess.Write32(RPI_UART0_LCRH, 0x7 << 4); // 8N1, enable FIFOs
+    m_memoryAccess.Write32(RPI_UART0_ICR, 0x7FF);     // clear interrupts
+    m_memoryAccess.Write32(RPI_UART0_LCRH, 0x7 << 4); // 8N1, enable FIFOs, this also latches the divisor
     m_memoryAccess.Write32(RPI_UART0_CR, 0x301);      // enable Tx, Rx, UART
 
-    m_baudRate = baudrate;
     m_isInitialized = true;
 }
 
@@ -133,15 +203,117 @@ unsigned UART0::GetBaudRate() const
     return m_baudRate;
 }
 
+/// <summary>
+/// Change the baud rate of an initialized device.
+///
+/// All data pending in the transmit buffer and FIFO is sent at the old baud rate first. The UART is then disabled while the UART clock and divisor
+/// are changed, as required by the PL011, and enabled again. Data being received during the switch is lost.
+/// </summary>
+/// <param name="baudrate">Baud rate to set, maximum is 4000000</param>
+/// <returns>True if the baud rate was set, false if the device is not initialized or the baud rate cannot be reached within
+/// UART0_MAX_BAUD_ERROR_PPM</returns>
+bool UART0::SetBaudRate(unsigned baudrate)
+{
+    if (!m_isInitialized)
+        return false;
+    if (baudrate == m_baudRate)
+        return true;
+    uint32 baudClock{};
+    uint32 divisor{};
+    int errorPPM{};
+    if (!SelectBaudClock(baudrate, baudClock, divisor, errorPPM))
+        return false;
+
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    // Nothing can be added to the transmit buffer by an interrupt handler now, so after flushing it stays empty
+    Flush();
+    while (m_memoryAccess.Read32(RPI_UART0_FR) & RPI_UART0_FR_BUSY)
+    {
+        NOP();
+    }
+    uint32 control = m_memoryAccess.Read32(RPI_UART0_CR);
+    m_memoryAccess.Write32(RPI_UART0_CR, 0);   // turn off UART0
+    m_memoryAccess.Write32(RPI_UART0_LCRH, 0); // disable FIFOs, this flushes them
+    bool result = ApplyBaudRate(baudrate, baudClock, divisor, errorPPM);
+    m_memoryAccess.Write32(RPI_UART0_LCRH, 0x7 << 4); // 8N1, enable FIFOs, this also latches the divisor
+    m_memoryAccess.Write32(RPI_UART0_CR, control);
+    SetDAIF(daif);
+    return result;
+}
+
+/// <summary>
+/// Return the deviation of the actual baud rate from the baud rate set, caused by the limited resolution of the divisor
+/// </summary>
+/// <returns>Baud rate error in ppm, positive if the actual baud rate is higher than the baud rate set</returns>
+int UART0::GetBaudRateError() const
+{
+    return m_baudRateError;
+}
+
+/// <summary>
+/// Set the UART clock and write the baud rate divisor. The UART must be disabled, the divisor takes effect with the next write to LCRH.
+///
+/// The firmware may not be able to set the UART clock to exactly the requested rate, in that case the divisor is recalculated for the actual clock rate.
+/// If the baud rate cannot be reached within UART0_MAX_BAUD_ERROR_PPM with the actual clock rate, the previous UART clock rate is restored and the
+/// divisor is not changed
+/// </summary>
+/// <param name="baudrate">Baud rate to set</param>
+/// <param name="baudClock">UART clock rate to set</param>
+/// <param name="divisor">Divisor for baudClock, in units of 1/64</param>
+/// <param name="errorPPM">Baud rate error in ppm for baudClock and divisor</param>
+/// <returns>True on success, false if the UART clock could not be set or the baud rate cannot be reached with the actual clock rate</returns>
+bool UART0::ApplyBaudRate(unsigned baudrate, uint32 baudClock, uint32 divisor, int errorPPM)
+{
+    if (baudClock != m_baudClock)
+    {
+        Mailbox       mailbox(MailboxChannel::ARM_MAILBOX_CH_PROP_OUT, m_memoryAccess);
+        RPIProperties properties(mailbox);
+        if (!properties.SetClockRate(ClockID::UART, baudClock, false))
+            return false;
+        uint32 actualClock{};
+        if (properties.GetClockRate(ClockID::UART, actualClock) && (actualClock != baudClock))
+        {
+            baudClock = actualClock;
+            if (!CalculateDivisor(baudrate, baudClock, divisor, errorPPM) || (ABS(errorPPM) > UART0_MAX_BAUD_ERROR_PPM))
+            {
+                // Leave the current baud rate intact
+                if (m_baudClock != 0)
+                    properties.SetClockRate(ClockID::UART, m_baudClock, false);
+                return false;
+            }
+        }
+        m_baudClock = baudClock;
+    }
+    m_memoryAccess.Write32(RPI_UART0_IBRD, divisor >> 6);
+    m_memoryAccess.Write32(RPI_UART0_FBRD, divisor & 0x3F);
+    m_baudRate = baudrate;
+    m_baudRateError = errorPPM;
+    return true;
+}
+
 /// <summary>
 /// Send a character
+///
+/// In interrupt mode the character is stored in the transmit buffer, waiting for space if the buffer is full
 /// </summary>
 /// <param name="c">Character to be sent</param>
 void UART0::Write(char c)
 {
+    if (m_isInterruptMode)
+    {
+        // The transmit buffer is also emptied from here, so this does not hang if IRQs are disabled
+        while (!PutTxByte(static_cast<uint8>(c)))
+        {
+            StartTransmit();
+        }
+        StartTransmit();
+        return;
+    }
     // wait until we can send
-    // Check Tx FIFO empty
-    while (m_memoryAccess.Read32(RPI_UART0_FR) & RPI_UART0_FR_TX_EMPTY)
+    // Check Tx FIFO not full
+    while (m_memoryAccess.Read32(RPI_UART0_FR) & RPI_UART0_FR_TXFF)
     {
         NOP();
     }
@@ -151,13 +323,24 @@ void UART0::Write(char c)
 
 /// <summary>
 /// Receive a character
+///
+/// In interrupt mode the character is taken from the receive buffer, waiting for data if the buffer is empty
 /// </summary>
 /// <returns>Character received</returns>
 char UART0::Read()
 {
+    if (m_isInterruptMode)
+    {
+        char c{};
+        while (Read(&c, 1) == 0)
+        {
+            NOP();
+        }
+        return c;
+    }
     // wait until something is in the buffer
     // Check Rx FIFO holds data
-    while (m_memoryAccess.Read32(RPI_UART0_FR) & RPI_UART0_FR_RX_READY)
+    while (m_memoryAccess.Read32(RPI_UART0_FR) & RPI_UART0_FR_RXFE)
     {
         NOP();
     }
@@ -165,12 +348,107 @@ char UART0::Read()
     return static_cast<char>(m_memoryAccess.Read32(RPI_UART0_DR));
 }
 
+/// <summary>
+/// Read a specified number of bytes from the device into a buffer
+///
+/// In polled mode this waits until all bytes are received. In interrupt mode this does not wait, but returns the bytes currently in the
+/// receive buffer, up to count
+/// </summary>
+/// <param name="buffer">Buffer, where read data will be placed</param>
+/// <param name="count">Maximum number of bytes to be read</param>
+/// <returns>Number of read bytes or < 0 on failure</returns>
+ssize_t UART0::Read(void* buffer, size_t count)
+{
+    if (!m_isInterruptMode)
+        return CharDevice::Read(buffer, count);
+    if (buffer == nullptr)
+        return static_cast<ssize_t>(-1);
+
+    uint8* bufferPtr = reinterpret_cast<uint8*>(buffer);
+    uint32 readCount = m_rxReadCount;
+    uint32 writeCount = __atomic_load_n(&m_rxWriteCount, __ATOMIC_ACQUIRE);
+    size_t bytesRead{};
+    while ((bytesRead < count) && (readCount != writeCount))
+    {
+        bufferPtr[bytesRead++] = m_rxBuffer[readCount++ & (UART0_RX_BUFFER_SIZE - 1)];
+    }
+    __atomic_store_n(&m_rxReadCount, readCount, __ATOMIC_RELEASE);
+    return static_cast<ssize_t>(bytesRead);
+}
+
+/// <summary>
+/// Write a specified number of bytes to the device, converting newline to carriage return + newline
+///
+/// In polled mode this waits until all bytes are sent. In interrupt mode this does not wait, but stores as many bytes as fit in the transmit buffer,
+/// and returns the number of bytes taken from buffer. See WriteV()
+/// </summary>
+/// <param name="buffer">Buffer, from which data will be fetched for write</param>
+/// <param name="count">Number of bytes to be written</param>
+/// <returns>Number of written bytes or < 0 on failure</returns>
+ssize_t UART0::Write(const void* buffer, size_t count)
+{
+    IOVector vector{buffer, count};
+    return WriteV(&vector, 1);
+}
+
+/// <summary>
+/// Write a list of buffers to the device in one call, converting newline to carriage return + newline
+///
+/// In polled mode this waits until all bytes are sent. The transmit FIFO is kept filled across buffers: the flag register is only read when the FIFO
+/// may be full, and if it reports an empty FIFO, a complete FIFO worth of bytes is written without further checks.
+/// In interrupt mode this does not wait, but stores as many bytes as fit in the transmit buffer, and starts transmission once for all buffers.
+/// It returns the total number of bytes taken from the buffers
+/// </summary>
+/// <param name="vectors">List of buffers to write</param>
+/// <param name="vectorCount">Number of buffers in list</param>
+/// <returns>Total number of written bytes or < 0 on failure</returns>
+ssize_t UART0::WriteV(const IOVector* vectors, size_t vectorCount)
+{
+    if (vectors == nullptr)
+        return static_cast<ssize_t>(-1);
+    for (size_t i = 0; i < vectorCount; ++i)
+    {
+        if ((vectors[i].buffer == nullptr) && (vectors[i].count != 0))
+            return static_cast<ssize_t>(-1);
+    }
+
+    size_t bytesWritten{};
+    if (!m_isInterruptMode)
+    {
+        size_t fifoSpace{};
+        for (size_t i = 0; i < vectorCount; ++i)
+        {
+            WriteToFIFO(reinterpret_cast<const char*>(vectors[i].buffer), vectors[i].count, fifoSpace);
+            bytesWritten += vectors[i].count;
+        }
+        return static_cast<ssize_t>(bytesWritten);
+    }
+
+    for (size_t i = 0; i < vectorCount; ++i)
+    {
+        size_t count = PutTxData(reinterpret_cast<const char*>(vectors[i].buffer), vectors[i].count);
+        bytesWritten += count;
+        if (count < vectors[i].count)
+        {
+            ++m_statistics.txBufferFull;
+            break;
+        }
+    }
+    StartTransmit();
+    return static_cast<ssize_t>(bytesWritten);
+}
+
 /// <summary>
 /// Write a string
 /// </summary>
 /// <param name="str">String to be written</param>
 void UART0::WriteString(const char* str)
 {
+    if (!m_isInterruptMode)
+    {
+        Write(str, strlen(str));
+        return;
+    }
     while (*str)
     {
         // convert newline to carriage return + newline
@@ -181,11 +459,284 @@ void UART0::WriteString(const char* str)
 }
 
 /// <summary>
-/// Flush buffers, in this case does nothing
+/// Flush buffers. In polled mode this does nothing, in interrupt mode this waits until the transmit buffer is empty and the UART has sent
+/// the last byte
 /// </summary>
 void UART0::Flush()
 {
-    // Do nothing
+    if (!m_isInterruptMode)
+        return;
+    while (GetTxFree() < UART0_TX_BUFFER_SIZE)
+    {
+        StartTransmit();
+    }
+    while (m_memoryAccess.Read32(RPI_UART0_FR) & RPI_UART0_FR_BUSY)
+    {
+        NOP();
+    }
+}
+
+/// <summary>
+/// Switch to interrupt mode. Transmit and receive are then handled by the UART0 interrupt, using the FIFO level interrupts:
+/// transmit is refilled when the transmit FIFO drops to 1/4, received data is collected when the receive FIFO reaches 1/2 or on receive
+/// timeout.
+///
+/// The device must be initialized first
+/// </summary>
+/// <returns>True if interrupt mode is enabled, false if the device is not initialized</returns>
+bool UART0::EnableInterruptMode()
+{
+    if (!m_isInitialized)
+        return false;
+    if (m_isInterruptMode)
+        return true;
+
+    m_txWriteCount = m_txReadCount = 0;
+    m_rxWriteCount = m_rxReadCount = 0;
+    m_memoryAccess.Write32(RPI_UART0_IMSC, 0);
+    m_memoryAccess.Write32(RPI_UART0_IFLS, RPI_UART0_IFLS_TX(RPI_UART0_IFLS_1_4) | RPI_UART0_IFLS_RX(RPI_UART0_IFLS_1_2));
+    m_memoryAccess.Write32(RPI_UART0_ICR, RPI_UART0_INT_ALL);
+    GetInterruptSystem().RegisterIRQHandler(IRQ_ID::IRQ_UART, IRQHandler, this);
+    m_isInterruptMode = true;
+    m_memoryAccess.Write32(RPI_UART0_IMSC, RPI_UART0_INT_RX | RPI_UART0_INT_TX | RPI_UART0_INT_RT | RPI_UART0_INT_FE | RPI_UART0_INT_PE |
+                                               RPI_UART0_INT_BE | RPI_UART0_INT_OE);
+    return true;
+}
+
+/// <summary>
+/// Switch back to polled mode. Pending transmit data is sent first, data left in the receive buffer is discarded
+/// </summary>
+void UART0::DisableInterruptMode()
+{
+    if (!m_isInterruptMode)
+        return;
+
+    Flush();
+    m_memoryAccess.Write32(RPI_UART0_IMSC, 0);
+    m_memoryAccess.Write32(RPI_UART0_ICR, RPI_UART0_INT_ALL);
+    GetInterruptSystem().UnregisterIRQHandler(IRQ_ID::IRQ_UART);
+    m_isInterruptMode = false;
+}
+
+/// <summary>
+/// Check whether the device is in interrupt mode
+/// </summary>
+/// <returns>True if transmit and receive are interrupt driven, false if polled</returns>
+bool UART0::IsInterruptMode() const
+{
+    return m_isInterruptMode;
+}
+
+/// <summary>
+/// Return the number of bytes waiting in the receive buffer (interrupt mode)
+/// </summary>
+/// <returns>Number of bytes that can be read without waiting</returns>
+size_t UART0::GetRxAvailable() const
+{
+    return __atomic_load_n(&m_rxWriteCount, __ATOMIC_ACQUIRE) - m_rxReadCount;
+}
+
+/// <summary>
+/// Return the number of free bytes in the transmit buffer (interrupt mode)
+/// </summary>
+/// <returns>Number of bytes that can be written without waiting</returns>
+size_t UART0::GetTxFree() const
+{
+    return UART0_TX_BUFFER_SIZE - (m_txWriteCount - __atomic_load_n(&m_txReadCount, __ATOMIC_ACQUIRE));
+}
+
+/// <summary>
+/// Return the transfer and error statistics gathered in interrupt mode
+/// </summary>
+/// <returns>Reference to the statistics</returns>
+const UARTStatistics& UART0::GetStatistics() const
+{
+    return m_statistics;
+}
+
+/// <summary>
+/// Reset the transfer and error statistics
+/// </summary>
+void UART0::ResetStatistics()
+{
+    memset(&m_statistics, 0, sizeof(m_statistics));
+}
+
+/// <summary>
+/// Handle the UART0 interrupt. Collects received data into the receive buffer, counting errors, and refills the transmit FIFO from the
+/// transmit buffer
+/// </summary>
+void UART0::InterruptHandler()
+{
+    uint32 status = m_memoryAccess.Read32(RPI_UART0_MIS);
+    m_memoryAccess.Write32(RPI_UART0_ICR, status);
+    ++m_statistics.interruptCount;
+
+    if (status & (RPI_UART0_INT_RX | RPI_UART0_INT_RT | RPI_UART0_INT_FE | RPI_UART0_INT_PE | RPI_UART0_INT_BE | RPI_UART0_INT_OE))
+        ReceiveFromFIFO();
+    if (status & RPI_UART0_INT_TX)
+        TransmitToFIFO();
+}
+
+/// <summary>
+/// UART0 IRQ handler, registered with the interrupt system
+/// </summary>
+/// <param name="param">Pointer to the UART0 instance</param>
+void UART0::IRQHandler(void* param)
+{
+    UART0* pThis = reinterpret_cast<UART0*>(param);
+    pThis->InterruptHandler();
+}
+
+/// <summary>
+/// Move all data from the receive FIFO to the receive buffer. Bytes received with a framing, parity or break error are counted and discarded.
+/// If the receive buffer is full, received bytes are counted and discarded.
+///
+/// Must be called from the interrupt handler (or with IRQs disabled)
+/// </summary>
+void UART0::ReceiveFromFIFO()
+{
+    uint32 writeCount = m_rxWriteCount;
+    while (!(m_memoryAccess.Read32(RPI_UART0_FR) & RPI_UART0_FR_RXFE))
+    {
+        uint32 data = m_memoryAccess.Read32(RPI_UART0_DR);
+        // Overrun means data was lost before this byte, the byte itself is valid
+        if (data & RPI_UART0_DR_OE)
+            ++m_statistics.rxFIFOOverrun;
+        if (data & RPI_UART0_DR_BE)
+        {
+            ++m_statistics.breakErrors;
+            continue;
+        }
+        if (data & RPI_UART0_DR_FE)
+        {
+            ++m_statistics.framingErrors;
+            continue;
+        }
+        if (data & RPI_UART0_DR_PE)
+        {
+            ++m_statistics.parityErrors;
+            continue;
+        }
+        if ((writeCount - __atomic_load_n(&m_rxReadCount, __ATOMIC_ACQUIRE)) >= UART0_RX_BUFFER_SIZE)
+        {
+            ++m_statistics.rxBufferOverrun;
+            continue;
+        }
+        m_rxBuffer[writeCount++ & (UART0_RX_BUFFER_SIZE - 1)] = static_cast<uint8>(data);
+        ++m_statistics.bytesReceived;
+    }
+    __atomic_store_n(&m_rxWriteCount, writeCount, __ATOMIC_RELEASE);
+}
+
+/// <summary>
+/// Move data from the transmit buffer to the transmit FIFO until the FIFO is full or the buffer is empty.
+///
+/// Must be called from the interrupt handler or with IRQs disabled, so that bytes are written to the FIFO in order
+/// </summary>
+void UART0::TransmitToFIFO()
+{
+    uint32 readCount = m_txReadCount;
+    uint32 writeCount = __atomic_load_n(&m_txWriteCount, __ATOMIC_ACQUIRE);
+    while ((readCount != writeCount) && !(m_memoryAccess.Read32(RPI_UART0_FR) & RPI_UART0_FR_TXFF))
+    {
+        m_memoryAccess.Write32(RPI_UART0_DR, m_txBuffer[readCount++ & (UART0_TX_BUFFER_SIZE - 1)]);
+        ++m_statistics.bytesSent;
+    }
+    __atomic_store_n(&m_txReadCount, readCount, __ATOMIC_RELEASE);
+}
+
+/// <summary>
+/// Fill the transmit FIFO from the transmit buffer with IRQs disabled. The transmit interrupt only fires when the FIFO level drops through the
+/// threshold, so an idle transmitter has to be started by the writer
+/// </summary>
+void UART0::StartTransmit()
+{
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    TransmitToFIFO();
+    SetDAIF(daif);
+}
+
+/// <summary>
+/// Store a byte in the transmit buffer
+/// </summary>
+/// <param name="data">Byte to store</param>
+/// <returns>True if the byte was stored, false if the transmit buffer is full</returns>
+bool UART0::PutTxByte(uint8 data)
+{
+    uint32 writeCount = m_txWriteCount;
+    if ((writeCount - __atomic_load_n(&m_txReadCount, __ATOMIC_ACQUIRE)) >= UART0_TX_BUFFER_SIZE)
+        return false;
+    m_txBuffer[writeCount & (UART0_TX_BUFFER_SIZE - 1)] = data;
+    __atomic_store_n(&m_txWriteCount, writeCount + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/// <summary>
+/// Write bytes to the transmit FIFO in polled mode, converting newline to carriage return + newline, and waiting for space in the FIFO when needed
+/// </summary>
+/// <param name="buffer">Bytes to write</param>
+/// <param name="count">Number of bytes to write</param>
+/// <param name="fifoSpace">Number of bytes known to fit in the FIFO, updated while writing. Start with 0 if unknown</param>
+void UART0::WriteToFIFO(const char* buffer, size_t count, size_t& fifoSpace)
+{
+    bool carriageReturnSent{};
+    for (size_t index = 0; index < count;)
+    {
+        if (fifoSpace == 0)
+        {
+            uint32 flags = m_memoryAccess.Read32(RPI_UART0_FR);
+            if (flags & RPI_UART0_FR_TXFE)
+                fifoSpace = RPI_UART0_FIFO_SIZE;
+            else if (!(flags & RPI_UART0_FR_TXFF))
+                fifoSpace = 1;
+            else
+            {
+                NOP();
+                continue;
+            }
+        }
+        char c = buffer[index];
+        // convert newline to carriage return + newline
+        if ((c == '\n') && !carriageReturnSent)
+        {
+            m_memoryAccess.Write32(RPI_UART0_DR, static_cast<uint32>('\r'));
+            carriageReturnSent = true;
+        }
+        else
+        {
+            m_memoryAccess.Write32(RPI_UART0_DR, static_cast<uint32>(c));
+            carriageReturnSent = false;
+            ++index;
+        }
+        --fifoSpace;
+    }
+}
+
+/// <summary>
+/// Store bytes in the transmit buffer in interrupt mode, converting newline to carriage return + newline. A newline is only stored if the
+/// carriage return fits as well
+/// </summary>
+/// <param name="buffer">Bytes to store</param>
+/// <param name="count">Number of bytes to store</param>
+/// <returns>Number of bytes taken from buffer</returns>
+size_t UART0::PutTxData(const char* buffer, size_t count)
+{
+    size_t bytesWritten{};
+    while (bytesWritten < count)
+    {
+        char c = buffer[bytesWritten];
+        if ((c == '\n') && (GetTxFree() < 2))
+            break;
+        if (c == '\n')
+            PutTxByte('\r');
+        if (!PutTxByte(static_cast<uint8>(c)))
+            break;
+        ++bytesWritten;
+    }
+    return bytesWritten;
 }
 
 /// <summary>
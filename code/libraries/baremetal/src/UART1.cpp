@@ -40,17 +40,31 @@
 #include "baremetal/UART1.h"
 
 #include "baremetal/ARMInstructions.h"
+#include "baremetal/Assert.h"
 #include "baremetal/BCMRegisters.h"
+#include "baremetal/InterruptHandler.h"
 #include "baremetal/Mailbox.h"
 #include "baremetal/MemoryAccess.h"
 #include "baremetal/PhysicalGPIOPin.h"
 #include "baremetal/RPIProperties.h"
+#include "stdlib/Macros.h"
+#include "stdlib/Util.h"
 
 /// @file
 /// Raspberry Pi UART1 serial device implementation
 
 namespace baremetal {
 
+static_assert((UART1_RX_BUFFER_SIZE & (UART1_RX_BUFFER_SIZE - 1)) == 0, "UART1_RX_BUFFER_SIZE must be a power of 2");
+
+#if BAREMETAL_RPI_TARGET == 3
+/// @brief IRQ line for the AUX peripherals (shared by UART1, SPI1 and SPI2)
+static const IRQ_ID UART1_IRQ{IRQ_ID::IRQ_AUX};
+#else
+/// @brief IRQ line for the AUX peripherals (shared by UART1, SPI1 and SPI2)
+static const IRQ_ID UART1_IRQ{IRQ_ID::IRQ_AUX_UART};
+#endif
+
 /// <summary>
 /// Constructs a default UART1 instance.
 ///
@@ -60,6 +74,18 @@ UART1::UART1()
     : m_isInitialized{}
     , m_memoryAccess{ GetMemoryAccess() }
     , m_baudrate{}
+    , m_baudrateError{}
+    , m_isReceiveInterruptEnabled{}
+    , m_rxBuffer{}
+    , m_rxWriteCount{}
+    , m_rxReadCount{}
+    , m_lineCallback{}
+    , m_lineCallbackParam{}
+    , m_line{}
+    , m_lineLength{}
+    , m_lineOverflow{}
+    , m_lastWasCarriageReturn{}
+    , m_statistics{}
 {
 }
 
@@ -71,15 +97,61 @@ UART1::UART1(IMemoryAccess& memoryAccess)
     : m_isInitialized{}
     , m_memoryAccess{ memoryAccess }
     , m_baudrate{}
+    , m_baudrateError{}
+    , m_isReceiveInterruptEnabled{}
+    , m_rxBuffer{}
+    , m_rxWriteCount{}
+    , m_rxReadCount{}
+    , m_lineCallback{}
+    , m_lineCallbackParam{}
+    , m_line{}
+    , m_lineLength{}
+    , m_lineOverflow{}
+    , m_lastWasCarriageReturn{}
+    , m_statistics{}
 {
 }
 
+/// <summary>
+/// Destructs a UART1 instance. If the receive interrupt is still enabled, it is disabled, which disconnects the interrupt handler
+/// </summary>
+UART1::~UART1()
+{
+    DisableReceiveInterrupt();
+}
+
+/// <summary>
+/// Calculate the mini UART baud rate register value closest to the requested baud rate.
+///
+/// The mini UART baud rate is clockRate / (8 * (value + 1)), the divisor is rounded to the nearest value instead of truncated, which at high
+/// baud rates halves the worst case error.
+/// </summary>
+/// <param name="baudrate">Requested baud rate</param>
+/// <param name="clockRate">Core clock rate</param>
+/// <param name="value">Baud rate register value</param>
+/// <param name="errorPPM">Deviation of the resulting baud rate from the requested baud rate in ppm, positive if the resulting baud rate is
+/// higher</param>
+/// <returns>True if a register value is found with an error within UART1_MAX_BAUD_ERROR_PPM, false otherwise</returns>
+static bool CalculateBaudValue(unsigned baudrate, uint32 clockRate, uint32& value, int& errorPPM)
+{
+    if (baudrate == 0)
+        return false;
+    uint64 divisor = (static_cast<uint64>(clockRate) + 4 * baudrate) / (8 * static_cast<uint64>(baudrate));
+    if ((divisor < 1) || (divisor > 0x10000))
+        return false;
+    value = static_cast<uint32>(divisor - 1);
+    int64 requested = static_cast<int64>(divisor) * 8 * baudrate;
+    errorPPM = static_cast<int>((static_cast<int64>(clockRate) - requested) * 1000000 / requested);
+    return ABS(errorPPM) <= UART1_MAX_BAUD_ERROR_PPM;
+}
+
 /// <summary>
 /// Initialize the UART1 device. Only performed once, guarded by m_isInitialized.
 ///
-///  Set baud rate and characteristics (8N1) and map to GPIO
+///  Set baud rate and characteristics (8N1) and map to GPIO. A baud rate which cannot be reached within UART1_MAX_BAUD_ERROR_PPM fails an assertion,
+///  and leaves the device uninitialized
 /// </summary>
-/// <param name="baudrate">Baud rate to set, maximum is 115200</param>
+/// <param name="baudrate">Baud rate to set, maximum is the core clock divided by 8</param>
 void UART1::Initialize(unsigned baudrate)
 {
     if (m_isInitialized)
@@ -87,8 +159,16 @@ void UART1::Initialize(unsigned baudrate)
 
     Mailbox mailbox(MailboxChannel::ARM_MAILBOX_CH_PROP_OUT, m_memoryAccess);
     RPIProperties property(mailbox);
-    uint32 clockFrequency;
-    property.GetClockRate(ClockID::CORE, clockFrequency);
+    uint32 clockFrequency{};
+    uint32 baudValue{};
+    int errorPPM{};
+    if (!property.GetClockRate(ClockID::CORE, clockFrequency))
+        return;
+    // Without a usable baud rate the UART stays disabled, and as it is normally the console nothing could be logged through it
+    bool baudrateSupported = CalculateBaudValue(baudrate, clockFrequency, baudValue, errorPPM);
+    assert(baudrateSupported);
+    if (!baudrateSupported)
+        return;
 
     // initialize UART
     auto value = m_memoryAccess.Read32(RPI_AUX_ENABLES);
@@ -103,10 +183,11 @@ void UART1::Initialize(unsigned baudrate)
     m_memoryAccess.Write32(RPI_AUX_MU_MCR, RPI_AUX_MU_MCR_RTS_HIGH);                                                                                                     // RTS high
     m_memoryAccess.Write32(RPI_AUX_MU_IER, 0);                                                                                                                           // Disable interrupts
     m_memoryAccess.Write32(RPI_AUX_MU_IIR, RPI_AUX_MU_IIR_TX_FIFO_ENABLE | RPI_AUX_MU_IIR_RX_FIFO_ENABLE | RPI_AUX_MU_IIR_TX_FIFO_CLEAR | RPI_AUX_MU_IIR_RX_FIFO_CLEAR); // Clear FIFO
-    m_memoryAccess.Write32(RPI_AUX_MU_BAUD, RPI_AUX_MU_BAUD_VALUE(clockFrequency, baudrate));                                                                            // Set baudrate
+    m_memoryAccess.Write32(RPI_AUX_MU_BAUD, baudValue);                                                                                                                  // Set baudrate
     m_memoryAccess.Write32(RPI_AUX_MU_CNTL, RPI_AUX_MU_CNTL_ENABLE_RX | RPI_AUX_MU_CNTL_ENABLE_TX);                                                                      // Enable Tx, Rx
 
     m_baudrate = baudrate;
+    m_baudrateError = errorPPM;
     m_isInitialized = true;
 }
 
@@ -119,12 +200,77 @@ unsigned UART1::GetBaudrate() const
     return m_baudrate;
 }
 
+/// <summary>
+/// Change the baud rate of an initialized device.
+///
+/// Waits until the transmit FIFO is empty and the last byte is sent, then disables transmitter and receiver while the baud rate register
+/// is changed. Data being received during the switch is lost.
+/// </summary>
+/// <param name="baudrate">Baud rate to set</param>
+/// <returns>True if the baud rate was set, false if the device is not initialized or the baud rate cannot be reached within
+/// UART1_MAX_BAUD_ERROR_PPM</returns>
+bool UART1::SetBaudrate(unsigned baudrate)
+{
+    if (!m_isInitialized)
+        return false;
+    if (baudrate == m_baudrate)
+        return true;
+
+    // The core clock may have changed since initialization, so request it again
+    Mailbox mailbox(MailboxChannel::ARM_MAILBOX_CH_PROP_OUT, m_memoryAccess);
+    RPIProperties property(mailbox);
+    uint32 clockFrequency{};
+    uint32 baudValue{};
+    int errorPPM{};
+    if (!property.GetClockRate(ClockID::CORE, clockFrequency) || !CalculateBaudValue(baudrate, clockFrequency, baudValue, errorPPM))
+        return false;
+
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    while (!(m_memoryAccess.Read32(RPI_AUX_MU_STAT) & RPI_AUX_MU_STAT_TX_DONE))
+    {
+        NOP();
+    }
+    auto control = m_memoryAccess.Read32(RPI_AUX_MU_CNTL);
+    m_memoryAccess.Write32(RPI_AUX_MU_CNTL, 0); // Disable Tx, Rx
+    m_memoryAccess.Write32(RPI_AUX_MU_BAUD, baudValue);
+    m_memoryAccess.Write32(RPI_AUX_MU_CNTL, control);
+    m_baudrate = baudrate;
+    m_baudrateError = errorPPM;
+    SetDAIF(daif);
+    return true;
+}
+
+/// <summary>
+/// Return the deviation of the actual baud rate from the baud rate set, caused by the integer divisor of the core clock
+/// </summary>
+/// <returns>Baud rate error in ppm, positive if the actual baud rate is higher than the baud rate set</returns>
+int UART1::GetBaudrateError() const
+{
+    return m_baudrateError;
+}
+
 /// <summary>
 /// Receive a character
+///
+/// With the receive interrupt enabled the character is taken from the receive buffer, waiting for data if the buffer is empty.
+/// In line assembly mode received data never reaches the receive buffer, so instead of waiting forever '\0' is returned if the buffer is empty
 /// </summary>
-/// <returns>Character received</returns>
+/// <returns>Character received, or '\0' if no character is available in line assembly mode</returns>
 char UART1::Read()
 {
+    if (m_isReceiveInterruptEnabled)
+    {
+        char c{};
+        while (Read(&c, 1) == 0)
+        {
+            if (m_lineCallback != nullptr)
+                return '\0';
+            NOP();
+        }
+        return c;
+    }
     // wait until something is in the buffer
     // Check Rx FIFO holds data
     while (!(m_memoryAccess.Read32(RPI_AUX_MU_LSR) & RPI_AUX_MU_LSR_RX_READY))
@@ -135,6 +281,34 @@ char UART1::Read()
     return static_cast<char>(m_memoryAccess.Read32(RPI_AUX_MU_IO));
 }
 
+/// <summary>
+/// Read a specified number of bytes from the device into a buffer
+///
+/// In polled mode this waits until all bytes are received. With the receive interrupt enabled this does not wait, but returns the bytes
+/// currently in the receive buffer, up to count. In line assembly mode the receive buffer is not used, so nothing is returned
+/// </summary>
+/// <param name="buffer">Buffer, where read data will be placed</param>
+/// <param name="count">Maximum number of bytes to be read</param>
+/// <returns>Number of read bytes or < 0 on failure</returns>
+ssize_t UART1::Read(void* buffer, size_t count)
+{
+    if (!m_isReceiveInterruptEnabled)
+        return CharDevice::Read(buffer, count);
+    if (buffer == nullptr)
+        return static_cast<ssize_t>(-1);
+
+    uint8* bufferPtr = reinterpret_cast<uint8*>(buffer);
+    uint32 readCount = m_rxReadCount;
+    uint32 writeCount = __atomic_load_n(&m_rxWriteCount, __ATOMIC_ACQUIRE);
+    size_t bytesRead{};
+    while ((bytesRead < count) && (readCount != writeCount))
+    {
+        bufferPtr[bytesRead++] = m_rxBuffer[readCount++ & (UART1_RX_BUFFER_SIZE - 1)];
+    }
+    __atomic_store_n(&m_rxReadCount, readCount, __ATOMIC_RELEASE);
+    return static_cast<ssize_t>(bytesRead);
+}
+
 /// <summary>
 /// Send a character
 /// </summary>
@@ -151,19 +325,81 @@ void UART1::Write(char c)
     m_memoryAccess.Write32(RPI_AUX_MU_IO, static_cast<uint32>(c));
 }
 
+/// <summary>
+/// Write a specified number of bytes to the device, converting newline to carriage return + newline. See WriteV()
+/// </summary>
+/// <param name="buffer">Buffer, from which data will be fetched for write</param>
+/// <param name="count">Number of bytes to be written</param>
+/// <returns>Number of written bytes or < 0 on failure</returns>
+ssize_t UART1::Write(const void* buffer, size_t count)
+{
+    IOVector vector{buffer, count};
+    return WriteV(&vector, 1);
+}
+
+/// <summary>
+/// Write a list of buffers to the device in one call, converting newline to carriage return + newline
+///
+/// The transmit FIFO is kept filled across buffers: the free space is determined from the transmit FIFO level, and that many bytes are written
+/// without further checks
+/// </summary>
+/// <param name="vectors">List of buffers to write</param>
+/// <param name="vectorCount">Number of buffers in list</param>
+/// <returns>Total number of written bytes or < 0 on failure</returns>
+ssize_t UART1::WriteV(const IOVector* vectors, size_t vectorCount)
+{
+    if (vectors == nullptr)
+        return static_cast<ssize_t>(-1);
+    for (size_t i = 0; i < vectorCount; ++i)
+    {
+        if ((vectors[i].buffer == nullptr) && (vectors[i].count != 0))
+            return static_cast<ssize_t>(-1);
+    }
+
+    size_t fifoSpace{};
+    size_t bytesWritten{};
+    for (size_t i = 0; i < vectorCount; ++i)
+    {
+        const char* bufferPtr = reinterpret_cast<const char*>(vectors[i].buffer);
+        bool carriageReturnSent{};
+        for (size_t index = 0; index < vectors[i].count;)
+        {
+            if (fifoSpace == 0)
+            {
+                fifoSpace = RPI_AUX_MU_FIFO_SIZE - RPI_AUX_MU_STAT_TX_FIFO_LEVEL(m_memoryAccess.Read32(RPI_AUX_MU_STAT));
+                if (fifoSpace == 0)
+                {
+                    NOP();
+                    continue;
+                }
+            }
+            char c = bufferPtr[index];
+            // convert newline to carriage return + newline
+            if ((c == '\n') && !carriageReturnSent)
+            {
+                m_memoryAccess.Write32(RPI_AUX_MU_IO, static_cast<uint32>('\r'));
+                carriageReturnSent = true;
+            }
+            else
+            {
+                m_memoryAccess.Write32(RPI_AUX_MU_IO, static_cast<uint32>(c));
+                carriageReturnSent = false;
+                ++index;
+            }
+            --fifoSpace;
+        }
+        bytesWritten += vectors[i].count;
+    }
+    return static_cast<ssize_t>(bytesWritten);
+}
+
 /// <summary>
 /// Write a string
 /// </summary>
 /// <param name="str">String to be written</param>
 void UART1::WriteString(const char* str)
 {
-    while (*str)
-    {
-        // convert newline to carriage return + newline
-        if (*str == '\n')
-            Write('\r');
-        Write(*str++);
-    }
+    Write(str, strlen(str));
 }
 
 /// <summary>
@@ -174,6 +410,181 @@ void UART1::Flush()
     // Do nothing
 }
 
+/// <summary>
+/// Enable the receive interrupt. Received data is then collected by the AUX interrupt handler into the receive buffer, or assembled into lines
+/// if a line callback is set. Transmit stays polled.
+///
+/// The device must be initialized first
+/// </summary>
+/// <returns>True if the receive interrupt is enabled, false if the device is not initialized</returns>
+bool UART1::EnableReceiveInterrupt()
+{
+    if (!m_isInitialized)
+        return false;
+    if (m_isReceiveInterruptEnabled)
+        return true;
+
+    m_rxWriteCount = m_rxReadCount = 0;
+    m_lineLength = 0;
+    m_lineOverflow = false;
+    m_lastWasCarriageReturn = false;
+    GetInterruptSystem().RegisterIRQHandler(UART1_IRQ, IRQHandler, this);
+    m_isReceiveInterruptEnabled = true;
+    m_memoryAccess.Write32(RPI_AUX_MU_IER, RPI_AUX_MU_IER_RX_IRQ_ENABLE | RPI_AUX_MU_IER_IRQ_REQUIRED);
+    return true;
+}
+
+/// <summary>
+/// Disable the receive interrupt and switch back to polled receive. Data left in the receive buffer is discarded
+/// </summary>
+void UART1::DisableReceiveInterrupt()
+{
+    if (!m_isReceiveInterruptEnabled)
+        return;
+
+    m_memoryAccess.Write32(RPI_AUX_MU_IER, 0);
+    GetInterruptSystem().UnregisterIRQHandler(UART1_IRQ);
+    m_isReceiveInterruptEnabled = false;
+}
+
+/// <summary>
+/// Check whether the receive interrupt is enabled
+/// </summary>
+/// <returns>True if receive is interrupt driven, false if polled</returns>
+bool UART1::IsReceiveInterruptEnabled() const
+{
+    return m_isReceiveInterruptEnabled;
+}
+
+/// <summary>
+/// Set or clear the callback for line assembly mode. With a callback set, received characters are collected into a line, which is passed to
+/// the callback when a carriage return or newline is received (CR LF counts as one line ending). Lines longer than UART1_LINE_SIZE - 1 are
+/// truncated. The callback is called from the interrupt handler, so it should be short.
+/// </summary>
+/// <param name="callback">Callback to receive complete lines, or nullptr to store received data in the receive buffer again</param>
+/// <param name="param">Parameter to pass to the callback</param>
+void UART1::SetLineCallback(UART1LineCallback* callback, void* param)
+{
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    m_lineCallback = callback;
+    m_lineCallbackParam = param;
+    m_lineLength = 0;
+    m_lineOverflow = false;
+    m_lastWasCarriageReturn = false;
+    SetDAIF(daif);
+}
+
+/// <summary>
+/// Return the number of bytes waiting in the receive buffer
+/// </summary>
+/// <returns>Number of bytes that can be read without waiting</returns>
+size_t UART1::GetRxAvailable() const
+{
+    return __atomic_load_n(&m_rxWriteCount, __ATOMIC_ACQUIRE) - m_rxReadCount;
+}
+
+/// <summary>
+/// Return the receive and error statistics gathered with the receive interrupt enabled
+/// </summary>
+/// <returns>Reference to the statistics</returns>
+const UARTStatistics& UART1::GetStatistics() const
+{
+    return m_statistics;
+}
+
+/// <summary>
+/// Reset the receive and error statistics
+/// </summary>
+void UART1::ResetStatistics()
+{
+    memset(&m_statistics, 0, sizeof(m_statistics));
+}
+
+/// <summary>
+/// Handle the AUX interrupt for UART1. Empties the receive FIFO into the receive buffer or line being assembled, and counts FIFO overruns.
+///
+/// The mini UART cannot detect framing, parity or break errors, so only overruns are counted
+/// </summary>
+void UART1::InterruptHandler()
+{
+    // The AUX interrupt is shared with SPI1 and SPI2
+    if (!(m_memoryAccess.Read32(RPI_AUX_IRQ) & RPI_AUX_IRQ_UART1))
+        return;
+    ++m_statistics.interruptCount;
+
+    for (;;)
+    {
+        // The overrun flag is cleared by reading the line status register
+        uint32 status = m_memoryAccess.Read32(RPI_AUX_MU_LSR);
+        if (status & RPI_AUX_MU_LSR_RX_OVERRUN)
+            ++m_statistics.rxFIFOOverrun;
+        if (!(status & RPI_AUX_MU_LSR_RX_READY))
+            break;
+        uint8 data = static_cast<uint8>(m_memoryAccess.Read32(RPI_AUX_MU_IO));
+        if (m_lineCallback != nullptr)
+            AssembleLine(static_cast<char>(data));
+        else
+            StoreReceivedByte(data);
+    }
+}
+
+/// <summary>
+/// UART1 IRQ handler, registered with the interrupt system
+/// </summary>
+/// <param name="param">Pointer to the UART1 instance</param>
+void UART1::IRQHandler(void* param)
+{
+    UART1* pThis = reinterpret_cast<UART1*>(param);
+    pThis->InterruptHandler();
+}
+
+/// <summary>
+/// Store a received byte in the receive buffer. If the buffer is full, the byte is counted and discarded
+/// </summary>
+/// <param name="data">Byte received</param>
+void UART1::StoreReceivedByte(uint8 data)
+{
+    uint32 writeCount = m_rxWriteCount;
+    if ((writeCount - __atomic_load_n(&m_rxReadCount, __ATOMIC_ACQUIRE)) >= UART1_RX_BUFFER_SIZE)
+    {
+        ++m_statistics.rxBufferOverrun;
+        return;
+    }
+    m_rxBuffer[writeCount & (UART1_RX_BUFFER_SIZE - 1)] = data;
+    __atomic_store_n(&m_rxWriteCount, writeCount + 1, __ATOMIC_RELEASE);
+    ++m_statistics.bytesReceived;
+}
+
+/// <summary>
+/// Add a received character to the line being assembled, and pass the line to the line callback on a line ending
+/// </summary>
+/// <param name="c">Character received</param>
+void UART1::AssembleLine(char c)
+{
+    bool lastWasCarriageReturn = m_lastWasCarriageReturn;
+    m_lastWasCarriageReturn = (c == '\r');
+    ++m_statistics.bytesReceived;
+    // Newline directly after carriage return completes the same line ending
+    if ((c == '\n') && lastWasCarriageReturn)
+        return;
+    if ((c == '\r') || (c == '\n'))
+    {
+        m_line[m_lineLength] = '\0';
+        if (m_lineOverflow)
+            ++m_statistics.lineOverflows;
+        m_lineCallback(m_line, m_lineLength, m_lineCallbackParam);
+        m_lineLength = 0;
+        m_lineOverflow = false;
+        return;
+    }
+    if (m_lineLength < UART1_LINE_SIZE - 1)
+        m_line[m_lineLength++] = c;
+    else
+        m_lineOverflow = true;
+}
+
 /// <summary>
 /// Construct the singleton UART1 device if needed, and return a reference to the instance
 /// </summary>
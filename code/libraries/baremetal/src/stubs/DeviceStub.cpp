@@ -0,0 +1,201 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : DeviceStub.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : DeviceStub
+//
+// Description : Device stub collecting written data
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/stubs/DeviceStub.h"
+
+#include "stdlib/Util.h"
+
+/// @file
+/// Device stub implementation
+
+namespace baremetal {
+
+/// <summary>
+/// Constructs a device stub with an empty data buffer
+/// </summary>
+DeviceStub::DeviceStub()
+    : m_data{}
+    , m_dataCount{}
+    , m_writeCount{}
+    , m_writeLimit{static_cast<size_t>(-1)}
+    , m_writeHandler{}
+    , m_writeHandlerParam{}
+{
+}
+
+/// <summary>
+/// Determines whether the device is a block device
+/// </summary>
+/// <returns>Always false</returns>
+bool DeviceStub::IsBlockDevice()
+{
+    return false;
+}
+
+/// <summary>
+/// Write a specified number of bytes to the device. Up to the write limit bytes are accepted, as far as they fit they are kept in the data buffer.
+/// The write handler, if set, is called first
+/// </summary>
+/// <param name="buffer">Buffer, from which data will be fetched for write</param>
+/// <param name="count">Number of bytes to be written</param>
+/// <returns>Number of written bytes</returns>
+ssize_t DeviceStub::Write(const void* buffer, size_t count)
+{
+    ++m_writeCount;
+    if (m_writeHandler != nullptr)
+        (*m_writeHandler)(*this, m_writeHandlerParam);
+    if (count > m_writeLimit)
+        count = m_writeLimit;
+    Store(buffer, count);
+    return static_cast<ssize_t>(count);
+}
+
+/// <summary>
+/// Write a list of buffers to the device in one call. This counts as a single write, the write handler is called once, and the write limit
+/// applies to the total number of bytes
+/// </summary>
+/// <param name="vectors">List of buffers to write</param>
+/// <param name="vectorCount">Number of buffers in list</param>
+/// <returns>Total number of written bytes or < 0 on failure</returns>
+ssize_t DeviceStub::WriteV(const IOVector* vectors, size_t vectorCount)
+{
+    if (vectors == nullptr)
+        return static_cast<ssize_t>(-1);
+    ++m_writeCount;
+    if (m_writeHandler != nullptr)
+        (*m_writeHandler)(*this, m_writeHandlerParam);
+    size_t total{};
+    for (size_t i = 0; (i < vectorCount) && (total < m_writeLimit); ++i)
+    {
+        size_t count = vectors[i].count;
+        if (count > m_writeLimit - total)
+            count = m_writeLimit - total;
+        Store(vectors[i].buffer, count);
+        total += count;
+    }
+    return static_cast<ssize_t>(total);
+}
+
+/// <summary>
+/// Limit the number of bytes accepted by a single write. A limit of 0 makes every write return 0, as a non-blocking device with a full transmit buffer
+/// </summary>
+/// <param name="limit">Maximum number of bytes accepted per write. Defaults to no limit</param>
+void DeviceStub::SetWriteLimit(size_t limit /*= static_cast<size_t>(-1)*/)
+{
+    m_writeLimit = limit;
+}
+
+/// <summary>
+/// Set a handler which is called at the start of every write. The handler may write to the device itself, or to the console using the device
+/// </summary>
+/// <param name="handler">Handler to call, nullptr to remove the handler</param>
+/// <param name="param">Parameter passed to the handler</param>
+void DeviceStub::SetWriteHandler(DeviceStubWriteHandler* handler, void* param)
+{
+    m_writeHandler = handler;
+    m_writeHandlerParam = param;
+}
+
+/// <summary>
+/// Discard all collected data, and reset the write count
+/// </summary>
+void DeviceStub::Clear()
+{
+    m_dataCount = 0;
+    m_writeCount = 0;
+}
+
+/// <summary>
+/// Return the collected data. Note that the data is not null terminated
+/// </summary>
+/// <returns>Pointer to the collected data</returns>
+const char* DeviceStub::GetData() const
+{
+    return m_data;
+}
+
+/// <summary>
+/// Return the number of bytes collected
+/// </summary>
+/// <returns>Number of valid bytes returned by GetData()</returns>
+size_t DeviceStub::GetDataCount() const
+{
+    return m_dataCount;
+}
+
+/// <summary>
+/// Return the number of calls to Write() and WriteV()
+/// </summary>
+/// <returns>Number of calls to Write() and WriteV()</returns>
+size_t DeviceStub::GetWriteCount() const
+{
+    return m_writeCount;
+}
+
+/// <summary>
+/// Find a string in the collected data
+/// </summary>
+/// <param name="str">String to search for</param>
+/// <param name="start">Offset in the collected data to start searching from</param>
+/// <returns>Offset of the first occurrence of the string at or after start, or -1 if not found</returns>
+ssize_t DeviceStub::Find(const char* str, size_t start /*= 0*/) const
+{
+    size_t length = strlen(str);
+    for (size_t offset = start; offset + length <= m_dataCount; ++offset)
+    {
+        if (memcmp(m_data + offset, str, length) == 0)
+            return static_cast<ssize_t>(offset);
+    }
+    return static_cast<ssize_t>(-1);
+}
+
+/// <summary>
+/// Keep written bytes in the data buffer, as far as they fit
+/// </summary>
+/// <param name="buffer">Bytes written</param>
+/// <param name="count">Number of bytes written</param>
+void DeviceStub::Store(const void* buffer, size_t count)
+{
+    if (count > DEVICE_STUB_DATA_SIZE - m_dataCount)
+        count = DEVICE_STUB_DATA_SIZE - m_dataCount;
+    memcpy(m_data + m_dataCount, buffer, count);
+    m_dataCount += count;
+}
+
+} // namespace baremetal
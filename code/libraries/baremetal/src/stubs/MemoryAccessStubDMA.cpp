@@ -0,0 +1,333 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : MemoryAccessStubDMA.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : MemoryAccessStubDMA
+//
+// Description : DMA controller stub
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/stubs/MemoryAccessStubDMA.h"
+
+#include "baremetal/BCMRegisters.h"
+#include "baremetal/Logger.h"
+#include "stdlib/Util.h"
+
+/// @file
+/// MemoryAccessStubDMA
+
+/// @brief Define log name
+LOG_MODULE("MemoryAccessStubDMA");
+
+using namespace baremetal;
+
+/// @brief Bits of the CS register that can be written (the others are status bits, or write 1 to clear)
+static const uint32 ControlStatusWriteMask = RPI_DMA_CS_DISDEBUG | RPI_DMA_CS_WAIT_FOR_OUTSTANDING_WRITES | RPI_DMA_CS_PANIC_PRIORITY(0xF) |
+                                             RPI_DMA_CS_PRIORITY(0xF) | RPI_DMA_CS_ACTIVE;
+/// @brief First DMA Lite channel
+static const uint32 FirstLiteChannel = 7;
+
+/// <summary>
+/// MemoryAccessStubDMA constructor
+/// </summary>
+MemoryAccessStubDMA::MemoryAccessStubDMA()
+    : m_channels{}
+    , m_enable{}
+    , m_autoComplete{true}
+    , m_transferError{}
+    , m_peripheralData{}
+    , m_peripheralDataCount{}
+    , m_peripheralReadData{}
+    , m_peripheralReadSize{}
+    , m_peripheralReadCount{}
+{
+}
+
+/// <summary>
+/// Read a 32 bit value from register at address
+/// </summary>
+/// <param name="address">Address of register</param>
+/// <returns>32 bit register value</returns>
+uint32 MemoryAccessStubDMA::Read32(regaddr address)
+{
+    uintptr addr = reinterpret_cast<uintptr>(address);
+    if ((addr < RPI_DMA_BASE) || (addr >= RPI_DMA_END))
+    {
+        return MemoryAccessStubMailbox::Read32(address);
+    }
+    if (address == RPI_DMA_ENABLE)
+        return m_enable;
+    if (address == RPI_DMA_INT_STATUS)
+    {
+        uint32 status{};
+        for (uint32 channel = 0; channel < DMA_CHANNELS; ++channel)
+        {
+            if (m_channels[channel].ControlStatus & RPI_DMA_CS_INT)
+                status |= BIT1(channel);
+        }
+        return status;
+    }
+    for (uint32 channel = 0; channel < DMA_CHANNELS; ++channel)
+    {
+        if (address == RPI_DMA_CS(channel))
+            return m_channels[channel].ControlStatus;
+        if (address == RPI_DMA_CONBLK_AD(channel))
+            return m_channels[channel].ControlBlockAddress;
+        if (address == RPI_DMA_DEBUG(channel))
+            return (channel >= FirstLiteChannel) ? RPI_DMA_DEBUG_LITE : 0;
+    }
+
+    LOG_ERROR("Invalid register access for reading: address %016llx", addr);
+    return {};
+}
+
+/// <summary>
+/// Write a 32 bit value to register at address
+/// </summary>
+/// <param name="address">Address of register</param>
+/// <param name="data">Data to write</param>
+void MemoryAccessStubDMA::Write32(regaddr address, uint32 data)
+{
+    uintptr addr = reinterpret_cast<uintptr>(address);
+    if ((addr < RPI_DMA_BASE) || (addr >= RPI_DMA_END))
+    {
+        MemoryAccessStubMailbox::Write32(address, data);
+        return;
+    }
+    if (address == RPI_DMA_ENABLE)
+    {
+        m_enable = data;
+        return;
+    }
+    for (uint32 channel = 0; channel < DMA_CHANNELS; ++channel)
+    {
+        DMAChannelRegisters& registers = m_channels[channel];
+        if (address == RPI_DMA_CS(channel))
+        {
+            if (data & RPI_DMA_CS_RESET)
+            {
+                registers = {};
+                return;
+            }
+            // END and INT are cleared by writing a 1
+            registers.ControlStatus &= ~(data & (RPI_DMA_CS_END | RPI_DMA_CS_INT));
+            registers.ControlStatus = (registers.ControlStatus & ~ControlStatusWriteMask) | (data & ControlStatusWriteMask);
+            if ((registers.ControlStatus & RPI_DMA_CS_ACTIVE) && m_autoComplete)
+                RunChannel(channel);
+            return;
+        }
+        if (address == RPI_DMA_CONBLK_AD(channel))
+        {
+            registers.ControlBlockAddress = data;
+            return;
+        }
+        if (address == RPI_DMA_DEBUG(channel))
+            return;
+    }
+
+    LOG_ERROR("Invalid register access for writing: address %016llx", addr);
+}
+
+/// <summary>
+/// Select whether transfers are executed as soon as a channel is activated (the default), or only when CompleteTransfers() is called
+/// </summary>
+/// <param name="autoComplete">If true, transfers are executed immediately</param>
+void MemoryAccessStubDMA::SetAutoComplete(bool autoComplete)
+{
+    m_autoComplete = autoComplete;
+}
+
+/// <summary>
+/// Execute the transfers of all active channels
+/// </summary>
+void MemoryAccessStubDMA::CompleteTransfers()
+{
+    for (uint32 channel = 0; channel < DMA_CHANNELS; ++channel)
+    {
+        if (m_channels[channel].ControlStatus & RPI_DMA_CS_ACTIVE)
+            RunChannel(channel);
+    }
+}
+
+/// <summary>
+/// Select whether transfers end with an error. The control blocks are still executed, but the channel reports an error when it ends
+/// </summary>
+/// <param name="transferError">If true, transfers ended from now on report an error</param>
+void MemoryAccessStubDMA::SetTransferError(bool transferError)
+{
+    m_transferError = transferError;
+}
+
+/// <summary>
+/// Return the number of control blocks executed by a channel since it was last reset
+/// </summary>
+/// <param name="channel">Channel number</param>
+/// <returns>Number of control blocks executed</returns>
+uint32 MemoryAccessStubDMA::GetControlBlockCount(uint32 channel) const
+{
+    return (channel < DMA_CHANNELS) ? m_channels[channel].ControlBlockCount : 0;
+}
+
+/// <summary>
+/// Return the bytes written to peripherals
+/// </summary>
+/// <returns>Pointer to bytes written to peripherals</returns>
+const uint8* MemoryAccessStubDMA::GetPeripheralData() const
+{
+    return m_peripheralData;
+}
+
+/// <summary>
+/// Return the number of bytes written to peripherals
+/// </summary>
+/// <returns>Number of bytes written to peripherals</returns>
+size_t MemoryAccessStubDMA::GetPeripheralDataCount() const
+{
+    return m_peripheralDataCount;
+}
+
+/// <summary>
+/// Set the data returned for reads from peripherals. Reads beyond the end of the data return 0
+/// </summary>
+/// <param name="data">Data to return, must stay valid while transfers are executed</param>
+/// <param name="size">Size of data in bytes</param>
+void MemoryAccessStubDMA::SetPeripheralReadData(const void* data, size_t size)
+{
+    m_peripheralReadData = reinterpret_cast<const uint8*>(data);
+    m_peripheralReadSize = size;
+    m_peripheralReadCount = 0;
+}
+
+/// <summary>
+/// Execute the control block chain of a channel, and signal the end of the transfer
+/// </summary>
+/// <param name="channel">Channel number</param>
+void MemoryAccessStubDMA::RunChannel(uint32 channel)
+{
+    DMAChannelRegisters& registers = m_channels[channel];
+    while (registers.ControlBlockAddress != 0)
+    {
+        const DMAControlBlock* controlBlock = reinterpret_cast<const DMAControlBlock*>(GPU_TO_ARM(static_cast<uintptr>(registers.ControlBlockAddress)));
+        ExecuteControlBlock(*controlBlock);
+        ++registers.ControlBlockCount;
+        if (controlBlock->transferInformation & RPI_DMA_TI_INTEN)
+            registers.ControlStatus |= RPI_DMA_CS_INT;
+        registers.ControlBlockAddress = controlBlock->nextControlBlockAddress;
+    }
+    registers.ControlStatus = (registers.ControlStatus & ~(RPI_DMA_CS_ACTIVE | RPI_DMA_CS_ERROR)) | RPI_DMA_CS_END;
+    if (m_transferError)
+        registers.ControlStatus |= RPI_DMA_CS_ERROR;
+}
+
+/// <summary>
+/// Execute a single control block, in normal or 2D mode
+/// </summary>
+/// <param name="controlBlock">Control block to execute</param>
+void MemoryAccessStubDMA::ExecuteControlBlock(const DMAControlBlock& controlBlock)
+{
+    uint32 transferInformation = controlBlock.transferInformation;
+    uint32 rowLength = controlBlock.transferLength;
+    uint32 rowCount = 1;
+    int16 sourceStride{};
+    int16 destinationStride{};
+    if (transferInformation & RPI_DMA_TI_TDMODE)
+    {
+        rowLength = controlBlock.transferLength & 0xFFFF;
+        rowCount = ((controlBlock.transferLength >> 16) & 0x3FFF) + 1;
+        sourceStride = static_cast<int16>(controlBlock.stride & 0xFFFF);
+        destinationStride = static_cast<int16>(controlBlock.stride >> 16);
+    }
+    uint32 sourceAddress = controlBlock.sourceAddress;
+    uint32 destinationAddress = controlBlock.destinationAddress;
+    for (uint32 row = 0; row < rowCount; ++row)
+    {
+        for (uint32 offset = 0; offset < rowLength; ++offset)
+        {
+            WriteByte(destinationAddress, offset, transferInformation, ReadByte(sourceAddress, offset, transferInformation));
+        }
+        if (transferInformation & RPI_DMA_TI_SRC_INC)
+            sourceAddress += rowLength;
+        if (transferInformation & RPI_DMA_TI_DEST_INC)
+            destinationAddress += rowLength;
+        sourceAddress += sourceStride;
+        destinationAddress += destinationStride;
+    }
+}
+
+/// <summary>
+/// Read a byte from the source of a transfer. If the source is not incremented, the same word (or 128 bit word for wide reads) is read
+/// repeatedly
+/// </summary>
+/// <param name="busAddress">Source bus address for the current row</param>
+/// <param name="offset">Byte offset in the current row</param>
+/// <param name="transferInformation">Transfer information of the control block</param>
+/// <returns>Byte read</returns>
+uint8 MemoryAccessStubDMA::ReadByte(uint32 busAddress, uint32 offset, uint32 transferInformation)
+{
+    if (transferInformation & RPI_DMA_TI_SRC_IGNORE)
+        return 0;
+    if ((busAddress & 0xFF000000) == GPU_IO_BASE)
+    {
+        if (m_peripheralReadCount >= m_peripheralReadSize)
+            return 0;
+        return m_peripheralReadData[m_peripheralReadCount++];
+    }
+    uint32 wordSize = (transferInformation & RPI_DMA_TI_SRC_WIDTH) ? 16 : 4;
+    if (!(transferInformation & RPI_DMA_TI_SRC_INC))
+        offset %= wordSize;
+    return reinterpret_cast<const uint8*>(GPU_TO_ARM(static_cast<uintptr>(busAddress)))[offset];
+}
+
+/// <summary>
+/// Write a byte to the destination of a transfer. If the destination is not incremented, the same word (or 128 bit word for wide writes)
+/// is written repeatedly
+/// </summary>
+/// <param name="busAddress">Destination bus address for the current row</param>
+/// <param name="offset">Byte offset in the current row</param>
+/// <param name="transferInformation">Transfer information of the control block</param>
+/// <param name="data">Byte to write</param>
+void MemoryAccessStubDMA::WriteByte(uint32 busAddress, uint32 offset, uint32 transferInformation, uint8 data)
+{
+    if (transferInformation & RPI_DMA_TI_DEST_IGNORE)
+        return;
+    if ((busAddress & 0xFF000000) == GPU_IO_BASE)
+    {
+        if (m_peripheralDataCount < DMA_STUB_PERIPHERAL_DATA_SIZE)
+            m_peripheralData[m_peripheralDataCount++] = data;
+        return;
+    }
+    uint32 wordSize = (transferInformation & RPI_DMA_TI_DEST_WIDTH) ? 16 : 4;
+    if (!(transferInformation & RPI_DMA_TI_DEST_INC))
+        offset %= wordSize;
+    reinterpret_cast<uint8*>(GPU_TO_ARM(static_cast<uintptr>(busAddress)))[offset] = data;
+}
@@ -0,0 +1,169 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : MemoryAccessStubMailbox.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : MemoryAccessStubMailbox
+//
+// Description : Memory access stub answering property mailbox requests
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/stubs/MemoryAccessStubMailbox.h"
+
+#include "baremetal/BCMRegisters.h"
+#include "baremetal/Logger.h"
+#include "baremetal/RPIPropertiesInterface.h"
+
+/// @file
+/// MemoryAccessStubMailbox
+
+/// @brief Define log name
+LOG_MODULE("MemoryAccessStubMailbox");
+
+using namespace baremetal;
+
+/// <summary>
+/// MemoryAccessStubMailbox constructor
+/// </summary>
+MemoryAccessStubMailbox::MemoryAccessStubMailbox()
+    : m_mailboxData{}
+    , m_mailboxResponsePending{}
+    , m_clockRates{}
+    , m_maxClockRates{}
+{
+    m_clockRates[static_cast<uint32>(ClockID::UART)] = 48000000;
+    m_clockRates[static_cast<uint32>(ClockID::CORE)] = 250000000;
+}
+
+/// <summary>
+/// Read a 32 bit value from register at address
+/// </summary>
+/// <param name="address">Address of register</param>
+/// <returns>32 bit register value</returns>
+uint32 MemoryAccessStubMailbox::Read32(regaddr address)
+{
+    uintptr addr = reinterpret_cast<uintptr>(address);
+    if ((addr >= RPI_GPIO_BASE) && (addr < RPI_GPIO_END))
+    {
+        return MemoryAccessStubGPIO::Read32(address);
+    }
+    if (address == RPI_MAILBOX0_STATUS)
+        return m_mailboxResponsePending ? 0 : RPI_MAILBOX_STATUS_EMPTY;
+    if (address == RPI_MAILBOX1_STATUS)
+        return 0;
+    if (address == RPI_MAILBOX0_READ)
+    {
+        m_mailboxResponsePending = false;
+        return m_mailboxData;
+    }
+
+    LOG_ERROR("Invalid register access for reading: address %016llx", addr);
+    return {};
+}
+
+/// <summary>
+/// Write a 32 bit value to register at address
+/// </summary>
+/// <param name="address">Address of register</param>
+/// <param name="data">Data to write</param>
+void MemoryAccessStubMailbox::Write32(regaddr address, uint32 data)
+{
+    uintptr addr = reinterpret_cast<uintptr>(address);
+    if ((addr >= RPI_GPIO_BASE) && (addr < RPI_GPIO_END))
+    {
+        MemoryAccessStubGPIO::Write32(address, data);
+        return;
+    }
+    if (address == RPI_MAILBOX1_WRITE)
+    {
+        HandleMailboxWrite(data);
+        return;
+    }
+
+    LOG_ERROR("Invalid register access for writing: address %016llx", addr);
+}
+
+/// <summary>
+/// Return the current rate of a clock, as set through the property mailbox
+/// </summary>
+/// <param name="clockID">Clock to return the rate for</param>
+/// <returns>Clock rate in Hz, 0 for an unknown clock</returns>
+uint32 MemoryAccessStubMailbox::GetClockRate(ClockID clockID) const
+{
+    auto index = static_cast<uint32>(clockID);
+    return (index < MAILBOX_STUB_CLOCK_COUNT) ? m_clockRates[index] : 0;
+}
+
+/// <summary>
+/// Limit the rate a clock can be set to, to simulate firmware which cannot set the exact rate requested. A higher rate set is changed into this
+/// maximum
+/// </summary>
+/// <param name="clockID">Clock to limit</param>
+/// <param name="rate">Maximum clock rate in Hz, 0 for no limit</param>
+void MemoryAccessStubMailbox::SetMaxClockRate(ClockID clockID, uint32 rate)
+{
+    auto index = static_cast<uint32>(clockID);
+    if (index < MAILBOX_STUB_CLOCK_COUNT)
+        m_maxClockRates[index] = rate;
+}
+
+/// <summary>
+/// Handle a write to the property mailbox, by answering all tags in the request with success.
+/// Clock rates set are remembered, limited to the maximum set with SetMaxClockRate(), and returned for clock rate requests. DMA channel requests return MAILBOX_STUB_DMA_CHANNELS
+/// </summary>
+/// <param name="data">Mailbox data written (GPU address of property buffer and channel)</param>
+void MemoryAccessStubMailbox::HandleMailboxWrite(uint32 data)
+{
+    MailboxBuffer* buffer = reinterpret_cast<MailboxBuffer*>(GPU_TO_ARM(static_cast<uintptr>(data & ~0xF)));
+    uint8* tagPtr = buffer->tags;
+    while (reinterpret_cast<PropertyTagEnd*>(tagPtr)->tagID != static_cast<uint32>(PropertyID::PROPTAG_END))
+    {
+        PropertyTag* tag = reinterpret_cast<PropertyTag*>(tagPtr);
+        LOG_DEBUG("Mailbox property request %08x", tag->tagID);
+        // Clock rate tags hold the clock ID followed by the rate
+        uint32* values = reinterpret_cast<uint32*>(tag->tagBuffer);
+        if ((tag->tagID == static_cast<uint32>(PropertyID::PROPTAG_SET_CLOCK_RATE)) && (values[0] < MAILBOX_STUB_CLOCK_COUNT))
+        {
+            uint32 maxRate = m_maxClockRates[values[0]];
+            m_clockRates[values[0]] = ((maxRate != 0) && (values[1] > maxRate)) ? maxRate : values[1];
+        }
+        else if ((tag->tagID == static_cast<uint32>(PropertyID::PROPTAG_GET_CLOCK_RATE)) && (values[0] < MAILBOX_STUB_CLOCK_COUNT))
+            values[1] = m_clockRates[values[0]];
+        else if (tag->tagID == static_cast<uint32>(PropertyID::PROPTAG_GET_DMA_CHANNELS))
+            values[0] = MAILBOX_STUB_DMA_CHANNELS;
+        tag->tagRequestResponse = RPI_MAILBOX_TAG_RESPONSE | tag->tagBufferSize;
+        tagPtr += sizeof(PropertyTag) + ((tag->tagBufferSize + 3) & ~3);
+    }
+    buffer->requestCode = RPI_MAILBOX_RESPONSE_SUCCESS;
+    m_mailboxData = data;
+    m_mailboxResponsePending = true;
+}
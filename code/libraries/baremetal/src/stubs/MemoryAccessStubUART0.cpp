@@ -0,0 +1,371 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : MemoryAccessStubUART0.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : MemoryAccessStubUART0
+//
+// Description : Memory access stub for UART0 (PL011)
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/stubs/MemoryAccessStubUART0.h"
+
+#include "baremetal/BCMRegisters.h"
+#include "baremetal/Logger.h"
+#include "stdlib/Util.h"
+
+/// @file
+/// MemoryAccessStubUART0
+
+/// @brief Define log name
+LOG_MODULE("MemoryAccessStubUART0");
+
+using namespace baremetal;
+
+/// <summary>
+/// Convert a FIFO level select value (IFLS field) to a number of bytes
+/// </summary>
+/// <param name="level">FIFO level select value</param>
+/// <returns>FIFO level in bytes</returns>
+static size_t FIFOLevelToBytes(uint32 level)
+{
+    switch (level)
+    {
+    case RPI_UART0_IFLS_1_8:
+        return RPI_UART0_FIFO_SIZE / 8;
+    case RPI_UART0_IFLS_1_4:
+        return RPI_UART0_FIFO_SIZE / 4;
+    case RPI_UART0_IFLS_3_4:
+        return RPI_UART0_FIFO_SIZE * 3 / 4;
+    case RPI_UART0_IFLS_7_8:
+        return RPI_UART0_FIFO_SIZE * 7 / 8;
+    default:
+        return RPI_UART0_FIFO_SIZE / 2;
+    }
+}
+
+/// <summary>
+/// MemoryAccessStubUART0 constructor
+/// </summary>
+MemoryAccessStubUART0::MemoryAccessStubUART0()
+    : m_registers{}
+    , m_rxFifo{}
+    , m_rxFifoErrors{}
+    , m_txFifo{}
+    , m_rxOverrunPending{}
+    , m_txData{}
+    , m_txDataCount{}
+{
+}
+
+/// <summary>
+/// Read a 8 bit value from register at address
+/// </summary>
+/// <param name="address">Address of register</param>
+/// <returns>8 bit register value</returns>
+uint8 MemoryAccessStubUART0::Read8(regaddr address)
+{
+    LOG_PANIC("Call to Read8 should not happen");
+    return {};
+}
+
+/// <summary>
+/// Write a 8 bit value to register at address
+/// </summary>
+/// <param name="address">Address of register</param>
+/// <param name="data">Data to write</param>
+void MemoryAccessStubUART0::Write8(regaddr address, uint8 data)
+{
+    LOG_PANIC("Call to Write8 should not happen");
+}
+
+/// <summary>
+/// Read a 16 bit value from register at address
+/// </summary>
+/// <param name="address">Address of register</param>
+/// <returns>16 bit register value</returns>
+uint16 MemoryAccessStubUART0::Read16(regaddr address)
+{
+    LOG_PANIC("Call to Read16 should not happen");
+    return {};
+}
+
+/// <summary>
+/// Write a 16 bit value to register at address
+/// </summary>
+/// <param name="address">Address of register</param>
+/// <param name="data">Data to write</param>
+void MemoryAccessStubUART0::Write16(regaddr address, uint16 data)
+{
+    LOG_PANIC("Call to Write16 should not happen");
+}
+
+/// <summary>
+/// Read a 32 bit value from register at address
+/// </summary>
+/// <param name="address">Address of register</param>
+/// <returns>32 bit register value</returns>
+uint32 MemoryAccessStubUART0::Read32(regaddr address)
+{
+    uintptr addr = reinterpret_cast<uintptr>(address);
+    if ((addr < RPI_UART0_BASE) || (addr >= RPI_UART0_END))
+    {
+        return MemoryAccessStubMailbox::Read32(address);
+    }
+
+    if (address == RPI_UART0_DR)
+        return ReadData();
+    if (address == RPI_UART0_FR)
+        return GetFlags();
+    if (address == RPI_UART0_IBRD)
+        return m_registers.IntegerBaudRateDivisor;
+    if (address == RPI_UART0_FBRD)
+        return m_registers.FractionalBaudRateDivisor;
+    if (address == RPI_UART0_LCRH)
+        return m_registers.LineControl;
+    if (address == RPI_UART0_CR)
+        return m_registers.Control;
+    if (address == RPI_UART0_IFLS)
+        return m_registers.InterruptFIFOLevelSelect;
+    if (address == RPI_UART0_IMSC)
+        return m_registers.InterruptMask;
+    if (address == RPI_UART0_RIS)
+        return GetRawInterruptStatus();
+    if (address == RPI_UART0_MIS)
+        return GetRawInterruptStatus() & m_registers.InterruptMask;
+    if (address == RPI_UART0_DMACR)
+        return m_registers.DMAControl;
+
+    LOG_ERROR("Invalid register access for reading: address %016llx", addr);
+    return {};
+}
+
+/// <summary>
+/// Write a 32 bit value to register at address
+/// </summary>
+/// <param name="address">Address of register</param>
+/// <param name="data">Data to write</param>
+void MemoryAccessStubUART0::Write32(regaddr address, uint32 data)
+{
+    uintptr addr = reinterpret_cast<uintptr>(address);
+    if ((addr < RPI_UART0_BASE) || (addr >= RPI_UART0_END))
+    {
+        MemoryAccessStubMailbox::Write32(address, data);
+        return;
+    }
+
+    if (address == RPI_UART0_DR)
+    {
+        if (m_txFifo.IsFull())
+            LOG_DEBUG("UART0 Write to full transmit FIFO, data lost %02x", data & 0xFF);
+        m_txFifo.Write(static_cast<uint8>(data));
+    }
+    else if (address == RPI_UART0_IBRD)
+    {
+        LOG_DEBUG("UART0 Set integer baud rate divisor %d", data);
+        m_registers.IntegerBaudRateDivisor = data;
+    }
+    else if (address == RPI_UART0_FBRD)
+    {
+        LOG_DEBUG("UART0 Set fractional baud rate divisor %d", data);
+        m_registers.FractionalBaudRateDivisor = data;
+    }
+    else if (address == RPI_UART0_LCRH)
+    {
+        LOG_DEBUG("UART0 Set line control %08x", data);
+        m_registers.LineControl = data;
+    }
+    else if (address == RPI_UART0_CR)
+    {
+        LOG_DEBUG("UART0 Set control %08x", data);
+        m_registers.Control = data;
+    }
+    else if (address == RPI_UART0_IFLS)
+    {
+        LOG_DEBUG("UART0 Set interrupt FIFO level select %08x", data);
+        m_registers.InterruptFIFOLevelSelect = data;
+    }
+    else if (address == RPI_UART0_IMSC)
+    {
+        LOG_DEBUG("UART0 Set interrupt mask %08x", data);
+        m_registers.InterruptMask = data & RPI_UART0_INT_ALL;
+    }
+    else if (address == RPI_UART0_ICR)
+    {
+        m_registers.ErrorInterruptStatus &= ~data;
+    }
+    else if (address == RPI_UART0_DMACR)
+    {
+        LOG_DEBUG("UART0 Set DMA control %08x", data);
+        m_registers.DMAControl = data;
+    }
+    else
+    {
+        LOG_ERROR("Invalid register access for writing: address %016llx", addr);
+    }
+}
+
+/// <summary>
+/// Put bytes on the receive line. Bytes are stored in the receive FIFO, if the FIFO is full, the bytes are lost and an overrun is flagged,
+/// which is reported with the next byte entering the FIFO
+/// </summary>
+/// <param name="data">Bytes received</param>
+/// <param name="count">Number of bytes received</param>
+/// <param name="errorFlags">Error bits (RPI_UART0_DR_FE, RPI_UART0_DR_PE, RPI_UART0_DR_BE) to set for all bytes</param>
+/// <returns>Number of bytes stored in the receive FIFO</returns>
+size_t MemoryAccessStubUART0::ReceiveData(const void* data, size_t count, uint32 errorFlags /*= 0*/)
+{
+    const uint8* bytes = reinterpret_cast<const uint8*>(data);
+    size_t stored{};
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (m_rxFifo.IsFull())
+        {
+            m_rxOverrunPending = true;
+            m_registers.ErrorInterruptStatus |= RPI_UART0_INT_OE;
+            continue;
+        }
+        uint32 flags = errorFlags;
+        if (m_rxOverrunPending)
+            flags |= RPI_UART0_DR_OE;
+        m_rxOverrunPending = false;
+        if (flags & RPI_UART0_DR_FE)
+            m_registers.ErrorInterruptStatus |= RPI_UART0_INT_FE;
+        if (flags & RPI_UART0_DR_PE)
+            m_registers.ErrorInterruptStatus |= RPI_UART0_INT_PE;
+        if (flags & RPI_UART0_DR_BE)
+            m_registers.ErrorInterruptStatus |= RPI_UART0_INT_BE;
+        m_rxFifo.Write(bytes[i]);
+        m_rxFifoErrors.Write(static_cast<uint8>(flags >> 8));
+        ++stored;
+    }
+    return stored;
+}
+
+/// <summary>
+/// Take bytes from the transmit FIFO off the line, and store them for inspection with GetTransmittedData()
+/// </summary>
+/// <param name="maxCount">Maximum number of bytes to take</param>
+/// <returns>Number of bytes taken from the transmit FIFO</returns>
+size_t MemoryAccessStubUART0::TransmitData(size_t maxCount /*= UART0_STUB_LINE_SIZE*/)
+{
+    size_t count{};
+    while ((count < maxCount) && !m_txFifo.IsEmpty())
+    {
+        uint8 data = m_txFifo.Read();
+        if (m_txDataCount < UART0_STUB_LINE_SIZE)
+            m_txData[m_txDataCount++] = data;
+        ++count;
+    }
+    return count;
+}
+
+/// <summary>
+/// Return the bytes transmitted so far
+/// </summary>
+/// <returns>Pointer to transmitted bytes</returns>
+const uint8* MemoryAccessStubUART0::GetTransmittedData() const
+{
+    return m_txData;
+}
+
+/// <summary>
+/// Return the number of bytes transmitted so far
+/// </summary>
+/// <returns>Number of transmitted bytes</returns>
+size_t MemoryAccessStubUART0::GetTransmittedCount() const
+{
+    return m_txDataCount;
+}
+
+/// <summary>
+/// Discard the bytes transmitted so far
+/// </summary>
+void MemoryAccessStubUART0::ClearTransmittedData()
+{
+    memset(m_txData, 0, sizeof(m_txData));
+    m_txDataCount = 0;
+}
+
+/// <summary>
+/// Determine the flag register (FR) value from the FIFO states
+/// </summary>
+/// <returns>Flag register value</returns>
+uint32 MemoryAccessStubUART0::GetFlags()
+{
+    uint32 result{};
+    if (!m_txFifo.IsEmpty())
+        result |= RPI_UART0_FR_BUSY;
+    if (m_rxFifo.IsEmpty())
+        result |= RPI_UART0_FR_RXFE;
+    if (m_txFifo.IsFull())
+        result |= RPI_UART0_FR_TXFF;
+    if (m_rxFifo.IsFull())
+        result |= RPI_UART0_FR_RXFF;
+    if (m_txFifo.IsEmpty())
+        result |= RPI_UART0_FR_TXFE;
+    return result;
+}
+
+/// <summary>
+/// Determine the raw interrupt status (RIS) from the FIFO levels and latched errors.
+/// The receive timeout is simulated as having expired as soon as data below the receive level is waiting
+/// </summary>
+/// <returns>Raw interrupt status register value</returns>
+uint32 MemoryAccessStubUART0::GetRawInterruptStatus()
+{
+    uint32 result = m_registers.ErrorInterruptStatus;
+    size_t rxLevel = FIFOLevelToBytes((m_registers.InterruptFIFOLevelSelect >> 3) & 0x7);
+    size_t txLevel = FIFOLevelToBytes(m_registers.InterruptFIFOLevelSelect & 0x7);
+    if (m_rxFifo.UsedSpace() >= rxLevel)
+        result |= RPI_UART0_INT_RX;
+    else if (!m_rxFifo.IsEmpty())
+        result |= RPI_UART0_INT_RT;
+    if (m_txFifo.UsedSpace() <= txLevel)
+        result |= RPI_UART0_INT_TX;
+    return result;
+}
+
+/// <summary>
+/// Read the data register (DR): next byte from the receive FIFO with its error flags
+/// </summary>
+/// <returns>Data register value</returns>
+uint32 MemoryAccessStubUART0::ReadData()
+{
+    if (m_rxFifo.IsEmpty())
+    {
+        LOG_DEBUG("UART0 Read from empty receive FIFO");
+        return {};
+    }
+    uint32 errors = m_rxFifoErrors.Read();
+    return m_rxFifo.Read() | (errors << 8);
+}
@@ -0,0 +1,312 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : MemoryAccessStubUART1.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : MemoryAccessStubUART1
+//
+// Description : Memory access stub for UART1 (mini UART)
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/stubs/MemoryAccessStubUART1.h"
+
+#include "baremetal/BCMRegisters.h"
+#include "baremetal/Logger.h"
+
+/// @file
+/// MemoryAccessStubUART1
+
+/// @brief Define log name
+LOG_MODULE("MemoryAccessStubUART1");
+
+using namespace baremetal;
+
+/// @brief End of the AUX register range handled by this stub (AUX IRQ, enables and mini UART registers)
+static uintptr UART1RegistersEnd{RPI_AUX_MU_BASE + 0x00000040};
+
+/// <summary>
+/// MemoryAccessStubUART1 constructor
+/// </summary>
+MemoryAccessStubUART1::MemoryAccessStubUART1()
+    : m_registers{}
+    , m_rxFifo{}
+    , m_txFifo{}
+    , m_rxOverrun{}
+    , m_txData{}
+    , m_txDataCount{}
+{
+}
+
+/// <summary>
+/// Read a 8 bit value from register at address
+/// </summary>
+/// <param name="address">Address of register</param>
+/// <returns>8 bit register value</returns>
+uint8 MemoryAccessStubUART1::Read8(regaddr address)
+{
+    LOG_PANIC("Call to Read8 should not happen");
+    return {};
+}
+
+/// <summary>
+/// Write a 8 bit value to register at address
+/// </summary>
+/// <param name="address">Address of register</param>
+/// <param name="data">Data to write</param>
+void MemoryAccessStubUART1::Write8(regaddr address, uint8 data)
+{
+    LOG_PANIC("Call to Write8 should not happen");
+}
+
+/// <summary>
+/// Read a 16 bit value from register at address
+/// </summary>
+/// <param name="address">Address of register</param>
+/// <returns>16 bit register value</returns>
+uint16 MemoryAccessStubUART1::Read16(regaddr address)
+{
+    LOG_PANIC("Call to Read16 should not happen");
+    return {};
+}
+
+/// <summary>
+/// Write a 16 bit value to register at address
+/// </summary>
+/// <param name="address">Address of register</param>
+/// <param name="data">Data to write</param>
+void MemoryAccessStubUART1::Write16(regaddr address, uint16 data)
+{
+    LOG_PANIC("Call to Write16 should not happen");
+}
+
+/// <summary>
+/// Read a 32 bit value from register at address
+/// </summary>
+/// <param name="address">Address of register</param>
+/// <returns>32 bit register value</returns>
+uint32 MemoryAccessStubUART1::Read32(regaddr address)
+{
+    uintptr addr = reinterpret_cast<uintptr>(address);
+    if ((addr < RPI_AUX_BASE) || (addr >= UART1RegistersEnd))
+    {
+        return MemoryAccessStubMailbox::Read32(address);
+    }
+
+    if (address == RPI_AUX_IRQ)
+    {
+        bool rxInterrupt = (m_registers.InterruptEnable & RPI_AUX_MU_IER_RX_IRQ_ENABLE) && !m_rxFifo.IsEmpty();
+        bool txInterrupt = (m_registers.InterruptEnable & RPI_AUX_MU_IER_TX_IRQ_ENABLE) && m_txFifo.IsEmpty();
+        return (rxInterrupt || txInterrupt) ? RPI_AUX_IRQ_UART1 : 0;
+    }
+    if (address == RPI_AUX_ENABLES)
+        return m_registers.AuxEnables;
+    if (address == RPI_AUX_MU_IO)
+    {
+        if (m_rxFifo.IsEmpty())
+            LOG_DEBUG("UART1 Read from empty receive FIFO");
+        return m_rxFifo.Read();
+    }
+    if (address == RPI_AUX_MU_IER)
+        return m_registers.InterruptEnable;
+    if (address == RPI_AUX_MU_IIR)
+        return (m_rxFifo.IsEmpty() ? RPI_AUX_MU_IIR_INTERRUPT_PENDING : BIT1(2)) | RPI_AUX_MU_IIR_TX_FIFO_ENABLE | RPI_AUX_MU_IIR_RX_FIFO_ENABLE;
+    if (address == RPI_AUX_MU_LCR)
+        return m_registers.LineControl;
+    if (address == RPI_AUX_MU_MCR)
+        return m_registers.ModemControl;
+    if (address == RPI_AUX_MU_LSR)
+        return GetLineStatus();
+    if (address == RPI_AUX_MU_CNTL)
+        return m_registers.ExtraControl;
+    if (address == RPI_AUX_MU_STAT)
+        return GetExtraStatus();
+    if (address == RPI_AUX_MU_BAUD)
+        return m_registers.Baudrate;
+
+    LOG_ERROR("Invalid register access for reading: address %016llx", addr);
+    return {};
+}
+
+/// <summary>
+/// Write a 32 bit value to register at address
+/// </summary>
+/// <param name="address">Address of register</param>
+/// <param name="data">Data to write</param>
+void MemoryAccessStubUART1::Write32(regaddr address, uint32 data)
+{
+    uintptr addr = reinterpret_cast<uintptr>(address);
+    if ((addr < RPI_AUX_BASE) || (addr >= UART1RegistersEnd))
+    {
+        MemoryAccessStubMailbox::Write32(address, data);
+        return;
+    }
+
+    if (address == RPI_AUX_ENABLES)
+    {
+        LOG_DEBUG("AUX Set enables %08x", data);
+        m_registers.AuxEnables = data;
+    }
+    else if (address == RPI_AUX_MU_IO)
+    {
+        if (m_txFifo.IsFull())
+            LOG_DEBUG("UART1 Write to full transmit FIFO, data lost %02x", data & 0xFF);
+        m_txFifo.Write(static_cast<uint8>(data));
+    }
+    else if (address == RPI_AUX_MU_IER)
+    {
+        LOG_DEBUG("UART1 Set interrupt enable %08x", data);
+        m_registers.InterruptEnable = data;
+    }
+    else if (address == RPI_AUX_MU_IIR)
+    {
+        if (data & RPI_AUX_MU_IIR_RX_FIFO_CLEAR)
+            m_rxFifo.Flush();
+        if (data & RPI_AUX_MU_IIR_TX_FIFO_CLEAR)
+            m_txFifo.Flush();
+    }
+    else if (address == RPI_AUX_MU_LCR)
+    {
+        LOG_DEBUG("UART1 Set line control %08x", data);
+        m_registers.LineControl = data;
+    }
+    else if (address == RPI_AUX_MU_MCR)
+    {
+        LOG_DEBUG("UART1 Set modem control %08x", data);
+        m_registers.ModemControl = data;
+    }
+    else if (address == RPI_AUX_MU_CNTL)
+    {
+        LOG_DEBUG("UART1 Set extra control %08x", data);
+        m_registers.ExtraControl = data;
+    }
+    else if (address == RPI_AUX_MU_BAUD)
+    {
+        LOG_DEBUG("UART1 Set baudrate register %d", data);
+        m_registers.Baudrate = data;
+    }
+    else
+    {
+        LOG_ERROR("Invalid register access for writing: address %016llx", addr);
+    }
+}
+
+/// <summary>
+/// Put bytes on the receive line. Bytes are stored in the receive FIFO, if the FIFO is full, the bytes are lost and an overrun is flagged
+/// </summary>
+/// <param name="data">Bytes received</param>
+/// <param name="count">Number of bytes received</param>
+/// <returns>Number of bytes stored in the receive FIFO</returns>
+size_t MemoryAccessStubUART1::ReceiveData(const void* data, size_t count)
+{
+    const uint8* bytes = reinterpret_cast<const uint8*>(data);
+    size_t stored{};
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (m_rxFifo.IsFull())
+        {
+            m_rxOverrun = true;
+            continue;
+        }
+        m_rxFifo.Write(bytes[i]);
+        ++stored;
+    }
+    return stored;
+}
+
+/// <summary>
+/// Take bytes from the transmit FIFO off the line, and store them for inspection with GetTransmittedData()
+/// </summary>
+/// <param name="maxCount">Maximum number of bytes to take</param>
+/// <returns>Number of bytes taken from the transmit FIFO</returns>
+size_t MemoryAccessStubUART1::TransmitData(size_t maxCount /*= UART1_STUB_LINE_SIZE*/)
+{
+    size_t count{};
+    while ((count < maxCount) && !m_txFifo.IsEmpty())
+    {
+        uint8 data = m_txFifo.Read();
+        if (m_txDataCount < UART1_STUB_LINE_SIZE)
+            m_txData[m_txDataCount++] = data;
+        ++count;
+    }
+    return count;
+}
+
+/// <summary>
+/// Return the bytes transmitted so far
+/// </summary>
+/// <returns>Pointer to transmitted bytes</returns>
+const uint8* MemoryAccessStubUART1::GetTransmittedData() const
+{
+    return m_txData;
+}
+
+/// <summary>
+/// Return the number of bytes transmitted so far
+/// </summary>
+/// <returns>Number of transmitted bytes</returns>
+size_t MemoryAccessStubUART1::GetTransmittedCount() const
+{
+    return m_txDataCount;
+}
+
+/// <summary>
+/// Determine the line status register (LSR) value from the FIFO states. Reading clears the overrun flag
+/// </summary>
+/// <returns>Line status register value</returns>
+uint32 MemoryAccessStubUART1::GetLineStatus()
+{
+    uint32 result{};
+    if (!m_rxFifo.IsEmpty())
+        result |= RPI_AUX_MU_LSR_RX_READY;
+    if (m_rxOverrun)
+        result |= RPI_AUX_MU_LSR_RX_OVERRUN;
+    if (!m_txFifo.IsFull())
+        result |= RPI_AUX_MU_LSR_TX_EMPTY;
+    if (m_txFifo.IsEmpty())
+        result |= RPI_AUX_MU_LSR_TX_IDLE;
+    m_rxOverrun = false;
+    return result;
+}
+
+/// <summary>
+/// Determine the extra status register (STAT) value from the FIFO states
+/// </summary>
+/// <returns>Extra status register value</returns>
+uint32 MemoryAccessStubUART1::GetExtraStatus()
+{
+    uint32 result = (static_cast<uint32>(m_txFifo.UsedSpace()) << 24) | (static_cast<uint32>(m_rxFifo.UsedSpace()) << 16);
+    if (m_txFifo.IsEmpty())
+        result |= RPI_AUX_MU_STAT_TX_DONE;
+    if (m_txFifo.IsFull())
+        result |= RPI_AUX_MU_STAT_TX_FIFO_FULL;
+    return result;
+}
@@ -0,0 +1,220 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : AsyncMemoryTest.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : AsyncMemoryTest
+//
+// Description : Asynchronous memory copy and fill tests
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/AsyncMemory.h"
+
+#include "baremetal/BCMRegisters.h"
+#include "baremetal/stubs/MemoryAccessStubDMA.h"
+#include "stdlib/Util.h"
+
+#include "unittest/unittest.h"
+
+using namespace unittest;
+
+namespace baremetal {
+namespace test {
+
+/// @brief Baremetal test suite
+TEST_SUITE(Baremetal)
+{
+
+class AsyncMemoryTest : public TestFixture
+{
+public:
+    void SetUp() override
+    {
+    }
+    void TearDown() override
+    {
+    }
+};
+
+/// @brief Size of buffers used
+static constexpr size_t BufferSize = 16384;
+/// @brief Source buffer
+static uint8 source[BufferSize] ALIGN(16);
+/// @brief Destination buffer
+static uint8 destination[BufferSize] ALIGN(16);
+
+/// <summary>
+/// Fill the source buffer with a pattern, and clear the destination buffer
+/// </summary>
+static void PrepareBuffers()
+{
+    for (size_t i = 0; i < BufferSize; ++i)
+        source[i] = static_cast<uint8>(i * 13 + 1);
+    memset(destination, 0, BufferSize);
+}
+
+TEST_FIXTURE(AsyncMemoryTest, SmallCopyDoneByCPU)
+{
+    MemoryAccessStubDMA memoryAccess;
+    DMAController controller(memoryAccess);
+    AsyncMemory memory(DMAChannelType::Normal, controller);
+    PrepareBuffers();
+    memoryAccess.SetAutoComplete(false);
+
+    AsyncMemoryHandle handle = memory.AsyncCopy(destination, source, ASYNC_MEMORY_DMA_THRESHOLD - 1);
+    EXPECT_TRUE(handle.IsDone());
+    EXPECT_TRUE(handle.Wait());
+    EXPECT_EQ(uint32{0}, memoryAccess.Read32(RPI_DMA_CONBLK_AD(0)));
+    EXPECT_EQ(0, memcmp(destination, source, ASYNC_MEMORY_DMA_THRESHOLD - 1));
+}
+
+TEST_FIXTURE(AsyncMemoryTest, CopyAlignsHeadAndTail)
+{
+    MemoryAccessStubDMA memoryAccess;
+    DMAController controller(memoryAccess);
+    AsyncMemory memory(DMAChannelType::Normal, controller);
+    PrepareBuffers();
+    memoryAccess.SetAutoComplete(false);
+
+    AsyncMemoryHandle handle = memory.AsyncCopy(destination + 3, source + 3, 10000);
+    EXPECT_FALSE(handle.IsDone());
+    // Head and tail are copied by the CPU, the DMA transfer covers the aligned middle part
+    EXPECT_EQ(0, memcmp(destination + 3, source + 3, 13));
+    EXPECT_EQ(uint8{0}, destination[16]);
+    DMAControlBlock* controlBlocks = controller.GetControlBlocks(0);
+    EXPECT_EQ(DMAChannel::GetBusAddress(destination + 16), controlBlocks[0].destinationAddress);
+    EXPECT_EQ(uint32{(10000 - 13) & ~15U}, controlBlocks[0].transferLength);
+    EXPECT_TRUE((controlBlocks[0].transferInformation & RPI_DMA_TI_DEST_WIDTH) != 0);
+
+    memoryAccess.CompleteTransfers();
+    EXPECT_TRUE(handle.IsDone());
+    EXPECT_TRUE(handle.Wait());
+    EXPECT_EQ(0, memcmp(destination + 3, source + 3, 10000));
+    EXPECT_EQ(uint8{0}, destination[2]);
+    EXPECT_EQ(uint8{0}, destination[10003]);
+}
+
+TEST_FIXTURE(AsyncMemoryTest, FillAndSubmitOrder)
+{
+    MemoryAccessStubDMA memoryAccess;
+    DMAController controller(memoryAccess);
+    AsyncMemory memory(DMAChannelType::Normal, controller);
+    PrepareBuffers();
+
+    AsyncMemoryHandle fill = memory.AsyncFill(destination + 1, 0xA5, 8190);
+    AsyncMemoryHandle copy = memory.AsyncCopy(destination + 8192, source, 8192);
+    EXPECT_TRUE(fill.IsDone());
+    EXPECT_TRUE(copy.Wait());
+    EXPECT_EQ(uint8{0}, destination[0]);
+    for (size_t i = 1; i < 8191; ++i)
+    {
+        if (destination[i] != 0xA5)
+        {
+            EXPECT_EQ(uint8{0xA5}, destination[i]);
+            break;
+        }
+    }
+    EXPECT_EQ(uint8{0}, destination[8191]);
+    EXPECT_EQ(0, memcmp(destination + 8192, source, 8192));
+}
+
+TEST_FIXTURE(AsyncMemoryTest, RectangleCopy)
+{
+    MemoryAccessStubDMA memoryAccess;
+    DMAController controller(memoryAccess);
+    AsyncMemory memory(DMAChannelType::Normal, controller);
+    PrepareBuffers();
+    memory.SetThreshold(256);
+
+    // Copy 64 rows of 32 bytes from a 128 byte wide image to a 64 byte wide image
+    AsyncMemoryHandle handle = memory.AsyncCopy2D(destination, 64, source + 16, 128, 32, 64);
+    EXPECT_TRUE(handle.Wait());
+    DMAControlBlock* controlBlocks = controller.GetControlBlocks(0);
+    EXPECT_TRUE((controlBlocks[0].transferInformation & RPI_DMA_TI_TDMODE) != 0);
+    EXPECT_EQ(uint32{RPI_DMA_STRIDE_2D(96, 32)}, controlBlocks[0].stride);
+    bool rowsMatch = true;
+    for (size_t row = 0; row < 64; ++row)
+    {
+        if ((memcmp(destination + row * 64, source + 16 + row * 128, 32) != 0) || (destination[row * 64 + 32] != 0))
+            rowsMatch = false;
+    }
+    EXPECT_TRUE(rowsMatch);
+}
+
+TEST_FIXTURE(AsyncMemoryTest, FailuresAreKeptPerOperation)
+{
+    MemoryAccessStubDMA memoryAccess;
+    DMAController controller(memoryAccess);
+    AsyncMemory memory(DMAChannelType::Normal, controller);
+    PrepareBuffers();
+
+    memoryAccess.SetTransferError(true);
+    AsyncMemoryHandle first = memory.AsyncCopy(destination, source, 4096);
+    memoryAccess.SetTransferError(false);
+    AsyncMemoryHandle second = memory.AsyncCopy(destination + 4096, source, 4096);
+    memoryAccess.SetTransferError(true);
+    AsyncMemoryHandle third = memory.AsyncFill(destination + 8192, 0xA5, 4096);
+    memoryAccess.SetTransferError(false);
+    AsyncMemoryHandle fourth = memory.AsyncCopy(destination, source, 16);
+
+    // Results can be collected in any order, a later failure does not hide an earlier one
+    EXPECT_TRUE(fourth.Wait());
+    EXPECT_FALSE(third.Wait());
+    EXPECT_TRUE(second.Wait());
+    EXPECT_FALSE(first.Wait());
+}
+
+TEST_FIXTURE(AsyncMemoryTest, FailureOlderThanHistoryIsReported)
+{
+    MemoryAccessStubDMA memoryAccess;
+    DMAController controller(memoryAccess);
+    AsyncMemory memory(DMAChannelType::Normal, controller);
+    PrepareBuffers();
+
+    AsyncMemoryHandle succeeded = memory.AsyncCopy(destination, source, 16);
+    memoryAccess.SetTransferError(true);
+    AsyncMemoryHandle failed = memory.AsyncCopy(destination, source, 4096);
+    memoryAccess.SetTransferError(false);
+    AsyncMemoryHandle recent{};
+    for (size_t i = 0; i < 100; ++i)
+        recent = memory.AsyncCopy(destination, source, 16);
+
+    EXPECT_FALSE(failed.Wait());
+    // The result of an operation this old is no longer known, so the failure after it is reported
+    EXPECT_FALSE(succeeded.Wait());
+    EXPECT_TRUE(recent.Wait());
+}
+
+} // suite Baremetal
+
+} // namespace test
+} // namespace baremetal
@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : ClockTest.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : ClockTest
+//
+// Description : Clock tests
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/Clock.h"
+
+#include "baremetal/Timer.h"
+
+#include "unittest/unittest.h"
+
+using namespace unittest;
+
+namespace baremetal {
+namespace test {
+
+/// @brief Baremetal test suite
+TEST_SUITE(Baremetal)
+{
+
+class ClockTest : public TestFixture
+{
+public:
+    void SetUp() override
+    {
+    }
+    void TearDown() override
+    {
+    }
+};
+
+TEST_FIXTURE(ClockTest, ConversionIsExactForWholeSeconds)
+{
+    uint64 frequency = Clock::GetFrequency();
+    EXPECT_EQ(NSEC_PER_SEC, Clock::CyclesToNanoSeconds(frequency));
+    EXPECT_EQ(10 * NSEC_PER_SEC, Clock::CyclesToNanoSeconds(10 * frequency));
+    EXPECT_EQ(frequency, Clock::NanoSecondsToCycles(NSEC_PER_SEC));
+    EXPECT_EQ(uint64{0}, Clock::CyclesToNanoSeconds(0));
+    // One hour, converted back and forth, is off by at most one cycle
+    uint64 cycles = 3600 * frequency + 12345;
+    uint64 roundTrip = Clock::NanoSecondsToCycles(Clock::CyclesToNanoSeconds(cycles));
+    EXPECT_TRUE((roundTrip + 1 >= cycles) && (roundTrip <= cycles + 1));
+}
+
+TEST_FIXTURE(ClockTest, ElapsedTime)
+{
+    TimePoint start = Clock::Now();
+    Timer::WaitMicroSeconds(2000);
+    Duration elapsed = Clock::Elapsed(start);
+    TimePoint end = Clock::Now();
+
+    EXPECT_TRUE(elapsed.MicroSeconds() >= 1990);
+    EXPECT_TRUE(elapsed < Duration::FromMilliSeconds(100));
+    EXPECT_TRUE((end - start) > elapsed - Duration(1));
+    EXPECT_TRUE((start - end).NanoSeconds() < 0);
+    EXPECT_TRUE(end.NanoSeconds() >= start.NanoSeconds());
+}
+
+TEST_FIXTURE(ClockTest, WaitEndsAtDeadline)
+{
+    Duration eventPeriod = Clock::GetEventPeriod();
+    EXPECT_TRUE(eventPeriod.NanoSeconds() > 0);
+    EXPECT_FALSE(eventPeriod > Duration::FromMicroSeconds(CLOCK_EVENT_STREAM_PERIOD_USEC));
+
+    TimePoint start = Clock::Now();
+    TimePoint deadline(start.Cycles() + Clock::NanoSecondsToCycles(500 * NSEC_PER_USEC));
+    Clock::WaitUntil(deadline);
+    TimePoint end = Clock::Now();
+    EXPECT_TRUE(end.Cycles() >= deadline.Cycles());
+    EXPECT_TRUE((end - start) < Duration::FromMilliSeconds(10));
+
+    // Deadlines in the past return immediately
+    start = Clock::Now();
+    Clock::Wait(Duration(-1000));
+    Clock::WaitUntil(TimePoint(start.Cycles() - 1));
+    EXPECT_TRUE(Clock::Elapsed(start) < Duration::FromMilliSeconds(1));
+}
+
+TEST_FIXTURE(ClockTest, DurationArithmetic)
+{
+    Duration a = Duration::FromMilliSeconds(3);
+    Duration b = Duration::FromMicroSeconds(500);
+    EXPECT_EQ(int64{3500000}, (a + b).NanoSeconds());
+    EXPECT_EQ(int64{2500}, (a - b).MicroSeconds());
+    EXPECT_EQ(int64{-2}, (b - a).MilliSeconds());
+    EXPECT_TRUE(b < a);
+    EXPECT_TRUE(Duration::FromMicroSeconds(1000) == Duration::FromMilliSeconds(1));
+}
+
+} // suite Baremetal
+
+} // namespace test
+} // namespace baremetal
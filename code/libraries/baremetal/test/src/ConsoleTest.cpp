@@ -0,0 +1,308 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : ConsoleTest.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : Console
+//
+// Description : Console output queue tests
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/Console.h"
+
+#include "baremetal/ARMInstructions.h"
+#include "baremetal/stubs/DeviceStub.h"
+#include "stdlib/Util.h"
+
+#include "unittest/unittest.h"
+
+using namespace unittest;
+
+namespace baremetal {
+namespace test {
+
+/// @brief Number of data bytes in each test record
+static constexpr size_t RecordLength = 100;
+/// @brief Size of a test record in the console queue, including the 8 byte record header and padding to a multiple of 8 bytes
+static constexpr size_t QueuedRecordSize = (8 + RecordLength + 7) & ~static_cast<size_t>(7);
+
+/// <summary>
+/// State for writes done from the device write handler, as if an interrupt arrives while the console writes to the device
+/// </summary>
+struct NestedWrites
+{
+    /// @brief Console to write to
+    Console* console;
+    /// @brief Number of records to write with Write(), the first time the handler is called
+    unsigned writeCount;
+    /// @brief First record index used for the records written
+    unsigned firstIndex;
+    /// @brief If true, fill the queue with TryWrite() first, and then try one more Write(), which has to wait for the interrupted consumer
+    bool fillQueue;
+    /// @brief Number of records queued with TryWrite() before the queue was full
+    unsigned queuedCount;
+    /// @brief Result of TryWrite() of a record larger than half the queue, while the consumer is interrupted
+    bool oversizedWritten;
+    /// @brief Time in timer counts the final Write() took
+    uint64 stallTime;
+};
+
+/// <summary>
+/// Fill a test record with a character depending on its index
+/// </summary>
+/// <param name="buffer">Buffer receiving the record, RecordLength bytes plus terminating null</param>
+/// <param name="index">Record index</param>
+static void FillRecord(char* buffer, unsigned index)
+{
+    memset(buffer, 'A' + static_cast<int>(index % 26), RecordLength);
+    buffer[RecordLength] = '\0';
+}
+
+/// <summary>
+/// Device write handler, writing records to the console which is currently writing to the device. Only acts the first time it is called
+/// </summary>
+/// <param name="device">Device being written</param>
+/// <param name="param">NestedWrites state</param>
+static void WriteNested(DeviceStub& device, void* param)
+{
+    NestedWrites* nested = reinterpret_cast<NestedWrites*>(param);
+    device.SetWriteHandler(nullptr, nullptr);
+
+    char record[RecordLength + 1];
+    for (unsigned i = 0; i < nested->writeCount; ++i)
+    {
+        FillRecord(record, nested->firstIndex + i);
+        nested->console->Write(record, RecordLength);
+    }
+    if (nested->fillQueue)
+    {
+        FillRecord(record, 0);
+        while (nested->console->TryWrite(record, ConsoleColor::Default))
+            nested->queuedCount++;
+
+        static char oversized[CONSOLE_QUEUE_SIZE / 2 + 1];
+        memset(oversized, 'x', sizeof(oversized) - 1);
+        nested->oversizedWritten = nested->console->TryWrite(oversized, ConsoleColor::Default);
+
+        uint64 start{};
+        GetTimerCounter(start);
+        nested->console->Write(record);
+        uint64 end{};
+        GetTimerCounter(end);
+        nested->stallTime = end - start;
+    }
+}
+
+/// @brief Baremetal test suite
+TEST_SUITE(Baremetal)
+{
+
+class ConsoleTest : public TestFixture
+{
+public:
+    DeviceStub* device;
+    Console* console;
+    NestedWrites* nested;
+
+    void SetUp() override
+    {
+        device = new DeviceStub;
+        console = new Console(device);
+        nested = new NestedWrites{};
+        nested->console = console;
+    }
+    void TearDown() override
+    {
+        delete nested;
+        delete console;
+        delete device;
+    }
+
+    bool HaveRecord(size_t offset, unsigned index) const
+    {
+        char record[RecordLength + 1];
+        FillRecord(record, index);
+        return (offset + RecordLength <= device->GetDataCount()) && (memcmp(device->GetData() + offset, record, RecordLength) == 0);
+    }
+};
+
+TEST_FIXTURE(ConsoleTest, IsNotSingleton)
+{
+    EXPECT_TRUE(&GetConsole() != console);
+}
+
+TEST_FIXTURE(ConsoleTest, RecordsWrapWithPadding)
+{
+    // More data than fits in the queue, so records wrap around. Record size is not a divider of the queue size, so a padding record is needed
+    static constexpr unsigned RecordCount = 2 * CONSOLE_QUEUE_SIZE / RecordLength;
+    char record[RecordLength + 1];
+    for (unsigned i = 0; i < RecordCount; ++i)
+    {
+        FillRecord(record, i);
+        console->Write(record, RecordLength);
+    }
+
+    EXPECT_EQ(size_t{RecordCount * RecordLength}, device->GetDataCount());
+    for (unsigned i = 0; i < RecordCount; ++i)
+    {
+        EXPECT_TRUE(HaveRecord(i * RecordLength, i));
+    }
+    EXPECT_EQ(0u, console->GetDroppedWriteCount());
+}
+
+TEST_FIXTURE(ConsoleTest, QueuedRecordsWrapWithPadding)
+{
+    // Move the queue position close to the end, then queue records from the device write handler while the console is draining,
+    // so that the padding record is placed while other records are waiting
+    static constexpr unsigned LeadCount = (CONSOLE_QUEUE_SIZE - 3 * QueuedRecordSize) / QueuedRecordSize;
+    char record[RecordLength + 1];
+    for (unsigned i = 0; i < LeadCount; ++i)
+    {
+        FillRecord(record, i);
+        console->Write(record, RecordLength);
+    }
+    device->Clear();
+
+    nested->writeCount = 10;
+    nested->firstIndex = 1;
+    device->SetWriteHandler(WriteNested, nested);
+    FillRecord(record, 0);
+    console->Write(record, RecordLength);
+
+    EXPECT_EQ(size_t{11 * RecordLength}, device->GetDataCount());
+    for (unsigned i = 0; i < 11; ++i)
+    {
+        EXPECT_TRUE(HaveRecord(i * RecordLength, i));
+    }
+    EXPECT_EQ(0u, console->GetDroppedWriteCount());
+}
+
+TEST_FIXTURE(ConsoleTest, QueuedRecordsAreGatheredInOneDeviceWrite)
+{
+    // Records written while the console is writing to the device are queued, and then written together
+    nested->writeCount = 3;
+    nested->firstIndex = 1;
+    device->SetWriteHandler(WriteNested, nested);
+    char record[RecordLength + 1];
+    FillRecord(record, 0);
+    console->Write(record, RecordLength);
+
+    EXPECT_EQ(size_t{2}, device->GetWriteCount());
+    EXPECT_EQ(size_t{4 * RecordLength}, device->GetDataCount());
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(HaveRecord(i * RecordLength, i));
+    }
+}
+
+TEST_FIXTURE(ConsoleTest, InterruptedConsumerStallTimesOut)
+{
+    // The device write handler fills the queue while the console is writing to the device. The writer cannot make progress, as the consumer is the
+    // context it interrupted, so the final Write() gives up after CONSOLE_QUEUE_STALL_TIMEOUT
+    nested->fillQueue = true;
+    device->SetWriteHandler(WriteNested, nested);
+    char record[RecordLength + 1];
+    FillRecord(record, 0);
+    console->Write(record, RecordLength);
+
+    uint64 frequency{};
+    GetTimerFrequency(frequency);
+    EXPECT_TRUE(nested->queuedCount > 0);
+    EXPECT_FALSE(nested->oversizedWritten);
+    EXPECT_TRUE(nested->stallTime >= frequency * CONSOLE_QUEUE_STALL_TIMEOUT / 1000);
+    EXPECT_TRUE(nested->stallTime < frequency * CONSOLE_QUEUE_STALL_TIMEOUT / 100);
+    // The full TryWrite(), the oversized TryWrite() and the final Write() are dropped
+    EXPECT_EQ(3u, console->GetDroppedWriteCount());
+    // Everything queued is written once the consumer continues
+    EXPECT_TRUE(HaveRecord(0, 0));
+    EXPECT_TRUE(device->GetDataCount() > RecordLength * (nested->queuedCount + 1));
+}
+
+TEST_FIXTURE(ConsoleTest, OversizedRecordWrittenDirectly)
+{
+    static char oversized[CONSOLE_QUEUE_SIZE];
+    for (size_t i = 0; i < sizeof(oversized); ++i)
+        oversized[i] = static_cast<char>('a' + i % 26);
+    char record[RecordLength + 1];
+    FillRecord(record, 0);
+
+    console->Write(record, RecordLength);
+    console->Write(oversized, sizeof(oversized));
+    console->Write(record, RecordLength);
+
+    EXPECT_EQ(size_t{2 * RecordLength + sizeof(oversized)}, device->GetDataCount());
+    EXPECT_TRUE(HaveRecord(0, 0));
+    EXPECT_EQ(0, memcmp(device->GetData() + RecordLength, oversized, sizeof(oversized)));
+    EXPECT_TRUE(HaveRecord(RecordLength + sizeof(oversized), 0));
+    EXPECT_EQ(0u, console->GetDroppedWriteCount());
+}
+
+TEST_FIXTURE(ConsoleTest, PartialDeviceWritesAreRepeated)
+{
+    device->SetWriteLimit(7);
+    char record[RecordLength + 1];
+    FillRecord(record, 3);
+    console->Write(record, RecordLength);
+
+    EXPECT_EQ(size_t{RecordLength}, device->GetDataCount());
+    EXPECT_TRUE(HaveRecord(0, 3));
+    EXPECT_EQ(0u, console->GetDroppedWriteCount());
+}
+
+TEST_FIXTURE(ConsoleTest, StalledDeviceDropsData)
+{
+    device->SetWriteLimit(0);
+    char record[RecordLength + 1];
+    FillRecord(record, 0);
+    uint64 start{};
+    GetTimerCounter(start);
+    console->Write(record, RecordLength);
+    uint64 end{};
+    GetTimerCounter(end);
+
+    uint64 frequency{};
+    GetTimerFrequency(frequency);
+    EXPECT_EQ(size_t{0}, device->GetDataCount());
+    EXPECT_EQ(1u, console->GetDroppedWriteCount());
+    EXPECT_TRUE(end - start >= frequency * CONSOLE_DEVICE_STALL_TIMEOUT / 1000);
+
+    // The console recovers once the device accepts data again
+    device->SetWriteLimit();
+    FillRecord(record, 1);
+    console->Write(record, RecordLength);
+    EXPECT_TRUE(HaveRecord(0, 1));
+}
+
+} // suite Baremetal
+
+} // namespace test
+} // namespace baremetal
@@ -0,0 +1,175 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : CrashLogTest.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : CrashLogTest
+//
+// Description : Crash log tests
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/CrashLog.h"
+
+#include "stdlib/Util.h"
+
+#include "unittest/unittest.h"
+
+using namespace unittest;
+
+namespace baremetal {
+namespace test {
+
+/// @brief Size of crash log memory region used for testing, including header
+static constexpr size_t TestCrashLogSize = sizeof(CrashLogHeader) + 32;
+
+/// @brief Baremetal test suite
+TEST_SUITE(Baremetal)
+{
+
+class CrashLogTest : public TestFixture
+{
+public:
+    void SetUp() override
+    {
+    }
+    void TearDown() override
+    {
+    }
+};
+
+TEST_FIXTURE(CrashLogTest, UninitializedMemoryHasNoPreviousLog)
+{
+    uint64 buffer[TestCrashLogSize / sizeof(uint64)];
+    memset(buffer, 0xA5, sizeof(buffer));
+    char text[TestCrashLogSize]{};
+    CrashLog crashLog(buffer, sizeof(buffer));
+
+    EXPECT_FALSE(crashLog.Initialize());
+    EXPECT_FALSE(crashLog.HasPreviousLog());
+    EXPECT_EQ(uint32{0}, crashLog.GetPreviousBootSequence());
+    EXPECT_EQ(uint32{1}, crashLog.GetBootSequence());
+    EXPECT_EQ(size_t{0}, crashLog.ReadPreviousLog(text, sizeof(text)));
+    EXPECT_EQ("", text);
+}
+
+TEST_FIXTURE(CrashLogTest, WriteBeforeStartIsIgnored)
+{
+    uint64 buffer[TestCrashLogSize / sizeof(uint64)];
+    memset(buffer, 0xA5, sizeof(buffer));
+    CrashLog crashLog(buffer, sizeof(buffer));
+    crashLog.Initialize();
+    crashLog.Write("abc\n", 4);
+    crashLog.Start();
+
+    CrashLog nextBoot(buffer, sizeof(buffer));
+    EXPECT_FALSE(nextBoot.Initialize());
+}
+
+TEST_FIXTURE(CrashLogTest, LogSurvivesReboot)
+{
+    uint64 buffer[TestCrashLogSize / sizeof(uint64)];
+    memset(buffer, 0xA5, sizeof(buffer));
+    char text[TestCrashLogSize]{};
+    CrashLog crashLog(buffer, sizeof(buffer));
+    crashLog.Initialize();
+    crashLog.Start();
+    crashLog.Write("Line 1\n", 7);
+    crashLog.Write("Line 2\n", 7);
+
+    CrashLog nextBoot(buffer, sizeof(buffer));
+    EXPECT_TRUE(nextBoot.Initialize());
+    EXPECT_TRUE(nextBoot.HasPreviousLog());
+    EXPECT_EQ(uint32{1}, nextBoot.GetPreviousBootSequence());
+    EXPECT_EQ(uint32{2}, nextBoot.GetBootSequence());
+    EXPECT_EQ(size_t{14}, nextBoot.ReadPreviousLog(text, sizeof(text)));
+    EXPECT_EQ("Line 1\nLine 2\n", text);
+}
+
+TEST_FIXTURE(CrashLogTest, WrappedLogSkipsPartialLine)
+{
+    uint64 buffer[TestCrashLogSize / sizeof(uint64)];
+    memset(buffer, 0xA5, sizeof(buffer));
+    char text[TestCrashLogSize]{};
+    CrashLog crashLog(buffer, sizeof(buffer));
+    crashLog.Initialize();
+    crashLog.Start();
+    crashLog.Write("First line 1\n", 13);
+    crashLog.Write("Second line 2\n", 14);
+    crashLog.Write("Third line 3\n", 13);
+
+    CrashLog nextBoot(buffer, sizeof(buffer));
+    EXPECT_TRUE(nextBoot.Initialize());
+    nextBoot.ReadPreviousLog(text, sizeof(text));
+    EXPECT_EQ("Second line 2\nThird line 3\n", text);
+}
+
+TEST_FIXTURE(CrashLogTest, StartClearsPreviousLog)
+{
+    uint64 buffer[TestCrashLogSize / sizeof(uint64)];
+    memset(buffer, 0xA5, sizeof(buffer));
+    char text[TestCrashLogSize]{};
+    CrashLog crashLog(buffer, sizeof(buffer));
+    crashLog.Initialize();
+    crashLog.Start();
+    crashLog.Write("Boot 1\n", 7);
+
+    CrashLog secondBoot(buffer, sizeof(buffer));
+    secondBoot.Initialize();
+    secondBoot.Start();
+    secondBoot.Write("Boot 2\n", 7);
+
+    CrashLog thirdBoot(buffer, sizeof(buffer));
+    EXPECT_TRUE(thirdBoot.Initialize());
+    EXPECT_EQ(uint32{2}, thirdBoot.GetPreviousBootSequence());
+    thirdBoot.ReadPreviousLog(text, sizeof(text));
+    EXPECT_EQ("Boot 2\n", text);
+}
+
+TEST_FIXTURE(CrashLogTest, CorruptHeaderIsRejected)
+{
+    uint64 buffer[TestCrashLogSize / sizeof(uint64)];
+    memset(buffer, 0xA5, sizeof(buffer));
+    CrashLog crashLog(buffer, sizeof(buffer));
+    crashLog.Initialize();
+    crashLog.Start();
+    crashLog.Write("Line 1\n", 7);
+    reinterpret_cast<CrashLogHeader*>(buffer)->bootSequence ^= 0x100;
+
+    CrashLog nextBoot(buffer, sizeof(buffer));
+    EXPECT_FALSE(nextBoot.Initialize());
+    EXPECT_EQ(uint32{1}, nextBoot.GetBootSequence());
+}
+
+} // suite Baremetal
+
+} // namespace test
+} // namespace baremetal
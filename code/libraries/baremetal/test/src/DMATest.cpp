@@ -0,0 +1,262 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : DMATest.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : DMATest
+//
+// Description : DMA controller and channel tests
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/DMAChannel.h"
+
+#include "baremetal/BCMRegisters.h"
+#include "baremetal/stubs/MemoryAccessStubDMA.h"
+#include "stdlib/Macros.h"
+#include "stdlib/Util.h"
+
+#include "unittest/unittest.h"
+
+using namespace unittest;
+
+namespace baremetal {
+namespace test {
+
+/// @brief Baremetal test suite
+TEST_SUITE(Baremetal)
+{
+
+class DMATest : public TestFixture
+{
+public:
+    void SetUp() override
+    {
+    }
+    void TearDown() override
+    {
+    }
+};
+
+/// @brief Size of buffers used for memory copies, larger than a single DMA Lite control block can handle
+static constexpr size_t BufferSize = 70000;
+/// @brief Source buffer
+static uint8 source[BufferSize] ALIGN(16);
+/// @brief Destination buffer
+static uint8 destination[BufferSize] ALIGN(16);
+
+/// <summary>
+/// Fill the source buffer with a pattern, and clear the destination buffer
+/// </summary>
+static void PrepareBuffers()
+{
+    for (size_t i = 0; i < BufferSize; ++i)
+        source[i] = static_cast<uint8>(i * 7 + 3);
+    memset(destination, 0, BufferSize);
+}
+
+/// <summary>
+/// Counts calls to the DMA completion handler
+/// </summary>
+struct CompletionCounter
+{
+    /// @brief Number of calls
+    size_t count;
+    /// @brief Success flag of the last call
+    bool success;
+
+    /// <summary>
+    /// DMA completion handler
+    /// </summary>
+    /// <param name="channel">DMA channel which completed</param>
+    /// <param name="success">True if the transfer completed without errors</param>
+    /// <param name="param">Pointer to CompletionCounter instance</param>
+    static void OnCompletion(DMAChannel& channel, bool success, void* param)
+    {
+        CompletionCounter* counter = reinterpret_cast<CompletionCounter*>(param);
+        ++counter->count;
+        counter->success = success;
+    }
+};
+
+TEST_FIXTURE(DMATest, AllocateChannels)
+{
+    MemoryAccessStubDMA memoryAccess;
+    DMAController controller(memoryAccess);
+
+    // Stub firmware reports channels 0, 2, 4, 5 and 8-14 as free
+    DMAChannel channel1(DMAChannelType::Normal, controller);
+    DMAChannel channel2(DMAChannelType::Normal, controller);
+    DMAChannel channel3(DMAChannelType::Normal, controller);
+    DMAChannel lite(DMAChannelType::Lite, controller);
+    EXPECT_EQ(uint32{0}, channel1.GetChannel());
+    EXPECT_EQ(uint32{2}, channel2.GetChannel());
+    EXPECT_EQ(uint32{4}, channel3.GetChannel());
+    EXPECT_EQ(uint32{8}, lite.GetChannel());
+    EXPECT_FALSE(channel1.IsLite());
+    EXPECT_TRUE(lite.IsLite());
+    EXPECT_EQ(uint32{BIT1(0) | BIT1(2) | BIT1(4) | BIT1(8)}, memoryAccess.Read32(RPI_DMA_ENABLE));
+    {
+        DMAChannel channel4(DMAChannelType::Normal, controller);
+        EXPECT_EQ(uint32{5}, channel4.GetChannel());
+        DMAChannel channel5(DMAChannelType::Normal, controller);
+        EXPECT_FALSE(channel5.IsAllocated());
+        EXPECT_FALSE(channel5.AddMemoryCopy(destination, source, 16));
+        EXPECT_FALSE(channel5.Start());
+    }
+    // Channel 5 was returned on destruction
+    DMAChannel channel6(DMAChannelType::Normal, controller);
+    EXPECT_EQ(uint32{5}, channel6.GetChannel());
+}
+
+TEST_FIXTURE(DMATest, ChainedMemoryCopy)
+{
+    MemoryAccessStubDMA memoryAccess;
+    DMAController controller(memoryAccess);
+    DMAChannel channel(DMAChannelType::Normal, controller);
+    PrepareBuffers();
+
+    EXPECT_TRUE(channel.AddMemoryCopy(destination, source, 4096));
+    EXPECT_TRUE(channel.AddMemoryCopy(destination + 8192, source + 4096, 100));
+    EXPECT_EQ(size_t{2}, channel.GetNumControlBlocks());
+    DMAControlBlock* controlBlocks = controller.GetControlBlocks(channel.GetChannel());
+    EXPECT_EQ(DMAChannel::GetBusAddress(&controlBlocks[1]), controlBlocks[0].nextControlBlockAddress);
+    // Aligned copy uses wide bursts, unaligned length does not
+    EXPECT_TRUE((controlBlocks[0].transferInformation & RPI_DMA_TI_SRC_WIDTH) != 0);
+    EXPECT_TRUE((controlBlocks[1].transferInformation & RPI_DMA_TI_SRC_WIDTH) == 0);
+
+    EXPECT_TRUE(channel.Start());
+    EXPECT_TRUE(channel.Wait());
+    EXPECT_FALSE(channel.HasError());
+    EXPECT_EQ(uint32{2}, memoryAccess.GetControlBlockCount(channel.GetChannel()));
+    EXPECT_EQ(0, memcmp(destination, source, 4096));
+    EXPECT_EQ(0, memcmp(destination + 8192, source + 4096, 100));
+    EXPECT_EQ(uint8{0}, destination[4096]);
+    EXPECT_EQ(uint8{0}, destination[8192 + 100]);
+    EXPECT_EQ(uint32{0}, memoryAccess.Read32(RPI_DMA_CS(channel.GetChannel())) & (RPI_DMA_CS_ACTIVE | RPI_DMA_CS_END));
+}
+
+TEST_FIXTURE(DMATest, LongCopySplitOnLiteChannel)
+{
+    MemoryAccessStubDMA memoryAccess;
+    DMAController controller(memoryAccess);
+    DMAChannel channel(DMAChannelType::Lite, controller);
+    PrepareBuffers();
+
+    EXPECT_TRUE(channel.AddMemoryCopy(destination, source, BufferSize));
+    EXPECT_EQ(size_t{2}, channel.GetNumControlBlocks());
+    EXPECT_FALSE(channel.AddTransfer(RPI_DMA_TI_TDMODE, 0, 0, RPI_DMA_TXFR_LEN_2D(16, 3)));
+
+    EXPECT_TRUE(channel.Start());
+    EXPECT_TRUE(channel.Wait());
+    EXPECT_EQ(0, memcmp(destination, source, BufferSize));
+}
+
+TEST_FIXTURE(DMATest, CompletionInterrupt)
+{
+    MemoryAccessStubDMA memoryAccess;
+    DMAController controller(memoryAccess);
+    DMAChannel channel(DMAChannelType::Normal, controller);
+    CompletionCounter counter{};
+    PrepareBuffers();
+    memoryAccess.SetAutoComplete(false);
+
+    channel.SetCompletionHandler(CompletionCounter::OnCompletion, &counter);
+    EXPECT_TRUE(channel.AddMemoryCopy(destination, source, 256));
+    EXPECT_TRUE(channel.Start());
+    EXPECT_TRUE(channel.IsBusy());
+    EXPECT_FALSE(channel.Start());
+    controller.InterruptHandler();
+    EXPECT_EQ(size_t{0}, counter.count);
+
+    memoryAccess.CompleteTransfers();
+    EXPECT_FALSE(channel.IsBusy());
+    EXPECT_EQ(static_cast<uint32>(BIT1(channel.GetChannel())), memoryAccess.Read32(RPI_DMA_INT_STATUS));
+    controller.InterruptHandler();
+    EXPECT_EQ(size_t{1}, counter.count);
+    EXPECT_TRUE(counter.success);
+    EXPECT_EQ(uint32{0}, memoryAccess.Read32(RPI_DMA_INT_STATUS));
+    EXPECT_EQ(0, memcmp(destination, source, 256));
+
+    // Completion was already handled, Wait() does not call the handler again
+    EXPECT_TRUE(channel.Wait());
+    EXPECT_EQ(size_t{1}, counter.count);
+    channel.SetCompletionHandler(nullptr, nullptr);
+}
+
+TEST_FIXTURE(DMATest, PeripheralTransfers)
+{
+    MemoryAccessStubDMA memoryAccess;
+    DMAController controller(memoryAccess);
+    DMAChannel channel(DMAChannelType::Normal, controller);
+    PrepareBuffers();
+    const uint8 received[] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88};
+    memoryAccess.SetPeripheralReadData(received, sizeof(received));
+
+    EXPECT_TRUE(channel.AddPeripheralWrite(RPI_UART0_DR, source, 12, DMADREQ::UARTTX));
+    EXPECT_TRUE(channel.AddPeripheralRead(destination, RPI_UART0_DR, sizeof(received), DMADREQ::UARTRX));
+    DMAControlBlock* controlBlocks = controller.GetControlBlocks(channel.GetChannel());
+    EXPECT_EQ(uint32{GPU_IO_BASE + 0x00201000}, controlBlocks[0].destinationAddress);
+    EXPECT_EQ(uint32{RPI_DMA_TI_PERMAP(12) | RPI_DMA_TI_DEST_DREQ}, controlBlocks[0].transferInformation & (RPI_DMA_TI_PERMAP(0x1F) | RPI_DMA_TI_DEST_DREQ | RPI_DMA_TI_DEST_INC));
+    EXPECT_EQ(uint32{RPI_DMA_TI_PERMAP(14) | RPI_DMA_TI_SRC_DREQ}, controlBlocks[1].transferInformation & (RPI_DMA_TI_PERMAP(0x1F) | RPI_DMA_TI_SRC_DREQ | RPI_DMA_TI_SRC_INC));
+
+    EXPECT_TRUE(channel.Start());
+    EXPECT_TRUE(channel.Wait());
+    EXPECT_EQ(size_t{12}, memoryAccess.GetPeripheralDataCount());
+    EXPECT_EQ(0, memcmp(source, memoryAccess.GetPeripheralData(), 12));
+    EXPECT_EQ(0, memcmp(received, destination, sizeof(received)));
+}
+
+TEST_FIXTURE(DMATest, WaitTimeoutAbortsTransfer)
+{
+    MemoryAccessStubDMA memoryAccess;
+    DMAController controller(memoryAccess);
+    DMAChannel channel(DMAChannelType::Normal, controller);
+    PrepareBuffers();
+    memoryAccess.SetAutoComplete(false);
+
+    EXPECT_TRUE(channel.AddMemoryCopy(destination, source, 256));
+    EXPECT_TRUE(channel.Start());
+    EXPECT_FALSE(channel.Wait(10));
+    EXPECT_FALSE(channel.IsBusy());
+    EXPECT_TRUE(channel.HasError());
+
+    // The channel can be restarted after the abort
+    memoryAccess.SetAutoComplete(true);
+    EXPECT_TRUE(channel.Start());
+    EXPECT_TRUE(channel.Wait(10));
+    EXPECT_EQ(0, memcmp(destination, source, 256));
+}
+
+} // suite Baremetal
+
+} // namespace test
+} // namespace baremetal
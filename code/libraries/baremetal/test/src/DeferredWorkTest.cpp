@@ -0,0 +1,185 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : DeferredWorkTest.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : DeferredWorkQueue
+//
+// Description : Deferred work queue tests
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/DeferredWork.h"
+
+#include "unittest/unittest.h"
+
+using namespace unittest;
+
+namespace baremetal {
+namespace test {
+
+/// <summary>
+/// Test work state, passed as work handler parameter
+/// </summary>
+struct WorkRecord
+{
+    /// @brief Queue the work runs on
+    DeferredWorkQueue* queue;
+    /// @brief Number of work items run
+    unsigned runs;
+    /// @brief Values passed to the work items, in the order they were run
+    uintptr values[DEFERRED_WORK_QUEUE_SIZE + 1];
+    /// @brief Number of work items to queue from the work handler
+    unsigned requeue;
+    /// @brief Result of Run() called from the work handler
+    unsigned nestedRunResult;
+};
+
+static void RecordWork(void* param, uintptr value)
+{
+    WorkRecord* record = reinterpret_cast<WorkRecord*>(param);
+    record->values[record->runs++] = value;
+    if (record->requeue != 0)
+    {
+        record->requeue--;
+        record->queue->Enqueue(RecordWork, record, value + 1);
+    }
+}
+
+static void NestedRunWork(void* param, uintptr /*value*/)
+{
+    WorkRecord* record = reinterpret_cast<WorkRecord*>(param);
+    record->runs++;
+    record->nestedRunResult = record->queue->Run();
+}
+
+/// @brief Baremetal test suite
+TEST_SUITE(Baremetal)
+{
+
+class DeferredWorkTest : public TestFixture
+{
+public:
+    DeferredWorkQueue* queue;
+    WorkRecord* record;
+
+    void SetUp() override
+    {
+        queue = new DeferredWorkQueue;
+        record = new WorkRecord{};
+        record->queue = queue;
+    }
+    void TearDown() override
+    {
+        delete record;
+        delete queue;
+    }
+};
+
+TEST_FIXTURE(DeferredWorkTest, RunsInOrder)
+{
+    EXPECT_TRUE(queue->IsEmpty());
+    for (uintptr value = 0; value < 3; ++value)
+    {
+        EXPECT_TRUE(queue->Enqueue(RecordWork, record, value));
+    }
+    EXPECT_FALSE(queue->IsEmpty());
+    EXPECT_EQ(0u, record->runs);
+
+    EXPECT_EQ(3u, queue->Run());
+    EXPECT_TRUE(queue->IsEmpty());
+    EXPECT_EQ(3u, record->runs);
+    for (uintptr value = 0; value < 3; ++value)
+    {
+        EXPECT_EQ(value, record->values[value]);
+    }
+    EXPECT_EQ(0u, queue->Run());
+}
+
+TEST_FIXTURE(DeferredWorkTest, FullQueueDropsWork)
+{
+    for (uintptr value = 0; value < DEFERRED_WORK_QUEUE_SIZE; ++value)
+    {
+        EXPECT_TRUE(queue->Enqueue(RecordWork, record, value));
+    }
+    EXPECT_FALSE(queue->Enqueue(RecordWork, record, DEFERRED_WORK_QUEUE_SIZE));
+
+    EXPECT_EQ(unsigned{DEFERRED_WORK_QUEUE_SIZE}, queue->Run());
+    EXPECT_EQ(uintptr{DEFERRED_WORK_QUEUE_SIZE - 1}, record->values[DEFERRED_WORK_QUEUE_SIZE - 1]);
+    // Slots are re-used after the queue wrapped
+    EXPECT_TRUE(queue->Enqueue(RecordWork, record, 0));
+    EXPECT_EQ(1u, queue->Run());
+
+    DeferredWorkStatistics statistics;
+    queue->GetStatistics(statistics);
+    EXPECT_EQ(uint64{DEFERRED_WORK_QUEUE_SIZE + 1}, statistics.queued);
+    EXPECT_EQ(uint64{DEFERRED_WORK_QUEUE_SIZE + 1}, statistics.executed);
+    EXPECT_EQ(uint64{1}, statistics.dropped);
+    EXPECT_EQ(uint64{DEFERRED_WORK_QUEUE_SIZE}, statistics.depth.GetMax());
+    EXPECT_EQ(statistics.executed, statistics.latency.GetCount());
+}
+
+TEST_FIXTURE(DeferredWorkTest, WorkQueuedByWorkRunsInSamePass)
+{
+    record->requeue = 2;
+    queue->Enqueue(RecordWork, record, 10);
+    EXPECT_EQ(3u, queue->Run());
+    EXPECT_EQ(uintptr{12}, record->values[2]);
+    EXPECT_TRUE(queue->IsEmpty());
+}
+
+TEST_FIXTURE(DeferredWorkTest, NestedRunReturnsImmediately)
+{
+    queue->Enqueue(NestedRunWork, record);
+    queue->Enqueue(RecordWork, record, 0);
+    EXPECT_EQ(2u, queue->Run());
+    EXPECT_EQ(0u, record->nestedRunResult);
+    EXPECT_EQ(2u, record->runs);
+}
+
+TEST_FIXTURE(DeferredWorkTest, ResetStatistics)
+{
+    queue->Enqueue(RecordWork, record, 0);
+    queue->Run();
+    queue->ResetStatistics();
+
+    DeferredWorkStatistics statistics;
+    queue->GetStatistics(statistics);
+    EXPECT_EQ(uint64{0}, statistics.queued);
+    EXPECT_EQ(uint64{0}, statistics.executed);
+    EXPECT_EQ(uint64{0}, statistics.dropped);
+    EXPECT_EQ(uint64{0}, statistics.depth.GetCount());
+}
+
+} // suite Baremetal
+
+} // namespace test
+} // namespace baremetal
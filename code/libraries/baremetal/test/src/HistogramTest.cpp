@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : HistogramTest.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : HistogramTest
+//
+// Description : Histogram tests
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/Histogram.h"
+
+#include "unittest/unittest.h"
+
+using namespace unittest;
+
+namespace baremetal {
+namespace test {
+
+/// @brief Baremetal test suite
+TEST_SUITE(Baremetal)
+{
+
+class HistogramTest : public TestFixture
+{
+public:
+    void SetUp() override
+    {
+    }
+    void TearDown() override
+    {
+    }
+};
+
+TEST_FIXTURE(HistogramTest, EmptyHistogram)
+{
+    Histogram histogram;
+    EXPECT_EQ(uint64{0}, histogram.GetCount());
+    EXPECT_EQ(uint64{0}, histogram.GetMin());
+    EXPECT_EQ(uint64{0}, histogram.GetMax());
+    EXPECT_EQ(uint64{0}, histogram.GetMean());
+    EXPECT_EQ(uint64{0}, histogram.GetPercentile(50));
+}
+
+TEST_FIXTURE(HistogramTest, BucketsCoverAllValues)
+{
+    // Small values have their own bucket
+    for (uint64 value = 0; value < HISTOGRAM_SUB_BUCKETS; ++value)
+        EXPECT_EQ(value, Histogram::GetBucketUpperBound(Histogram::GetBucketIndex(value)));
+    // Every value lies in its bucket, and buckets are contiguous
+    for (uint64 value = 1; value < 100000; value = value * 9 / 8 + 1)
+    {
+        unsigned index = Histogram::GetBucketIndex(value);
+        EXPECT_TRUE(value <= Histogram::GetBucketUpperBound(index));
+        EXPECT_TRUE(value > Histogram::GetBucketUpperBound(index - 1));
+    }
+    EXPECT_EQ(unsigned{HISTOGRAM_BUCKETS - 1}, Histogram::GetBucketIndex(~0ULL));
+    EXPECT_EQ(unsigned{HISTOGRAM_BUCKETS - 1}, Histogram::GetBucketIndex(1ULL << HISTOGRAM_MAX_BITS));
+}
+
+TEST_FIXTURE(HistogramTest, Statistics)
+{
+    Histogram histogram;
+    for (uint64 value = 1000; value <= 100000; value += 1000)
+        histogram.Add(value);
+    EXPECT_EQ(uint64{100}, histogram.GetCount());
+    EXPECT_EQ(uint64{1000}, histogram.GetMin());
+    EXPECT_EQ(uint64{100000}, histogram.GetMax());
+    EXPECT_EQ(uint64{50500}, histogram.GetMean());
+    // Percentiles are bucket upper bounds, at most 1 / HISTOGRAM_SUB_BUCKETS too high
+    uint64 median = histogram.GetPercentile(50);
+    EXPECT_TRUE((median >= 50000) && (median <= 50000 + 50000 / HISTOGRAM_SUB_BUCKETS));
+    EXPECT_EQ(uint64{100000}, histogram.GetPercentile(100));
+    EXPECT_EQ(uint64{1000}, histogram.GetPercentile(0));
+
+    histogram.Reset();
+    EXPECT_EQ(uint64{0}, histogram.GetCount());
+    histogram.Add(7);
+    EXPECT_EQ(uint64{7}, histogram.GetMin());
+    EXPECT_EQ(uint64{7}, histogram.GetPercentile(99));
+}
+
+} // suite Baremetal
+
+} // namespace test
+} // namespace baremetal
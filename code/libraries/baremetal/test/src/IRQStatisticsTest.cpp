@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : IRQStatisticsTest.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : IRQStatisticsTest
+//
+// Description : Interrupt statistics tests
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/InterruptHandler.h"
+
+#include "baremetal/Clock.h"
+#include "baremetal/Timer.h"
+
+#include "unittest/unittest.h"
+
+#if BAREMETAL_IRQ_STATS
+
+using namespace unittest;
+
+namespace baremetal {
+namespace test {
+
+/// @brief Number of times the test kernel timer elapsed
+static volatile unsigned timerElapsed{};
+
+static void TestTimerHandler(KernelTimerHandle /*handle*/, void* /*param*/, void* /*context*/)
+{
+    timerElapsed = timerElapsed + 1;
+}
+
+/// @brief Baremetal test suite
+TEST_SUITE(Baremetal)
+{
+
+class IRQStatisticsTest : public TestFixture
+{
+public:
+    void SetUp() override
+    {
+        GetInterruptSystem().ResetIRQStatistics();
+    }
+    void TearDown() override
+    {
+    }
+};
+
+TEST_FIXTURE(IRQStatisticsTest, TimerInterruptIsRecorded)
+{
+    auto& interruptSystem = GetInterruptSystem();
+    timerElapsed = 0;
+    GetTimer().StartKernelTimerMicroSeconds(5000, TestTimerHandler);
+    Timer::WaitMilliSeconds(50);
+    EXPECT_EQ(1u, timerElapsed);
+
+    IRQStatistics statistics;
+    EXPECT_TRUE(interruptSystem.GetIRQStatistics(IRQ_ID::IRQ_LOCAL_CNTPNS, statistics));
+    EXPECT_TRUE(statistics.irqID == IRQ_ID::IRQ_LOCAL_CNTPNS);
+    EXPECT_TRUE(statistics.count >= 1);
+    EXPECT_EQ(statistics.count, statistics.duration.GetCount());
+    EXPECT_EQ(statistics.count, statistics.dispatchLatency.GetCount());
+    EXPECT_TRUE(statistics.dispatchLatency.GetMax() < Clock::NanoSecondsToCycles(NSEC_PER_MSEC));
+
+    Histogram latency;
+    interruptSystem.GetTimerEntryLatency(latency);
+    EXPECT_TRUE(latency.GetCount() >= 1);
+    EXPECT_TRUE(latency.GetMax() < Clock::NanoSecondsToCycles(NSEC_PER_MSEC));
+
+    // A timer tick may occur right after the reset
+    interruptSystem.ResetIRQStatistics();
+    EXPECT_TRUE(!interruptSystem.GetIRQStatistics(IRQ_ID::IRQ_LOCAL_CNTPNS, statistics) || (statistics.count <= 1));
+}
+
+} // suite Baremetal
+
+} // namespace test
+} // namespace baremetal
+
+#endif
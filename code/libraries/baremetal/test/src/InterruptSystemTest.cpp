@@ -0,0 +1,509 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : InterruptSystemTest.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : InterruptSystemTest
+//
+// Description : Interrupt system tests
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/InterruptHandler.h"
+
+#include "baremetal/ARMInstructions.h"
+#include "baremetal/ARMRegisters.h"
+#include "baremetal/BCMRegisters.h"
+#include "baremetal/Interrupts.h"
+#if BAREMETAL_IRQ_STATS
+#include "baremetal/Clock.h"
+#include "baremetal/Timer.h"
+#endif
+#include "baremetal/mocks/MemoryAccessMock.h"
+#include "stdlib/Util.h"
+
+#include "unittest/unittest.h"
+
+using namespace unittest;
+
+namespace baremetal {
+namespace test {
+
+/// @brief IRQ mask bit in the DAIF register
+#define DAIF_IRQ_MASK BIT1(7)
+
+/// <summary>
+/// Memory access mock simulating the interrupt controller registers
+/// </summary>
+class InterruptControllerMock : public MemoryAccessMock
+{
+public:
+#if BAREMETAL_RPI_TARGET == 3
+    /// @brief Pending GPU IRQs (IRQ pending 1, IRQ pending 2, basic pending). Reading a pending register clears it, as if the handlers cleared the sources
+    uint32 m_gpuPending[3]{};
+#else
+    /// @brief GICD_IPRIORITYR registers
+    uint32 m_priority[IRQ_LINES / 4]{};
+    /// @brief GICD_IGROUPR registers
+    uint32 m_group[IRQ_LINES / 32]{};
+    /// @brief Values returned by successive GICC_IAR reads, after these the spurious interrupt ID 1023 is returned
+    uint32 m_iarValues[8]{};
+    /// @brief Number of valid entries in m_iarValues
+    unsigned m_numIARValues{};
+    /// @brief Number of GICC_IAR reads done
+    unsigned m_iarReadCount{};
+#endif
+
+    uint32 OnRead(regaddr address) override
+    {
+#if BAREMETAL_RPI_TARGET == 3
+        if (address == ARM_LOCAL_IRQ_PENDING0)
+            return ((m_gpuPending[0] | m_gpuPending[1] | m_gpuPending[2]) != 0) ? ARM_LOCAL_INTSRC_GPU : 0;
+        static const regaddr pendingRegisters[3]{RPI_INTRCTRL_IRQ_PENDING_1, RPI_INTRCTRL_IRQ_PENDING_2, RPI_INTRCTRL_IRQ_BASIC_PENDING};
+        for (unsigned reg = 0; reg < 3; ++reg)
+        {
+            if (address == pendingRegisters[reg])
+            {
+                uint32 value = m_gpuPending[reg];
+                m_gpuPending[reg] = 0;
+                return value;
+            }
+        }
+#else
+        if ((address >= RPI_GICD_IPRIORITYR0) && (address < RPI_GICD_IPRIORITYR0 + IRQ_LINES))
+            return m_priority[(address - RPI_GICD_IPRIORITYR0) / 4];
+        if ((address >= RPI_GICD_IGROUPR0) && (address < RPI_GICD_IGROUPR0 + IRQ_LINES / 8))
+            return m_group[(address - RPI_GICD_IGROUPR0) / 4];
+        if (address == RPI_GICC_IAR)
+            return (m_iarReadCount < m_numIARValues) ? m_iarValues[m_iarReadCount++] : 1023;
+#endif
+        return 0;
+    }
+    void OnWrite(regaddr address, uint32 data) override
+    {
+#if BAREMETAL_RPI_TARGET == 3
+        (void)address;
+        (void)data;
+#else
+        if ((address >= RPI_GICD_IPRIORITYR0) && (address < RPI_GICD_IPRIORITYR0 + IRQ_LINES))
+            m_priority[(address - RPI_GICD_IPRIORITYR0) / 4] = data;
+        if ((address >= RPI_GICD_IGROUPR0) && (address < RPI_GICD_IGROUPR0 + IRQ_LINES / 8))
+            m_group[(address - RPI_GICD_IGROUPR0) / 4] = data;
+#endif
+    }
+    /// <summary>
+    /// Make an IRQ pending. On the GIC, pending IRQs are acknowledged in the order in which they are set
+    /// </summary>
+    /// <param name="irqID">IRQ to make pending</param>
+    void SetPending(IRQ_ID irqID)
+    {
+        uint32 irq = static_cast<uint32>(irqID);
+#if BAREMETAL_RPI_TARGET == 3
+        m_gpuPending[irq / ARM_IRQS_PER_REG] |= ARM_IRQ_MASK(irq);
+#else
+        m_iarValues[m_numIARValues++] = irq;
+#endif
+    }
+    /// <summary>
+    /// Find the last write to a register
+    /// </summary>
+    /// <param name="address">Address of register</param>
+    /// <param name="data">Receives the value written</param>
+    /// <returns>True if the register was written, false otherwise</returns>
+    bool FindLastWrite(regaddr address, uint32& data) const
+    {
+        for (size_t index = GetNumMemoryOperations(); index > 0; --index)
+        {
+            const MemoryAccessOperation& operation = GetMemoryOperation(index - 1);
+            if (operation.isWriteOperation && (operation.address == address))
+            {
+                data = operation.data;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/// @brief Value of the DAIF register seen by the last call to TestIRQHandler()
+static uint64 handlerDAIF{};
+/// @brief Number of calls to TestIRQHandler()
+static unsigned handlerCalls{};
+/// @brief IRQs handled by TestIRQHandler(), in order of the calls
+static uint32 handledIRQs[8]{};
+
+/// <summary>
+/// IRQ handler recording the interrupt mask it was called with
+/// </summary>
+/// <param name="param">IRQ number</param>
+static void TestIRQHandler(void* param)
+{
+    uint64 daif;
+    GetDAIF(daif);
+    handlerDAIF = daif;
+    if (handlerCalls < sizeof(handledIRQs) / sizeof(handledIRQs[0]))
+        handledIRQs[handlerCalls] = static_cast<uint32>(reinterpret_cast<uintptr>(param));
+    handlerCalls++;
+}
+
+/// @brief Value of the DAIF register seen by the last call to TestFIQHandler()
+static uint64 fiqHandlerDAIF{};
+/// @brief Number of calls to TestFIQHandler()
+static unsigned fiqHandlerCalls{};
+
+#if BAREMETAL_RPI_TARGET == 3
+#else
+/// <summary>
+/// FIQ handler recording the interrupt mask it was called with
+/// </summary>
+/// <param name="param">Not used</param>
+static void TestFIQHandler(void* /*param*/)
+{
+    uint64 daif;
+    GetDAIF(daif);
+    fiqHandlerDAIF = daif;
+    fiqHandlerCalls++;
+}
+#endif
+
+#if BAREMETAL_IRQ_STATS
+/// <summary>
+/// IRQ handler taking 1 millisecond
+/// </summary>
+/// <param name="param">IRQ number</param>
+static void SlowIRQHandler(void* param)
+{
+    TestIRQHandler(param);
+    Timer::WaitMilliSeconds(1);
+}
+#endif
+
+/// <summary>
+/// Return the parameter for TestIRQHandler() for an IRQ
+/// </summary>
+/// <param name="irqID">IRQ ID</param>
+/// <returns>Parameter to register with TestIRQHandler()</returns>
+static void* IRQParam(IRQ_ID irqID)
+{
+    return reinterpret_cast<void*>(static_cast<uintptr>(irqID));
+}
+
+/// @brief Baremetal test suite
+TEST_SUITE(Baremetal)
+{
+
+class InterruptSystemTest : public TestFixture
+{
+public:
+    /// @brief Interrupt mask at the start of the test, the InterruptSystem instances under test disable IRQs on shutdown
+    uint64 m_daif{};
+
+    void SetUp() override
+    {
+        GetDAIF(m_daif);
+        handlerDAIF = 0;
+        handlerCalls = 0;
+        memset(handledIRQs, 0, sizeof(handledIRQs));
+        fiqHandlerDAIF = 0;
+        fiqHandlerCalls = 0;
+    }
+    void TearDown() override
+    {
+        SetDAIF(m_daif);
+    }
+    /// <summary>
+    /// Handle an interrupt as the exception stub does, with IRQs disabled
+    /// </summary>
+    /// <param name="interruptSystem">Interrupt system handling the interrupt</param>
+    void HandleInterrupt(InterruptSystem& interruptSystem) const
+    {
+        uint64 daif;
+        GetDAIF(daif);
+        DisableIRQs();
+        interruptSystem.InterruptHandler();
+        SetDAIF(daif);
+    }
+};
+
+#if BAREMETAL_RPI_TARGET == 3
+/// @brief IRQs used in the dispatch tests, in the order in which they are handled
+static const IRQ_ID testIRQs[]{IRQ_ID::IRQ_AUX, IRQ_ID::IRQ_I2C, IRQ_ID::IRQ_UART};
+#else
+/// @brief IRQs used in the dispatch tests, in the order in which they are handled
+static const IRQ_ID testIRQs[]{static_cast<IRQ_ID>(GIC_SPI(1)), static_cast<IRQ_ID>(GIC_SPI(40)), static_cast<IRQ_ID>(GIC_SPI(2))};
+#endif
+
+TEST_FIXTURE(InterruptSystemTest, SeveralPendingIRQsAreHandledInOneEntry)
+{
+    InterruptControllerMock memoryAccess;
+    InterruptSystem interruptSystem(memoryAccess);
+    for (auto irqID : testIRQs)
+    {
+        interruptSystem.RegisterIRQHandler(irqID, TestIRQHandler, IRQParam(irqID));
+        memoryAccess.SetPending(irqID);
+    }
+
+    HandleInterrupt(interruptSystem);
+    EXPECT_EQ(3u, handlerCalls);
+    for (unsigned index = 0; index < 3; ++index)
+        EXPECT_EQ(static_cast<uint32>(testIRQs[index]), handledIRQs[index]);
+    EXPECT_EQ(uint64{1}, interruptSystem.GetInterruptEntryCount());
+    EXPECT_EQ(uint64{3}, interruptSystem.GetHandledIRQCount());
+#if BAREMETAL_RPI_TARGET == 3
+#else
+    // Every acknowledged IRQ is ended, in the same order
+    unsigned endOfInterrupt{};
+    for (size_t index = 0; index < memoryAccess.GetNumMemoryOperations(); ++index)
+    {
+        const MemoryAccessOperation& operation = memoryAccess.GetMemoryOperation(index);
+        if (operation.isWriteOperation && (operation.address == RPI_GICC_EOIR))
+        {
+            EXPECT_EQ(static_cast<uint32>(testIRQs[endOfInterrupt]), operation.data);
+            endOfInterrupt++;
+        }
+    }
+    EXPECT_EQ(3u, endOfInterrupt);
+#endif
+
+    for (auto irqID : testIRQs)
+        interruptSystem.UnregisterIRQHandler(irqID);
+}
+
+TEST_FIXTURE(InterruptSystemTest, SpuriousInterruptCallsNoHandler)
+{
+    InterruptControllerMock memoryAccess;
+    InterruptSystem interruptSystem(memoryAccess);
+    interruptSystem.RegisterIRQHandler(testIRQs[0], TestIRQHandler, IRQParam(testIRQs[0]));
+    size_t numOperations = memoryAccess.GetNumMemoryOperations();
+
+    HandleInterrupt(interruptSystem);
+    EXPECT_EQ(0u, handlerCalls);
+    EXPECT_EQ(uint64{1}, interruptSystem.GetInterruptEntryCount());
+    EXPECT_EQ(uint64{0}, interruptSystem.GetHandledIRQCount());
+    // Only the pending state is read, nothing is acknowledged or disabled
+    for (size_t index = numOperations; index < memoryAccess.GetNumMemoryOperations(); ++index)
+        EXPECT_FALSE(memoryAccess.GetMemoryOperation(index).isWriteOperation);
+
+    interruptSystem.UnregisterIRQHandler(testIRQs[0]);
+}
+
+TEST_FIXTURE(InterruptSystemTest, IRQWithoutHandlerIsDisabled)
+{
+    InterruptControllerMock memoryAccess;
+    InterruptSystem interruptSystem(memoryAccess);
+    const IRQ_ID irqID = testIRQs[1];
+    uint32 irq = static_cast<uint32>(irqID);
+    memoryAccess.SetPending(irqID);
+
+    HandleInterrupt(interruptSystem);
+    EXPECT_EQ(0u, handlerCalls);
+    uint32 value{};
+#if BAREMETAL_RPI_TARGET == 3
+    EXPECT_TRUE(memoryAccess.FindLastWrite(ARM_IC_IRQS_DISABLE(irq), value));
+    EXPECT_EQ(static_cast<uint32>(ARM_IRQ_MASK(irq)), value);
+#else
+    EXPECT_TRUE(memoryAccess.FindLastWrite(RPI_GICD_ICENABLER0 + 4 * (irq / 32), value));
+    EXPECT_EQ(static_cast<uint32>(BIT1(irq % 32)), value);
+    EXPECT_TRUE(memoryAccess.FindLastWrite(RPI_GICC_EOIR, value));
+    EXPECT_EQ(irq, value);
+#endif
+}
+
+#if BAREMETAL_IRQ_STATS
+TEST_FIXTURE(InterruptSystemTest, DispatchLatencyExcludesEarlierHandlers)
+{
+    InterruptControllerMock memoryAccess;
+    InterruptSystem interruptSystem(memoryAccess);
+    interruptSystem.RegisterIRQHandler(testIRQs[0], SlowIRQHandler, IRQParam(testIRQs[0]));
+    interruptSystem.RegisterIRQHandler(testIRQs[1], TestIRQHandler, IRQParam(testIRQs[1]));
+    memoryAccess.SetPending(testIRQs[0]);
+    memoryAccess.SetPending(testIRQs[1]);
+
+    HandleInterrupt(interruptSystem);
+    EXPECT_EQ(2u, handlerCalls);
+    // The second IRQ waited 1 ms for the first handler, which is not part of its dispatch latency
+    IRQStatistics statistics;
+    EXPECT_TRUE(interruptSystem.GetIRQStatistics(testIRQs[1], statistics));
+    EXPECT_EQ(uint64{1}, statistics.count);
+    EXPECT_TRUE(statistics.dispatchLatency.GetMax() < Clock::NanoSecondsToCycles(NSEC_PER_MSEC / 10));
+
+    interruptSystem.UnregisterIRQHandler(testIRQs[0]);
+    interruptSystem.UnregisterIRQHandler(testIRQs[1]);
+}
+#endif
+
+#if BAREMETAL_RPI_TARGET == 3
+#else
+
+TEST_FIXTURE(InterruptSystemTest, InitializeSetsPriorityMaskAndBinaryPoint)
+{
+    InterruptControllerMock memoryAccess;
+    InterruptSystem interruptSystem(memoryAccess);
+    interruptSystem.Initialize();
+
+    uint32 value{};
+    EXPECT_TRUE(memoryAccess.FindLastWrite(RPI_GICC_PMR, value));
+    EXPECT_EQ(uint32{RPI_GICC_PMR_PRIORITY}, value);
+    EXPECT_TRUE(memoryAccess.FindLastWrite(RPI_GICC_BPR, value));
+    EXPECT_EQ(uint32{RPI_GICC_BPR_ALL_GROUP_PRIORITY}, value);
+    EXPECT_EQ(uint32{0xA0A0A0A0}, memoryAccess.m_priority[0]);
+}
+
+TEST_FIXTURE(InterruptSystemTest, SetIRQPriorityOnlyChangesItsOwnField)
+{
+    InterruptControllerMock memoryAccess;
+    memoryAccess.m_priority[8] = 0xA0B0C0D0;
+    InterruptSystem interruptSystem(memoryAccess);
+
+    // IRQ 33 is byte 1 of GICD_IPRIORITYR8
+    interruptSystem.SetIRQPriority(static_cast<IRQ_ID>(GIC_SPI(1)), 0x60);
+
+    size_t index{};
+    EXPECT_EQ(size_t{2}, memoryAccess.GetNumMemoryOperations());
+    EXPECT_EQ((MemoryAccessOperation{RPI_GICD_IPRIORITYR0 + 32, 0xA0B0C0D0}), memoryAccess.GetMemoryOperation(index++));
+    EXPECT_EQ((MemoryAccessOperation{RPI_GICD_IPRIORITYR0 + 32, 0xA0B060D0, true}), memoryAccess.GetMemoryOperation(index++));
+    EXPECT_EQ(uint32{0xA0B060D0}, memoryAccess.m_priority[8]);
+}
+
+TEST_FIXTURE(InterruptSystemTest, SetPriorityMaskAndGrouping)
+{
+    InterruptControllerMock memoryAccess;
+    InterruptSystem interruptSystem(memoryAccess);
+
+    interruptSystem.SetPriorityMask(0x80);
+    interruptSystem.SetPriorityGrouping(4);
+
+    size_t index{};
+    EXPECT_EQ(size_t{2}, memoryAccess.GetNumMemoryOperations());
+    EXPECT_EQ((MemoryAccessOperation{RPI_GICC_PMR, 0x80, true}), memoryAccess.GetMemoryOperation(index++));
+    EXPECT_EQ((MemoryAccessOperation{RPI_GICC_BPR, 4, true}), memoryAccess.GetMemoryOperation(index++));
+}
+
+TEST_FIXTURE(InterruptSystemTest, OnlyPreemptibleHandlersRunWithIRQsEnabled)
+{
+    InterruptControllerMock memoryAccess;
+    InterruptSystem interruptSystem(memoryAccess);
+    const IRQ_ID irqID = IRQ_ID::IRQ_HOSTPORT;
+
+    interruptSystem.RegisterIRQHandler(irqID, TestIRQHandler, nullptr);
+    memoryAccess.m_iarValues[memoryAccess.m_numIARValues++] = static_cast<uint32>(irqID);
+    HandleInterrupt(interruptSystem);
+    EXPECT_EQ(1u, handlerCalls);
+    EXPECT_TRUE((handlerDAIF & DAIF_IRQ_MASK) != 0);
+    interruptSystem.UnregisterIRQHandler(irqID);
+
+    interruptSystem.RegisterIRQHandler(irqID, TestIRQHandler, nullptr, IRQ_PRIORITY_LOWEST, true);
+    memoryAccess.m_iarValues[memoryAccess.m_numIARValues++] = static_cast<uint32>(irqID);
+    HandleInterrupt(interruptSystem);
+    EXPECT_EQ(2u, handlerCalls);
+    EXPECT_TRUE((handlerDAIF & DAIF_IRQ_MASK) == 0);
+    interruptSystem.UnregisterIRQHandler(irqID);
+}
+
+TEST_FIXTURE(InterruptSystemTest, RegisterFIQHandlerMakesSourceGroup0)
+{
+    InterruptControllerMock memoryAccess;
+    memoryAccess.m_priority[8] = 0xA0A0A0A0;
+    memoryAccess.m_group[1] = 0xFFFFFFFF;
+    InterruptSystem interruptSystem(memoryAccess);
+    const FIQ_ID fiqID = static_cast<FIQ_ID>(GIC_SPI(1));
+
+    interruptSystem.RegisterFIQHandler(fiqID, TestFIQHandler, nullptr);
+
+    // IRQ 33 is byte 1 of GICD_IPRIORITYR8, and bit 1 of GICD_IGROUPR1
+    size_t index{};
+    EXPECT_EQ(size_t{7}, memoryAccess.GetNumMemoryOperations());
+    EXPECT_EQ((MemoryAccessOperation{RPI_GICD_IPRIORITYR0 + 32, 0xA0A0A0A0}), memoryAccess.GetMemoryOperation(index++));
+    EXPECT_EQ((MemoryAccessOperation{RPI_GICD_IPRIORITYR0 + 32, 0xA0A040A0, true}), memoryAccess.GetMemoryOperation(index++));
+    EXPECT_EQ((MemoryAccessOperation{RPI_GICD_IGROUPR0 + 4, 0xFFFFFFFF}), memoryAccess.GetMemoryOperation(index++));
+    EXPECT_EQ((MemoryAccessOperation{RPI_GICD_IGROUPR0 + 4, 0xFFFFFFFD, true}), memoryAccess.GetMemoryOperation(index++));
+    EXPECT_EQ((MemoryAccessOperation{RPI_GICD_CTLR, RPI_GICD_CTLR_ENABLE_GROUP0 | RPI_GICD_CTLR_ENABLE_GROUP1, true}), memoryAccess.GetMemoryOperation(index++));
+    EXPECT_EQ((MemoryAccessOperation{RPI_GICC_CTLR, RPI_GICC_CTLR_ENABLE_GROUP0 | RPI_GICC_CTLR_ENABLE_GROUP1 | RPI_GICC_CTLR_FIQ_ENABLE, true}),
+              memoryAccess.GetMemoryOperation(index++));
+    EXPECT_EQ((MemoryAccessOperation{RPI_GICD_ISENABLER0 + 4, BIT1(1), true}), memoryAccess.GetMemoryOperation(index++));
+
+    interruptSystem.UnregisterFIQHandler(fiqID);
+    EXPECT_EQ(uint32{0xA0A0A0A0}, memoryAccess.m_priority[8]);
+    EXPECT_EQ(uint32{0xFFFFFFFF}, memoryAccess.m_group[1]);
+    uint32 value{};
+    EXPECT_TRUE(memoryAccess.FindLastWrite(RPI_GICD_ICENABLER0 + 4, value));
+    EXPECT_EQ(uint32{BIT1(1)}, value);
+}
+
+TEST_FIXTURE(InterruptSystemTest, FIQSignalledAsIRQCallsFIQHandler)
+{
+    InterruptControllerMock memoryAccess;
+    InterruptSystem interruptSystem(memoryAccess);
+    const FIQ_ID fiqID = static_cast<FIQ_ID>(GIC_SPI(1));
+    const IRQ_ID irqID = static_cast<IRQ_ID>(GIC_SPI(1));
+
+    interruptSystem.RegisterFIQHandler(fiqID, TestFIQHandler, nullptr);
+    memoryAccess.SetPending(irqID);
+    HandleInterrupt(interruptSystem);
+    EXPECT_EQ(1u, fiqHandlerCalls);
+    EXPECT_TRUE((fiqHandlerDAIF & DAIF_IRQ_MASK) != 0);
+    uint32 value{};
+    EXPECT_TRUE(memoryAccess.FindLastWrite(RPI_GICC_EOIR, value));
+    EXPECT_EQ(static_cast<uint32>(irqID), value);
+    interruptSystem.UnregisterFIQHandler(fiqID);
+
+    // Without FIQ or IRQ handler, the interrupt is disabled
+    size_t numOperations = memoryAccess.GetNumMemoryOperations();
+    memoryAccess.SetPending(irqID);
+    HandleInterrupt(interruptSystem);
+    EXPECT_EQ(1u, fiqHandlerCalls);
+    EXPECT_EQ(0u, handlerCalls);
+    EXPECT_TRUE(memoryAccess.FindLastWrite(RPI_GICD_ICENABLER0 + 4, value));
+    EXPECT_EQ(uint32{BIT1(1)}, value);
+    EXPECT_TRUE(memoryAccess.GetNumMemoryOperations() > numOperations);
+}
+
+TEST_FIXTURE(InterruptSystemTest, UnhandledFIQIsDisabled)
+{
+    InterruptControllerMock memoryAccess;
+    InterruptSystem interruptSystem(memoryAccess);
+
+    // FIQStub passes the acknowledged interrupt if no FIQ handler is registered
+    interruptSystem.HandleUnhandledFIQ(GIC_SPI(40));
+    EXPECT_EQ(size_t{1}, memoryAccess.GetNumMemoryOperations());
+    EXPECT_EQ((MemoryAccessOperation{RPI_GICD_ICENABLER0 + 8, BIT1(8), true}), memoryAccess.GetMemoryOperation(0));
+
+    // Spurious interrupt, nothing to disable
+    interruptSystem.HandleUnhandledFIQ(1023);
+    EXPECT_EQ(size_t{1}, memoryAccess.GetNumMemoryOperations());
+}
+
+#endif
+
+} // suite Baremetal
+
+} // namespace test
+} // namespace baremetal
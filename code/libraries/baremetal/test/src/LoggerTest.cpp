@@ -0,0 +1,478 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : LoggerTest.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : Logger
+//
+// Description : Logger asynchronous queue tests
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/ARMInstructions.h"
+#include "baremetal/Console.h"
+#include "baremetal/Format.h"
+#include "baremetal/Logger.h"
+#include "baremetal/Timer.h"
+#include "baremetal/stubs/DeviceStub.h"
+#include "stdlib/Util.h"
+
+#include "unittest/unittest.h"
+
+using namespace unittest;
+
+namespace baremetal {
+namespace test {
+
+/// @brief Module name used for log lines written by the tests. Debug and data statements are not compiled in
+LOG_MODULE("LoggerTest", LOG_LEVEL_INFO);
+/// @brief Number of lines written by the timer tick handler
+static volatile int s_interruptLineCount{};
+
+/// <summary>
+/// Timer tick handler, logging a few lines from interrupt context
+/// </summary>
+static void LogFromInterrupt()
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        GetLogger().LogNoAlloc(From, __LINE__, LogSeverity::Info, "Interrupt line %d.", s_interruptLineCount);
+        s_interruptLineCount = s_interruptLineCount + 1;
+    }
+}
+
+#if !BAREMETAL_BINARY_LOG
+
+/// <summary>
+/// Log a line from a single log statement, for the rate limiting tests
+/// </summary>
+/// <param name="index">Index written in the line</param>
+/// <returns>Source line of the log statement</returns>
+static int LogRateLimitedLine(int index)
+{
+    LOG_INFO("Rate limited line %d.", index);
+    return __LINE__ - 1;
+}
+
+/// <summary>
+/// Log a line from a single log statement, for the repeated message tests
+/// </summary>
+/// <param name="index">Index written in the line</param>
+/// <returns>Source line of the log statement</returns>
+static int LogRepeatedLine(int index)
+{
+    LOG_INFO("Repeated line %d.", index);
+    return __LINE__ - 1;
+}
+
+#endif
+
+#if BAREMETAL_BINARY_LOG
+
+/// <summary>
+/// Decode a binary log frame, the reverse of EncodeBinaryLogFrame()
+/// </summary>
+/// <param name="frame">Encoded frame, without the frame end byte</param>
+/// <param name="size">Size of the encoded frame in bytes</param>
+/// <param name="record">Buffer receiving the decoded record</param>
+/// <returns>Size of the decoded record in bytes</returns>
+static size_t DecodeBinaryLogFrame(const uint8* frame, size_t size, uint8* record)
+{
+    size_t outIndex = 0;
+    size_t index = 0;
+    while (index < size)
+    {
+        uint8 code = frame[index++] ^ '\n';
+        for (uint8 i = 1; (i < code) && (index < size); ++i)
+            record[outIndex++] = frame[index++] ^ '\n';
+        if ((code != 0xFF) && (index < size))
+            record[outIndex++] = 0;
+    }
+    return outIndex;
+}
+
+/// <summary>
+/// Encode a record, and check that the frame contains no frame end byte except at the end, and decodes to the same record
+/// </summary>
+/// <param name="record">Record to encode</param>
+/// <param name="size">Size of record in bytes</param>
+/// <returns>True if the record survives the round trip, false otherwise</returns>
+static bool RoundTripBinaryLogFrame(const uint8* record, size_t size)
+{
+    static uint8 frame[1024];
+    static uint8 decoded[1024];
+    size_t frameSize = EncodeBinaryLogFrame(record, size, frame);
+    if ((frameSize > size + size / 254 + 2) || (frame[frameSize - 1] != '\n'))
+        return false;
+    for (size_t i = 0; i < frameSize - 1; ++i)
+    {
+        if (frame[i] == '\n')
+            return false;
+    }
+    return (DecodeBinaryLogFrame(frame, frameSize - 1, decoded) == size) && (memcmp(decoded, record, size) == 0);
+}
+
+#endif
+
+/// @brief Baremetal test suite
+TEST_SUITE(Baremetal)
+{
+
+class LoggerTest : public TestFixture
+{
+public:
+    Logger* logger;
+    DeviceStub* device;
+
+    void SetUp() override
+    {
+        logger = &GetLogger();
+        logger->Flush();
+        device = new DeviceStub;
+    }
+    void TearDown() override
+    {
+        logger->SetAsynchronous(false);
+        delete device;
+    }
+
+    Device* StartCapture() const
+    {
+        GetConsole().Flush();
+        Device* previousDevice = GetConsole().GetDevice();
+        GetConsole().AssignDevice(device);
+        return previousDevice;
+    }
+    void StopCapture(Device* previousDevice) const
+    {
+        GetConsole().Flush();
+        GetConsole().AssignDevice(previousDevice);
+    }
+    void QueueLines(LogOverflowPolicy policy, int count) const
+    {
+        logger->SetAsynchronous(true, policy);
+        for (int i = 0; i < count; ++i)
+        {
+            logger->LogNoAlloc(From, __LINE__, LogSeverity::Info, "Queued line %d.", i);
+        }
+    }
+    ssize_t FindLine(int index) const
+    {
+        char text[32]{};
+        FormatNoAlloc(text, sizeof(text), "Queued line %d.", index);
+        return device->Find(text);
+    }
+};
+
+TEST_FIXTURE(LoggerTest, DropNewestKeepsOldestLines)
+{
+    uint32 droppedBefore = logger->GetDroppedLineCount();
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    Device* previousDevice = StartCapture();
+    QueueLines(LogOverflowPolicy::DropNewest, LOGGER_QUEUE_SIZE + 4);
+    uint32 dropped = logger->GetDroppedLineCount() - droppedBefore;
+    size_t written = logger->ProcessQueue();
+    StopCapture(previousDevice);
+    SetDAIF(daif);
+
+    EXPECT_EQ(4u, dropped);
+    EXPECT_EQ(size_t{LOGGER_QUEUE_SIZE}, written);
+    EXPECT_TRUE(device->Find("4 log lines dropped") >= 0);
+    EXPECT_TRUE(FindLine(0) >= 0);
+    EXPECT_TRUE(FindLine(LOGGER_QUEUE_SIZE - 1) >= 0);
+    EXPECT_FALSE(FindLine(LOGGER_QUEUE_SIZE) >= 0);
+    EXPECT_FALSE(FindLine(LOGGER_QUEUE_SIZE + 3) >= 0);
+}
+
+TEST_FIXTURE(LoggerTest, DropOldestKeepsNewestLines)
+{
+    uint32 droppedBefore = logger->GetDroppedLineCount();
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    Device* previousDevice = StartCapture();
+    QueueLines(LogOverflowPolicy::DropOldest, LOGGER_QUEUE_SIZE + 4);
+    uint32 dropped = logger->GetDroppedLineCount() - droppedBefore;
+    size_t written = logger->ProcessQueue();
+    StopCapture(previousDevice);
+    SetDAIF(daif);
+
+    EXPECT_EQ(4u, dropped);
+    EXPECT_EQ(size_t{LOGGER_QUEUE_SIZE}, written);
+    EXPECT_TRUE(device->Find("4 log lines dropped") >= 0);
+    EXPECT_FALSE(FindLine(0) >= 0);
+    EXPECT_FALSE(FindLine(3) >= 0);
+    EXPECT_TRUE(FindLine(4) >= 0);
+    EXPECT_TRUE(FindLine(LOGGER_QUEUE_SIZE + 3) >= 0);
+    EXPECT_TRUE(FindLine(4) < FindLine(LOGGER_QUEUE_SIZE + 3));
+}
+
+TEST_FIXTURE(LoggerTest, BlockWritesOldestLines)
+{
+    uint32 droppedBefore = logger->GetDroppedLineCount();
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    Device* previousDevice = StartCapture();
+    QueueLines(LogOverflowPolicy::Block, LOGGER_QUEUE_SIZE + 4);
+    uint32 dropped = logger->GetDroppedLineCount() - droppedBefore;
+    bool oldestWritten = (FindLine(3) >= 0);
+    size_t written = logger->ProcessQueue();
+    StopCapture(previousDevice);
+    SetDAIF(daif);
+
+    EXPECT_EQ(0u, dropped);
+    EXPECT_TRUE(oldestWritten);
+    EXPECT_EQ(size_t{LOGGER_QUEUE_SIZE}, written);
+    EXPECT_TRUE(FindLine(0) >= 0);
+    EXPECT_TRUE(FindLine(0) < FindLine(LOGGER_QUEUE_SIZE + 3));
+}
+
+TEST_FIXTURE(LoggerTest, DropOldestWithInterruptingProducer)
+{
+    // The interrupt handler logs into a full queue while the main loop is dropping the oldest line, the queue must keep draining
+    uint32 droppedBefore = logger->GetDroppedLineCount();
+    s_interruptLineCount = 0;
+    Device* previousDevice = StartCapture();
+    logger->SetAsynchronous(true, LogOverflowPolicy::DropOldest);
+    GetTimer().RegisterPeriodicHandler(LogFromInterrupt);
+    for (int i = 0; (i < 100000) && (s_interruptLineCount < 200); ++i)
+    {
+        logger->LogNoAlloc(From, __LINE__, LogSeverity::Info, "Main line %d.", i);
+    }
+    GetTimer().UnregisterPeriodicHandler(LogFromInterrupt);
+
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    logger->Flush();
+    device->Clear();
+    logger->LogNoAlloc(From, __LINE__, LogSeverity::Info, "Final line.");
+    size_t written = logger->ProcessQueue();
+    StopCapture(previousDevice);
+    SetDAIF(daif);
+
+    EXPECT_TRUE(s_interruptLineCount >= 200);
+    EXPECT_TRUE(logger->GetDroppedLineCount() != droppedBefore);
+    EXPECT_EQ(size_t{1}, written);
+    EXPECT_TRUE(device->Find("Final line.") >= 0);
+}
+
+TEST_FIXTURE(LoggerTest, TimerTickDrainsBatchOfLines)
+{
+    Device* previousDevice = StartCapture();
+    QueueLines(LogOverflowPolicy::DropNewest, LOGGER_QUEUE_SIZE);
+    // Two ticks more than needed when writing LOGGER_DRAIN_PER_TICK lines per tick
+    Timer::WaitMicroSeconds((LOGGER_QUEUE_SIZE / LOGGER_DRAIN_PER_TICK + 2) * USEC_PER_TICK);
+    bool allWritten = (FindLine(LOGGER_QUEUE_SIZE - 1) >= 0);
+    logger->SetAsynchronous(false);
+    StopCapture(previousDevice);
+
+    EXPECT_TRUE(allWritten);
+    EXPECT_TRUE(FindLine(0) >= 0);
+}
+
+#if !BAREMETAL_BINARY_LOG
+
+TEST_FIXTURE(LoggerTest, ModuleLevelOverridesGlobalLevel)
+{
+    Device* previousDevice = StartCapture();
+    bool isSet = logger->SetModuleLogLevel("LoggerTest", LogSeverity::Warning);
+    LogSeverity moduleLevel = logger->GetModuleLogLevel("LoggerTest");
+    bool traceInfoEnabled = logger->IsLogSeverityEnabled("LoggerTest.cpp", LogSeverity::Info);
+    LOG_INFO("Module info line.");
+    LOG_WARNING("Module warning line.");
+    logger->ResetModuleLogLevel("LoggerTest");
+    LOG_INFO("Module info line after reset.");
+    StopCapture(previousDevice);
+
+    EXPECT_TRUE(isSet);
+    EXPECT_TRUE(moduleLevel == LogSeverity::Warning);
+    EXPECT_FALSE(traceInfoEnabled);
+    EXPECT_FALSE(device->Find("Module info line.") >= 0);
+    EXPECT_TRUE(device->Find("Module warning line.") >= 0);
+    EXPECT_TRUE(device->Find("Module info line after reset.") >= 0);
+    EXPECT_TRUE(logger->IsLogSeverityEnabled("LoggerTest", LogSeverity::Info));
+
+    // A module level can also be higher than the global level
+    EXPECT_TRUE(logger->SetModuleLogLevel("OtherModule", LogSeverity::Debug));
+    EXPECT_TRUE(logger->IsLogSeverityEnabled("OtherModule", LogSeverity::Debug));
+    EXPECT_FALSE(logger->IsLogSeverityEnabled("LoggerTest", LogSeverity::Debug));
+    logger->ResetModuleLogLevel("OtherModule");
+    EXPECT_FALSE(logger->IsLogSeverityEnabled("OtherModule", LogSeverity::Debug));
+}
+
+TEST_FIXTURE(LoggerTest, RateLimitSuppressesAfterBurst)
+{
+    Device* previousDevice = StartCapture();
+    logger->SetRateLimit(3, 10);
+    for (int i = 0; i < 10; ++i)
+    {
+        LogRateLimitedLine(i);
+    }
+    // One token is added every 100 milliseconds
+    Timer::WaitMilliSeconds(150);
+    int statementLine = LogRateLimitedLine(10);
+    logger->SetRateLimit(LOGGER_RATE_LIMIT_BURST, LOGGER_RATE_LIMIT_PER_SECOND);
+    StopCapture(previousDevice);
+
+    char summary[80]{};
+    FormatNoAlloc(summary, sizeof(summary), "7 messages suppressed by rate limit (LoggerTest:%d)", statementLine);
+    EXPECT_TRUE(device->Find("Rate limited line 0.") >= 0);
+    EXPECT_TRUE(device->Find("Rate limited line 2.") >= 0);
+    EXPECT_FALSE(device->Find("Rate limited line 3.") >= 0);
+    EXPECT_FALSE(device->Find("Rate limited line 9.") >= 0);
+    EXPECT_TRUE(device->Find("Rate limited line 10.") >= 0);
+    EXPECT_TRUE(device->Find(summary) >= 0);
+    EXPECT_TRUE(device->Find(summary) < device->Find("Rate limited line 10."));
+}
+
+TEST_FIXTURE(LoggerTest, RepeatedMessagesAreFolded)
+{
+    Device* previousDevice = StartCapture();
+    int statementLine{};
+    for (int i = 0; i < 5; ++i)
+    {
+        statementLine = LogRepeatedLine(1);
+    }
+    LogRepeatedLine(2);
+    // A repeat at the end is reported when flushing
+    LogRepeatedLine(2);
+    logger->Flush();
+    StopCapture(previousDevice);
+
+    char summary[80]{};
+    FormatNoAlloc(summary, sizeof(summary), "Last message repeated 4 times (LoggerTest:%d)", statementLine);
+    ssize_t first = device->Find("Repeated line 1.");
+    EXPECT_TRUE(first >= 0);
+    EXPECT_FALSE(device->Find("Repeated line 1.", static_cast<size_t>(first) + 1) >= 0);
+    EXPECT_TRUE(device->Find(summary) > first);
+    EXPECT_TRUE(device->Find(summary) < device->Find("Repeated line 2."));
+    FormatNoAlloc(summary, sizeof(summary), "Last message repeated 1 times (LoggerTest:%d)", statementLine);
+    EXPECT_TRUE(device->Find(summary) > device->Find("Repeated line 2."));
+}
+
+#endif
+
+TEST(UptimeTimestampFormat)
+{
+    char buffer[32]{};
+    FormatUptimeTimestamp(buffer, sizeof(buffer), 3 * 54000000 + 27000054, 54000000);
+    EXPECT_EQ("3.500001", buffer);
+    FormatUptimeTimestamp(buffer, sizeof(buffer), 12 * 19200000 + 1920, 19200000);
+    EXPECT_EQ("12.000100", buffer);
+    FormatUptimeTimestamp(buffer, sizeof(buffer), 19199999, 19200000);
+    EXPECT_EQ("0.999999", buffer);
+    FormatUptimeTimestamp(buffer, sizeof(buffer), 12345, 0);
+    EXPECT_EQ("", buffer);
+}
+
+TEST(ModuleLevelRemovesLogStatements)
+{
+    int evaluated = 0;
+    LOG_DEBUG("Not compiled in %d", ++evaluated);
+    TRACE_DATA("Not compiled in %d", ++evaluated);
+    EXPECT_EQ(0, evaluated);
+    EXPECT_FALSE(LOG_SEVERITY_COMPILED_IN(LogSeverity::Debug));
+    EXPECT_EQ(BAREMETAL_LOG_LEVEL >= LOG_LEVEL_INFO, LOG_SEVERITY_COMPILED_IN(LogSeverity::Info));
+}
+
+#if BAREMETAL_BINARY_LOG
+
+TEST(EncodeBinaryLogFrameRoundTrip)
+{
+    static uint8 record[600];
+    EXPECT_TRUE(RoundTripBinaryLogFrame(record, 0));
+
+    const uint8 zeros[]{0, 1, 0, 0, '\n', 2, 0};
+    EXPECT_TRUE(RoundTripBinaryLogFrame(zeros, sizeof(zeros)));
+
+    // Runs of 255 non zero bytes, and runs longer than a COBS block
+    for (size_t i = 0; i < sizeof(record); ++i)
+        record[i] = static_cast<uint8>(i);
+    EXPECT_TRUE(RoundTripBinaryLogFrame(record, sizeof(record)));
+    for (size_t i = 0; i < sizeof(record); ++i)
+        record[i] = static_cast<uint8>(i % 255 + 1);
+    EXPECT_TRUE(RoundTripBinaryLogFrame(record, 254));
+    EXPECT_TRUE(RoundTripBinaryLogFrame(record, sizeof(record)));
+}
+
+TEST_FIXTURE(LoggerTest, BinaryRecordsRoundTripThroughConsole)
+{
+    const uint64 args[]{0x0A0A0A0A00000000ULL, 0};
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    logger->FlushBinary();
+    Device* previousDevice = StartCapture();
+    for (uint64 i = 0; i < 3; ++i)
+    {
+        uint64 recordArgs[]{args[0], i};
+        logger->LogBinary(From, __LINE__, nullptr, LogSeverity::Info, "Binary record %x %d", 2, recordArgs);
+    }
+    logger->FlushBinary();
+    StopCapture(previousDevice);
+    SetDAIF(daif);
+
+    // Split the output in frames, the console device may have inserted a carriage return before the frame end
+    const uint8* data = reinterpret_cast<const uint8*>(device->GetData());
+    size_t frameStart = 0;
+    uint64 records = 0;
+    for (size_t i = 0; i < device->GetDataCount(); ++i)
+    {
+        if (data[i] != '\n')
+            continue;
+        size_t frameEnd = ((i > frameStart) && (data[i - 1] == '\r')) ? i - 1 : i;
+        uint8 record[256];
+        size_t size = DecodeBinaryLogFrame(data + frameStart, frameEnd - frameStart, record);
+        EXPECT_TRUE(size > sizeof(args));
+        if (size > sizeof(args))
+        {
+            uint64 recordArgs[2];
+            memcpy(recordArgs, record + size - sizeof(recordArgs), sizeof(recordArgs));
+            EXPECT_EQ(args[0], recordArgs[0]);
+            EXPECT_EQ(records, recordArgs[1]);
+        }
+        ++records;
+        frameStart = i + 1;
+    }
+    EXPECT_EQ(uint64{3}, records);
+    EXPECT_EQ(device->GetDataCount(), frameStart);
+}
+
+#endif
+
+} // suite Baremetal
+
+} // namespace test
+} // namespace baremetal
@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : PeriodicTaskServiceTest.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : PeriodicTaskServiceTest
+//
+// Description : PeriodicTaskService tests
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/PeriodicTaskService.h"
+
+#include "baremetal/Clock.h"
+#include "baremetal/Timer.h"
+
+#include "unittest/unittest.h"
+
+using namespace unittest;
+
+namespace baremetal {
+namespace test {
+
+/// <summary>
+/// Test task state, passed as task handler context
+/// </summary>
+struct TaskRecord
+{
+    /// @brief Number of task runs
+    volatile unsigned runs;
+    /// @brief Busy time per run in microseconds
+    uint64 busyUsec;
+    /// @brief Remove the task from its own handler after this many runs, 0 for never
+    unsigned removeAfter;
+    /// @brief Service running the task
+    PeriodicTaskService* service;
+    /// @brief The task itself
+    PeriodicTask* task;
+};
+
+static void RecordTask(void* context)
+{
+    TaskRecord* record = reinterpret_cast<TaskRecord*>(context);
+    record->runs = record->runs + 1;
+    if (record->busyUsec != 0)
+        Clock::Wait(Duration::FromMicroSeconds(static_cast<int64>(record->busyUsec)));
+    if ((record->removeAfter != 0) && (record->runs == record->removeAfter))
+        record->service->RemoveTask(record->task);
+}
+
+/// @brief Baremetal test suite
+TEST_SUITE(Baremetal)
+{
+
+class PeriodicTaskServiceTest : public TestFixture
+{
+public:
+    PeriodicTaskService* service;
+
+    void SetUp() override
+    {
+        service = new PeriodicTaskService(GetTimer());
+    }
+    void TearDown() override
+    {
+        delete service;
+    }
+};
+
+TEST_FIXTURE(PeriodicTaskServiceTest, RunsAtPeriod)
+{
+    TaskRecord record{0, 0, 0, service, nullptr};
+    record.task = service->AddTask("test", 10000, 0, RecordTask, &record);
+    EXPECT_TRUE(record.task != nullptr);
+    Timer::WaitMilliSeconds(105);
+    service->RemoveTask(record.task);
+
+    PeriodicTaskStatistics statistics;
+    service->GetStatistics(record.task, statistics);
+    EXPECT_TRUE((record.runs >= 9) && (record.runs <= 11));
+    EXPECT_EQ(uint64{record.runs}, statistics.releases);
+    EXPECT_EQ(uint64{0}, statistics.overruns);
+    EXPECT_EQ(statistics.releases, statistics.executionTime.GetCount());
+    EXPECT_EQ(statistics.releases, statistics.releaseJitter.GetCount());
+    EXPECT_TRUE(statistics.releaseJitter.GetMax() <= 2 * USEC_PER_TICK * NSEC_PER_USEC);
+}
+
+TEST_FIXTURE(PeriodicTaskServiceTest, OverrunIsDetected)
+{
+    TaskRecord record{0, 15000, 0, service, nullptr};
+    record.task = service->AddTask("overrun", 10000, 0, RecordTask, &record);
+    Timer::WaitMilliSeconds(100);
+    service->RemoveTask(record.task);
+
+    PeriodicTaskStatistics statistics;
+    service->GetStatistics(record.task, statistics);
+    EXPECT_TRUE(statistics.releases >= 2);
+    EXPECT_EQ(statistics.releases, statistics.overruns);
+    EXPECT_TRUE(statistics.missedReleases >= statistics.overruns);
+    EXPECT_TRUE(statistics.executionTime.GetMin() >= 15000 * NSEC_PER_USEC);
+}
+
+TEST_FIXTURE(PeriodicTaskServiceTest, HandlerRemovesTask)
+{
+    TaskRecord record{0, 0, 3, service, nullptr};
+    record.task = service->AddTask("once", 10000, 5000, RecordTask, &record);
+    Timer::WaitMilliSeconds(100);
+    EXPECT_EQ(3u, record.runs);
+}
+
+} // suite Baremetal
+
+} // namespace test
+} // namespace baremetal
@@ -0,0 +1,166 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : SPIMasterDMATest.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : SPIMasterDMATest
+//
+// Description : SPI master DMA transfer tests
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/SPIMaster.h"
+
+#include "baremetal/BCMRegisters.h"
+#include "baremetal/stubs/MemoryAccessStubDMA.h"
+#include "stdlib/Util.h"
+
+#include "unittest/unittest.h"
+
+using namespace unittest;
+
+namespace baremetal {
+namespace test {
+
+/// @brief Baremetal test suite
+TEST_SUITE(Baremetal)
+{
+
+class SPIMasterDMATest : public TestFixture
+{
+public:
+    void SetUp() override
+    {
+    }
+    void TearDown() override
+    {
+    }
+};
+
+/// <summary>
+/// DMA controller stub which also keeps the SPI0 registers, so SPI DMA transfers can be tested
+/// </summary>
+class MemoryAccessStubSPIDMA : public MemoryAccessStubDMA
+{
+private:
+    /// @brief SPI0 registers (CS, FIFO, CLK, DLEN, LTOH, DC)
+    uint32 m_registers[6];
+
+public:
+    MemoryAccessStubSPIDMA()
+        : m_registers{}
+    {
+    }
+    uint32 Read32(regaddr address) override
+    {
+        uintptr offset = reinterpret_cast<uintptr>(address) - reinterpret_cast<uintptr>(RPI_SPI0_BASE);
+        if (offset < sizeof(m_registers))
+            return m_registers[offset / 4];
+        return MemoryAccessStubDMA::Read32(address);
+    }
+    void Write32(regaddr address, uint32 data) override
+    {
+        uintptr offset = reinterpret_cast<uintptr>(address) - reinterpret_cast<uintptr>(RPI_SPI0_BASE);
+        if (offset < sizeof(m_registers))
+            m_registers[offset / 4] = data;
+        else
+            MemoryAccessStubDMA::Write32(address, data);
+    }
+};
+
+/// @brief Size of SPI DMA transfer, more than a single DMA transfer can handle
+static constexpr size_t DMATransferSize = SPI_DMA_CHUNK_SIZE + 100;
+/// @brief Data received from the device
+static uint8 dmaReceived[DMATransferSize];
+/// @brief Buffer for data received from the device
+static uint8 dmaReadBuffer[DMATransferSize];
+
+TEST_FIXTURE(SPIMasterDMATest, ChunkedTransfers)
+{
+    MemoryAccessStubSPIDMA memoryAccess;
+    DMAController controller(memoryAccess);
+    SPIMaster master(memoryAccess);
+    master.Initialize(0);
+    EXPECT_TRUE(master.EnableDMA(controller));
+    EXPECT_TRUE(master.IsDMAEnabled());
+    EXPECT_EQ(uint32{0x30201020}, memoryAccess.Read32(RPI_SPI_REG_ADDRESS(RPI_SPI0_BASE, RPI_SPI_DC_OFFSET)));
+
+    uint8 dataOut[16]{0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10};
+    master.SetDMAThreshold(sizeof(dataOut));
+    EXPECT_EQ(sizeof(dataOut), master.Write(SPI_CEIndex::CE0, dataOut, sizeof(dataOut)));
+    // Length and CS word, followed by the data
+    EXPECT_EQ(size_t{4 + sizeof(dataOut)}, memoryAccess.GetPeripheralDataCount());
+    uint32 header{};
+    memcpy(&header, memoryAccess.GetPeripheralData(), sizeof(header));
+    EXPECT_EQ(static_cast<uint32>((sizeof(dataOut) << 16) | RPI_SPI_CS_TA), header);
+    EXPECT_EQ(0, memcmp(dataOut, memoryAccess.GetPeripheralData() + 4, sizeof(dataOut)));
+
+    // Transfers longer than a single DMA transfer can handle are split into chunks
+    for (size_t i = 0; i < DMATransferSize; ++i)
+        dmaReceived[i] = static_cast<uint8>(i ^ 0x5A);
+    memset(dmaReadBuffer, 0, DMATransferSize);
+    memoryAccess.SetPeripheralReadData(dmaReceived, DMATransferSize);
+    EXPECT_EQ(DMATransferSize, master.Read(SPI_CEIndex::CE1, dmaReadBuffer, DMATransferSize));
+    EXPECT_EQ(0, memcmp(dmaReceived, dmaReadBuffer, DMATransferSize));
+    memcpy(&header, memoryAccess.GetPeripheralData() + 4 + sizeof(dataOut), sizeof(header));
+    EXPECT_EQ(uint32{(uint32{SPI_DMA_CHUNK_SIZE} << 16) | RPI_SPI_CS_TA | 1}, header);
+    // TX: length word and data for each of the 3 transfers, RX: data for each transfer
+    EXPECT_EQ(uint32{6}, memoryAccess.GetControlBlockCount(8));
+    EXPECT_EQ(uint32{3}, memoryAccess.GetControlBlockCount(9));
+    EXPECT_EQ(uint32{0}, memoryAccess.Read32(RPI_SPI_REG_ADDRESS(RPI_SPI0_BASE, RPI_SPI_CS_OFFSET)) & (RPI_SPI_CS_DMAEN | RPI_SPI_CS_TA));
+}
+
+TEST_FIXTURE(SPIMasterDMATest, StalledTransferIsAborted)
+{
+    MemoryAccessStubSPIDMA memoryAccess;
+    DMAController controller(memoryAccess);
+    SPIMaster master(memoryAccess);
+    master.Initialize(0);
+    EXPECT_TRUE(master.EnableDMA(controller));
+
+    // The channels never complete, as if the device never raises its DREQ
+    uint8 dataOut[16]{};
+    master.SetDMAThreshold(sizeof(dataOut));
+    memoryAccess.SetAutoComplete(false);
+    EXPECT_EQ(size_t{0}, master.Write(SPI_CEIndex::CE0, dataOut, sizeof(dataOut)));
+    EXPECT_EQ(uint32{0}, memoryAccess.Read32(RPI_DMA_CS(8)) & RPI_DMA_CS_ACTIVE);
+    EXPECT_EQ(uint32{0}, memoryAccess.Read32(RPI_DMA_CS(9)) & RPI_DMA_CS_ACTIVE);
+    EXPECT_EQ(uint32{0}, memoryAccess.Read32(RPI_SPI_REG_ADDRESS(RPI_SPI0_BASE, RPI_SPI_CS_OFFSET)) & (RPI_SPI_CS_DMAEN | RPI_SPI_CS_TA));
+
+    // The channels can be used again after the abort
+    memoryAccess.SetAutoComplete(true);
+    EXPECT_EQ(sizeof(dataOut), master.Write(SPI_CEIndex::CE0, dataOut, sizeof(dataOut)));
+}
+
+} // suite Baremetal
+
+} // namespace test
+} // namespace baremetal
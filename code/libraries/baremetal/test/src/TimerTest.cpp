@@ -0,0 +1,204 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : TimerTest.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : -
+//
+// Description : Timer tests
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/Timer.h"
+
+#include "baremetal/ARMInstructions.h"
+#include "baremetal/Clock.h"
+#include "stdlib/Util.h"
+
+#include "unittest/unittest.h"
+
+using namespace unittest;
+
+namespace baremetal {
+namespace test {
+
+/// <summary>
+/// Record of a kernel timer expiration, passed as context to the timer handler
+/// </summary>
+struct TimerRecord
+{
+    /// @brief Number of expirations
+    volatile unsigned count;
+    /// @brief Uptime in microseconds at the last expiration
+    volatile uint64 elapsedAt;
+};
+
+/// @brief Number of calls to PeriodicHandler()
+static volatile unsigned periodicCount;
+
+static void RecordTimer(KernelTimerHandle /*handle*/, void* /*param*/, void* context)
+{
+    TimerRecord* record = reinterpret_cast<TimerRecord*>(context);
+    record->count = record->count + 1;
+    record->elapsedAt = GetTimer().GetUptimeMicroSeconds();
+}
+
+static void PeriodicHandler()
+{
+    periodicCount = periodicCount + 1;
+}
+
+/// <summary>
+/// Convert the "SS.mmm" part at the end of a time string to milliseconds
+/// </summary>
+/// <param name="timeString">Time string, as written by Timer::GetTimeString()</param>
+/// <returns>Seconds within the minute, plus milliseconds, in milliseconds</returns>
+static unsigned GetMilliSecondsInMinute(const char* timeString)
+{
+    const char* end = timeString + strlen(timeString) - 6;
+    return ((end[0] - '0') * 10 + (end[1] - '0')) * 1000 + (end[3] - '0') * 100 + (end[4] - '0') * 10 + (end[5] - '0');
+}
+
+/// @brief Baremetal test suite
+TEST_SUITE(Baremetal)
+{
+
+class TimerTest : public TestFixture
+{
+public:
+    void SetUp() override
+    {
+    }
+    void TearDown() override
+    {
+    }
+};
+
+TEST_FIXTURE(TimerTest, KernelTimerElapses)
+{
+    TimerRecord record{};
+    KernelTimerHandle handle = GetTimer().StartKernelTimer(3, RecordTimer, nullptr, &record);
+    EXPECT_TRUE(handle != 0);
+    Timer::WaitMicroSeconds(5 * USEC_PER_TICK);
+    EXPECT_EQ(1u, record.count);
+    // Cancelling an elapsed timer has no effect
+    GetTimer().CancelKernelTimer(handle);
+
+    record.count = 0;
+    handle = GetTimer().StartKernelTimer(3, RecordTimer, nullptr, &record);
+    GetTimer().CancelKernelTimer(handle);
+    Timer::WaitMicroSeconds(5 * USEC_PER_TICK);
+    EXPECT_EQ(0u, record.count);
+}
+
+TEST_FIXTURE(TimerTest, PeriodicHandlerIsCalledEveryTick)
+{
+    periodicCount = 0;
+    GetTimer().RegisterPeriodicHandler(PeriodicHandler);
+    Timer::WaitMicroSeconds(10 * USEC_PER_TICK + USEC_PER_TICK / 2);
+    GetTimer().UnregisterPeriodicHandler(PeriodicHandler);
+    unsigned count = periodicCount;
+    EXPECT_TRUE((count >= 9) && (count <= 11));
+
+    // No more calls after unregistering
+    Timer::WaitMicroSeconds(3 * USEC_PER_TICK);
+    EXPECT_EQ(count, periodicCount);
+}
+
+TEST_FIXTURE(TimerTest, TimeStringForCounterValue)
+{
+    uint64 counter = Clock::Cycles();
+    char now[32]{};
+    char later[32]{};
+    GetTimer().GetTimeString(now, sizeof(now), counter);
+    GetTimer().GetTimeString(later, sizeof(later), counter + 2 * Clock::GetFrequency() + Clock::GetFrequency() / 2);
+
+    EXPECT_TRUE(strlen(now) >= 9);
+    EXPECT_EQ(strlen(now), strlen(later));
+    EXPECT_EQ(2500u, (GetMilliSecondsInMinute(later) + 60000 - GetMilliSecondsInMinute(now)) % 60000);
+}
+
+#if BAREMETAL_TICKLESS
+
+TEST_FIXTURE(TimerTest, MicroSecondTimerElapsesWithinATick)
+{
+    TimerRecord record{};
+    uint64 start = GetTimer().GetUptimeMicroSeconds();
+    GetTimer().StartKernelTimerMicroSeconds(300, RecordTimer, nullptr, &record);
+    Timer::WaitMicroSeconds(2000);
+    EXPECT_EQ(1u, record.count);
+    // Not rounded up to a timer tick, only delayed by interrupt latency
+    EXPECT_TRUE(record.elapsedAt >= start + 300);
+    EXPECT_TRUE(record.elapsedAt < start + 300 + USEC_PER_TICK / 2);
+}
+
+TEST_FIXTURE(TimerTest, DeadlineIsProgrammedForFirstEvent)
+{
+    TimerRecord record{};
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
+    uint64 counter{};
+    GetTimerCounter(counter);
+    KernelTimerHandle handle = GetTimer().StartKernelTimerMicroSeconds(200, RecordTimer, nullptr, &record);
+    uint64 compareValue{};
+    uint64 control{};
+    GetTimerCompareValue(compareValue);
+    GetTimerControl(control);
+    SetDAIF(daif);
+
+    // The timer interrupt is armed no later than the new timer elapses (another timer may elapse earlier)
+    EXPECT_TRUE((control & CNTP_CTL_EL0_ENABLE) != 0);
+    EXPECT_TRUE((control & CNTP_CTL_EL0_IMASK) == 0);
+    EXPECT_TRUE(compareValue <= counter + Clock::NanoSecondsToCycles(200 * NSEC_PER_USEC) + Clock::NanoSecondsToCycles(10 * NSEC_PER_USEC));
+
+    Timer::WaitMicroSeconds(1000);
+    EXPECT_EQ(1u, record.count);
+    GetTimer().CancelKernelTimer(handle);
+}
+
+TEST_FIXTURE(TimerTest, FarTimerNeedsFewWakeUps)
+{
+    // Without other timers, the core is only woken up at the cascade points of the timer wheel levels, not every tick
+    TimerRecord record{};
+    uint64 interrupts = GetTimer().GetInterruptCount();
+    GetTimer().StartKernelTimerMicroSeconds(20000, RecordTimer, nullptr, &record);
+    Timer::WaitMicroSeconds(21000);
+    EXPECT_EQ(1u, record.count);
+    EXPECT_TRUE(GetTimer().GetInterruptCount() - interrupts < 100);
+}
+
+#endif
+
+} // suite Baremetal
+
+} // namespace test
+} // namespace baremetal
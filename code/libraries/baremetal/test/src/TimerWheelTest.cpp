@@ -0,0 +1,243 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : TimerWheelTest.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : -
+//
+// Description : Timer wheel tests
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/TimerWheel.h"
+
+#include "unittest/unittest.h"
+
+using namespace unittest;
+
+namespace baremetal {
+namespace test {
+
+/// @brief Baremetal test suite
+TEST_SUITE(Baremetal)
+{
+
+/// @brief Maximum number of timer expirations recorded
+static constexpr size_t MaxExpirations = 16;
+
+/// <summary>
+/// Record of timer expirations, passed as context to the timer handlers
+/// </summary>
+struct ExpirationLog
+{
+    /// @brief Timer wheel being tested
+    TimerWheel* wheel;
+    /// @brief Tick being advanced to
+    uint64 now;
+    /// @brief Number of expirations recorded
+    size_t count;
+    /// @brief Parameter passed to the handler for each expiration
+    uintptr params[MaxExpirations];
+    /// @brief Tick at which each expiration took place
+    uint64 ticks[MaxExpirations];
+    /// @brief Handle to cancel from the handler, if not 0
+    KernelTimerHandle cancelHandle;
+    /// @brief Number of times the timer with parameter 0 restarts itself
+    unsigned restarts;
+};
+
+class TimerWheelTest : public TestFixture
+{
+public:
+    TimerWheel* wheel;
+    ExpirationLog* log;
+
+    void SetUp() override
+    {
+        // The timer wheel is too large for the stack
+        wheel = new TimerWheel();
+        log = new ExpirationLog{};
+        log->wheel = wheel;
+    }
+    void TearDown() override
+    {
+        delete log;
+        delete wheel;
+    }
+    void AdvanceTo(uint64 ticks) const
+    {
+        log->now = ticks;
+        wheel->Advance(ticks);
+    }
+};
+
+/// <summary>
+/// Timer handler recording the expiration
+/// </summary>
+/// <param name="handle">Handle of the expired timer</param>
+/// <param name="param">Parameter identifying the timer</param>
+/// <param name="context">Expiration log</param>
+static void RecordExpiration(KernelTimerHandle /*handle*/, void* param, void* context)
+{
+    ExpirationLog* log = reinterpret_cast<ExpirationLog*>(context);
+    if (log->count < MaxExpirations)
+    {
+        log->params[log->count] = reinterpret_cast<uintptr>(param);
+        log->ticks[log->count] = log->now;
+    }
+    log->count++;
+    if (log->cancelHandle != 0)
+    {
+        log->wheel->Cancel(log->cancelHandle);
+        log->cancelHandle = 0;
+    }
+    if ((param == nullptr) && (log->restarts > 0))
+    {
+        log->restarts--;
+        log->wheel->Add(log->now + 10, RecordExpiration, param, context);
+    }
+}
+
+TEST_FIXTURE(TimerWheelTest, ElapseAtDeadline)
+{
+    wheel->Add(100, RecordExpiration, reinterpret_cast<void*>(3), log);
+    wheel->Add(5, RecordExpiration, reinterpret_cast<void*>(1), log);
+    wheel->Add(64, RecordExpiration, reinterpret_cast<void*>(2), log);
+    wheel->Add(5, RecordExpiration, reinterpret_cast<void*>(4), log);
+    EXPECT_EQ(size_t{4}, wheel->GetActiveCount());
+
+    for (uint64 tick = 1; tick <= 200; ++tick)
+        AdvanceTo(tick);
+
+    EXPECT_EQ(size_t{4}, log->count);
+    EXPECT_EQ(uintptr{1}, log->params[0]);
+    EXPECT_EQ(uint64{5}, log->ticks[0]);
+    EXPECT_EQ(uintptr{4}, log->params[1]);
+    EXPECT_EQ(uint64{5}, log->ticks[1]);
+    EXPECT_EQ(uintptr{2}, log->params[2]);
+    EXPECT_EQ(uint64{64}, log->ticks[2]);
+    EXPECT_EQ(uintptr{3}, log->params[3]);
+    EXPECT_EQ(uint64{100}, log->ticks[3]);
+    EXPECT_EQ(size_t{0}, wheel->GetActiveCount());
+}
+
+TEST_FIXTURE(TimerWheelTest, CancelAndStaleHandle)
+{
+    KernelTimerHandle handle = wheel->Add(10, RecordExpiration, reinterpret_cast<void*>(1), log);
+    EXPECT_NE(KernelTimerHandle{0}, handle);
+    EXPECT_TRUE(wheel->IsActive(handle));
+    EXPECT_TRUE(wheel->Cancel(handle));
+    EXPECT_FALSE(wheel->IsActive(handle));
+    EXPECT_FALSE(wheel->Cancel(handle));
+
+    // The administration is re-used, but the old handle must not cancel the new timer
+    KernelTimerHandle newHandle = wheel->Add(10, RecordExpiration, reinterpret_cast<void*>(2), log);
+    EXPECT_NE(handle, newHandle);
+    EXPECT_EQ(handle & 0xFFFFFFFF, newHandle & 0xFFFFFFFF);
+    EXPECT_FALSE(wheel->Cancel(handle));
+    EXPECT_FALSE(wheel->Cancel(0));
+
+    AdvanceTo(10);
+    EXPECT_EQ(size_t{1}, log->count);
+    EXPECT_EQ(uintptr{2}, log->params[0]);
+    EXPECT_FALSE(wheel->Cancel(newHandle));
+}
+
+TEST_FIXTURE(TimerWheelTest, LongDelaysCascade)
+{
+    AdvanceTo(1000);
+    wheel->Add(1000 + 5000, RecordExpiration, reinterpret_cast<void*>(1), log);
+    wheel->Add(1000 + 300000, RecordExpiration, reinterpret_cast<void*>(2), log);
+    // Beyond the range of the timer wheel
+    wheel->Add(1000 + (1ULL << 25) + 3, RecordExpiration, reinterpret_cast<void*>(3), log);
+
+    AdvanceTo(1000 + 4999);
+    EXPECT_EQ(size_t{0}, log->count);
+    AdvanceTo(1000 + 5000);
+    EXPECT_EQ(size_t{1}, log->count);
+    AdvanceTo(1000 + 299999);
+    EXPECT_EQ(size_t{1}, log->count);
+    AdvanceTo(1000 + 300000);
+    EXPECT_EQ(size_t{2}, log->count);
+    AdvanceTo(1000 + (1ULL << 25) + 2);
+    EXPECT_EQ(size_t{2}, log->count);
+    AdvanceTo(1000 + (1ULL << 25) + 3);
+    EXPECT_EQ(size_t{3}, log->count);
+    EXPECT_EQ(uintptr{3}, log->params[2]);
+    EXPECT_EQ(uint64{1000 + (1ULL << 25) + 3}, log->ticks[2]);
+}
+
+TEST_FIXTURE(TimerWheelTest, HandlerRestartsAndCancels)
+{
+    wheel->Add(20, RecordExpiration, nullptr, log);
+    wheel->Add(30, RecordExpiration, reinterpret_cast<void*>(1), log);
+    KernelTimerHandle other = wheel->Add(30, RecordExpiration, reinterpret_cast<void*>(2), log);
+    log->restarts = 1;
+
+    for (uint64 tick = 1; tick < 30; ++tick)
+        AdvanceTo(tick);
+    EXPECT_EQ(size_t{1}, log->count);
+
+    // Timer 0 restarted itself to elapse at tick 30 as well, timer 1 cancels timer 2 which is due at the same tick
+    log->cancelHandle = other;
+    AdvanceTo(30);
+    EXPECT_EQ(size_t{3}, log->count);
+    EXPECT_EQ(uintptr{1}, log->params[1]);
+    EXPECT_EQ(uintptr{0}, log->params[2]);
+    EXPECT_EQ(size_t{0}, wheel->GetActiveCount());
+}
+
+TEST_FIXTURE(TimerWheelTest, NextEventForOneShotInterrupt)
+{
+    uint64 next{};
+    EXPECT_FALSE(wheel->GetNextEvent(next));
+
+    AdvanceTo(100);
+    wheel->Add(130, RecordExpiration, reinterpret_cast<void*>(1), log);
+    wheel->Add(50000, RecordExpiration, reinterpret_cast<void*>(2), log);
+    EXPECT_TRUE(wheel->GetNextEvent(next));
+    EXPECT_EQ(uint64{130}, next);
+
+    // Only advance to the events, as a tickless timer would
+    while (wheel->GetNextEvent(next))
+    {
+        EXPECT_TRUE(next <= 50000);
+        AdvanceTo(next);
+    }
+    EXPECT_EQ(size_t{2}, log->count);
+    EXPECT_EQ(uint64{130}, log->ticks[0]);
+    EXPECT_EQ(uint64{50000}, log->ticks[1]);
+}
+
+} // suite Baremetal
+
+} // namespace test
+} // namespace baremetal
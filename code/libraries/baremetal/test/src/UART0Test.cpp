@@ -0,0 +1,339 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : UART0Test.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : UART0Test
+//
+// Description : UART0 tests
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/UART0.h"
+
+#include "baremetal/BCMRegisters.h"
+#include "baremetal/stubs/MemoryAccessStubUART0.h"
+#include "stdlib/Util.h"
+
+#include "unittest/unittest.h"
+
+using namespace unittest;
+
+namespace baremetal {
+namespace test {
+
+/// @brief Baremetal test suite
+TEST_SUITE(Baremetal)
+{
+
+class UART0Test : public TestFixture
+{
+public:
+    void SetUp() override
+    {
+    }
+    void TearDown() override
+    {
+    }
+};
+
+/// <summary>
+/// Let the stub send everything, running the UART0 interrupt handler whenever the transmit FIFO was emptied, until all data is sent
+/// </summary>
+/// <param name="memoryAccess">UART0 memory access stub</param>
+/// <param name="uart">UART0 instance in interrupt mode</param>
+static void TransmitAll(MemoryAccessStubUART0& memoryAccess, UART0& uart)
+{
+    while (memoryAccess.TransmitData() > 0)
+    {
+        uart.InterruptHandler();
+    }
+}
+
+TEST_FIXTURE(UART0Test, PolledWrite)
+{
+    MemoryAccessStubUART0 memoryAccess;
+    UART0 uart(memoryAccess);
+    uart.Initialize(115200);
+
+    EXPECT_EQ(uint32{17}, memoryAccess.Read32(RPI_UART0_IBRD));
+    EXPECT_EQ(uint32{23}, memoryAccess.Read32(RPI_UART0_FBRD));
+    EXPECT_FALSE(uart.IsInterruptMode());
+
+    uart.WriteString("Hi\n");
+    memoryAccess.TransmitData();
+    EXPECT_EQ(size_t{4}, memoryAccess.GetTransmittedCount());
+    EXPECT_EQ(0, memcmp("Hi\r\n", memoryAccess.GetTransmittedData(), 4));
+}
+
+TEST_FIXTURE(UART0Test, BaudRateSelectsClockAndDivisor)
+{
+    MemoryAccessStubUART0 memoryAccess;
+    UART0 uart(memoryAccess);
+    EXPECT_FALSE(uart.SetBaudRate(921600));
+    uart.Initialize(115200);
+
+    EXPECT_EQ(uint32{32000000}, memoryAccess.GetClockRate(ClockID::UART));
+    EXPECT_EQ(100, uart.GetBaudRateError());
+
+    // 32 MHz and 64 MHz give the same error, the lower clock is preferred
+    EXPECT_TRUE(uart.SetBaudRate(921600));
+    EXPECT_EQ(uint32{32000000}, memoryAccess.GetClockRate(ClockID::UART));
+    EXPECT_EQ(uint32{2}, memoryAccess.Read32(RPI_UART0_IBRD));
+    EXPECT_EQ(uint32{11}, memoryAccess.Read32(RPI_UART0_FBRD));
+    EXPECT_EQ(-799, uart.GetBaudRateError());
+
+    EXPECT_TRUE(uart.SetBaudRate(3000000));
+    EXPECT_EQ(uint32{48000000}, memoryAccess.GetClockRate(ClockID::UART));
+    EXPECT_EQ(uint32{1}, memoryAccess.Read32(RPI_UART0_IBRD));
+    EXPECT_EQ(uint32{0}, memoryAccess.Read32(RPI_UART0_FBRD));
+    EXPECT_EQ(0, uart.GetBaudRateError());
+
+    EXPECT_TRUE(uart.SetBaudRate(4000000));
+    EXPECT_EQ(uint32{64000000}, memoryAccess.GetClockRate(ClockID::UART));
+    EXPECT_EQ(uint32{1}, memoryAccess.Read32(RPI_UART0_IBRD));
+    EXPECT_EQ(uint32{0}, memoryAccess.Read32(RPI_UART0_FBRD));
+    EXPECT_EQ(uint32{0x301}, memoryAccess.Read32(RPI_UART0_CR));
+    EXPECT_EQ(uint32{0x7 << 4}, memoryAccess.Read32(RPI_UART0_LCRH));
+
+    EXPECT_FALSE(uart.SetBaudRate(5000000));
+    EXPECT_EQ(4000000u, uart.GetBaudRate());
+}
+
+TEST_FIXTURE(UART0Test, BaudRateKeptIfClockCannotBeSet)
+{
+    MemoryAccessStubUART0 memoryAccess;
+    UART0 uart(memoryAccess);
+    uart.Initialize(115200);
+    memoryAccess.SetMaxClockRate(ClockID::UART, 48000000);
+
+    // 4 Mbaud needs a 64 MHz clock, with the 48 MHz the firmware sets instead the divisor is below 1
+    EXPECT_FALSE(uart.SetBaudRate(4000000));
+    EXPECT_EQ(115200u, uart.GetBaudRate());
+    EXPECT_EQ(uint32{32000000}, memoryAccess.GetClockRate(ClockID::UART));
+    EXPECT_EQ(uint32{17}, memoryAccess.Read32(RPI_UART0_IBRD));
+    EXPECT_EQ(uint32{23}, memoryAccess.Read32(RPI_UART0_FBRD));
+    EXPECT_EQ(100, uart.GetBaudRateError());
+
+    // 3 Mbaud gets the 48 MHz clock it needs
+    EXPECT_TRUE(uart.SetBaudRate(3000000));
+    EXPECT_EQ(uint32{48000000}, memoryAccess.GetClockRate(ClockID::UART));
+}
+
+TEST_FIXTURE(UART0Test, PolledWriteFillsFIFO)
+{
+    MemoryAccessStubUART0 memoryAccess;
+    UART0 uart(memoryAccess);
+    uart.Initialize(115200);
+
+    const char* text = "0123456789\n0123456789\n";
+    const char* expected = "0123456789\r\n0123456789\r\n";
+    EXPECT_EQ(static_cast<ssize_t>(strlen(text)), uart.Write(text, strlen(text)));
+    EXPECT_EQ(uint32{0}, memoryAccess.Read32(RPI_UART0_FR) & RPI_UART0_FR_TXFF);
+    memoryAccess.TransmitData();
+    EXPECT_EQ(strlen(expected), memoryAccess.GetTransmittedCount());
+    EXPECT_EQ(0, memcmp(expected, memoryAccess.GetTransmittedData(), strlen(expected)));
+}
+
+TEST_FIXTURE(UART0Test, PolledGatherWrite)
+{
+    MemoryAccessStubUART0 memoryAccess;
+    UART0 uart(memoryAccess);
+    uart.Initialize(115200);
+
+    IOVector vectors[]{{"ab", 2}, {nullptr, 0}, {"\ncd", 3}};
+    EXPECT_EQ(ssize_t{5}, uart.WriteV(vectors, 3));
+    memoryAccess.TransmitData();
+    EXPECT_EQ(size_t{6}, memoryAccess.GetTransmittedCount());
+    EXPECT_EQ(0, memcmp("ab\r\ncd", memoryAccess.GetTransmittedData(), 6));
+
+    IOVector invalid[]{{"ab", 2}, {nullptr, 1}};
+    EXPECT_EQ(ssize_t{-1}, uart.WriteV(invalid, 2));
+}
+
+TEST_FIXTURE(UART0Test, InterruptModeRequiresInitialize)
+{
+    MemoryAccessStubUART0 memoryAccess;
+    UART0 uart(memoryAccess);
+
+    EXPECT_FALSE(uart.EnableInterruptMode());
+    EXPECT_FALSE(uart.IsInterruptMode());
+}
+
+TEST_FIXTURE(UART0Test, InterruptModeWriteReturnsPartialCount)
+{
+    MemoryAccessStubUART0 memoryAccess;
+    UART0 uart(memoryAccess);
+    uart.Initialize(115200);
+    EXPECT_TRUE(uart.EnableInterruptMode());
+    EXPECT_EQ(uint32{RPI_UART0_INT_RX | RPI_UART0_INT_TX | RPI_UART0_INT_RT | RPI_UART0_INT_FE | RPI_UART0_INT_PE | RPI_UART0_INT_BE |
+                     RPI_UART0_INT_OE},
+              memoryAccess.Read32(RPI_UART0_IMSC));
+
+    constexpr size_t DataSize = UART0_TX_BUFFER_SIZE + 100;
+    uint8 data[DataSize];
+    for (size_t i = 0; i < DataSize; ++i)
+        data[i] = static_cast<uint8>('A' + (i % 26));
+
+    // The transmit buffer is filled completely, after which the first part is moved to the transmit FIFO
+    ssize_t written = uart.Write(data, DataSize);
+    EXPECT_EQ(static_cast<ssize_t>(UART0_TX_BUFFER_SIZE), written);
+    EXPECT_EQ(size_t{RPI_UART0_FIFO_SIZE}, uart.GetTxFree());
+    EXPECT_EQ(uint32{1}, uart.GetStatistics().txBufferFull);
+
+    TransmitAll(memoryAccess, uart);
+    EXPECT_EQ(size_t{UART0_TX_BUFFER_SIZE}, uart.GetTxFree());
+
+    written = uart.Write(data + UART0_TX_BUFFER_SIZE, DataSize - UART0_TX_BUFFER_SIZE);
+    EXPECT_EQ(static_cast<ssize_t>(DataSize - UART0_TX_BUFFER_SIZE), written);
+    TransmitAll(memoryAccess, uart);
+
+    EXPECT_EQ(DataSize, memoryAccess.GetTransmittedCount());
+    EXPECT_EQ(0, memcmp(data, memoryAccess.GetTransmittedData(), DataSize));
+    EXPECT_EQ(uint64{DataSize}, uart.GetStatistics().bytesSent);
+}
+
+TEST_FIXTURE(UART0Test, InterruptModeWriteConvertsNewline)
+{
+    MemoryAccessStubUART0 memoryAccess;
+    UART0 uart(memoryAccess);
+    uart.Initialize(115200);
+    uart.EnableInterruptMode();
+
+    EXPECT_EQ(ssize_t{3}, uart.Write("a\nb", 3));
+    uart.WriteString("\n");
+    TransmitAll(memoryAccess, uart);
+
+    EXPECT_EQ(size_t{6}, memoryAccess.GetTransmittedCount());
+    EXPECT_EQ(0, memcmp("a\r\nb\r\n", memoryAccess.GetTransmittedData(), 6));
+}
+
+TEST_FIXTURE(UART0Test, InterruptModeGatherWriteFillsBufferAcrossVectors)
+{
+    MemoryAccessStubUART0 memoryAccess;
+    UART0 uart(memoryAccess);
+    uart.Initialize(115200);
+    uart.EnableInterruptMode();
+
+    constexpr size_t DataSize = UART0_TX_BUFFER_SIZE - 2;
+    uint8 data[DataSize];
+    for (size_t i = 0; i < DataSize; ++i)
+        data[i] = static_cast<uint8>('A' + (i % 26));
+
+    // The newline and its carriage return take the last two places in the transmit buffer, the last vector does not fit
+    IOVector vectors[]{{data, DataSize}, {"\n", 1}, {"xyz", 3}};
+    EXPECT_EQ(static_cast<ssize_t>(DataSize + 1), uart.WriteV(vectors, 3));
+    EXPECT_EQ(uint32{1}, uart.GetStatistics().txBufferFull);
+    TransmitAll(memoryAccess, uart);
+
+    EXPECT_EQ(DataSize + 2, memoryAccess.GetTransmittedCount());
+    EXPECT_EQ(0, memcmp(data, memoryAccess.GetTransmittedData(), DataSize));
+    EXPECT_EQ(0, memcmp("\r\n", memoryAccess.GetTransmittedData() + DataSize, 2));
+}
+
+TEST_FIXTURE(UART0Test, InterruptModeReceive)
+{
+    MemoryAccessStubUART0 memoryAccess;
+    UART0 uart(memoryAccess);
+    uart.Initialize(115200);
+    uart.EnableInterruptMode();
+
+    char buffer[16]{};
+    EXPECT_EQ(ssize_t{0}, uart.Read(buffer, sizeof(buffer)));
+
+    memoryAccess.ReceiveData("hello", 5);
+    EXPECT_EQ(uint32{RPI_UART0_INT_RT}, memoryAccess.Read32(RPI_UART0_MIS) & (RPI_UART0_INT_RX | RPI_UART0_INT_RT));
+    uart.InterruptHandler();
+    EXPECT_EQ(size_t{5}, uart.GetRxAvailable());
+
+    EXPECT_EQ(ssize_t{3}, uart.Read(buffer, 3));
+    EXPECT_EQ(0, memcmp("hel", buffer, 3));
+    EXPECT_EQ('l', uart.Read());
+    EXPECT_EQ(ssize_t{1}, uart.Read(buffer, sizeof(buffer)));
+    EXPECT_EQ('o', buffer[0]);
+    EXPECT_EQ(size_t{0}, uart.GetRxAvailable());
+    EXPECT_EQ(uint64{5}, uart.GetStatistics().bytesReceived);
+}
+
+TEST_FIXTURE(UART0Test, InterruptModeReceiveErrors)
+{
+    MemoryAccessStubUART0 memoryAccess;
+    UART0 uart(memoryAccess);
+    uart.Initialize(115200);
+    uart.EnableInterruptMode();
+
+    memoryAccess.ReceiveData("x", 1, RPI_UART0_DR_FE);
+    memoryAccess.ReceiveData("y", 1, RPI_UART0_DR_PE);
+    memoryAccess.ReceiveData("z", 1, RPI_UART0_DR_BE);
+    uart.InterruptHandler();
+    EXPECT_EQ(size_t{0}, uart.GetRxAvailable());
+    EXPECT_EQ(uint32{1}, uart.GetStatistics().framingErrors);
+    EXPECT_EQ(uint32{1}, uart.GetStatistics().parityErrors);
+    EXPECT_EQ(uint32{1}, uart.GetStatistics().breakErrors);
+
+    // Overflow the receive FIFO, the lost bytes are reported with the next byte received
+    uint8 data[RPI_UART0_FIFO_SIZE + 8];
+    memset(data, '1', sizeof(data));
+    EXPECT_EQ(size_t{RPI_UART0_FIFO_SIZE}, memoryAccess.ReceiveData(data, sizeof(data)));
+    uart.InterruptHandler();
+    EXPECT_EQ(uint32{0}, uart.GetStatistics().rxFIFOOverrun);
+    memoryAccess.ReceiveData("2", 1);
+    uart.InterruptHandler();
+    EXPECT_EQ(uint32{1}, uart.GetStatistics().rxFIFOOverrun);
+    EXPECT_EQ(size_t{RPI_UART0_FIFO_SIZE + 1}, uart.GetRxAvailable());
+
+    uart.ResetStatistics();
+    EXPECT_EQ(uint32{0}, uart.GetStatistics().rxFIFOOverrun);
+}
+
+TEST_FIXTURE(UART0Test, InterruptModeReceiveBufferOverrun)
+{
+    MemoryAccessStubUART0 memoryAccess;
+    UART0 uart(memoryAccess);
+    uart.Initialize(115200);
+    uart.EnableInterruptMode();
+
+    uint8 data[RPI_UART0_FIFO_SIZE];
+    memset(data, 'r', sizeof(data));
+    for (size_t i = 0; i < UART0_RX_BUFFER_SIZE / RPI_UART0_FIFO_SIZE + 1; ++i)
+    {
+        memoryAccess.ReceiveData(data, sizeof(data));
+        uart.InterruptHandler();
+    }
+    EXPECT_EQ(size_t{UART0_RX_BUFFER_SIZE}, uart.GetRxAvailable());
+    EXPECT_EQ(uint32{RPI_UART0_FIFO_SIZE}, uart.GetStatistics().rxBufferOverrun);
+    EXPECT_EQ(uint64{UART0_RX_BUFFER_SIZE}, uart.GetStatistics().bytesReceived);
+}
+
+} // suite Baremetal
+
+} // namespace test
+} // namespace baremetal
@@ -0,0 +1,287 @@
+//------------------------------------------------------------------------------
+// Copyright   : Copyright(c) 2025 Rene Barto
+//
+// File        : UART1Test.cpp
+//
+// Namespace   : baremetal
+//
+// Class       : UART1Test
+//
+// Description : UART1 tests
+//
+//------------------------------------------------------------------------------
+//
+// Baremetal - A C++ bare metal environment for embedded 64 bit ARM devices
+//
+// Intended support is for 64 bit code only, running on Raspberry Pi (3 or later)
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files(the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and /or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+
+#include "baremetal/UART1.h"
+
+#include "baremetal/Assert.h"
+#include "baremetal/BCMRegisters.h"
+#include "baremetal/stubs/MemoryAccessStubUART1.h"
+#include "stdlib/Util.h"
+
+#include "unittest/unittest.h"
+
+using namespace unittest;
+
+namespace baremetal {
+namespace test {
+
+/// @brief Baremetal test suite
+TEST_SUITE(Baremetal)
+{
+
+class UART1Test : public TestFixture
+{
+public:
+    void SetUp() override
+    {
+    }
+    void TearDown() override
+    {
+    }
+};
+
+/// @brief Maximum number of lines collected by LineCollector
+static constexpr size_t MaxLines = 4;
+
+/// <summary>
+/// Collects lines passed to the UART1 line callback
+/// </summary>
+struct LineCollector
+{
+    /// @brief Lines received
+    char lines[MaxLines][UART1_LINE_SIZE];
+    /// @brief Number of lines received
+    size_t count;
+
+    /// <summary>
+    /// UART1 line callback
+    /// </summary>
+    /// <param name="line">Received line</param>
+    /// <param name="length">Length of received line</param>
+    /// <param name="param">Pointer to LineCollector instance</param>
+    static void OnLine(const char* line, size_t length, void* param)
+    {
+        LineCollector* collector = reinterpret_cast<LineCollector*>(param);
+        if (collector->count < MaxLines)
+        {
+            memcpy(collector->lines[collector->count], line, length + 1);
+            ++collector->count;
+        }
+    }
+};
+
+TEST_FIXTURE(UART1Test, PolledWrite)
+{
+    MemoryAccessStubUART1 memoryAccess;
+    UART1 uart(memoryAccess);
+    uart.Initialize(115200);
+
+    EXPECT_EQ(ssize_t{5}, uart.Write("ab\ncd", 5));
+    memoryAccess.TransmitData();
+    EXPECT_EQ(size_t{6}, memoryAccess.GetTransmittedCount());
+    EXPECT_EQ(0, memcmp("ab\r\ncd", memoryAccess.GetTransmittedData(), 6));
+}
+
+TEST_FIXTURE(UART1Test, PolledGatherWrite)
+{
+    MemoryAccessStubUART1 memoryAccess;
+    UART1 uart(memoryAccess);
+    uart.Initialize(115200);
+
+    IOVector vectors[]{{"ab", 2}, {"\n", 1}, {"cd", 2}};
+    EXPECT_EQ(ssize_t{5}, uart.WriteV(vectors, 3));
+    memoryAccess.TransmitData();
+    EXPECT_EQ(size_t{6}, memoryAccess.GetTransmittedCount());
+    EXPECT_EQ(0, memcmp("ab\r\ncd", memoryAccess.GetTransmittedData(), 6));
+}
+
+TEST_FIXTURE(UART1Test, BaudrateRoundsDivisor)
+{
+    MemoryAccessStubUART1 memoryAccess;
+    UART1 uart(memoryAccess);
+    uart.Initialize(115200);
+
+    // Stub core clock is 250 MHz
+    EXPECT_EQ(uint32{270}, memoryAccess.Read32(RPI_AUX_MU_BAUD));
+    EXPECT_EQ(986, uart.GetBaudrateError());
+
+    // 250 MHz / (8 * 921600) is 33.9, rounding gives a lower error than truncating
+    EXPECT_TRUE(uart.SetBaudrate(921600));
+    EXPECT_EQ(uint32{33}, memoryAccess.Read32(RPI_AUX_MU_BAUD));
+    EXPECT_EQ(-2693, uart.GetBaudrateError());
+    EXPECT_EQ(uint32{RPI_AUX_MU_CNTL_ENABLE_RX | RPI_AUX_MU_CNTL_ENABLE_TX}, memoryAccess.Read32(RPI_AUX_MU_CNTL));
+
+    // Closest divisor is off by 2.3%
+    EXPECT_FALSE(uart.SetBaudrate(4000000));
+    EXPECT_EQ(921600u, uart.GetBaudrate());
+    EXPECT_EQ(uint32{33}, memoryAccess.Read32(RPI_AUX_MU_BAUD));
+}
+
+#ifndef NDEBUG
+
+/// @brief Number of failed assertions seen by CountAssertion
+static int s_assertionCount;
+
+/// <summary>
+/// Assertion callback counting failed assertions instead of halting
+/// </summary>
+/// <param name="expression">Expression which failed</param>
+/// <param name="fileName">File containing the assertion</param>
+/// <param name="lineNumber">Line number of the assertion</param>
+static void CountAssertion(const char* /*expression*/, const char* /*fileName*/, int /*lineNumber*/)
+{
+    ++s_assertionCount;
+}
+
+TEST_FIXTURE(UART1Test, InitializeWithUnsupportedBaudrateAsserts)
+{
+    MemoryAccessStubUART1 memoryAccess;
+    UART1 uart(memoryAccess);
+    s_assertionCount = 0;
+    SetAssertionCallback(CountAssertion);
+    uart.Initialize(4000000);
+    ResetAssertionCallback();
+
+    EXPECT_EQ(1, s_assertionCount);
+    EXPECT_EQ(0u, uart.GetBaudrate());
+    EXPECT_FALSE(uart.SetBaudrate(115200));
+}
+
+#endif
+
+TEST_FIXTURE(UART1Test, ReceiveInterruptBuffersData)
+{
+    MemoryAccessStubUART1 memoryAccess;
+    UART1 uart(memoryAccess);
+    EXPECT_FALSE(uart.EnableReceiveInterrupt());
+    uart.Initialize(115200);
+    EXPECT_TRUE(uart.EnableReceiveInterrupt());
+    EXPECT_EQ(uint32{RPI_AUX_MU_IER_RX_IRQ_ENABLE | RPI_AUX_MU_IER_IRQ_REQUIRED}, memoryAccess.Read32(RPI_AUX_MU_IER));
+
+    char buffer[16]{};
+    EXPECT_EQ(ssize_t{0}, uart.Read(buffer, sizeof(buffer)));
+    memoryAccess.ReceiveData("12345678", 8);
+    uart.InterruptHandler();
+    memoryAccess.ReceiveData("9", 1);
+    uart.InterruptHandler();
+
+    EXPECT_EQ(size_t{9}, uart.GetRxAvailable());
+    EXPECT_EQ(ssize_t{9}, uart.Read(buffer, sizeof(buffer)));
+    EXPECT_EQ(0, memcmp("123456789", buffer, 9));
+    EXPECT_EQ(uint64{9}, uart.GetStatistics().bytesReceived);
+    EXPECT_EQ(uint64{2}, uart.GetStatistics().interruptCount);
+}
+
+TEST_FIXTURE(UART1Test, ReceiveInterruptCountsOverrun)
+{
+    MemoryAccessStubUART1 memoryAccess;
+    UART1 uart(memoryAccess);
+    uart.Initialize(115200);
+    uart.EnableReceiveInterrupt();
+
+    EXPECT_EQ(size_t{RPI_AUX_MU_FIFO_SIZE}, memoryAccess.ReceiveData("0123456789", 10));
+    uart.InterruptHandler();
+
+    EXPECT_EQ(uint32{1}, uart.GetStatistics().rxFIFOOverrun);
+    EXPECT_EQ(size_t{RPI_AUX_MU_FIFO_SIZE}, uart.GetRxAvailable());
+}
+
+TEST_FIXTURE(UART1Test, LineAssembly)
+{
+    MemoryAccessStubUART1 memoryAccess;
+    UART1 uart(memoryAccess);
+    LineCollector collector{};
+    uart.Initialize(115200);
+    uart.EnableReceiveInterrupt();
+    uart.SetLineCallback(LineCollector::OnLine, &collector);
+
+    memoryAccess.ReceiveData("get\r\nse", 7);
+    uart.InterruptHandler();
+    memoryAccess.ReceiveData("t x\n\nab", 7);
+    uart.InterruptHandler();
+
+    EXPECT_EQ(size_t{3}, collector.count);
+    EXPECT_EQ("get", collector.lines[0]);
+    EXPECT_EQ("set x", collector.lines[1]);
+    EXPECT_EQ("", collector.lines[2]);
+    EXPECT_EQ(size_t{0}, uart.GetRxAvailable());
+
+    uart.SetLineCallback(nullptr, nullptr);
+    memoryAccess.ReceiveData("z", 1);
+    uart.InterruptHandler();
+    EXPECT_EQ(size_t{1}, uart.GetRxAvailable());
+}
+
+TEST_FIXTURE(UART1Test, ReadCharDoesNotWaitInLineAssemblyMode)
+{
+    MemoryAccessStubUART1 memoryAccess;
+    UART1 uart(memoryAccess);
+    LineCollector collector{};
+    uart.Initialize(115200);
+    uart.EnableReceiveInterrupt();
+    memoryAccess.ReceiveData("a", 1);
+    uart.InterruptHandler();
+    uart.SetLineCallback(LineCollector::OnLine, &collector);
+
+    memoryAccess.ReceiveData("b", 1);
+    uart.InterruptHandler();
+
+    EXPECT_EQ('a', uart.Read());
+    EXPECT_EQ('\0', uart.Read());
+    EXPECT_EQ(size_t{0}, collector.count);
+}
+
+TEST_FIXTURE(UART1Test, LineAssemblyTruncatesLongLines)
+{
+    MemoryAccessStubUART1 memoryAccess;
+    UART1 uart(memoryAccess);
+    LineCollector collector{};
+    uart.Initialize(115200);
+    uart.EnableReceiveInterrupt();
+    uart.SetLineCallback(LineCollector::OnLine, &collector);
+
+    char data[RPI_AUX_MU_FIFO_SIZE];
+    memset(data, 'x', sizeof(data));
+    for (size_t i = 0; i < UART1_LINE_SIZE / RPI_AUX_MU_FIFO_SIZE + 1; ++i)
+    {
+        memoryAccess.ReceiveData(data, sizeof(data));
+        uart.InterruptHandler();
+    }
+    memoryAccess.ReceiveData("\r", 1);
+    uart.InterruptHandler();
+
+    EXPECT_EQ(size_t{1}, collector.count);
+    EXPECT_EQ(size_t{UART1_LINE_SIZE - 1}, strlen(collector.lines[0]));
+    EXPECT_EQ(uint32{1}, uart.GetStatistics().lineOverflows);
+}
+
+} // suite Baremetal
+
+} // namespace test
+} // namespace baremetal
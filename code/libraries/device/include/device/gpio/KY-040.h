@@ -136,11 +136,15 @@ private:
     void SwitchEncoderInterruptHandler(baremetal::IGPIOPin* pin);
     static void SwitchButtonInterruptHandler(baremetal::IGPIOPin* pin, void* param);
     void SwitchButtonInterruptHandler(baremetal::IGPIOPin* pin);
+    static void SwitchButtonRestartDebounceWork(void* param, uintptr value);
+    void SwitchButtonRestartDebounce();
     static void SwitchButtonDebounceHandler(baremetal::KernelTimerHandle handle, void* param, void* context);
     void SwitchButtonDebounceHandler(baremetal::KernelTimerHandle handle, void* param);
     static void SwitchButtonTickHandler(baremetal::KernelTimerHandle handle, void* param, void* context);
     void SwitchButtonTickHandler(baremetal::KernelTimerHandle handle, void* param);
     void HandleSwitchButtonEvent(SwitchButtonEvent switchEvent);
+    void PostEvent(Event event);
+    static void EventWork(void* param, uintptr value);
 };
 
 } // namespace device
@@ -39,6 +39,7 @@
 
 #include "device/display/HD44780Display.h"
 
+#include "baremetal/Assert.h"
 #include "baremetal/Logger.h"
 #include "baremetal/Timer.h"
 #include "stdlib/Util.h"
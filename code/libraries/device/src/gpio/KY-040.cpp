@@ -39,7 +39,9 @@
 
 #include "device/gpio/KY-040.h"
 
+#include "baremetal/ARMInstructions.h"
 #include "baremetal/Assert.h"
+#include "baremetal/DeferredWork.h"
 #include "baremetal/Logger.h"
 
 /// @file
@@ -433,6 +435,8 @@ void KY040::Uninitialize()
         m_swPin.DisconnectInterrupt();
         m_isInitialized = false;
     }
+    // Run work queued by the interrupt handlers, as it refers to this instance. This may restart the debounce timer, so do this before cancelling the timers
+    GetDeferredWorkQueue().Run();
     if (m_debounceTimerHandle)
     {
         GetTimer().CancelKernelTimer(m_debounceTimerHandle);
@@ -497,9 +501,9 @@ void KY040::SwitchEncoderInterruptHandler(baremetal::IGPIOPin* pin)
     TRACE_DEBUG("KY040 Event: %s", EventToString(event));
     TRACE_DEBUG("KY040 Next state: %s", EncoderStateToString(m_switchEncoderState));
 
-    if ((event != Event::Unknown) && (m_eventHandler != nullptr))
+    if (event != Event::Unknown)
     {
-        (*m_eventHandler)(event, m_eventHandlerParam);
+        PostEvent(event);
     }
 }
 
@@ -535,6 +539,34 @@ void KY040::SwitchButtonInterruptHandler(IGPIOPin* pin)
         m_currentPressTicks = GetTimer().GetTicks();
     }
 
+    // Restarting the debounce timer is done as deferred work, to keep the interrupt handler short
+    if (!GetDeferredWorkQueue().Enqueue(SwitchButtonRestartDebounceWork, this))
+    {
+        SwitchButtonRestartDebounce();
+    }
+}
+
+/// <summary>
+/// Deferred work queued by the switch button interrupt handler, restarts the debounce timer
+/// </summary>
+/// <param name="param">Pointer to the class instance</param>
+/// <param name="value">Unused</param>
+void KY040::SwitchButtonRestartDebounceWork(void* param, uintptr /*value*/)
+{
+    KY040* pThis = reinterpret_cast<KY040*>(param);
+    assert(pThis != nullptr);
+    pThis->SwitchButtonRestartDebounce();
+}
+
+/// <summary>
+/// Restart the switch button debounce timer, so the debounce handler is called when the switch button has been stable for SwitchDebounceDelayMilliseconds
+/// </summary>
+void KY040::SwitchButtonRestartDebounce()
+{
+    // Deferred work runs with interrupts enabled, make sure the debounce timer does not expire while it is being replaced
+    uint64 daif;
+    GetDAIF(daif);
+    DisableIRQs();
     if (m_debounceTimerHandle)
     {
         TRACE_DEBUG("KY040 Cancel debounce timer");
@@ -542,7 +574,8 @@ void KY040::SwitchButtonInterruptHandler(IGPIOPin* pin)
     }
 
     TRACE_DEBUG("KY040 Start debounce timer");
-    m_debounceTimerHandle = GetTimer().StartKernelTimer(MSEC2TICKS(SwitchDebounceDelayMilliseconds), SwitchButtonDebounceHandler, nullptr, this);
+    m_debounceTimerHandle = GetTimer().StartKernelTimerMicroSeconds(SwitchDebounceDelayMilliseconds * USEC_PER_MSEC, SwitchButtonDebounceHandler, nullptr, this);
+    SetDAIF(daif);
 }
 
 /// <summary>
@@ -603,10 +636,7 @@ void KY040::SwitchButtonDebounceHandler(KernelTimerHandle handle, void* param)
 
     TRACE_DEBUG("KY040 Event             : %s", EventToString(event));
     TRACE_DEBUG("KY040 Switch Event      : %s", SwitchButtonEventToString(switchButtonEvent));
-    if (m_eventHandler)
-    {
-        (*m_eventHandler)(event, m_eventHandlerParam);
-    }
+    PostEvent(event);
 
     if (m_tickTimerHandle)
     {
@@ -614,7 +644,7 @@ void KY040::SwitchButtonDebounceHandler(KernelTimerHandle handle, void* param)
     }
 
     if (!swValue) // If pressed, check for hold
-        m_tickTimerHandle = GetTimer().StartKernelTimer(MSEC2TICKS(SwitchTickDelayMilliseconds), SwitchButtonTickHandler, nullptr, this);
+        m_tickTimerHandle = GetTimer().StartKernelTimerMicroSeconds(SwitchTickDelayMilliseconds * USEC_PER_MSEC, SwitchButtonTickHandler, nullptr, this);
 
     HandleSwitchButtonEvent(switchButtonEvent);
 }
@@ -644,7 +674,7 @@ void KY040::SwitchButtonTickHandler(KernelTimerHandle handle, void* param)
 {
     TRACE_DEBUG("KY040 Timeout tick timer");
     // Timer timed out, so we need to generate a tick
-    m_tickTimerHandle = GetTimer().StartKernelTimer(MSEC2TICKS(SwitchTickDelayMilliseconds), SwitchButtonTickHandler, nullptr, this);
+    m_tickTimerHandle = GetTimer().StartKernelTimerMicroSeconds(SwitchTickDelayMilliseconds * USEC_PER_MSEC, SwitchButtonTickHandler, nullptr, this);
 
     HandleSwitchButtonEvent(SwitchButtonEvent::Tick);
 }
@@ -669,10 +699,41 @@ void KY040::HandleSwitchButtonEvent(SwitchButtonEvent switchButtonEvent)
 
     m_switchButtonState = nextState;
 
-    if ((event != Event::Unknown) && (m_eventHandler != nullptr))
+    if (event != Event::Unknown)
+    {
+        PostEvent(event);
+    }
+}
+
+/// <summary>
+/// Pass an event to the registered event handler. Events are generated in interrupt context, so the event handler is called as deferred work.
+/// If the deferred work queue is full, the event handler is called directly
+/// </summary>
+/// <param name="event">Event to pass</param>
+void KY040::PostEvent(Event event)
+{
+    if (m_eventHandler == nullptr)
+        return;
+    if (!GetDeferredWorkQueue().Enqueue(EventWork, this, static_cast<uintptr>(event)))
     {
         (*m_eventHandler)(event, m_eventHandlerParam);
     }
 }
 
+/// <summary>
+/// Deferred work queued by PostEvent(), calls the registered event handler
+/// </summary>
+/// <param name="param">Pointer to the class instance</param>
+/// <param name="value">Event to pass</param>
+void KY040::EventWork(void* param, uintptr value)
+{
+    KY040* pThis = reinterpret_cast<KY040*>(param);
+    assert(pThis != nullptr);
+    // The event handler may have been unregistered after the event was queued
+    if (pThis->m_eventHandler != nullptr)
+    {
+        (*pThis->m_eventHandler)(static_cast<Event>(value), pThis->m_eventHandlerParam);
+    }
+}
+
 } // namespace device
@@ -72,3 +72,5 @@
 #define MIN(a, b)    ((a) < (b) ? (a) : (b))
 /// @brief Determine maximum of two values. Note that the arguments are evaluated multiple times, so they should not have side effects.
 #define MAX(a, b)    ((a) > (b) ? (a) : (b))
+/// @brief Determine absolute value. Note that the argument is evaluated multiple times, so it should not have side effects.
+#define ABS(a)       ((a) < 0 ? -(a) : (a))
@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+#------------------------------------------------------------------------------
+# Copyright   : Copyright(c) 2025 Rene Barto
+#
+# File        : decode-binary-log.py
+#
+# Description : Decode binary log output (BAREMETAL_BINARY_LOGGING=ON) into text
+#
+#------------------------------------------------------------------------------
+#
+# Usage: decode-binary-log.py <application.elf> [<captured log file or serial device>]
+#
+# The log is read from standard input if no input is specified.
+# Each binary log record is a frame terminated by a newline, encoded with COBS (removing zero bytes) and then XOR-ed with 0x0A.
+# Lines which cannot be decoded as a binary log record (e.g. output written before the logger was set up) are printed as is.
+#
+#------------------------------------------------------------------------------
+
+import argparse
+import re
+import struct
+import sys
+
+FRAME_END = 0x0A
+TIME_BASE_ID = 0xFFFFFFFE
+NO_STRING_ID = 0xFFFFFFFF
+HEADER_FORMAT = '<IIIQHBB'
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+SEVERITIES = ['!Panic!', 'Error  ', 'Warning', 'Info   ', 'Debug  ', 'Data   ']
+FORMAT_SPEC = re.compile(r'%(%|(#?)(-?)(0?)([0-9]*)(?:\.([0-9]+))?(l{0,2})([cdiufboxXsp]))')
+
+class ElfImage:
+    """Minimal 64 bit little endian ELF reader, giving access to the read only data section"""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[0:4] != b'\x7fELF' or self.data[4] != 2 or self.data[5] != 1:
+            raise ValueError(f'{path} is not a 64 bit little endian ELF file')
+        (shoff,) = struct.unpack_from('<Q', self.data, 0x28)
+        (shentsize, shnum, shstrndx) = struct.unpack_from('<HHH', self.data, 0x3A)
+        sections = []
+        for i in range(shnum):
+            (name, _, _, addr, offset, size) = struct.unpack_from('<IIQQQQ', self.data, shoff + i * shentsize)
+            sections.append((name, addr, offset, size))
+        strtab_offset = sections[shstrndx][2]
+        self.sections = {}
+        for (name, addr, offset, size) in sections:
+            end = self.data.index(b'\0', strtab_offset + name)
+            self.sections[self.data[strtab_offset + name:end].decode()] = (addr, offset, size)
+        if '.rodata' not in self.sections:
+            raise ValueError(f'{path} has no .rodata section')
+
+    def string_at_offset(self, rodata_offset):
+        (addr, offset, size) = self.sections['.rodata']
+        if rodata_offset >= size:
+            return None
+        start = offset + rodata_offset
+        end = self.data.index(b'\0', start)
+        return self.data[start:end].decode(errors='replace')
+
+    def string_at_address(self, address):
+        for (addr, offset, size) in self.sections.values():
+            if addr != 0 and addr <= address < addr + size:
+                start = offset + address - addr
+                end = self.data.index(b'\0', start)
+                return self.data[start:end].decode(errors='replace')
+        return None
+
+def cobs_decode(frame):
+    data = bytes(b ^ FRAME_END for b in frame)
+    result = bytearray()
+    index = 0
+    while index < len(data):
+        code = data[index]
+        if code == 0 or index + code > len(data) + 1:
+            return None
+        result += data[index + 1:index + code]
+        index += code
+        if code != 0xFF and index < len(data):
+            result.append(0)
+    return bytes(result)
+
+def to_signed(value, bits):
+    value &= (1 << bits) - 1
+    return value - (1 << bits) if value & (1 << (bits - 1)) else value
+
+def format_message(elf, format_string, args):
+    args = list(args)
+
+    def replace(match):
+        if match.group(1) == '%':
+            return '%'
+        (alternate, left, zero, width, precision, length, conversion) = match.groups()[1:]
+        value = args.pop(0) if args else 0
+        bits = 64 if length == 'll' or conversion == 'p' else 32
+        if conversion == 'c':
+            text = chr(value & 0xFF)
+        elif conversion in 'di':
+            text = str(to_signed(value, bits))
+        elif conversion == 'u':
+            text = str(value & ((1 << bits) - 1))
+        elif conversion == 'f':
+            text = f'{struct.unpack("<d", struct.pack("<Q", value))[0]:.{precision or 6}f}'
+        elif conversion == 's':
+            text = elf.string_at_address(value)
+            if text is None:
+                text = f'<string @ {value:#x}>'
+        else:
+            base = {'b': 'b', 'o': 'o', 'x': 'x', 'X': 'X', 'p': 'x'}[conversion]
+            prefix = {'b': '0b', 'o': '0', 'x': '0x', 'X': '0x', 'p': '0x'}[conversion] if alternate else ''
+            text = prefix + format(value & ((1 << bits) - 1), base)
+        if width:
+            fill = '0' if zero and not left else ' '
+            text = text.ljust(int(width)) if left else text.rjust(int(width), fill)
+        return text
+
+    return FORMAT_SPEC.sub(replace, format_string)
+
+class Decoder:
+    def __init__(self, elf):
+        self.elf = elf
+        self.counter_frequency = None
+
+    def decode_record(self, record):
+        if len(record) < HEADER_SIZE:
+            return None
+        (format_id, source_id, function_id, timestamp, line, severity, num_args) = struct.unpack_from(HEADER_FORMAT, record)
+        if len(record) != HEADER_SIZE + 8 * num_args or severity >= len(SEVERITIES):
+            return None
+        args = struct.unpack_from(f'<{num_args}Q', record, HEADER_SIZE)
+        if format_id == TIME_BASE_ID:
+            self.counter_frequency = args[0] if num_args > 0 else None
+            return f'-- time base {self.counter_frequency} Hz'
+        format_string = self.elf.string_at_offset(format_id)
+        if format_string is None:
+            return None
+        source = self.elf.string_at_offset(source_id) if source_id != NO_STRING_ID else '?'
+        if self.counter_frequency:
+            time = f'{timestamp / self.counter_frequency:.6f}'
+        else:
+            time = f'@{timestamp}'
+        message = format_message(self.elf, format_string, args)
+        if function_id != NO_STRING_ID:
+            function = self.elf.string_at_offset(function_id)
+            return f'{SEVERITIES[severity]}{time} {function} ({source}:{line}) {message}'
+        return f'{SEVERITIES[severity]}{time} {message} ({source}:{line})'
+
+    def decode_line(self, line):
+        if line.endswith(b'\r'):
+            line = line[:-1]
+        record = cobs_decode(line) if line else None
+        text = self.decode_record(record) if record is not None else None
+        if text is None:
+            text = line.decode(errors='replace')
+        return text
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode binary log output into text')
+    parser.add_argument('elf', help='ELF file of the application which produced the log')
+    parser.add_argument('input', nargs='?', help='Captured log file or serial device (default: standard input)')
+    options = parser.parse_args()
+
+    decoder = Decoder(ElfImage(options.elf))
+    log = open(options.input, 'rb') if options.input else sys.stdin.buffer
+    with log:
+        for line in log:
+            print(decoder.decode_line(line.rstrip(b'\n')), flush=True)
+
+if __name__ == '__main__':
+    main()